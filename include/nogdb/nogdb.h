@@ -92,6 +92,13 @@ namespace nogdb {
 
         static void update(Txn &txn, const RecordDescriptor &recordDescriptor, const Record &record);
 
+        // updates only the given properties, leaving the others and the indexes of unchanged values untouched
+        static void patch(Txn &txn, const RecordDescriptor &recordDescriptor, const Record &record);
+
+        // adds delta to a numeric property, a missing value counting as zero, and returns the new value
+        static Bytes increment(Txn &txn, const RecordDescriptor &recordDescriptor, const std::string &propertyName,
+                               int64_t delta);
+
         static void destroy(Txn &txn, const RecordDescriptor &recordDescriptor);
 
         static void destroy(Txn &txn, const std::string &className);
@@ -226,6 +233,13 @@ namespace nogdb {
 
         static void update(Txn &txn, const RecordDescriptor &recordDescriptor, const Record &record);
 
+        // updates only the given properties, leaving the others and the indexes of unchanged values untouched
+        static void patch(Txn &txn, const RecordDescriptor &recordDescriptor, const Record &record);
+
+        // adds delta to a numeric property, a missing value counting as zero, and returns the new value
+        static Bytes increment(Txn &txn, const RecordDescriptor &recordDescriptor, const std::string &propertyName,
+                               int64_t delta);
+
         static void updateSrc(Txn &txn, const RecordDescriptor &recordDescriptor,
                               const RecordDescriptor &newSrcVertexRecordDescriptor);
 
@@ -285,6 +299,45 @@ namespace nogdb {
         static const ClassDescriptor getSchema(const Txn &txn, const ClassId &classId);
 
         static const DBInfo getDbInfo(const Txn &txn);
+
+        // rewrites the records of a class which are still stored in the legacy format, while the database stays
+        // online, and returns the number of rewritten records; records are also rewritten whenever they are updated
+        static size_t upgradeRecordFormat(Txn &txn, const std::string &className);
+    };
+
+    //*************************************************************
+    //*  NogDB bulk loading operations.                           *
+    //*************************************************************
+
+    // A bulk loading session for an initial ingestion of vertices and edges in a single write transaction.
+    // Position ids are allocated in memory and records are appended to their classes as they are added,
+    // whereas relations, indexes, and the in-memory graph are built in one pass by finish(). Record counters
+    // are written back when the transaction commits.
+    // A transaction in which records have been added refuses to commit until finish() has succeeded. Endpoints of edges are not re-versioned
+    // and unique index violations are reported by finish() rather than by addVertex()/addEdge().
+    class BulkLoader {
+    public:
+        BulkLoader(Txn &txn_);
+
+        ~BulkLoader() noexcept;
+
+        BulkLoader(const BulkLoader &bl) = delete;
+
+        BulkLoader &operator=(const BulkLoader &bl) = delete;
+
+        const RecordDescriptor addVertex(const std::string &className, const Record &record = Record{});
+
+        const RecordDescriptor
+        addEdge(const std::string &className, const RecordDescriptor &srcVertexRecordDescriptor,
+                const RecordDescriptor &dstVertexRecordDescriptor, const Record &record = Record{});
+
+        void finish();
+
+    private:
+        struct BulkState;
+
+        Txn &txn;
+        std::unique_ptr<BulkState> state;
     };
 
     //*************************************************************
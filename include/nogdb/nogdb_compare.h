@@ -407,6 +407,34 @@ namespace nogdb {
         //bool isExclude{false};
     };
 
+    // selects the properties to be decoded when records are retrieved, where an empty filter means all properties
+    // and basic info (e.g. @className or @recordId) is generated only when it is listed
+    class PropertyFilter {
+    public:
+        PropertyFilter() = default;
+
+        ~PropertyFilter() noexcept = default;
+
+        PropertyFilter(const std::initializer_list<std::string> &initializerList);
+
+        PropertyFilter(const std::vector<std::string> &propertyNames_);
+
+        PropertyFilter(const std::set<std::string> &propertyNames_);
+
+        void add(const std::string &propertyName);
+
+        void remove(const std::string &propertyName);
+
+        size_t size() const;
+
+        bool empty() const;
+
+        const std::set<std::string> &getPropertyName() const;
+
+    private:
+        std::set<std::string> propertyNames{};
+    };
+
 }
 
 #endif
@@ -36,6 +36,25 @@
 
 namespace nogdb {
 
+    struct ContextOptions {
+        ContextOptions();
+
+        unsigned int maxDbNum;              // a maximum number of databases that can be handled.
+        unsigned long maxDbSize;            // the initial size of the memory map.
+        unsigned long maxMapSize;           // the memory map doubles up to this size as it fills up, 0 for a fixed size.
+        unsigned int maxReaders;            // a maximum number of concurrent read transactions.
+        unsigned int readTxnPoolSize;       // completed read transactions kept for reuse, 0 for none.
+        unsigned int numLoadingThreads;     // threads restoring relations into memory, 0 for one per hardware thread.
+        unsigned long adjacencyCacheSize;   // edges kept in memory, 0 for keeping the whole graph in memory.
+
+        // durability modes, a system crash (not an application crash) may lose commits made since the last flush
+        bool noSync;                        // do not flush to disk on commit.
+        bool noMetaSync;                    // flush data but not the meta page on commit, may lose the last commit.
+        bool writeMap;                      // write through a writable memory map instead of write(2).
+        bool mapAsync;                      // with writeMap, flush the memory map asynchronously on commit.
+        unsigned int syncIntervalMs;        // flush to disk from a background thread this often, 0 for never.
+    };
+
     class Context {
     public:
         friend struct LMDBInterface;
@@ -53,6 +72,10 @@ namespace nogdb {
 
         friend class BaseTxn;
 
+        friend class BulkLoader;
+
+        friend class WriteQueue;
+
         friend class Txn;
 
         Context() = default;
@@ -67,6 +90,8 @@ namespace nogdb {
 
         Context(const std::string &dbPath, unsigned int maxDbNum, unsigned long maxDbSize);
 
+        Context(const std::string &dbPath, const ContextOptions &options);
+
         Context(const Context &ctx);
 
         Context &operator=(const Context &ctx);
@@ -81,19 +106,27 @@ namespace nogdb {
 
         std::pair<TxnId, TxnId> getMinActiveTxnId() const;
 
+        ReclaimStat getReclaimStat() const;
+
+        // flush committed data to disk, for contexts opened without synchronous commits
+        void sync() const;
+
     private:
         std::shared_ptr<storage_engine::LMDBEnv> envHandler;
         std::shared_ptr<DBInfo> dbInfo;
         std::shared_ptr<Schema> dbSchema;
         std::shared_ptr<TxnStat> dbTxnStat;
         std::shared_ptr<Graph> dbRelation;
+        std::shared_ptr<Reclaimer> dbReclaimer;
+        std::shared_ptr<Flusher> dbFlusher;
+        std::shared_ptr<BaseTxnPool> dbTxnPool;
 
         mutable std::shared_ptr<boost::shared_mutex> dbInfoMutex;
         mutable std::shared_ptr<boost::shared_mutex> dbWriterMutex;
 
         int lockContextFileDescriptor;
 
-        void initDatabase();
+        void initDatabase(unsigned int numLoadingThreads);
     };
 
 }
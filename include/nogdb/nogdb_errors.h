@@ -23,6 +23,8 @@
 #define __NOGDB_ERR_H_INCLUDED_
 
 #include <exception>
+#include <stdexcept>
+#include <string>
 #include "lmdb/lmdb.h"
 
 //*************************************************************
@@ -42,6 +44,8 @@
 #define NOGDB_TXN_INVALID_MODE                  0xa00
 #define NOGDB_TXN_COMPLETED                     0xa01
 #define NOGDB_TXN_VERSION_MAXREACH              0xa02
+#define NOGDB_TXN_INVALID_SAVEPOINT             0xa03
+#define NOGDB_TXN_UNFINISHED_BULK_LOAD          0xa04
 #define NOGDB_TXN_UNKNOWN_ERR                   0xfff
 
 #define NOGDB_CTX_INVALID_CLASSTYPE             0x1000
@@ -56,6 +60,7 @@
 #define NOGDB_CTX_OVERRIDE_PROPERTY             0x2040
 #define NOGDB_CTX_CONFLICT_PROPTYPE             0x2050
 #define NOGDB_CTX_IN_USED_PROPERTY              0x2060
+#define NOGDB_CTX_OUT_OF_RANGE_VALUE            0x2070
 #define NOGDB_CTX_NOEXST_RECORD	                0x3000
 #define NOGDB_CTX_INVALID_COMPARATOR            0x4000
 #define NOGDB_CTX_INVALID_PROPTYPE_INDEX        0x6000
@@ -183,6 +188,8 @@ namespace nogdb {
                     return "NOGDB_CTX_CONFLICT_PROPTYPE: Some properties do not have the same type";
                 case NOGDB_CTX_IN_USED_PROPERTY:
                     return "NOGDB_CTX_IN_USED_PROPERTY: A property is used by one or more database indexes";
+                case NOGDB_CTX_OUT_OF_RANGE_VALUE:
+                    return "NOGDB_CTX_OUT_OF_RANGE_VALUE: A value is out of the range of its property type";
                 case NOGDB_CTX_NOEXST_RECORD:
                     return "NOGDB_CTX_NOEXST_RECORD: A record with the given descriptor doesn't exist";
                 case NOGDB_CTX_MISMATCH_CLASSTYPE:
@@ -234,6 +241,10 @@ namespace nogdb {
                     return "NOGDB_TXN_COMPLETED: An operation couldn't be executed due to a completed transaction";
                 case NOGDB_TXN_VERSION_MAXREACH:
                     return "NOGDB_TXN_VERSION_MAXREACH: The transaction version has been reached the maximum value";
+                case NOGDB_TXN_INVALID_SAVEPOINT:
+                    return "NOGDB_TXN_INVALID_SAVEPOINT: A savepoint doesn't exist in the transaction";
+                case NOGDB_TXN_UNFINISHED_BULK_LOAD:
+                    return "NOGDB_TXN_UNFINISHED_BULK_LOAD: A transaction couldn't be committed or use its savepoints with an unfinished bulk loading";
                 case NOGDB_TXN_UNKNOWN_ERR:
                 default:
                     return "NOGDB_TXN_UNKNOWN_ERR: Unknown";
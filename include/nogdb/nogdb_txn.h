@@ -22,6 +22,13 @@
 #ifndef __NOGDB_TXN_H_INCLUDED_
 #define __NOGDB_TXN_H_INCLUDED_
 
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 #include "nogdb_context.h"
 
 namespace nogdb {
@@ -43,6 +50,8 @@ namespace nogdb {
         friend struct Traverse;
 
         friend class ResultSetCursor;
+        friend class BulkLoader;
+        friend class WriteQueue;
 
         enum Mode {
             READ_ONLY, READ_WRITE
@@ -64,6 +73,22 @@ namespace nogdb {
 
         void rollback() noexcept;
 
+        // A savepoint marks the changes made so far in a read-write transaction, so that the changes made after it
+        // can be rolled back alone, e.g. a sub-batch of a large ingestion which violates a unique constraint.
+        // Savepoints are nested transactions of LMDB, which are not supported with ContextOptions::writeMap,
+        // and a BulkLoader which has added records must finish before a savepoint is taken, rolled back to,
+        // or released, otherwise NOGDB_TXN_UNFINISHED_BULK_LOAD is thrown.
+        typedef size_t Savepoint;
+
+        Savepoint savepoint();
+
+        // undo the changes made after a savepoint, which stays valid, while the savepoints taken after it are gone
+        void rollbackTo(Savepoint savepoint);
+
+        // keep the changes made after a savepoint and the savepoints taken after it as a part of the enclosing
+        // savepoint or transaction, a released savepoint costs nothing in the rest of the transaction
+        void releaseSavepoint(Savepoint savepoint);
+
         TxnId getTxnId() const;
 
         TxnId getVersionId() const;
@@ -77,6 +102,112 @@ namespace nogdb {
 
     };
 
+    // A queue of mutations submitted by many threads and applied by a single writer thread, which group-commits
+    // the mutations arriving while the previous group commits in one write transaction rather than one each.
+    // A future returned by submit() completes with the result of its function once the transaction applying
+    // it has been committed, or with the exception thrown by the function, whose changes are rolled back to
+    // a savepoint taken before it while the other mutations of the group stay applied. A group which runs out
+    // of map space is applied again once the map has grown, and so is the rest of a group with a failed function
+    // under ContextOptions::writeMap, which does not support savepoints.
+    // A function may therefore be applied more than once and must only act through the given transaction.
+    // It must not open another write transaction on the same context.
+    class WriteQueue {
+    public:
+        explicit WriteQueue(Context &ctx_);
+
+        // maxBatchSize is the maximum number of mutations in a group commit, and maxDelayUs is the longest time
+        // in microseconds a mutation arriving at an idle writer waits for others to join its group, 0 by default
+        WriteQueue(Context &ctx_, unsigned int maxBatchSize, unsigned int maxDelayUs);
+
+        // pending mutations are still committed before the writer thread stops
+        ~WriteQueue() noexcept;
+
+        WriteQueue(const WriteQueue &wq) = delete;
+
+        WriteQueue &operator=(const WriteQueue &wq) = delete;
+
+        template<typename Function>
+        std::future<typename std::result_of<Function(Txn &)>::type> submit(Function function);
+
+    private:
+        class Request {
+        public:
+            virtual ~Request() noexcept = default;
+
+            virtual void apply(Txn &txn) = 0;
+
+            virtual void complete(std::exception_ptr error) noexcept = 0;
+        };
+
+        template<typename Result>
+        class Task;
+
+        struct QueueState;
+
+        Context &ctx;
+        std::unique_ptr<QueueState> state;
+
+        void enqueue(const std::shared_ptr<Request> &request);
+
+        void run();
+
+        void commit(std::vector<std::shared_ptr<Request>> &requests);
+    };
+
+    template<typename Result>
+    class WriteQueue::Task : public WriteQueue::Request {
+    public:
+        explicit Task(std::function<Result(Txn &)> function_) : function{std::move(function_)} {}
+
+        std::future<Result> getFuture() { return promise.get_future(); }
+
+        virtual void apply(Txn &txn) { result.reset(new Result(function(txn))); }
+
+        virtual void complete(std::exception_ptr error) noexcept {
+            if (error) {
+                promise.set_exception(error);
+            } else {
+                promise.set_value(std::move(*result));
+            }
+        }
+
+    private:
+        std::function<Result(Txn &)> function;
+        std::promise<Result> promise{};
+        std::unique_ptr<Result> result{};
+    };
+
+    template<>
+    class WriteQueue::Task<void> : public WriteQueue::Request {
+    public:
+        explicit Task(std::function<void(Txn &)> function_) : function{std::move(function_)} {}
+
+        std::future<void> getFuture() { return promise.get_future(); }
+
+        virtual void apply(Txn &txn) { function(txn); }
+
+        virtual void complete(std::exception_ptr error) noexcept {
+            if (error) {
+                promise.set_exception(error);
+            } else {
+                promise.set_value();
+            }
+        }
+
+    private:
+        std::function<void(Txn &)> function;
+        std::promise<void> promise{};
+    };
+
+    template<typename Function>
+    std::future<typename std::result_of<Function(Txn &)>::type> WriteQueue::submit(Function function) {
+        typedef typename std::result_of<Function(Txn &)>::type Result;
+        auto task = std::make_shared<Task<Result>>(std::function<Result(Txn &)>{std::move(function)});
+        auto future = task->getFuture();
+        enqueue(task);
+        return future;
+    }
+
 }
 
 #endif
@@ -64,13 +64,19 @@ namespace nogdb {
 
     class BaseTxn;
 
+    class BaseTxnPool;
+
+    class Reclaimer;
+
+    class Flusher;
+
     class Condition;
 
     class MultiCondition;
 
     class PathFilter;
 
-    class RWSpinLock;
+    class PropertyFilter;
 
     namespace storage_engine {
         class LMDBEnv;
@@ -130,6 +136,17 @@ namespace nogdb {
         IndexId numIndex{0};           // a number of indexes in the database.
     };
 
+    struct ReclaimStat {
+        ReclaimStat() = default;
+
+        TxnId safeVersionId{0};                 // the latest version which no active reader is older than.
+        TxnId versionLag{0};                    // a number of committed versions newer than safeVersionId.
+        unsigned long numPendingElements{0};    // deleted elements waiting for active readers to complete.
+        unsigned long numPendingVersions{0};    // elements holding versions which may still be visible.
+        unsigned long numReclaimedElements{0};  // a total number of deleted elements freed from memory.
+        unsigned long numRuns{0};               // a total number of reclamation passes.
+    };
+
     class Txn;
 
     class Bytes {
@@ -205,8 +222,14 @@ namespace nogdb {
             return Converter<T>::toBytes(data);
         }
     private:
+        // values up to this size, e.g. any numeric property, are kept inline without a heap allocation
+        static constexpr size_t INLINE_CAPACITY = 16;
+
         unsigned char *value_{nullptr};
         size_t size_{0};
+        unsigned char buffer_[INLINE_CAPACITY];
+
+        void allocate(size_t len);
 
         static Bytes merge(const Bytes& bytes1, const Bytes& byte2);
         static Bytes merge(const std::vector<Bytes> &bytes);
@@ -532,9 +555,18 @@ namespace nogdb {
 
         explicit Record() = default;
 
+        Record(const Record &other);
+
+        Record(Record &&other) = default;
+
+        Record &operator=(const Record &other);
+
+        Record &operator=(Record &&other) = default;
+
         template<typename T>
         Record &set(const std::string &propName, const T &value) {
             if (!propName.empty() && !isBasicInfo(propName)) {
+                expand();
                 properties[propName] = Bytes::Converter<T>::toBytes(value);
             }
             return *this;
@@ -542,6 +574,7 @@ namespace nogdb {
 
         template<typename T>
         Record &setIfNotExists(const std::string &propName, const T &value) {
+            expand();
             if (properties.find(propName) == properties.cend()) {
                 set(propName, value);
             }
@@ -601,16 +634,35 @@ namespace nogdb {
 
         friend struct Vertex;
         friend struct Edge;
+        friend class BulkLoader;
+        friend struct ClassPropertyInfo;
+
+        // a record decoded from storage keeps its values in a vector ordered by property id and resolves
+        // their names through the class schema until a string-keyed map is actually needed
+        struct PropertyNameMap {
+            std::map<PropertyId, std::string> idToName{};
+            std::map<std::string, PropertyId> nameToId{};
+        };
+        using PropertyIdToBytes = std::vector<std::pair<PropertyId, Bytes>>;
 
         Record(PropertyToBytesMap properties);
 
         Record(PropertyToBytesMap properties, PropertyToBytesMap basicProperties)
                 : properties(std::move(properties)), basicProperties(std::move(basicProperties)) {}
 
+        Record(PropertyIdToBytes properties, std::shared_ptr<const PropertyNameMap> propertyNames);
+
         inline bool isBasicInfo(const std::string &str) const { return str.at(0) == '@'; }
 
+        void expand();
+
         PropertyToBytesMap properties{};
         mutable PropertyToBytesMap basicProperties{};
+        PropertyIdToBytes compactProperties{};
+        std::shared_ptr<const PropertyNameMap> propertyNames{};
+        // the string-keyed map of a compact record, built by the first getAll() and published atomically
+        // since concurrent readers may share a const record
+        mutable std::shared_ptr<const PropertyToBytesMap> expandedProperties{};
 
         template<typename T>
         const Record &setBasicInfo(const std::string &propName, const T &value) const {
@@ -703,6 +755,9 @@ namespace nogdb {
         Result(const RecordDescriptor &recordDescriptor_, const Record &record_)
                 : descriptor{recordDescriptor_}, record{record_} {}
 
+        Result(const RecordDescriptor &recordDescriptor_, Record &&record_)
+                : descriptor{recordDescriptor_}, record{std::move(record_)} {}
+
         RecordDescriptor descriptor{};
         Record record{};
     };
@@ -758,6 +813,9 @@ namespace nogdb {
 
         const Result *operator->() const;
 
+        // only the properties in the filter are decoded from the next retrieved record onwards
+        ResultSetCursor &setPropertyFilter(const PropertyFilter &propertyFilter);
+
     private:
         typedef std::unordered_map<ClassId, ClassPropertyInfo> ClassPropertyCache;
 
@@ -766,8 +824,11 @@ namespace nogdb {
         std::vector<RecordDescriptor> metadata{};
         long long currentIndex;
         Result result;
+        std::set<std::string> propertyNames{};
+
+        Result retrieve(const RecordDescriptor &recordDescriptor);
 
-        const ClassPropertyInfo resolveClassPropertyInfo(ClassId classId);
+        const ClassPropertyInfo &resolveClassPropertyInfo(ClassId classId);
     };
 
     inline bool operator<(const RecordId &lhs, const RecordId &rhs) {
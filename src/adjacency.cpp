@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <cstring>
+
+#include "constant.hpp"
+#include "lmdb_engine.hpp"
+#include "adjacency.hpp"
+
+namespace nogdb {
+
+    std::vector<Adjacency::Entry> Adjacency::find(storage_engine::LMDBTxn &txn, const RecordId &vertexRid) {
+        static_assert(sizeof(Key) == sizeof(RelationKey) * 2 + sizeof(uint8_t), "an adjacency key must be packed");
+        auto result = std::vector<Entry>{};
+        auto const prefix = rid2key(vertexRid);
+        auto adjacencyCursor = txn.openCursor(TB_ADJACENCY);
+        for (auto keyValue = adjacencyCursor.findRange(prefix);
+             !keyValue.empty();
+             keyValue = adjacencyCursor.getNext()) {
+            if (keyValue.key.data.size() != sizeof(Key) ||
+                memcmp(keyValue.key.data.data(), prefix.bytes, sizeof(RelationKey)) != 0) {
+                break;
+            }
+            auto key = keyValue.key.data.numeric<Key>();
+            result.emplace_back(static_cast<Direction>(key.direction),
+                                key2rid(key.edge),
+                                key2rid(keyValue.val.data.numeric<RelationKey>()));
+        }
+        return result;
+    }
+
+    void Adjacency::add(storage_engine::LMDBTxn &txn, const RecordId &edgeRid,
+                        const RecordId &srcRid, const RecordId &dstRid) {
+        auto adjacencyDBHandler = txn.openDbi(TB_ADJACENCY);
+        adjacencyDBHandler.put(getKey(srcRid, Direction::OUT, edgeRid), rid2key(dstRid));
+        adjacencyDBHandler.put(getKey(dstRid, Direction::IN, edgeRid), rid2key(srcRid));
+    }
+
+    void Adjacency::remove(storage_engine::LMDBTxn &txn, const RecordId &edgeRid,
+                           const RecordId &srcRid, const RecordId &dstRid) {
+        auto adjacencyDBHandler = txn.openDbi(TB_ADJACENCY);
+        adjacencyDBHandler.del(getKey(srcRid, Direction::OUT, edgeRid));
+        adjacencyDBHandler.del(getKey(dstRid, Direction::IN, edgeRid));
+    }
+
+    void Adjacency::synchronize(storage_engine::LMDBTxn &txn) {
+        auto adjacencyDBHandler = txn.openDbi(TB_ADJACENCY);
+        if (!adjacencyDBHandler.get(ADJACENCY_SYNCED_KEY).empty) {
+            return;
+        }
+        adjacencyDBHandler.drop();
+        auto relationCursor = txn.openCursor(TB_RELATIONS);
+        for (auto keyValue = relationCursor.getNext(); !keyValue.empty(); keyValue = relationCursor.getNext()) {
+            // skip non-relation entries (e.g. .init and .format)
+            if (keyValue.key.data.size() != sizeof(RelationKey)) {
+                continue;
+            }
+            auto srcRid = RecordId{};
+            auto dstRid = RecordId{};
+            auto data = keyValue.val.data.blob();
+            auto offset = data.retrieve(&srcRid.first, 0, sizeof(ClassId));
+            offset = data.retrieve(&srcRid.second, offset, sizeof(PositionId));
+            offset = data.retrieve(&dstRid.first, offset, sizeof(ClassId));
+            data.retrieve(&dstRid.second, offset, sizeof(PositionId));
+            add(txn, key2rid(keyValue.key.data.numeric<RelationKey>()), srcRid, dstRid);
+        }
+        adjacencyDBHandler.put(ADJACENCY_SYNCED_KEY, uint8_t{1});
+    }
+
+    void Adjacency::invalidate(storage_engine::LMDBTxn &txn) {
+        txn.openDbi(TB_ADJACENCY).del(ADJACENCY_SYNCED_KEY);
+    }
+
+}
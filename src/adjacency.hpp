@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __ADJACENCY_HPP_INCLUDED_
+#define __ADJACENCY_HPP_INCLUDED_
+
+#include <tuple>
+#include <vector>
+
+#include "storage_engine.hpp"
+#include "graph.hpp"
+
+#include "nogdb_types.h"
+
+namespace nogdb {
+
+    // NOTE: .adjacency keeps both incidences of every edge keyed by a vertex so that the adjacency of
+    // a single vertex can be read with one range scan when the in-memory graph is only a bounded cache.
+    // A key is [vertex rid][direction][edge rid] and a value is the rid of the vertex at the other end.
+    // It is only maintained while a context runs with a bounded adjacency cache, ADJACENCY_SYNCED_KEY
+    // marks whether its content is in line with .relations.
+    struct Adjacency {
+        Adjacency() = delete;
+
+        ~Adjacency() noexcept = delete;
+
+        enum Direction : uint8_t {
+            IN = 0, OUT = 1
+        };
+
+        // direction, edge rid, and rid of the vertex at the other end of an edge
+        typedef std::tuple<Direction, RecordId, RecordId> Entry;
+
+        static std::vector<Entry> find(storage_engine::LMDBTxn &txn, const RecordId &vertexRid);
+
+        static void add(storage_engine::LMDBTxn &txn, const RecordId &edgeRid,
+                        const RecordId &srcRid, const RecordId &dstRid);
+
+        static void remove(storage_engine::LMDBTxn &txn, const RecordId &edgeRid,
+                           const RecordId &srcRid, const RecordId &dstRid);
+
+        // rebuild the adjacency from .relations unless it is already in sync
+        static void synchronize(storage_engine::LMDBTxn &txn);
+
+        // mark the adjacency as out of sync since relations will be changed without maintaining it
+        static void invalidate(storage_engine::LMDBTxn &txn);
+
+    private:
+        struct Key {
+            RelationKey vertex;
+            uint8_t direction;
+            RelationKey edge;
+        };
+
+        inline static Key getKey(const RecordId &vertexRid, Direction direction, const RecordId &edgeRid) {
+            return Key{rid2key(vertexRid), direction, rid2key(edgeRid)};
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,494 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __ADJACENCY_LIST_HPP_INCLUDED_
+#define __ADJACENCY_LIST_HPP_INCLUDED_
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "boost/functional/hash.hpp"
+#include "spinlock.hpp"
+
+#include "nogdb_types.h"
+
+// a writer with more uncommitted (or committed) changes in an adjacency looks them up by edge rather than scanning them
+#define ADJACENCY_DELTA_INDEX_THRESHOLD 32U
+
+namespace nogdb {
+
+    // NOTE: a compact, multi-versioned set of edges incident to a vertex in one direction.
+    // Edges which every active transaction can see are kept as sorted position ids grouped by edge class.
+    // Changes made by later commits (and by the current writer) are kept in a small overlay of deltas
+    // which are merged into the sorted groups once no transaction can see the graph before them.
+    // The deltas are also the versions of the edges themselves: an edge moved to another vertex is inserted
+    // along with the vertex it comes from, so that a reader can follow it back to where it was.
+    class AdjacencyList {
+    public:
+        AdjacencyList() = default;
+
+        AdjacencyList(const AdjacencyList &) = delete;
+
+        AdjacencyList &operator=(const AdjacencyList &) = delete;
+
+        // add an edge which is visible to every transaction, e.g. when restoring relations
+        void load(const RecordId &rid) {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            auto &positionIds = getEdgeClass(rid.first).positionIds;
+            if (positionIds.empty() || positionIds.back() < rid.second) {
+                positionIds.push_back(rid.second);
+            } else {
+                auto iter = std::lower_bound(positionIds.begin(), positionIds.end(), rid.second);
+                if (iter == positionIds.end() || *iter != rid.second) {
+                    positionIds.insert(iter, rid.second);
+                }
+            }
+        }
+
+        // add an edge which is visible to every transaction without keeping the order of edges,
+        // sort() must be called before the list is used by any transaction
+        void append(const RecordId &rid) {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            getEdgeClass(rid.first).positionIds.push_back(rid.second);
+        }
+
+        void sort() {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            for (auto &edgeClass: edgeClasses_) {
+                auto &positionIds = edgeClass.positionIds;
+                std::sort(positionIds.begin(), positionIds.end());
+                positionIds.erase(std::unique(positionIds.begin(), positionIds.end()), positionIds.end());
+                positionIds.shrink_to_fit();
+            }
+        }
+
+        // uncommitted changes of a writer, return true if the latest version of the adjacency has changed,
+        // an edge moved from another vertex is inserted along with that vertex, an edge created has none
+        bool insert(const RecordId &rid, const RecordId &from = RecordId{}) {
+            return update(rid, true, from);
+        }
+
+        bool erase(const RecordId &rid) {
+            return update(rid, false, RecordId{});
+        }
+
+        // aka. commit, all uncommitted changes belong to the only writer
+        void commit(TxnId versionId) {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            for (auto iter = deltas_.end() - numUncommitted_; iter != deltas_.end(); ++iter) {
+                iter->versionId = versionId;
+                iter->isCommitted = true;
+            }
+            if (committedRids_ != nullptr) {
+                for (auto iter = deltas_.cend() - numUncommitted_; iter != deltas_.cend(); ++iter) {
+                    indexCommitted(*iter);
+                }
+            } else if (deltas_.size() > ADJACENCY_DELTA_INDEX_THRESHOLD) {
+                committedRids_.reset(new std::unordered_map<RecordId, CommittedState, boost::hash<RecordId>>{});
+                for (const auto &delta: deltas_) {
+                    indexCommitted(delta);
+                }
+            }
+            numUncommitted_ = 0;
+            uncommittedRids_.reset();
+        }
+
+        // aka. rollback
+        void rollback() {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            deltas_.erase(deltas_.end() - numUncommitted_, deltas_.end());
+            numUncommitted_ = 0;
+            uncommittedRids_.reset();
+        }
+
+        // merge changes committed up to baseVersionId into the sorted edge classes and return the number of
+        // changes left, only the part of an edge class from its first changed edge onwards is rebuilt,
+        // which is just the changes themselves when new edges are appended
+        size_t clear(TxnId baseVersionId) {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            auto last = deltas_.begin();
+            while (last != deltas_.end() && last->isCommitted && last->versionId <= baseVersionId) {
+                ++last;
+            }
+            if (last == deltas_.begin()) {
+                return deltas_.size();
+            }
+            // the last change of an edge decides whether it stays
+            auto changes = std::vector<std::pair<RecordId, bool>>{};
+            changes.reserve(static_cast<size_t>(std::distance(deltas_.begin(), last)));
+            for (auto iter = deltas_.begin(); iter != last; ++iter) {
+                changes.emplace_back(iter->rid, iter->isInsert);
+            }
+            std::stable_sort(changes.begin(), changes.end(),
+                             [](const std::pair<RecordId, bool> &lhs, const std::pair<RecordId, bool> &rhs) {
+                                 return lhs.first < rhs.first;
+                             });
+            auto suffix = std::vector<PositionId>{};
+            for (auto change = changes.cbegin(); change != changes.cend();) {
+                auto const classId = change->first.first;
+                auto &positionIds = getEdgeClass(classId).positionIds;
+                auto const first = std::lower_bound(positionIds.cbegin(), positionIds.cend(), change->first.second);
+                suffix.clear();
+                auto position = first;
+                for (; change != changes.cend() && change->first.first == classId; ++change) {
+                    auto next = std::next(change);
+                    if (next != changes.cend() && next->first == change->first) {
+                        continue;
+                    }
+                    auto const positionId = change->first.second;
+                    auto bound = std::lower_bound(position, positionIds.cend(), positionId);
+                    suffix.insert(suffix.end(), position, bound);
+                    position = bound;
+                    if (position != positionIds.cend() && *position == positionId) {
+                        ++position;
+                    }
+                    if (change->second) {
+                        suffix.push_back(positionId);
+                    }
+                }
+                suffix.insert(suffix.end(), position, positionIds.cend());
+                positionIds.erase(positionIds.begin() + (first - positionIds.cbegin()), positionIds.end());
+                positionIds.insert(positionIds.end(), suffix.cbegin(), suffix.cend());
+            }
+            if (committedRids_ != nullptr) {
+                for (auto iter = deltas_.cbegin(); iter != last; ++iter) {
+                    unindexCommitted(*iter);
+                }
+            }
+            deltas_.erase(deltas_.begin(), last);
+            if (deltas_.size() == numUncommitted_) {
+                committedRids_.reset();
+            }
+            removeEmptyEdgeClasses();
+            return deltas_.size();
+        }
+
+        // drop an edge regardless of its versions, e.g. when it is evicted from a cache
+        void evict(const RecordId &rid) {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            deltas_.erase(std::remove_if(deltas_.begin(), deltas_.end(),
+                                         [&rid](const Delta &delta) { return delta.rid == rid; }),
+                          deltas_.end());
+            numUncommitted_ = static_cast<size_t>(std::count_if(deltas_.cbegin(), deltas_.cend(),
+                                                                [](const Delta &delta) { return !delta.isCommitted; }));
+            if (uncommittedRids_ != nullptr) {
+                uncommittedRids_->erase(rid);
+            }
+            if (committedRids_ != nullptr) {
+                committedRids_->erase(rid);
+            }
+            auto &positionIds = getEdgeClass(rid.first).positionIds;
+            auto position = std::lower_bound(positionIds.begin(), positionIds.end(), rid.second);
+            if (position != positionIds.end() && *position == rid.second) {
+                positionIds.erase(position);
+            }
+            removeEmptyEdgeClasses();
+        }
+
+        // whether an edge is seen by a reader of versionId
+        bool contains(const RecordId &rid, TxnId versionId) const {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_);
+            auto result = isInBase(rid);
+            for (const auto &delta: deltas_) {
+                if (delta.rid == rid && delta.isCommitted && delta.versionId <= versionId) {
+                    result = delta.isInsert;
+                }
+            }
+            return result;
+        }
+
+        // the vertex which an edge has been moved from by the latest commit after sinceVersionId and before
+        // untilVersionId which inserted the edge, along with the version of that commit, or an empty record id
+        // if the edge has been created by that commit, or a version of 0 if there is no such commit
+        std::pair<RecordId, TxnId> findOrigin(const RecordId &rid, TxnId sinceVersionId, TxnId untilVersionId) const {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_);
+            for (auto delta = deltas_.crbegin(); delta != deltas_.crend(); ++delta) {
+                if (delta->rid == rid && delta->isCommitted && delta->isInsert &&
+                    delta->versionId > sinceVersionId && delta->versionId < untilVersionId) {
+                    return std::make_pair(delta->from, delta->versionId);
+                }
+            }
+            return std::make_pair(RecordId{}, TxnId{0});
+        }
+
+        bool empty() const {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_);
+            return edgeClasses_.empty() && deltas_.empty();
+        }
+
+        // edges of a given class (or all edges if classId is 0) as seen by the writer
+        std::vector<RecordId> getLatestEdges(const ClassId &classId = 0) const {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_);
+            return getEdges(classId, [](const Delta &) { return true; });
+        }
+
+        // edges of a given class (or all edges if classId is 0) as seen by a reader of versionId
+        std::vector<RecordId> getStableEdges(TxnId versionId, const ClassId &classId = 0) const {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_);
+            return getEdges(classId, [versionId](const Delta &delta) {
+                return delta.isCommitted && delta.versionId <= versionId;
+            });
+        }
+
+        // edges found in the latest version of the adjacency, including ones which are already deleted
+        std::vector<RecordId> getAllEdges() const {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_);
+            auto result = std::vector<RecordId>{};
+            for (const auto &edgeClass: edgeClasses_) {
+                for (const auto &positionId: edgeClass.positionIds) {
+                    result.emplace_back(edgeClass.classId, positionId);
+                }
+            }
+            for (const auto &delta: deltas_) {
+                result.emplace_back(delta.rid);
+            }
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+            return result;
+        }
+
+    private:
+        struct EdgeClass {
+            ClassId classId;
+            std::vector<PositionId> positionIds;
+        };
+
+        struct Delta {
+            RecordId rid;
+            TxnId versionId;
+            bool isInsert;
+            bool isCommitted;
+            RecordId from;  // of an inserted edge, the vertex it has been moved from
+        };
+
+        struct CommittedState {
+            size_t numDeltas;
+            bool isInsert;  // of the last committed delta
+        };
+
+        struct Change {
+            RecordId rid;
+            size_t order;   // of the first visible delta of an edge
+            bool isInsert;  // of the last visible delta of an edge
+        };
+
+        mutable RWSpinLock spinlock_{};
+        std::vector<EdgeClass> edgeClasses_{};
+        std::vector<Delta> deltas_{};
+        size_t numUncommitted_{0};      // uncommitted deltas are always at the end of deltas_
+        std::unique_ptr<std::unordered_set<RecordId, boost::hash<RecordId>>> uncommittedRids_{};
+        std::unique_ptr<std::unordered_map<RecordId, CommittedState, boost::hash<RecordId>>> committedRids_{};
+
+        EdgeClass &getEdgeClass(const ClassId &classId) {
+            auto iter = std::lower_bound(edgeClasses_.begin(), edgeClasses_.end(), classId,
+                                         [](const EdgeClass &edgeClass, const ClassId &id) {
+                                             return edgeClass.classId < id;
+                                         });
+            if (iter == edgeClasses_.end() || iter->classId != classId) {
+                iter = edgeClasses_.insert(iter, EdgeClass{classId, {}});
+            }
+            return *iter;
+        }
+
+        void removeEmptyEdgeClasses() {
+            edgeClasses_.erase(std::remove_if(edgeClasses_.begin(), edgeClasses_.end(),
+                                              [](const EdgeClass &edgeClass) {
+                                                  return edgeClass.positionIds.empty();
+                                              }),
+                               edgeClasses_.end());
+        }
+
+        bool isInBase(const RecordId &rid) const {
+            for (const auto &edgeClass: edgeClasses_) {
+                if (edgeClass.classId == rid.first) {
+                    return std::binary_search(edgeClass.positionIds.cbegin(), edgeClass.positionIds.cend(),
+                                              rid.second);
+                }
+            }
+            return false;
+        }
+
+        void indexCommitted(const Delta &delta) {
+            auto &state = (*committedRids_)[delta.rid];
+            ++state.numDeltas;
+            state.isInsert = delta.isInsert;
+        }
+
+        // deltas are unindexed from the oldest, so the last committed delta of an edge stays in its state
+        void unindexCommitted(const Delta &delta) {
+            auto state = committedRids_->find(delta.rid);
+            if (state != committedRids_->end() && --state->second.numDeltas == 0) {
+                committedRids_->erase(state);
+            }
+        }
+
+        // only one writer at a time, so an edge has at most one uncommitted delta
+        std::vector<Delta>::iterator findUncommitted(const RecordId &rid) {
+            if (uncommittedRids_ != nullptr && uncommittedRids_->find(rid) == uncommittedRids_->cend()) {
+                return deltas_.end();
+            }
+            return std::find_if(deltas_.end() - numUncommitted_, deltas_.end(),
+                                [&rid](const Delta &delta) { return delta.rid == rid; });
+        }
+
+        bool update(const RecordId &rid, bool isInsert, const RecordId &from) {
+            RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            // the committed state of an edge is decided by its last committed delta, if any
+            auto isCommittedInsert = isInBase(rid);
+            if (committedRids_ != nullptr) {
+                auto state = committedRids_->find(rid);
+                if (state != committedRids_->cend()) {
+                    isCommittedInsert = state->second.isInsert;
+                }
+            } else {
+                for (auto delta = deltas_.crbegin() + numUncommitted_; delta != deltas_.crend(); ++delta) {
+                    if (delta->rid == rid) {
+                        isCommittedInsert = delta->isInsert;
+                        break;
+                    }
+                }
+            }
+            auto isLatestInsert = isCommittedInsert;
+            auto iter = findUncommitted(rid);
+            if (iter != deltas_.end()) {
+                isLatestInsert = iter->isInsert;
+                deltas_.erase(iter);
+                --numUncommitted_;
+                if (uncommittedRids_ != nullptr) {
+                    uncommittedRids_->erase(rid);
+                }
+            }
+            if (isCommittedInsert != isInsert) {
+                deltas_.push_back(Delta{rid, TxnId{0}, isInsert, false, from});
+                ++numUncommitted_;
+                if (uncommittedRids_ != nullptr) {
+                    uncommittedRids_->insert(rid);
+                } else if (numUncommitted_ > ADJACENCY_DELTA_INDEX_THRESHOLD) {
+                    uncommittedRids_.reset(new std::unordered_set<RecordId, boost::hash<RecordId>>{});
+                    for (auto delta = deltas_.cend() - numUncommitted_; delta != deltas_.cend(); ++delta) {
+                        uncommittedRids_->insert(delta->rid);
+                    }
+                }
+            }
+            return isLatestInsert != isInsert;
+        }
+
+        template<typename IsVisible>
+        std::vector<RecordId> getEdges(const ClassId &classId, IsVisible isVisible) const {
+            auto result = std::vector<RecordId>{};
+            // the last visible delta of an edge overrides the sorted edge classes, changes are sorted by edge
+            // so that they can be merged with the sorted position ids in one pass
+            auto changes = std::vector<Change>{};
+            for (auto delta = deltas_.cbegin(); delta != deltas_.cend(); ++delta) {
+                if ((classId == 0 || delta->rid.first == classId) && isVisible(*delta)) {
+                    changes.push_back(Change{delta->rid, static_cast<size_t>(delta - deltas_.cbegin()),
+                                             delta->isInsert});
+                }
+            }
+            std::stable_sort(changes.begin(), changes.end(), [](const Change &lhs, const Change &rhs) {
+                return lhs.rid < rhs.rid;
+            });
+            auto last = changes.begin();
+            for (auto change = changes.cbegin(); change != changes.cend(); ++change) {
+                if (last != changes.begin() && std::prev(last)->rid == change->rid) {
+                    std::prev(last)->isInsert = change->isInsert;
+                } else {
+                    *last++ = *change;
+                }
+            }
+            changes.erase(last, changes.end());
+
+            auto classIds = std::vector<ClassId>{};
+            for (const auto &edgeClass: edgeClasses_) {
+                if (classId == 0 || edgeClass.classId == classId) {
+                    classIds.push_back(edgeClass.classId);
+                }
+            }
+            for (const auto &change: changes) {
+                if (classIds.empty() || classIds.back() != change.rid.first) {
+                    classIds.push_back(change.rid.first);
+                }
+            }
+            std::sort(classIds.begin(), classIds.end());
+            classIds.erase(std::unique(classIds.begin(), classIds.end()), classIds.end());
+
+            auto insertions = std::vector<const Change *>{};
+            auto classChanges = changes.cbegin();
+            for (const auto &edgeClassId: classIds) {
+                while (classChanges != changes.cend() && classChanges->rid.first < edgeClassId) {
+                    ++classChanges;
+                }
+                auto classChangesEnd = classChanges;
+                while (classChangesEnd != changes.cend() && classChangesEnd->rid.first == edgeClassId) {
+                    ++classChangesEnd;
+                }
+                auto edgeClass = std::lower_bound(edgeClasses_.cbegin(), edgeClasses_.cend(), edgeClassId,
+                                                  [](const EdgeClass &element, const ClassId &id) {
+                                                      return element.classId < id;
+                                                  });
+                auto const isBaseClass = edgeClass != edgeClasses_.cend() && edgeClass->classId == edgeClassId;
+                // the most recent edges of each class come first
+                insertions.clear();
+                for (auto change = classChanges; change != classChangesEnd; ++change) {
+                    if (change->isInsert &&
+                        !(isBaseClass && std::binary_search(edgeClass->positionIds.cbegin(),
+                                                            edgeClass->positionIds.cend(), change->rid.second))) {
+                        insertions.push_back(&*change);
+                    }
+                }
+                std::sort(insertions.begin(), insertions.end(), [](const Change *lhs, const Change *rhs) {
+                    return lhs->order > rhs->order;
+                });
+                for (const auto &insertion: insertions) {
+                    result.push_back(insertion->rid);
+                }
+                if (isBaseClass) {
+                    // both the position ids and the changes are walked backwards, skipping deleted edges
+                    result.reserve(result.size() + edgeClass->positionIds.size());
+                    auto change = classChangesEnd;
+                    for (auto positionId = edgeClass->positionIds.crbegin();
+                         positionId != edgeClass->positionIds.crend();
+                         ++positionId) {
+                        while (change != classChanges && std::prev(change)->rid.second > *positionId) {
+                            --change;
+                        }
+                        if (change != classChanges && std::prev(change)->rid.second == *positionId &&
+                            !std::prev(change)->isInsert) {
+                            continue;
+                        }
+                        result.emplace_back(edgeClassId, *positionId);
+                    }
+                }
+                classChanges = classChangesEnd;
+            }
+            return result;
+        }
+    };
+
+}
+
+#endif
@@ -113,6 +113,7 @@ namespace nogdb {
                                                                                const ClassId &classId),
                                       RecordId (Graph::*vertexFunc)(const BaseTxn &baseTxn, const RecordId &rid),
                                       const PathFilter &pathFilter) {
+        BaseTxn::PinScope pinScope{*txn.txnBase};
         switch (Generic::checkIfRecordExist(txn, recordDescriptor)) {
             case RECORD_NOT_EXIST:
                 throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_VERTEX);
@@ -188,6 +189,7 @@ namespace nogdb {
                         throw err;
                     }
                 }
+                pinScope.keep(result);
                 return result;
         }
     }
@@ -203,6 +205,7 @@ namespace nogdb {
                                                                               const ClassId &classId),
                                      RecordId (Graph::*vertexFunc)(const BaseTxn &baseTxn, const RecordId &rid),
                                      const PathFilter &pathFilter) {
+        BaseTxn::PinScope pinScope{*txn.txnBase};
         switch (Generic::checkIfRecordExist(txn, recordDescriptor)) {
             case RECORD_NOT_EXIST:
                 throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_VERTEX);
@@ -284,6 +287,7 @@ namespace nogdb {
                         throw err;
                     }
                 }
+                pinScope.keep(result);
                 return result;
         }
     }
@@ -294,6 +298,7 @@ namespace nogdb {
                                     const RecordDescriptor &dstVertexRecordDescriptor,
                                     const std::vector<ClassId> &edgeClassIds,
                                     const PathFilter &pathFilter) {
+        BaseTxn::PinScope pinScope{*txn.txnBase};
         auto srcStatus = Generic::checkIfRecordExist(txn, srcVertexRecordDescriptor);
         auto dstStatus = Generic::checkIfRecordExist(txn, dstVertexRecordDescriptor);
         if (srcStatus == RECORD_NOT_EXIST) {
@@ -364,6 +369,7 @@ namespace nogdb {
                     throw err;
                 }
             }
+            pinScope.keep(result);
             return result;
         }
     }
@@ -132,6 +132,7 @@ namespace nogdb {
                                   const std::vector<ClassId> &edgeClassIds,
                                   const PathFilter& pathFilter) {
 
+            BaseTxn::PinScope pinScope{*txn.txnBase};
             auto srcStatus = Generic::checkIfRecordExist(txn, srcVertexRecordDescriptor);
             auto dstStatus = Generic::checkIfRecordExist(txn, dstVertexRecordDescriptor);
 
@@ -219,6 +220,7 @@ namespace nogdb {
                     result[i].depth = i;
                 }
 
+                pinScope.keep(result);
                 return {distance.at(dstId), result};
             }
         }
@@ -234,25 +236,25 @@ namespace nogdb {
             if (classDescriptor == nullptr || classDescriptor->id != rid.first) {
                 classDescriptor = Generic::getClassDescriptor(txn, rid.first, ClassType::UNDEFINED);
                 classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                classDBHandler = dsTxnHandler->openDbi(std::to_string(rid.first), true);
+                classDBHandler = dsTxnHandler->openClassDbi(rid.first);
             }
             auto className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
             auto rawData = classDBHandler.get(rid.second);
-            auto record = Parser::parseRawDataWithBasicInfo(className, rid, rawData, classPropertyInfo);
+            auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, rid, rawData, classPropertyInfo);
             if (pathFilter.isSetVertex() && type == ClassType::VERTEX) {
                 if ((*pathFilter.vertexFilter)(record)) {
-                    return Result{RecordDescriptor{rid}, record};
+                    return Result{RecordDescriptor{rid}, std::move(record)};
                 } else {
                     return Result{};
                 }
             } else if (pathFilter.isSetEdge() && type == ClassType::EDGE) {
                 if ((*pathFilter.edgeFilter)(record)) {
-                    return Result{RecordDescriptor{rid}, record};
+                    return Result{RecordDescriptor{rid}, std::move(record)};
                 } else {
                     return Result{};
                 }
             } else {
-                return Result{RecordDescriptor{rid}, record};
+                return Result{RecordDescriptor{rid}, std::move(record)};
             }
         }
 
@@ -267,26 +269,18 @@ namespace nogdb {
             if (classDescriptor == nullptr || classDescriptor->id != rid.first) {
                 classDescriptor = Generic::getClassDescriptor(txn, rid.first, ClassType::UNDEFINED);
                 classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                classDBHandler = dsTxnHandler->openDbi(std::to_string(rid.first), true);
+                classDBHandler = dsTxnHandler->openClassDbi(rid.first);
             }
-            auto className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
-            auto rawData = classDBHandler.get(rid.second);
-            auto record = Parser::parseRawDataWithBasicInfo(className, rid, rawData, classPropertyInfo);
-            if (pathFilter.isSetVertex() && type == ClassType::VERTEX) {
-                if ((*pathFilter.vertexFilter)(record)) {
-                    return RecordDescriptor{rid};
-                } else {
-                    return RecordDescriptor{};
-                }
-            } else if (pathFilter.isSetEdge() && type == ClassType::EDGE) {
-                if ((*pathFilter.edgeFilter)(record)) {
-                    return RecordDescriptor{rid};
-                } else {
-                    return RecordDescriptor{};
-                }
-            } else {
+            // only a path filter needs the record itself
+            auto filter = (type == ClassType::VERTEX) ? pathFilter.vertexFilter
+                                                      : (type == ClassType::EDGE) ? pathFilter.edgeFilter : nullptr;
+            if (filter == nullptr) {
                 return RecordDescriptor{rid};
             }
+            auto className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
+            auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, rid,
+                                                            RecordView{classDBHandler.get(rid.second)}, classPropertyInfo);
+            return (*filter)(record) ? RecordDescriptor{rid} : RecordDescriptor{};
         }
 
         inline static Record retrieveRecord(const Txn &txn, const RecordDescriptor &descriptor) {
@@ -294,11 +288,11 @@ namespace nogdb {
             auto classDescriptor = Generic::getClassDescriptor(txn, descriptor.rid.first,
                                                                ClassType::UNDEFINED);
             auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-            auto classDBHandler = dsTxnHandler->openDbi(std::to_string(descriptor.rid.first), true);
+            auto classDBHandler = dsTxnHandler->openClassDbi(descriptor.rid.first);
             auto keyValue = classDBHandler.get(descriptor.rid.second);
             auto className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
 
-            return Parser::parseRawDataWithBasicInfo(className, descriptor.rid, keyValue, classPropertyInfo);
+            return Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, descriptor.rid, keyValue, classPropertyInfo);
         }
 
         inline static std::vector<RecordDescriptor>
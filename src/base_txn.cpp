@@ -19,12 +19,14 @@
  *
  */
 
+#include <algorithm>
 #include <iostream> // for debugging
 #include <limits>
 #include <tuple>
 
 #include "shared_lock.hpp"
 #include "base_txn.hpp"
+#include "reclaimer.hpp"
 #include "utils.hpp" // for benchmarking
 
 #include "nogdb_errors.h"
@@ -33,17 +35,12 @@ namespace nogdb {
 
     BaseTxn::BaseTxn(Context &ctx, bool isReadWrite, bool inMemory)
             : dsTxnHandler{nullptr},
+              relation{ctx.dbRelation.get()},
               txnType{(isReadWrite) ? TxnType::READ_WRITE : TxnType::READ_ONLY},
               isWithDataStore{!inMemory} {
         auto envHandler = ctx.envHandler.get();
         if (!isReadWrite) {
-            if (isWithDataStore) {
-                dsTxnHandler = new storage_engine::LMDBTxn(envHandler, storage_engine::lmdb::TXN_RO);
-            }
-            txnId = ctx.dbTxnStat->fetchAddMaxTxnId();
-            // get the recent version that was committed
-            versionId = ctx.dbTxnStat->maxVersionId;
-            ctx.dbTxnStat->addActiveTxnId(txnId, versionId);
+            beginReadOnly(ctx);
         } else {
             if (isWithDataStore) {
                 dsTxnHandler = new storage_engine::LMDBTxn(envHandler, storage_engine::lmdb::TXN_RW);
@@ -71,24 +68,152 @@ namespace nogdb {
         }
     }
 
+    void BaseTxn::beginReadOnly(Context &ctx) {
+        auto begin = [&]() {
+            if (isWithDataStore) {
+                if (dsTxnHandler) {
+                    *dsTxnHandler = storage_engine::LMDBTxn(ctx.envHandler.get(), storage_engine::lmdb::TXN_RO);
+                } else {
+                    dsTxnHandler = new storage_engine::LMDBTxn(ctx.envHandler.get(), storage_engine::lmdb::TXN_RO);
+                }
+            }
+            txnId = ctx.dbTxnStat->fetchAddMaxTxnId();
+            // get the recent version that was committed
+            std::tie(readerSlot, versionId) = ctx.dbTxnStat->addActiveTxnId(txnId);
+        };
+        if (isWithDataStore && ctx.dbRelation->isAdjacencyCached()) {
+            // adjacency loaded on demand must come from a snapshot which matches the version
+            ReadLock<boost::shared_mutex> _(*(ctx.dbWriterMutex));
+            begin();
+        } else {
+            begin();
+        }
+    }
+
+    void BaseTxn::renew(Context &ctx) {
+        require(txnType == TxnType::READ_ONLY && isCompleted);
+        beginReadOnly(ctx);
+        isCompleted = false;
+    }
+
+    std::shared_ptr<BaseTxn> BaseTxnPool::acquire(Context &ctx) {
+        auto txn = std::shared_ptr<BaseTxn>{};
+        {
+            SpinLockGuard<SpinLock> _(lock);
+            if (!txns.empty()) {
+                txn = std::move(txns.back());
+                txns.pop_back();
+            }
+        }
+        if (txn) {
+            txn->renew(ctx);
+            return txn;
+        }
+        return std::make_shared<BaseTxn>(ctx, false);
+    }
+
+    void BaseTxnPool::release(std::shared_ptr<BaseTxn> &&txn) noexcept {
+        SpinLockGuard<SpinLock> _(lock);
+        if (txns.size() < maxSize) {
+            txns.push_back(std::move(txn));
+        }
+    }
+
     void BaseTxn::addUncommittedVertex(const std::shared_ptr<Graph::Vertex> &vertex) {
         if (ucVertices.find(vertex->rid) == ucVertices.cend()) {
             ucVertices.emplace(vertex->rid, vertex);
+            logUndo([this, vertex]() { ucVertices.erase(vertex->rid); });
         }
     }
 
     void BaseTxn::deleteUncommittedVertex(const RecordId &rid) {
-        ucVertices.erase(rid);
+        auto iterator = ucVertices.find(rid);
+        if (iterator != ucVertices.cend()) {
+            if (hasSavepoint()) {
+                auto vertex = iterator->second;
+                logUndo([this, vertex]() { ucVertices.emplace(vertex->rid, vertex); });
+            }
+            ucVertices.erase(iterator);
+        }
     }
 
-    void BaseTxn::addUncommittedEdge(const std::shared_ptr<Graph::Edge> &edge) {
-        if (ucEdges.find(edge->rid) == ucEdges.cend()) {
-            ucEdges.emplace(edge->rid, edge);
+    void BaseTxn::addUncommittedEdge(const RecordId &rid, const Graph::Edge &edge) {
+        auto iterator = ucEdges.find(rid);
+        if (iterator == ucEdges.end()) {
+            ucEdges.emplace(rid, edge);
+            logUndo([this, rid]() { ucEdges.erase(rid); });
+        } else {
+            if (hasSavepoint()) {
+                auto const prevEdge = iterator->second;
+                logUndo([this, rid, prevEdge]() { ucEdges[rid] = prevEdge; });
+            }
+            iterator->second = edge;
         }
     }
 
+    void BaseTxn::addUncommittedEdges(std::vector<std::pair<RecordId, Graph::Edge>> &&edges) {
+        if (hasSavepoint()) {
+            auto rids = std::make_shared<std::vector<RecordId>>();
+            rids->reserve(edges.size());
+            for (const auto &edge: edges) {
+                rids->emplace_back(edge.first);
+            }
+            logUndo([this, rids]() {
+                for (const auto &rid: *rids) {
+                    ucEdges.erase(rid);
+                }
+            });
+        }
+        ucEdges.reserve(ucEdges.size() + edges.size());
+        ucEdges.insert(edges.cbegin(), edges.cend());
+        edges.clear();
+    }
+
     void BaseTxn::deleteUncommittedEdge(const RecordId &rid) {
-        ucEdges.erase(rid);
+        auto iterator = ucEdges.find(rid);
+        if (iterator != ucEdges.cend()) {
+            if (hasSavepoint()) {
+                auto const edge = iterator->second;
+                logUndo([this, rid, edge]() { ucEdges.emplace(rid, edge); });
+            }
+            ucEdges.erase(iterator);
+        }
+    }
+
+    BaseTxn::PinScope::~PinScope() noexcept {
+        txn.pinScope = enclosing;
+        auto isReleased = false;
+        for (const auto vertex: pinnedVertices) {
+            if (keptRids.find(vertex->rid) != keptRids.cend()) {
+                if (enclosing != nullptr) {
+                    enclosing->pinnedVertices.emplace_back(vertex);
+                }
+                continue;
+            }
+            auto pinned = txn.pinnedVertices.find(vertex);
+            if (pinned != txn.pinnedVertices.end()) {
+                --pinned->second->numPins;
+                txn.pinnedVertices.erase(pinned);
+                isReleased = true;
+            }
+        }
+        // bring the cache back within its bound now rather than at the next load
+        if (isReleased && txn.relation != nullptr) {
+            try { txn.relation->evictAdjacency(); } catch (...) {}
+        }
+    }
+
+    void BaseTxn::trackVersionBump(const RecordId &rid, bool isBumped) {
+        auto const isChanged = (isBumped) ? unbumpedVertices.erase(rid) > 0 : unbumpedVertices.insert(rid).second;
+        if (isChanged) {
+            logUndo([this, rid, isBumped]() {
+                if (isBumped) {
+                    unbumpedVertices.insert(rid);
+                } else {
+                    unbumpedVertices.erase(rid);
+                }
+            });
+        }
     }
 
     void BaseTxn::addUncommittedSchema(const std::shared_ptr<Schema::ClassDescriptor> &classPtr) {
@@ -101,18 +226,171 @@ namespace nogdb {
         ucSchema.erase(classId);
     }
 
+    PositionId BaseTxn::allocatePositionId(const ClassId &classId) {
+        return findNextPositionId(classId).second++;
+    }
+
+    PositionId BaseTxn::getNextPositionId(const ClassId &classId) {
+        return findNextPositionId(classId).second;
+    }
+
+    std::pair<PositionId, PositionId> &BaseTxn::findNextPositionId(const ClassId &classId) {
+        auto found = nextPositionIds.find(classId);
+        if (found != nextPositionIds.end()) {
+            return found->second;
+        }
+        // seed from the stored counter, or from the last key if the counter was emptied with the table
+        auto classDBHandler = dsTxnHandler->openClassDbi(classId);
+        auto positionId = PositionId{1};
+        auto dsResult = classDBHandler.get(EM_MAXRECNUM);
+        if (!dsResult.empty) {
+            positionId = dsResult.data.numeric<PositionId>();
+        } else {
+            auto keyValue = dsTxnHandler->openCursor(classDBHandler).getLast();
+            if (!keyValue.empty()) {
+                positionId = std::max(positionId, keyValue.key.data.numeric<PositionId>() + 1);
+            }
+        }
+        return nextPositionIds.emplace(classId, std::make_pair(positionId, positionId)).first->second;
+    }
+
+    void BaseTxn::writePositionIds() {
+        for (const auto &nextPositionId: nextPositionIds) {
+            if (nextPositionId.second.second != nextPositionId.second.first) {
+                dsTxnHandler->openClassDbi(nextPositionId.first).put(EM_MAXRECNUM,
+                                                                     PositionId{nextPositionId.second.second});
+            }
+        }
+        nextPositionIds.clear();
+    }
+
+    size_t BaseTxn::savepoint() {
+        if (isCompleted) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_COMPLETED);
+        }
+        if (txnType != TxnType::READ_WRITE) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_INVALID_MODE);
+        }
+        // a bulk loading session writes through handles of the current nested transaction
+        if (numPendingBulkLoads > 0) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_UNFINISHED_BULK_LOAD);
+        }
+        auto savepoint = Savepoint{undoLog.size(), dbInfo, ucSchema, {}, nextPositionIds};
+        savepoint.schemaCheckpoints.reserve(ucSchema.size());
+        for (const auto &classDescriptor: ucSchema) {
+            auto const &classDescriptorPtr = classDescriptor.second;
+            savepoint.schemaCheckpoints.push_back(SchemaCheckpoint{
+                    classDescriptorPtr,
+                    classDescriptorPtr->getState().second,
+                    classDescriptorPtr->name.getCheckpoint(),
+                    classDescriptorPtr->properties.getCheckpoint(),
+                    classDescriptorPtr->super.getCheckpoint(),
+                    classDescriptorPtr->sub.getCheckpoint()
+            });
+        }
+        if (isWithDataStore) {
+            dsTxnHandler->beginNested();
+        }
+        savepoints.push_back(std::move(savepoint));
+        return savepoints.size();
+    }
+
+    void BaseTxn::rollbackTo(Context &ctx, size_t savepoint) {
+        if (isCompleted) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_COMPLETED);
+        }
+        if (savepoint == 0 || savepoint > savepoints.size()) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_INVALID_SAVEPOINT);
+        }
+        if (numPendingBulkLoads > 0) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_UNFINISHED_BULK_LOAD);
+        }
+        if (isWithDataStore) {
+            dsTxnHandler->rollbackNested(savepoint);
+        }
+        savepoints.resize(savepoint);
+        const auto &target = savepoints.back();
+        // undo changes of the graph in reverse order
+        while (undoLog.size() > target.undoLogSize) {
+            undoLog.back()();
+            undoLog.pop_back();
+        }
+        // classes changed only after the savepoint go back to their committed versions
+        for (const auto &classDescriptor: ucSchema) {
+            auto found = target.ucSchema.find(classDescriptor.first);
+            if (found != target.ucSchema.cend() && found->second == classDescriptor.second) {
+                continue;
+            }
+            auto classDescriptorPtr = classDescriptor.second;
+            if (classDescriptorPtr->getState().second == TxnObject::StatusFlag::UNCOMMITTED_DELETE) {
+                classDescriptorPtr->setStatus(TxnObject::StatusFlag::COMMITTED_CREATE);
+            }
+            classDescriptorPtr->name.disableUnstableVersion();
+            classDescriptorPtr->properties.disableUnstableVersion();
+            classDescriptorPtr->super.disableUnstableVersion();
+            classDescriptorPtr->sub.disableUnstableVersion();
+        }
+        ucSchema = target.ucSchema;
+        for (const auto &checkpoint: target.schemaCheckpoints) {
+            auto const &classDescriptorPtr = checkpoint.classDescriptor;
+            classDescriptorPtr->setStatus(checkpoint.status);
+            classDescriptorPtr->name.restoreCheckpoint(checkpoint.name);
+            classDescriptorPtr->properties.restoreCheckpoint(checkpoint.properties);
+            classDescriptorPtr->super.restoreCheckpoint(checkpoint.super);
+            classDescriptorPtr->sub.restoreCheckpoint(checkpoint.sub);
+        }
+        dbInfo = target.dbInfo;
+        nextPositionIds = target.nextPositionIds;
+        // the savepoint stays valid for the changes made from now on
+        if (isWithDataStore) {
+            try {
+                dsTxnHandler->beginNested();
+            } catch (...) {
+                rollback(ctx);
+                throw;
+            }
+        }
+    }
+
+    void BaseTxn::releaseSavepoint(Context &ctx, size_t savepoint) {
+        if (isCompleted) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_COMPLETED);
+        }
+        if (savepoint == 0 || savepoint > savepoints.size()) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_INVALID_SAVEPOINT);
+        }
+        if (numPendingBulkLoads > 0) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_UNFINISHED_BULK_LOAD);
+        }
+        if (isWithDataStore) {
+            try {
+                dsTxnHandler->commitNested(savepoint);
+            } catch (...) {
+                rollback(ctx);
+                throw;
+            }
+        }
+        savepoints.resize(savepoint - 1);
+        if (savepoints.empty()) {
+            undoLog.clear();
+        }
+    }
+
     bool BaseTxn::commit(Context &ctx) {
         if (!isCompleted) {
             if (txnType == TxnType::READ_WRITE) {
+                if (numPendingBulkLoads > 0) {
+                    throw NOGDB_TXN_ERROR(NOGDB_TXN_UNFINISHED_BULK_LOAD);
+                }
                 // prevent another txn writer to enter a critical section
                 // after datastore has committed
                 WriteLock<boost::shared_mutex> _(*(ctx.dbWriterMutex));
                 if (isWithDataStore) {
+                    writePositionIds();
                     dsTxnHandler->commit();
                     isCommitDatastore = true;
                 }
-                auto oldestTxn = ctx.dbTxnStat->minActiveTxnId();
-                auto currentMinVersion = (oldestTxn.first != 0) ? oldestTxn.second : versionId - 1;
+                auto hasStaleElements = false;
                 // commit changes in database schema
                 if (!ucSchema.empty()) {
                     DeleteQueue<ClassId> tmpDeletedClassId;
@@ -122,12 +400,12 @@ namespace nogdb {
                             if (currentStatus == TxnObject::StatusFlag::UNCOMMITTED_DELETE) {
                                 tmpDeletedClassId.emplace_back(std::make_pair(classDescriptorPtr->id, versionId));
                             } else if (currentStatus == TxnObject::StatusFlag::UNCOMMITTED_CREATE) {
-                                ctx.dbSchema->schemaInfo.lockAndEmplace(classDescriptorPtr->id, classDescriptorPtr);
+                                // a dropped class waiting for reclamation may have the same id
+                                ctx.dbSchema->schemaInfo.lockAndReplace(classDescriptorPtr->id, classDescriptorPtr);
                             } else {
-                                classDescriptorPtr->name.clearStableVersion(currentMinVersion);
-                                classDescriptorPtr->properties.clearStableVersion(currentMinVersion);
-                                classDescriptorPtr->super.clearStableVersion(currentMinVersion);
-                                classDescriptorPtr->sub.clearStableVersion(currentMinVersion);
+                                // the previous versions are dropped in the background once no reader needs them
+                                ctx.dbReclaimer->addStaleVersions(classDescriptorPtr);
+                                hasStaleElements = true;
                             }
                             classDescriptorPtr->updateState(versionId);
                             classDescriptorPtr->name.upgradeStableVersion(versionId);
@@ -137,69 +415,66 @@ namespace nogdb {
                         }
                     }
                     ctx.dbSchema->deletedClassId.push_back(tmpDeletedClassId);
+                    hasStaleElements = hasStaleElements || !tmpDeletedClassId.empty();
                 }
                 // commit changes in database relation
-                if (ucVertices.size() + ucEdges.size() > 0) {
+                if (ucVertices.size() + ucEdges.size() + dirtyVertices.size() > 0) {
                     DeleteQueue<RecordId> tmpDeletedVertices;
                     DeleteQueue<RecordId> tmpDeletedEdges;
+                    // created elements are published with one lock per shard, e.g. after a bulk load
+                    std::vector<std::pair<RecordId, std::shared_ptr<Graph::Vertex>>> createdVertices;
+                    std::vector<std::pair<RecordId, Graph::Edge>> committedEdges;
+                    // adjacencies are committed once per vertex and merged in the background,
+                    // so a commit does not depend on the degrees of the vertices
+                    // NOTE: the versions of an edge are the changes of its endpoints, which are committed
+                    // before the edge itself so that a reader of an older version can always follow it back
+                    for (const auto &vertex: dirtyVertices) {
+                        vertex.second->out.commit(versionId);
+                        vertex.second->in.commit(versionId);
+                        vertex.second->lastModified = versionId;
+                        ctx.dbReclaimer->addDirtyVertex(vertex.second);
+                    }
+                    committedEdges.reserve(ucEdges.size());
+                    for (const auto &edge: ucEdges) {
+                        auto committedEdge = edge.second;
+                        if (committedEdge.status == TxnObject::StatusFlag::UNCOMMITTED_DELETE) {
+                            tmpDeletedEdges.emplace_back(std::make_pair(edge.first, versionId));
+                            committedEdge.status = TxnObject::StatusFlag::COMMITTED_DELETE;
+                        } else {
+                            committedEdge.status = TxnObject::StatusFlag::COMMITTED_CREATE;
+                        }
+                        committedEdge.versionId = versionId;
+                        committedEdges.emplace_back(edge.first, committedEdge);
+                    }
                     for (const auto &vertex: ucVertices) {
                         if (auto vertexPtr = vertex.second) {
                             auto currentStatus = vertexPtr->getState().second;
                             if (currentStatus == TxnObject::StatusFlag::UNCOMMITTED_DELETE) {
                                 tmpDeletedVertices.emplace_back(std::make_pair(vertexPtr->rid, versionId));
                             } else if (currentStatus == TxnObject::StatusFlag::UNCOMMITTED_CREATE) {
-                                ctx.dbRelation->vertices.lockAndEmplace(vertex.first, vertex.second);
+                                createdVertices.emplace_back(vertex.first, vertexPtr);
                             }
                             vertexPtr->updateState(versionId);
+                            vertexPtr->lastModified = versionId;
                         }
                     }
-                    for (const auto &edge: ucEdges) {
-                        if (auto edgePtr = edge.second) {
-                            auto currentStatus = edgePtr->getState().second;
-                            if (currentStatus == TxnObject::StatusFlag::UNCOMMITTED_DELETE) {
-                                tmpDeletedEdges.emplace_back(std::make_pair(edgePtr->rid, versionId));
-                            } else if (currentStatus == TxnObject::StatusFlag::UNCOMMITTED_CREATE) {
-                                ctx.dbRelation->edges.lockAndEmplace(edge.first, edge.second);
-                            } else {
-                                edgePtr->source.clearStableVersion(currentMinVersion);
-                                edgePtr->target.clearStableVersion(currentMinVersion);
-                            }
-
-                            auto srcVertexUnstable = edgePtr->source.getUnstableVersion();
-                            if (auto srcVertexUnstablePtr = srcVertexUnstable.first.lock()) {
-                                srcVertexUnstablePtr->out.clear(currentMinVersion);
-                                if (auto tmp = srcVertexUnstablePtr->out.get(edgePtr->rid.first, edgePtr->rid.second)) {
-                                    tmp->upgradeStableVersion(versionId);
-                                }
-                            }
-                            auto srcVertexStable = edgePtr->source.getStableVersion();
-                            if (auto srcVertexStablePtr = srcVertexStable.first.lock()) {
-                                srcVertexStablePtr->out.clear(currentMinVersion);
-                                if (auto tmp = srcVertexStablePtr->out.get(edgePtr->rid.first, edgePtr->rid.second)) {
-                                    tmp->upgradeStableVersion(versionId);
-                                }
-                            }
-                            auto dstVertexUnstable = edgePtr->target.getUnstableVersion();
-                            if (auto dstVertexUnstablePtr = dstVertexUnstable.first.lock()) {
-                                dstVertexUnstablePtr->in.clear(currentMinVersion);
-                                if (auto tmp = dstVertexUnstablePtr->in.get(edgePtr->rid.first, edgePtr->rid.second)) {
-                                    tmp->upgradeStableVersion(versionId);
-                                }
-                            }
-                            auto dstVertexStable = edgePtr->target.getStableVersion();
-                            if (auto dstVertexStablePtr = dstVertexStable.first.lock()) {
-                                dstVertexStablePtr->in.clear(currentMinVersion);
-                                if (auto tmp = dstVertexStablePtr->in.get(edgePtr->rid.first, edgePtr->rid.second)) {
-                                    tmp->upgradeStableVersion(versionId);
-                                }
-                            }
-                            edgePtr->updateState(versionId);
-                            edgePtr->source.upgradeStableVersion(versionId);
-                            edgePtr->target.upgradeStableVersion(versionId);
-                        }
+                    ctx.dbRelation->vertices.lockAndReplace(createdVertices.cbegin(), createdVertices.cend(),
+                                                            createdVertices.size());
+                    for (const auto &vertex: createdVertices) {
+                        ctx.dbRelation->trackVertex(vertex.second);
                     }
+                    ctx.dbRelation->edges.lockAndReplace(committedEdges.cbegin(), committedEdges.cend(),
+                                                         committedEdges.size());
                     ctx.dbRelation->deletedVertices.push_back(tmpDeletedVertices);
                     ctx.dbRelation->deletedEdges.push_back(tmpDeletedEdges);
+                    hasStaleElements = hasStaleElements || !dirtyVertices.empty() ||
+                                       !tmpDeletedVertices.empty() || !tmpDeletedEdges.empty();
+                }
+                // vertices whose records now carry their latest versions need no lookup in .versions
+                for (const auto &rid: unbumpedVertices) {
+                    if (auto vertexPtr = ctx.dbRelation->vertices.find(rid)) {
+                        vertexPtr->noVersionBumpSince = versionId;
+                    }
                 }
                 if (ucSchema.size() + ucVertices.size() + ucEdges.size() > 0) {
                     {   // save changes in dbInfo
@@ -209,22 +484,22 @@ namespace nogdb {
                 }
                 // allow the next txns to see the latest version and updates
                 ctx.dbTxnStat->fetchAddMaxVersionId();
-                auto minTxn = ctx.dbTxnStat->minActiveTxnId();
-                if (minTxn.first == 0 && minTxn.second == 0) {
-                    ctx.dbSchema->clearDeletedElements(versionId);
-                    ctx.dbRelation->clearDeletedElements(versionId);
+                if (hasStaleElements) {
+                    ctx.dbReclaimer->notify();
                 }
             } else {
-                if (ctx.dbTxnStat->isLastMinVersionId(txnId)) {
-                    ctx.dbSchema->clearDeletedElements(versionId + 1);
-                    ctx.dbRelation->clearDeletedElements(versionId + 1);
-                }
-                ctx.dbTxnStat->removeActiveTxnId(txnId);
+                ctx.dbTxnStat->removeActiveTxnId(readerSlot, txnId);
                 if (isWithDataStore) {
                     dsTxnHandler->rollback();
                 }
             }
             isCompleted = true;
+            releaseVertices();
+            savepoints.clear();
+            undoLog.clear();
+            if (txnType == TxnType::READ_WRITE) {
+                ctx.dbRelation->evictAdjacency();
+            }
             return true;
         }
         return false;
@@ -242,45 +517,10 @@ namespace nogdb {
                         vertexPtr->setStatus(TxnObject::StatusFlag::COMMITTED_CREATE);
                     }
                 }
-                for (const auto &edge: ucEdges) {
-                    auto edgePtr = edge.second;
-                    require(edgePtr != nullptr);
-                    auto state = edgePtr->getState();
-                    auto status = state.second;
-                    if (status == TxnObject::StatusFlag::UNCOMMITTED_DELETE) {
-                        edgePtr->setStatus(TxnObject::StatusFlag::COMMITTED_CREATE);
-                    }
-
-                    auto srcVertexUnstable = edgePtr->source.getUnstableVersion();
-                    if (srcVertexUnstable.second) {
-                        if (auto srcVertexUnstablePtr = srcVertexUnstable.first.lock()) {
-                            // clear only uncommitted version
-                            srcVertexUnstablePtr->out.clear(edgePtr->rid.first, edgePtr->rid.second, 0);
-                        }
-                    }
-                    auto srcVertexStable = edgePtr->source.getStableVersion();
-                    if (srcVertexStable.second) {
-                        if (auto srcVertexStablePtr = srcVertexStable.first.lock()) {
-                            // clear only uncommitted version
-                            srcVertexStablePtr->out.clear(edgePtr->rid.first, edgePtr->rid.second, 0);
-                        }
-                    }
-                    auto dstVertexUnstable = edgePtr->target.getUnstableVersion();
-                    if (dstVertexUnstable.second) {
-                        if (auto dstVertexUnablePtr = dstVertexUnstable.first.lock()) {
-                            // clear only uncommitted version
-                            dstVertexUnablePtr->in.clear(edgePtr->rid.first, edgePtr->rid.second, 0);
-                        }
-                    }
-                    auto dstVertexStable = edgePtr->target.getStableVersion();
-                    if (dstVertexStable.second) {
-                        if (auto dstVertexStablePtr = dstVertexStable.first.lock()) {
-                            // clear only uncommitted version
-                            dstVertexStablePtr->in.clear(edgePtr->rid.first, edgePtr->rid.second, 0);
-                        }
-                    }
-                    edgePtr->source.disableUnstableVersion();
-                    edgePtr->target.disableUnstableVersion();
+                for (const auto &vertex: dirtyVertices) {
+                    // clear only uncommitted version
+                    vertex.second->out.rollback();
+                    vertex.second->in.rollback();
                 }
                 for (const auto &classDescriptor: ucSchema) {
                     auto classDescriptorPtr = classDescriptor.second;
@@ -296,16 +536,15 @@ namespace nogdb {
                     classDescriptorPtr->sub.disableUnstableVersion();
                 }
             } else {
-                if (ctx.dbTxnStat->isLastMinVersionId(txnId)) {
-                    ctx.dbRelation->clearDeletedElements(versionId + 1);
-                    ctx.dbSchema->clearDeletedElements(versionId + 1);
-                }
-                ctx.dbTxnStat->removeActiveTxnId(txnId);
+                ctx.dbTxnStat->removeActiveTxnId(readerSlot, txnId);
             }
             if (isWithDataStore && !isCommitDatastore) {
                 dsTxnHandler->rollback();
             }
             isCompleted = true;
+            releaseVertices();
+            savepoints.clear();
+            undoLog.clear();
             return true;
         }
         return false;
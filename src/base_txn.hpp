@@ -23,6 +23,11 @@
 #define __BASE_TXN_HPP_INCLUDED_
 
 #include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "storage_engine.hpp"
 #include "lmdb_engine.hpp"
@@ -48,6 +53,7 @@ namespace nogdb {
         BaseTxn(Context &ctx, bool isReadWrite, bool inMemory = false);
 
         ~BaseTxn() noexcept {
+            releaseVertices();
             if (isWithDataStore && !isCompleted) {
                 dsTxnHandler->rollback();
             }
@@ -63,6 +69,8 @@ namespace nogdb {
 
         storage_engine::LMDBTxn *getDsTxnHandler() const { return dsTxnHandler; }
 
+        Graph *getRelation() const { return relation; }
+
         const TxnId &getVersionId() const { return versionId; }
 
         TxnType getType() const { return txnType; }
@@ -71,12 +79,21 @@ namespace nogdb {
 
         void addUncommittedVertex(const std::shared_ptr<Graph::Vertex> &vertex);
 
-        void addUncommittedEdge(const std::shared_ptr<Graph::Edge> &edge);
+        // the latest version of an edge changed by the writer, which replaces the previous one
+        void addUncommittedEdge(const RecordId &rid, const Graph::Edge &edge);
+
+        // edges created as a whole, e.g. by a bulk loader, with a single entry in the undo log
+        void addUncommittedEdges(std::vector<std::pair<RecordId, Graph::Edge>> &&edges);
 
         void deleteUncommittedVertex(const RecordId &rid);
 
         void deleteUncommittedEdge(const RecordId &rid);
 
+        // a vertex whose adjacency has got uncommitted changes, which are committed or rolled back with the writer
+        void addDirtyVertex(const std::shared_ptr<Graph::Vertex> &vertex) {
+            dirtyVertices.emplace(vertex.get(), vertex);
+        }
+
         void addUncommittedSchema(const std::shared_ptr<Schema::ClassDescriptor> &classPtr);
 
         void deleteUncommittedSchema(const ClassId &classId);
@@ -85,16 +102,99 @@ namespace nogdb {
 
         bool rollback(Context &ctx) noexcept;
 
+        // begin a completed read-only transaction again, reusing its storage transaction handle
+        void renew(Context &ctx);
+
+        // mark the changes made so far and return the depth of the savepoint, the changes made after it
+        // are kept in a nested transaction of the datastore
+        size_t savepoint();
+
+        // undo the changes made after a savepoint, which stays valid while the inner savepoints are dropped
+        // NOTE: the whole transaction is rolled back if the datastore fails to begin the savepoint again
+        void rollbackTo(Context &ctx, size_t savepoint);
+
+        // keep the changes made after a savepoint as a part of the enclosing one
+        // NOTE: the whole transaction is rolled back if the datastore fails to merge the changes
+        void releaseSavepoint(Context &ctx, size_t savepoint);
+
+        bool hasSavepoint() const { return !savepoints.empty(); }
+
+        // record how to undo an in-memory change of the graph made after a savepoint
+        template<typename Undo>
+        void logUndo(Undo &&undo) {
+            if (!savepoints.empty()) {
+                undoLog.emplace_back(std::forward<Undo>(undo));
+            }
+        }
+
+        // hand out the position of a new record of a class, the counter is kept in memory and written back
+        // to the datastore only once at commit
+        PositionId allocatePositionId(const ClassId &classId);
+
+        // the position which the next record of a class will take, without allocating it
+        PositionId getNextPositionId(const ClassId &classId);
+
+        // forget the counter of a class whose table has been dropped
+        void dropPositionId(const ClassId &classId) { nextPositionIds.erase(classId); }
+
+        // a bulk loading session which has written records keeps the transaction from committing until it finishes
+        void addPendingBulkLoad() { ++numPendingBulkLoads; }
+
+        void removePendingBulkLoad() { --numPendingBulkLoads; }
+
+        // a version bump of a vertex has been written or removed, a vertex whose bump has been removed
+        // is known to have none from the version of the transaction once it commits
+        void trackVersionBump(const RecordId &rid, bool isBumped);
+
         bool isNotCompleted() const { return !isCompleted; }
 
+        // keep a vertex of a bounded adjacency cache from being evicted until the transaction completes,
+        // or until the innermost pin scope closes
+        void pinVertex(const std::shared_ptr<Graph::Vertex> &vertex) const {
+            if (pinnedVertices.emplace(vertex.get(), vertex).second) {
+                ++vertex->numPins;
+                if (pinScope != nullptr) {
+                    pinScope->pinnedVertices.emplace_back(vertex.get());
+                }
+            }
+        }
+
+        // Releases the pins taken while a graph traversal runs once it returns, except for the vertices
+        // it hands back, so that a traversal over more vertices than the adjacency cache holds leaves
+        // the cache within its bound. Vertices pinned before the scope opened stay pinned.
+        class PinScope {
+        public:
+            explicit PinScope(const BaseTxn &txn_) : txn{txn_}, enclosing{txn_.pinScope} { txn.pinScope = this; }
+
+            ~PinScope() noexcept;
+
+            PinScope(const PinScope &) = delete;
+
+            PinScope &operator=(const PinScope &) = delete;
+
+            void keep(const std::vector<RecordDescriptor> &recordDescriptors) {
+                for (const auto &recordDescriptor: recordDescriptors) {
+                    keptRids.insert(recordDescriptor.rid);
+                }
+            }
+
+        private:
+            friend class BaseTxn;
+
+            const BaseTxn &txn;
+            PinScope *enclosing;
+            std::vector<const Graph::Vertex *> pinnedVertices{};
+            std::unordered_set<RecordId, Graph::RecordIdHash> keptRids{};
+        };
+
         std::shared_ptr<Graph::Vertex> findUncommittedVertex(const RecordId &rid) const {
             auto iterator = ucVertices.find(rid);
             return (iterator == ucVertices.cend()) ? nullptr : iterator->second;
         }
 
-        std::shared_ptr<Graph::Edge> findUncommittedEdge(const RecordId &rid) const {
+        const Graph::Edge *findUncommittedEdge(const RecordId &rid) const {
             auto iterator = ucEdges.find(rid);
-            return (iterator == ucEdges.cend()) ? nullptr : iterator->second;
+            return (iterator == ucEdges.cend()) ? nullptr : &iterator->second;
         }
 
         const Schema::SchemaElements<ClassId, Schema::ClassDescriptor> &findUncommittedSchema() const {
@@ -119,18 +219,83 @@ namespace nogdb {
         DBInfo dbInfo{};
 
     private:
+        // changes of the graph may be many, so they are undone from a log, while the schema is small enough
+        // to be checkpointed as a whole
+        struct SchemaCheckpoint {
+            Schema::ClassDescriptorPtr classDescriptor;
+            TxnObject::StatusFlag status;
+            VersionControl<std::string>::Checkpoint name;
+            VersionControl<Schema::ClassProperty>::Checkpoint properties;
+            VersionControl<std::weak_ptr<Schema::ClassDescriptor>>::Checkpoint super;
+            VersionControl<std::vector<std::weak_ptr<Schema::ClassDescriptor>>>::Checkpoint sub;
+        };
+
+        struct Savepoint {
+            size_t undoLogSize;
+            DBInfo dbInfo;
+            Schema::SchemaElements<ClassId, Schema::ClassDescriptor> ucSchema;
+            std::vector<SchemaCheckpoint> schemaCheckpoints;
+            std::unordered_map<ClassId, std::pair<PositionId, PositionId>> nextPositionIds;
+        };
+
         storage_engine::LMDBTxn *dsTxnHandler{nullptr};
+        Graph *relation{nullptr};
         TxnId txnId;
         TxnId versionId;
+        size_t readerSlot{0};
         TxnType txnType;
         Schema::SchemaElements<ClassId, Schema::ClassDescriptor> ucSchema;
         Graph::GraphElements<Graph::Vertex> ucVertices;
-        Graph::GraphElements<Graph::Edge> ucEdges;
+        std::unordered_map<RecordId, Graph::Edge, Graph::RecordIdHash> ucEdges;
+        std::unordered_map<const Graph::Vertex *, std::shared_ptr<Graph::Vertex>> dirtyVertices;
+        mutable std::unordered_map<const Graph::Vertex *, std::shared_ptr<Graph::Vertex>> pinnedVertices;
+        mutable PinScope *pinScope{nullptr};
+        std::vector<Savepoint> savepoints{};
+        std::vector<std::function<void()>> undoLog{};
+        // the first and the next positions of the classes which have been written to
+        std::unordered_map<ClassId, std::pair<PositionId, PositionId>> nextPositionIds{};
+        size_t numPendingBulkLoads{0};
+        std::unordered_set<RecordId, Graph::RecordIdHash> unbumpedVertices{};
 
         bool isWithDataStore;
         bool isCompleted{false}; // throw error if working with isCompleted = true
         bool isCommitDatastore{false};
 
+        void beginReadOnly(Context &ctx);
+
+        std::pair<PositionId, PositionId> &findNextPositionId(const ClassId &classId);
+
+        void writePositionIds();
+
+        void releaseVertices() noexcept {
+            for (const auto &vertex: pinnedVertices) {
+                --vertex.second->numPins;
+            }
+            pinnedVertices.clear();
+        }
+    };
+
+    // Keeps completed read-only transactions for reuse, so that beginning one does not allocate.
+    class BaseTxnPool {
+    public:
+        explicit BaseTxnPool(unsigned int maxSize_)
+                : maxSize{maxSize_} {
+            txns.reserve(maxSize);
+        }
+
+        BaseTxnPool(const BaseTxnPool &) = delete;
+
+        BaseTxnPool &operator=(const BaseTxnPool &) = delete;
+
+        std::shared_ptr<BaseTxn> acquire(Context &ctx);
+
+        // takes a completed read-only transaction which is not shared anymore
+        void release(std::shared_ptr<BaseTxn> &&txn) noexcept;
+
+    private:
+        const unsigned int maxSize;
+        SpinLock lock{};
+        std::vector<std::shared_ptr<BaseTxn>> txns{};
     };
 
 }
@@ -0,0 +1,279 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+
+#include "schema.hpp"
+#include "constant.hpp"
+#include "lmdb_engine.hpp"
+#include "storage_engine.hpp"
+#include "base_txn.hpp"
+#include "graph.hpp"
+#include "parser.hpp"
+#include "index.hpp"
+#include "generic.hpp"
+#include "validate.hpp"
+
+#include "nogdb.h"
+
+namespace nogdb {
+
+    namespace {
+
+        bool lessIndexKey(PropertyType type, const Bytes &lhs, const Bytes &rhs) {
+            switch (type) {
+                case PropertyType::UNSIGNED_TINYINT:
+                    return lhs.toTinyIntU() < rhs.toTinyIntU();
+                case PropertyType::UNSIGNED_SMALLINT:
+                    return lhs.toSmallIntU() < rhs.toSmallIntU();
+                case PropertyType::UNSIGNED_INTEGER:
+                    return lhs.toIntU() < rhs.toIntU();
+                case PropertyType::UNSIGNED_BIGINT:
+                    return lhs.toBigIntU() < rhs.toBigIntU();
+                case PropertyType::TINYINT:
+                    return lhs.toTinyInt() < rhs.toTinyInt();
+                case PropertyType::SMALLINT:
+                    return lhs.toSmallInt() < rhs.toSmallInt();
+                case PropertyType::INTEGER:
+                    return lhs.toInt() < rhs.toInt();
+                case PropertyType::BIGINT:
+                    return lhs.toBigInt() < rhs.toBigInt();
+                case PropertyType::REAL:
+                    return lhs.toReal() < rhs.toReal();
+                case PropertyType::TEXT:
+                    return lhs.toText() < rhs.toText();
+                default:
+                    return false;
+            }
+        }
+
+    }
+
+    struct BulkLoader::BulkState {
+        struct ClassState {
+            Schema::ClassDescriptorPtr classDescriptor;
+            ClassPropertyInfo classInfo;
+            storage_engine::lmdb::Dbi classDBHandler;
+            PositionId firstPositionId;
+            PositionId nextPositionId;
+        };
+
+        struct IndexState {
+            PropertyType type;
+            bool isUnique;
+            std::vector<std::pair<Bytes, PositionId>> entries;
+        };
+
+        std::unordered_map<ClassId, ClassState> classIdToState{};
+        std::unordered_map<std::string, ClassState *> classNameToState{};
+        std::map<IndexId, IndexState> indexes{};
+        std::vector<std::tuple<RecordId, RecordId, RecordId>> edges{};
+        bool isFinished{false};
+        bool isPending{false};
+
+        ClassState &registerClass(BaseTxn &baseTxn, const Schema::ClassDescriptorPtr &classDescriptor) {
+            auto dsTxnHandler = baseTxn.getDsTxnHandler();
+            auto classState = ClassState{};
+            classState.classDescriptor = classDescriptor;
+            classState.classInfo = Generic::getClassMapProperty(baseTxn, classDescriptor);
+            classState.classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
+            classState.firstPositionId = baseTxn.getNextPositionId(classDescriptor->id);
+            classState.nextPositionId = classState.firstPositionId;
+            auto &result = classIdToState[classDescriptor->id];
+            result = std::move(classState);
+            return result;
+        }
+
+        ClassState &getClassState(const Txn &txn, BaseTxn &baseTxn, const std::string &className, ClassType type) {
+            auto found = classNameToState.find(className);
+            if (found != classNameToState.end()) {
+                if (found->second->classDescriptor->type != type) {
+                    throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_MISMATCH_CLASSTYPE);
+                }
+                return *found->second;
+            }
+            auto classDescriptor = Generic::getClassDescriptor(txn, className, type);
+            auto foundClass = classIdToState.find(classDescriptor->id);
+            auto &result = (foundClass != classIdToState.end()) ? foundClass->second
+                                                                : registerClass(baseTxn, classDescriptor);
+            classNameToState.emplace(className, &result);
+            return result;
+        }
+
+        ClassState &getClassState(const Txn &txn, BaseTxn &baseTxn, const ClassId &classId, ClassType type) {
+            auto found = classIdToState.find(classId);
+            if (found != classIdToState.end()) {
+                if (found->second.classDescriptor->type != type) {
+                    throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_MISMATCH_CLASSTYPE);
+                }
+                return found->second;
+            }
+            return registerClass(baseTxn, Generic::getClassDescriptor(txn, classId, type));
+        }
+
+        bool isAddedRecord(const ClassState &classState, const PositionId &positionId) const {
+            return positionId >= classState.firstPositionId && positionId < classState.nextPositionId;
+        }
+
+        bool isAddedRecord(const RecordId &rid) const {
+            auto found = classIdToState.find(rid.first);
+            return found != classIdToState.cend() && isAddedRecord(found->second, rid.second);
+        }
+
+        bool isExistingRecord(const ClassState &classState, const PositionId &positionId) const {
+            // records added by this session are known without touching the storage
+            if (isAddedRecord(classState, positionId)) {
+                return true;
+            }
+            return !classState.classDBHandler.get(positionId).data.empty();
+        }
+
+        PositionId appendRecord(BaseTxn &baseTxn, ClassState &classState, const Record &record, TxnId versionId) {
+            if (!isPending) {
+                baseTxn.addPendingBulkLoad();
+                isPending = true;
+            }
+            record.setBasicInfo(TXN_VERSION, versionId);
+            record.setBasicInfo(VERSION_PROPERTY, 1ULL);
+            auto indexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
+            auto value = Parser::parseRecord(baseTxn, classState.classDescriptor->id, classState.classInfo, record,
+                                             indexInfos);
+            auto const positionId = baseTxn.allocatePositionId(classState.classDescriptor->id);
+            classState.classDBHandler.put(positionId, value, true);
+            classState.nextPositionId = positionId + 1;
+
+            // defer index population until finish
+            for (const auto &indexInfo: indexInfos) {
+                auto bytesValue = record.get(indexInfo.first);
+                if (bytesValue.empty()) {
+                    continue;
+                }
+                auto const indexId = std::get<1>(indexInfo.second);
+                auto found = indexes.find(indexId);
+                if (found == indexes.end()) {
+                    found = indexes.emplace(
+                            indexId,
+                            IndexState{std::get<0>(indexInfo.second), std::get<2>(indexInfo.second), {}}
+                    ).first;
+                }
+                found->second.entries.emplace_back(bytesValue, positionId);
+            }
+            return positionId;
+        }
+    };
+
+    BulkLoader::BulkLoader(Txn &txn_)
+            : txn{txn_}, state{new BulkState{}} {
+        Validate::isTransactionValid(txn);
+    }
+
+    BulkLoader::~BulkLoader() noexcept = default;
+
+    const RecordDescriptor BulkLoader::addVertex(const std::string &className, const Record &record) {
+        Validate::isTransactionValid(txn);
+        if (state->isFinished) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_COMPLETED);
+        }
+        auto &classState = state->getClassState(txn, *txn.txnBase, className, ClassType::VERTEX);
+        auto const positionId = state->appendRecord(*txn.txnBase, classState, record, txn.getVersionId());
+        return RecordDescriptor{classState.classDescriptor->id, positionId};
+    }
+
+    const RecordDescriptor BulkLoader::addEdge(const std::string &className,
+                                               const RecordDescriptor &srcVertexRecordDescriptor,
+                                               const RecordDescriptor &dstVertexRecordDescriptor,
+                                               const Record &record) {
+        Validate::isTransactionValid(txn);
+        if (state->isFinished) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_COMPLETED);
+        }
+        auto &classState = state->getClassState(txn, *txn.txnBase, className, ClassType::EDGE);
+        auto &srcClassState = state->getClassState(txn, *txn.txnBase, srcVertexRecordDescriptor.rid.first,
+                                                   ClassType::VERTEX);
+        if (!state->isExistingRecord(srcClassState, srcVertexRecordDescriptor.rid.second)) {
+            throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_SRC);
+        }
+        auto &dstClassState = state->getClassState(txn, *txn.txnBase, dstVertexRecordDescriptor.rid.first,
+                                                   ClassType::VERTEX);
+        if (!state->isExistingRecord(dstClassState, dstVertexRecordDescriptor.rid.second)) {
+            throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_DST);
+        }
+        auto const positionId = state->appendRecord(*txn.txnBase, classState, record, txn.getVersionId());
+        auto const rid = RecordId{classState.classDescriptor->id, positionId};
+        state->edges.emplace_back(rid, srcVertexRecordDescriptor.rid, dstVertexRecordDescriptor.rid);
+        return RecordDescriptor{rid};
+    }
+
+    void BulkLoader::finish() {
+        Validate::isTransactionValid(txn);
+        if (state->isFinished) {
+            throw NOGDB_TXN_ERROR(NOGDB_TXN_COMPLETED);
+        }
+        state->isFinished = true;
+        auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+
+        // write relations in key order
+        auto relations = std::vector<std::pair<RecordId, size_t>>{};
+        relations.reserve(state->edges.size());
+        for (size_t i = 0; i < state->edges.size(); ++i) {
+            relations.emplace_back(std::get<0>(state->edges[i]), i);
+        }
+        std::sort(relations.begin(), relations.end());
+        auto relationDBHandler = dsTxnHandler->openDbi(TB_RELATIONS);
+        for (const auto &relation: relations) {
+            auto const &srcRid = std::get<1>(state->edges[relation.second]);
+            auto const &dstRid = std::get<2>(state->edges[relation.second]);
+            auto edgeRecord = Blob((sizeof(ClassId) + sizeof(PositionId)) * 2);
+            edgeRecord.append(&srcRid.first, sizeof(ClassId));
+            edgeRecord.append(&srcRid.second, sizeof(PositionId));
+            edgeRecord.append(&dstRid.first, sizeof(ClassId));
+            edgeRecord.append(&dstRid.second, sizeof(PositionId));
+            relationDBHandler.put(rid2key(relation.first), edgeRecord);
+        }
+
+        // build each index from its entries sorted by key
+        for (auto &index: state->indexes) {
+            auto &indexState = index.second;
+            auto const type = indexState.type;
+            std::stable_sort(indexState.entries.begin(), indexState.entries.end(),
+                             [type](const std::pair<Bytes, PositionId> &lhs, const std::pair<Bytes, PositionId> &rhs) {
+                                 return lessIndexKey(type, lhs.first, rhs.first);
+                             });
+            for (const auto &entry: indexState.entries) {
+                Index::addIndex(*txn.txnBase, index.first, entry.second, entry.first, type, indexState.isUnique);
+            }
+        }
+
+        // update in-memory relations, the adjacency of vertices added by this session is built as a whole
+        auto const &bulkState = *state;
+        txn.txnCtx.dbRelation->createEdges(*txn.txnBase, state->edges, [&bulkState](const RecordId &rid) {
+            return bulkState.isAddedRecord(rid);
+        });
+
+        if (state->isPending) {
+            txn.txnBase->removePendingBulkLoad();
+            state->isPending = false;
+        }
+    }
+
+}
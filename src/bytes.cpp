@@ -24,8 +24,8 @@
 namespace nogdb {
 
     Bytes::Bytes(const unsigned char *data, size_t len)
-            : value_{nullptr}, size_{len} {
-        value_ = new(std::nothrow) unsigned char[size_];
+            : value_{nullptr}, size_{0} {
+        allocate(len);
         std::copy(data, data + size_, value_);
     }
 
@@ -39,7 +39,9 @@ namespace nogdb {
             : Bytes{static_cast<const unsigned char *>((void *) data.c_str()), strlen(data.c_str())} {}
 
     Bytes::~Bytes() noexcept {
-        delete[] value_;
+        if (value_ != buffer_) {
+            delete[] value_;
+        }
     }
 
     Bytes::Bytes(const Bytes &binaryObject)
@@ -56,21 +58,36 @@ namespace nogdb {
 
     Bytes::Bytes(Bytes &&binaryObject) noexcept
             : value_{binaryObject.value_}, size_{binaryObject.size_} {
+        if (binaryObject.value_ == binaryObject.buffer_) {
+            value_ = buffer_;
+            std::copy(binaryObject.buffer_, binaryObject.buffer_ + size_, buffer_);
+        }
         binaryObject.value_ = nullptr;
         binaryObject.size_ = 0;
     }
 
     Bytes &Bytes::operator=(Bytes &&binaryObject) noexcept {
         if (this != &binaryObject) {
-            delete[] value_;
+            if (value_ != buffer_) {
+                delete[] value_;
+            }
             value_ = binaryObject.value_;
             size_ = binaryObject.size_;
+            if (binaryObject.value_ == binaryObject.buffer_) {
+                value_ = buffer_;
+                std::copy(binaryObject.buffer_, binaryObject.buffer_ + size_, buffer_);
+            }
             binaryObject.value_ = nullptr;
             binaryObject.size_ = 0;
         }
         return *this;
     }
 
+    void Bytes::allocate(size_t len) {
+        size_ = len;
+        value_ = (len <= INLINE_CAPACITY) ? buffer_ : new(std::nothrow) unsigned char[len];
+    }
+
     uint8_t Bytes::toTinyIntU() const {
         return convert<uint8_t>();
     }
@@ -129,14 +146,13 @@ namespace nogdb {
 
     Bytes Bytes::merge(const Bytes &bytes1, const Bytes &bytes2) {
 
-        const size_t total_size = bytes1.size() + bytes2.size();
-
-        auto * data = new unsigned char [total_size];
+        auto result = Bytes{};
+        result.allocate(bytes1.size() + bytes2.size());
 
-        std::copy(bytes1.getRaw(), bytes1.getRaw() + bytes1.size(), data);
-        std::copy(bytes2.getRaw(), bytes2.getRaw() + bytes2.size(), data + bytes1.size());
+        std::copy(bytes1.getRaw(), bytes1.getRaw() + bytes1.size(), result.value_);
+        std::copy(bytes2.getRaw(), bytes2.getRaw() + bytes2.size(), result.value_ + bytes1.size());
 
-        return Bytes {data, total_size};
+        return result;
     };
 
     Bytes Bytes::merge(const std::vector<Bytes> &bytes) {
@@ -146,14 +162,15 @@ namespace nogdb {
             total_size += b.size();
         }
 
-        auto * data = new unsigned char [total_size];
+        auto result = Bytes{};
+        result.allocate(total_size);
 
         size_t idx = 0;
         for (const Bytes& b : bytes) {
-            std::copy(b.getRaw(), b.getRaw() + b.size(), data + idx);
+            std::copy(b.getRaw(), b.getRaw() + b.size(), result.value_ + idx);
             idx += b.size();
         }
 
-        return Bytes {data, total_size};
+        return result;
     }
 }
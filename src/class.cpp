@@ -29,6 +29,8 @@
 #include "storage_engine.hpp"
 #include "lmdb_engine.hpp"
 #include "generic.hpp"
+#include "record_version.hpp"
+#include "relation_snapshot.hpp"
 #include "validate.hpp"
 #include "utils.hpp"
 
@@ -68,7 +70,7 @@ namespace nogdb {
             value.append(className.c_str(), className.length());
             classDBHandler.put(dbInfo.maxClassId, value, true);
             // create interface for itself
-            auto newClassDBHandler = dsTxnHandler->openDbi(std::to_string(dbInfo.maxClassId), true);
+            auto newClassDBHandler = dsTxnHandler->openClassDbi(dbInfo.maxClassId);
             newClassDBHandler.put(EM_MAXRECNUM, PositionId{1}, true);
 
             // update in-memory schema and info
@@ -118,7 +120,7 @@ namespace nogdb {
             value.append(className.c_str(), className.length());
             classDBHandler.put(dbInfo.maxClassId, value, true);
             // create interface for itself
-            auto newClassDBHandler = dsTxnHandler->openDbi(std::to_string(dbInfo.maxClassId), true);
+            auto newClassDBHandler = dsTxnHandler->openClassDbi(dbInfo.maxClassId);
             newClassDBHandler.put(EM_MAXRECNUM, PositionId{1}, true);
 
             // update in-memory schema and info
@@ -177,7 +179,7 @@ namespace nogdb {
             }
             // delete all associated relations
             auto relationDBHandler = dsTxnHandler->openDbi(TB_RELATIONS);
-            auto dbHandler = dsTxnHandler->openDbi(std::to_string(foundClass->id), true);
+            auto dbHandler = dsTxnHandler->openClassDbi(foundClass->id);
             auto cursorHandler = dsTxnHandler->openCursor(dbHandler);
             for(auto keyValue = cursorHandler.getNext();
                 !keyValue.empty();
@@ -186,13 +188,15 @@ namespace nogdb {
                 if (key != EM_MAXRECNUM) {
                     auto recordId = RecordId{foundClass->id, key};
                     if (foundClass->type == ClassType::EDGE) {
-                        relationDBHandler.del(rid2str(recordId));
+                        // keep the edge in memory while its relation is being removed
+                        txn.txnCtx.dbRelation->lookupEdge(*txn.txnBase, recordId);
+                        relationDBHandler.del(rid2key(recordId));
                     } else {
                         try {
                             for (const auto &edgeId : txn.txnCtx.dbRelation->getEdgeInOut(*txn.txnBase, recordId)) {
-                                auto edgeClassDBHandler = dsTxnHandler->openDbi(std::to_string(edgeId.first), true);
+                                auto edgeClassDBHandler = dsTxnHandler->openClassDbi(edgeId.first);
                                 edgeClassDBHandler.del(edgeId.second);
-                                relationDBHandler.del(rid2str(edgeId));
+                                relationDBHandler.del(rid2key(edgeId));
                             }
                         } catch (const Error &err) {
                             if (err.code() != NOGDB_GRAPH_NOEXST_VERTEX) {
@@ -205,7 +209,13 @@ namespace nogdb {
             }
 
             // drop the actual table
-            dbHandler.drop(true);
+            dsTxnHandler->dropDbi(storage_engine::LMDBDbiRegistry::classKey(foundClass->id), true);
+            txn.txnBase->dropPositionId(foundClass->id);
+            if (foundClass->type == ClassType::VERTEX) {
+                RecordVersion::removeAll(*txn.txnBase, foundClass->id);
+            }
+            // class and position ids of the dropped class may be reused
+            RelationSnapshot::invalidate(*txn.txnBase);
 
             // prepare for class inheritance
             auto superClassDescriptor = foundClass->super.getLatestVersion().first.lock();
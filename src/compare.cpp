@@ -22,6 +22,7 @@
 #include <iostream> // for debugging
 #include <vector>
 #include <algorithm>
+#include <iterator>
 #include <regex>
 
 #include "shared_lock.hpp"
@@ -348,6 +349,33 @@ namespace nogdb {
         return false;
     }
 
+    bool Compare::checkCondition(const Bytes &value, PropertyType type, const Condition &condition) {
+        switch (condition.comp) {
+            case Condition::Comparator::IS_NULL:
+                return value.empty();
+            case Condition::Comparator::NOT_NULL:
+                return !value.empty();
+            default:
+                return !value.empty() && compareBytesValue(value, type, condition);
+        }
+    }
+
+    bool Compare::checkMultiCondition(const BaseTxn &txn,
+                                      const std::string &className,
+                                      const RecordId &rid,
+                                      const RecordView &recordView,
+                                      const ClassPropertyInfo &classPropertyInfo,
+                                      const MultiCondition &conditions,
+                                      const PropertyMapType &types) {
+        for (const auto &type: types) {
+            if (Parser::isBasicInfo(type.first)) {
+                auto record = Parser::parseRawDataWithBasicInfo(txn, className, rid, recordView, classPropertyInfo);
+                return conditions.execute(record, types);
+            }
+        }
+        return conditions.execute(Parser::parseRawData(recordView, classPropertyInfo, types), types);
+    }
+
 //*****************************************************************
 //*  compare by condition and multi-condition object              *
 //*****************************************************************
@@ -359,37 +387,18 @@ namespace nogdb {
         auto result = ResultSet{};
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         for (const auto &classInfo: classInfos) {
-            auto cursorHandler = dsTxnHandler->openCursor(std::to_string(classInfo.id), true);
+            auto cursorHandler = dsTxnHandler->openClassCursor(classInfo.id);
             auto keyValue = cursorHandler.getNext();
             while (!keyValue.empty()) {
                 auto key = keyValue.key.data.numeric<PositionId>();
                 if (key != EM_MAXRECNUM) {
                     auto rid = RecordId{classInfo.id, key};
-                    auto record = Parser::parseRawDataWithBasicInfo(classInfo.name, rid, keyValue.val, classInfo.propertyInfo);
-                    if (condition.comp != Condition::Comparator::IS_NULL &&
-                        condition.comp != Condition::Comparator::NOT_NULL) {
-                        if (record.get(condition.propName).empty()) {
-                            keyValue = cursorHandler.getNext();
-                            continue;
-                        }
-                        if (compareBytesValue(record.get(condition.propName), type, condition)) {
-                            result.push_back(Result{RecordDescriptor{classInfo.id, key}, record});
-                        }
-                    } else {
-                        switch (condition.comp) {
-                            case Condition::Comparator::IS_NULL:
-                                if (record.get(condition.propName).empty()) {
-                                    result.push_back(Result{RecordDescriptor{classInfo.id, key}, record});
-                                }
-                                break;
-                            case Condition::Comparator::NOT_NULL:
-                                if (!record.get(condition.propName).empty()) {
-                                    result.push_back(Result{RecordDescriptor{classInfo.id, key}, record});
-                                }
-                                break;
-                            default:
-                                throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_INVALID_COMPARATOR);
-                        }
+                    auto recordView = RecordView{keyValue.val};
+                    auto value = Parser::parseRawDataProperty(*txn.txnBase, classInfo.name, rid, recordView,
+                                                              classInfo.propertyInfo, condition.propName);
+                    if (checkCondition(value, type, condition)) {
+                        auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, classInfo.name, rid, recordView, classInfo.propertyInfo);
+                        result.push_back(Result{RecordDescriptor{classInfo.id, key}, std::move(record)});
                     }
                 }
                 keyValue = cursorHandler.getNext();
@@ -405,15 +414,16 @@ namespace nogdb {
         auto result = ResultSet{};
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         for (const auto &classInfo: classInfos) {
-            auto cursorHandler = dsTxnHandler->openCursor(std::to_string(classInfo.id), true);
+            auto cursorHandler = dsTxnHandler->openClassCursor(classInfo.id);
             auto keyValue = cursorHandler.getNext();
             while (!keyValue.empty()) {
                 auto key = keyValue.key.data.numeric<PositionId>();
                 if (key != EM_MAXRECNUM) {
                     auto rid = RecordId{classInfo.id, key};
-                    auto record = Parser::parseRawDataWithBasicInfo(classInfo.name, rid, keyValue.val, classInfo.propertyInfo);
-                    if (conditions.execute(record, types)) {
-                        result.push_back(Result{RecordDescriptor{classInfo.id, key}, record});
+                    auto recordView = RecordView{keyValue.val};
+                    if (checkMultiCondition(*txn.txnBase, classInfo.name, rid, recordView, classInfo.propertyInfo, conditions, types)) {
+                        auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, classInfo.name, rid, recordView, classInfo.propertyInfo);
+                        result.push_back(Result{RecordDescriptor{classInfo.id, key}, std::move(record)});
                     }
                 }
                 keyValue = cursorHandler.getNext();
@@ -442,45 +452,19 @@ namespace nogdb {
                     auto classPropertyInfo = ClassPropertyInfo{};
                     auto classDBHandler = storage_engine::lmdb::Dbi{};
                     auto className = std::string{};
-                    auto filter = [&condition, &type](const Record &record) {
-                        if (condition.comp != Condition::Comparator::IS_NULL &&
-                            condition.comp != Condition::Comparator::NOT_NULL) {
-                            auto recordValue = record.get(condition.propName);
-                            if (recordValue.empty()) {
-                                return false;
-                            }
-                            if (compareBytesValue(recordValue, type, condition)) {
-                                return true;
-                            }
-                        } else {
-                            switch (condition.comp) {
-                                case Condition::Comparator::IS_NULL:
-                                    if (record.get(condition.propName).empty()) {
-                                        return true;
-                                    }
-                                    break;
-                                case Condition::Comparator::NOT_NULL:
-                                    if (!record.get(condition.propName).empty()) {
-                                        return true;
-                                    }
-                                    break;
-                                default:
-                                    throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_INVALID_COMPARATOR);
-                            }
-                        }
-                        return false;
-                    };
                     auto retrieve = [&](ResultSet &result, const RecordId &edge) {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = dsTxnHandler->openDbi(std::to_string(edge.first), true);
+                            classDBHandler = dsTxnHandler->openClassDbi(edge.first);
                             className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         }
-                        auto keyValue = classDBHandler.get(edge.second);
-                        auto record = Parser::parseRawDataWithBasicInfo(className, edge, keyValue, classPropertyInfo);
-                        if (filter(record)) {
-                            result.push_back(Result{RecordDescriptor{edge}, record});
+                        auto recordView = RecordView{classDBHandler.get(edge.second)};
+                        auto value = Parser::parseRawDataProperty(*txn.txnBase, className, edge, recordView,
+                                                                  classPropertyInfo, condition.propName);
+                        if (checkCondition(value, type, condition)) {
+                            auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, edge, recordView, classPropertyInfo);
+                            result.push_back(Result{RecordDescriptor{edge}, std::move(record)});
                         }
                     };
                     if (edgeClassIds.empty()) {
@@ -529,13 +513,13 @@ namespace nogdb {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = dsTxnHandler->openDbi(std::to_string(edge.first), true);
+                            classDBHandler = dsTxnHandler->openClassDbi(edge.first);
                             className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         }
-                        auto keyValue = classDBHandler.get(edge.second);
-                        auto record = Parser::parseRawDataWithBasicInfo(className, edge, keyValue, classPropertyInfo);
-                        if (conditions.execute(record, types)) {
-                            result.push_back(Result{RecordDescriptor{edge}, record});
+                        auto recordView = RecordView{classDBHandler.get(edge.second)};
+                        if (checkMultiCondition(*txn.txnBase, className, edge, recordView, classPropertyInfo, conditions, types)) {
+                            auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, edge, recordView, classPropertyInfo);
+                            result.push_back(Result{RecordDescriptor{edge}, std::move(record)});
                         }
                     };
                     if (edgeClassIds.empty()) {
@@ -583,21 +567,23 @@ namespace nogdb {
         if (propertyType == PropertyType::UNDEFINED) {
             throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_NOEXST_PROPERTY);
         }
-        //TODO: temporary fix indexing errors
-//        auto foundClassId = std::find_if(classDescriptors.cbegin(), classDescriptors.cend(),
-//                                         [&txn, &className](const Schema::ClassDescriptorPtr& ptr) {
-//            return BaseTxn::getCurrentVersion(*txn.txnBase, ptr->name).first == className;
-//        });
-//        auto &classId = (*foundClassId)->id;
-//        auto foundIndex = Index::hasIndex(classId, *classInfos.cbegin(), condition);
-//        if (foundIndex.second) {
-//            return Generic::getMultipleRecordFromRdesc(txn, Index::getIndexRecord(txn, classId, foundIndex.first, condition));
-//        }
-//        if (searchIndexOnly) {
-//            return ResultSet{};
-//        } else {
-            return getRecordCondition(txn, classInfos, condition, propertyType);
-//        }
+        auto result = ResultSet{};
+        for (const auto &classInfo: classInfos) {
+            auto plan = Index::planCondition(txn, classInfo, condition);
+            if (searchIndexOnly || Index::isIndexPlanPreferred(txn, classInfo.id, plan, true)) {
+                if (plan != nullptr) {
+                    auto partialResult = Generic::getMultipleRecordFromRdesc(
+                            txn, classInfo, Index::getIndexRecord(txn, classInfo.id, plan));
+                    result.insert(result.end(), std::make_move_iterator(partialResult.begin()),
+                                  std::make_move_iterator(partialResult.end()));
+                }
+            } else {
+                auto partialResult = getRecordCondition(txn, std::vector<ClassInfo>{classInfo}, condition, propertyType);
+                result.insert(result.end(), std::make_move_iterator(partialResult.begin()),
+                              std::make_move_iterator(partialResult.end()));
+            }
+        }
+        return result;
     }
 
     ResultSet Compare::compareMultiCondition(const Txn &txn,
@@ -636,21 +622,27 @@ namespace nogdb {
         if (numOfUndefPropertyType != 0) {
             throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_NOEXST_PROPERTY);
         }
-        //TODO: temporary fix indexing errors
-//        auto foundClassId = std::find_if(classDescriptors.cbegin(), classDescriptors.cend(),
-//                                         [&txn, &className](const Schema::ClassDescriptorPtr& ptr) {
-//            return BaseTxn::getCurrentVersion(*txn.txnBase, ptr->name).first == className;
-//        });
-//        auto &classId = (*foundClassId)->id;
-//        auto foundIndex = Index::hasIndex(classId, *classInfos.cbegin(), conditions);
-//        if (foundIndex.second) {
-//            return Generic::getMultipleRecordFromRdesc(txn, Index::getIndexRecord(txn, classId, foundIndex.first, conditions));
-//        }
-//        if (searchIndexOnly) {
-//            return ResultSet{};
-//        } else {
-            return getRecordMultiCondition(txn, classInfos, conditions, conditionPropertyTypes);
-//        }
+        auto result = ResultSet{};
+        for (const auto &classInfo: classInfos) {
+            auto plan = Index::planMultiCondition(txn, classInfo, conditions);
+            if (searchIndexOnly || Index::isIndexPlanPreferred(txn, classInfo.id, plan, true)) {
+                if (plan != nullptr) {
+                    auto partialResult = Generic::getMultipleRecordFromRdesc(
+                            txn, classInfo, Index::getIndexRecord(txn, classInfo.id, plan));
+                    for (const auto &res: partialResult) {
+                        if (plan->isExact || conditions.execute(res.record, conditionPropertyTypes)) {
+                            result.push_back(res);
+                        }
+                    }
+                }
+            } else {
+                auto partialResult = getRecordMultiCondition(txn, std::vector<ClassInfo>{classInfo},
+                                                             conditions, conditionPropertyTypes);
+                result.insert(result.end(), std::make_move_iterator(partialResult.begin()),
+                              std::make_move_iterator(partialResult.end()));
+            }
+        }
+        return result;
     }
 
     ResultSet Compare::compareEdgeCondition(const Txn &txn,
@@ -772,15 +764,15 @@ namespace nogdb {
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         try {
             for (const auto &classInfo: classInfos) {
-                auto cursorHandler = dsTxnHandler->openCursor(std::to_string(classInfo.id), true);
+                auto cursorHandler = dsTxnHandler->openClassCursor(classInfo.id);
                 auto keyValue = cursorHandler.getNext();
                 while (!keyValue.empty()) {
                     auto key = keyValue.key.data.numeric<PositionId>();
                     if (key != EM_MAXRECNUM) {
                         auto rid = RecordId{classInfo.id, key};
-                        auto record = Parser::parseRawDataWithBasicInfo(classInfo.name, rid, keyValue.val, classInfo.propertyInfo);
+                        auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, classInfo.name, rid, keyValue.val, classInfo.propertyInfo);
                         if ((*condition)(record)) {
-                            result.push_back(Result{RecordDescriptor{classInfo.id, key}, record});
+                            result.push_back(Result{RecordDescriptor{classInfo.id, key}, std::move(record)});
                         }
                     }
                     keyValue = cursorHandler.getNext();
@@ -824,13 +816,13 @@ namespace nogdb {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = dsTxnHandler->openDbi(std::to_string(edge.first), true);
+                            classDBHandler = dsTxnHandler->openClassDbi(edge.first);
                             className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         }
                         auto keyValue = classDBHandler.get(edge.second);
-                        auto record = Parser::parseRawDataWithBasicInfo(className, edge, keyValue, classPropertyInfo);
+                        auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, edge, keyValue, classPropertyInfo);
                         if ((*condition)(record)) {
-                            result.push_back(Result{RecordDescriptor{edge}, record});
+                            result.push_back(Result{RecordDescriptor{edge}, std::move(record)});
                         }
                     };
                     if (edgeClassIds.empty()) {
@@ -24,6 +24,7 @@
 
 #include "schema.hpp"
 #include "base_txn.hpp"
+#include "record_view.hpp"
 
 #include "graph.hpp"
 #include "nogdb_types.h"
@@ -50,6 +51,18 @@ namespace nogdb {
 
         static bool compareBytesValue(const Bytes &value, PropertyType type, const Condition &condition);
 
+        // evaluates a condition, including IS_NULL and NOT_NULL, against the value of its property
+        static bool checkCondition(const Bytes &value, PropertyType type, const Condition &condition);
+
+        // evaluates conditions on a stored record by decoding only the properties they refer to
+        static bool checkMultiCondition(const BaseTxn &txn,
+                                        const std::string &className,
+                                        const RecordId &rid,
+                                        const RecordView &recordView,
+                                        const ClassPropertyInfo &classPropertyInfo,
+                                        const MultiCondition &conditions,
+                                        const PropertyMapType &types);
+
         //*****************************************************************
         //*  result set supported functions                               *
         //*****************************************************************
@@ -46,37 +46,16 @@ namespace nogdb {
         auto result = std::vector<RecordDescriptor>{};
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         for (const auto &classInfo: classInfos) {
-            auto cursorHandler = dsTxnHandler->openCursor(std::to_string(classInfo.id), true);
+            auto cursorHandler = dsTxnHandler->openClassCursor(classInfo.id);
             auto keyValue = cursorHandler.getNext();
             while (!keyValue.empty()) {
                 auto key = keyValue.key.data.numeric<PositionId>();
                 if (key != EM_MAXRECNUM) {
                     auto rid = RecordId{classInfo.id, key};
-                    auto record = Parser::parseRawDataWithBasicInfo(classInfo.name, rid, keyValue.val, classInfo.propertyInfo);
-                    if (condition.comp != Condition::Comparator::IS_NULL &&
-                        condition.comp != Condition::Comparator::NOT_NULL) {
-                        if (record.get(condition.propName).empty()) {
-                            keyValue = cursorHandler.getNext();
-                            continue;
-                        }
-                        if (compareBytesValue(record.get(condition.propName), type, condition)) {
-                            result.emplace_back(RecordDescriptor{rid});
-                        }
-                    } else {
-                        switch (condition.comp) {
-                            case Condition::Comparator::IS_NULL:
-                                if (record.get(condition.propName).empty()) {
-                                    result.emplace_back(RecordDescriptor{rid});
-                                }
-                                break;
-                            case Condition::Comparator::NOT_NULL:
-                                if (!record.get(condition.propName).empty()) {
-                                    result.emplace_back(RecordDescriptor{rid});
-                                }
-                                break;
-                            default:
-                                throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_INVALID_COMPARATOR);
-                        }
+                    auto value = Parser::parseRawDataProperty(*txn.txnBase, classInfo.name, rid, RecordView{keyValue.val},
+                                                              classInfo.propertyInfo, condition.propName);
+                    if (checkCondition(value, type, condition)) {
+                        result.emplace_back(RecordDescriptor{rid});
                     }
                 }
                 keyValue = cursorHandler.getNext();
@@ -93,14 +72,14 @@ namespace nogdb {
         auto result = std::vector<RecordDescriptor>{};
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         for (const auto &classInfo: classInfos) {
-            auto cursorHandler = dsTxnHandler->openCursor(std::to_string(classInfo.id), true);
+            auto cursorHandler = dsTxnHandler->openClassCursor(classInfo.id);
             auto keyValue = cursorHandler.getNext();
             while (!keyValue.empty()) {
                 auto key = keyValue.key.data.numeric<PositionId>();
                 if (key != EM_MAXRECNUM) {
                     auto rid = RecordId{classInfo.id, key};
-                    auto record = Parser::parseRawDataWithBasicInfo(classInfo.name, rid, keyValue.val, classInfo.propertyInfo);
-                    if (conditions.execute(record, types)) {
+                    if (checkMultiCondition(*txn.txnBase, classInfo.name, rid, RecordView{keyValue.val},
+                                            classInfo.propertyInfo, conditions, types)) {
                         result.emplace_back(RecordDescriptor{rid});
                     }
                 }
@@ -128,44 +107,17 @@ namespace nogdb {
                     auto classPropertyInfo = ClassPropertyInfo{};
                     auto classDBHandler = storage_engine::lmdb::Dbi{};
                     auto className = std::string{};
-                    auto filter = [&condition, &type](const Record &record) {
-                        if (condition.comp != Condition::Comparator::IS_NULL &&
-                            condition.comp != Condition::Comparator::NOT_NULL) {
-                            auto recordValue = record.get(condition.propName);
-                            if (recordValue.empty()) {
-                                return false;
-                            }
-                            if (compareBytesValue(recordValue, type, condition)) {
-                                return true;
-                            }
-                        } else {
-                            switch (condition.comp) {
-                                case Condition::Comparator::IS_NULL:
-                                    if (record.get(condition.propName).empty()) {
-                                        return true;
-                                    }
-                                    break;
-                                case Condition::Comparator::NOT_NULL:
-                                    if (!record.get(condition.propName).empty()) {
-                                        return true;
-                                    }
-                                    break;
-                                default:
-                                    throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_INVALID_COMPARATOR);
-                            }
-                        }
-                        return false;
-                    };
                     auto retrieve = [&](std::vector<RecordDescriptor> &result, const RecordId &edge) {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = dsTxnHandler->openDbi(std::to_string(edge.first), true);
+                            classDBHandler = dsTxnHandler->openClassDbi(edge.first);
                             className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         }
-                        auto keyValue = classDBHandler.get(edge.second);
-                        auto record = Parser::parseRawDataWithBasicInfo(className, edge, keyValue, classPropertyInfo);
-                        if (filter(record)) {
+                        auto value = Parser::parseRawDataProperty(*txn.txnBase, className, edge,
+                                                                  RecordView{classDBHandler.get(edge.second)},
+                                                                  classPropertyInfo, condition.propName);
+                        if (checkCondition(value, type, condition)) {
                             result.emplace_back(RecordDescriptor{edge});
                         }
                     };
@@ -214,12 +166,11 @@ namespace nogdb {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = dsTxnHandler->openDbi(std::to_string(edge.first), true);
+                            classDBHandler = dsTxnHandler->openClassDbi(edge.first);
                             className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         }
-                        auto keyValue = classDBHandler.get(edge.second);
-                        auto record = Parser::parseRawDataWithBasicInfo(className, edge, keyValue, classPropertyInfo);
-                        if (conditions.execute(record, types)) {
+                        if (checkMultiCondition(*txn.txnBase, className, edge, RecordView{classDBHandler.get(edge.second)},
+                                                classPropertyInfo, conditions, types)) {
                             result.emplace_back(RecordDescriptor{edge});
                         }
                     };
@@ -266,21 +217,20 @@ namespace nogdb {
         if (propertyType == PropertyType::UNDEFINED) {
             throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_NOEXST_PROPERTY);
         }
-        //TODO: temporary fix indexing errors
-//        auto foundClassId = std::find_if(classDescriptors.cbegin(), classDescriptors.cend(),
-//                                         [&txn, &className](const Schema::ClassDescriptorPtr& ptr) {
-//            return BaseTxn::getCurrentVersion(*txn.txnBase, ptr->name).first == className;
-//        });
-//        auto &classId = (*foundClassId)->id;
-//        auto foundIndex = Index::hasIndex(classId, *classInfos.cbegin(), condition);
-//        if (foundIndex.second) {
-//            return Index::getIndexRecord(txn, classId, foundIndex.first, condition);
-//        }
-//        if (searchIndexOnly) {
-//            return std::vector<RecordDescriptor>{};
-//        } else {
-            return getRdescCondition(txn, classInfos, condition, propertyType);
-//        }
+        auto result = std::vector<RecordDescriptor>{};
+        for (const auto &classInfo: classInfos) {
+            auto plan = Index::planCondition(txn, classInfo, condition);
+            if (searchIndexOnly || Index::isIndexPlanPreferred(txn, classInfo.id, plan, false)) {
+                if (plan != nullptr) {
+                    auto partialResult = Index::getIndexRecord(txn, classInfo.id, plan);
+                    result.insert(result.end(), partialResult.cbegin(), partialResult.cend());
+                }
+            } else {
+                auto partialResult = getRdescCondition(txn, std::vector<ClassInfo>{classInfo}, condition, propertyType);
+                result.insert(result.end(), partialResult.cbegin(), partialResult.cend());
+            }
+        }
+        return result;
     }
 
     std::vector<RecordDescriptor>
@@ -317,21 +267,30 @@ namespace nogdb {
         if (numOfUndefPropertyType != 0) {
             throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_NOEXST_PROPERTY);
         }
-        //TODO: temporary fix indexing errors
-//        auto foundClassId = std::find_if(classDescriptors.cbegin(), classDescriptors.cend(),
-//                                         [&txn, &className](const Schema::ClassDescriptorPtr& ptr) {
-//            return BaseTxn::getCurrentVersion(*txn.txnBase, ptr->name).first == className;
-//        });
-//        auto &classId = (*foundClassId)->id;
-//        auto foundIndex = Index::hasIndex(classId, *classInfos.cbegin(), conditions);
-//        if (foundIndex.second) {
-//            return Index::getIndexRecord(txn, classId, foundIndex.first, conditions);
-//        }
-//        if (searchIndexOnly) {
-//            return std::vector<RecordDescriptor>{};
-//        } else {
-            return getRdescMultiCondition(txn, classInfos, conditions, conditionPropertyTypes);
-//        }
+        auto result = std::vector<RecordDescriptor>{};
+        for (const auto &classInfo: classInfos) {
+            auto plan = Index::planMultiCondition(txn, classInfo, conditions);
+            if (searchIndexOnly || Index::isIndexPlanPreferred(txn, classInfo.id, plan, false)) {
+                if (plan == nullptr) {
+                    continue;
+                }
+                auto partialResult = Index::getIndexRecord(txn, classInfo.id, plan);
+                if (plan->isExact) {
+                    result.insert(result.end(), partialResult.cbegin(), partialResult.cend());
+                } else {
+                    for (const auto &res: Generic::getMultipleRecordFromRdesc(txn, classInfo, partialResult)) {
+                        if (conditions.execute(res.record, conditionPropertyTypes)) {
+                            result.emplace_back(res.descriptor);
+                        }
+                    }
+                }
+            } else {
+                auto partialResult = getRdescMultiCondition(txn, std::vector<ClassInfo>{classInfo},
+                                                            conditions, conditionPropertyTypes);
+                result.insert(result.end(), partialResult.cbegin(), partialResult.cend());
+            }
+        }
+        return result;
     }
 
     std::vector<RecordDescriptor>
@@ -448,13 +407,13 @@ namespace nogdb {
         auto result = std::vector<RecordDescriptor>{};
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         for (const auto &classInfo: classInfos) {
-            auto cursorHandler = dsTxnHandler->openCursor(std::to_string(classInfo.id), true);
+            auto cursorHandler = dsTxnHandler->openClassCursor(classInfo.id);
             auto keyValue = cursorHandler.getNext();
             while (!keyValue.empty()) {
                 auto key = keyValue.key.data.numeric<PositionId>();
                 if (key != EM_MAXRECNUM) {
                     auto rid = RecordId{classInfo.id, key};
-                    auto record = Parser::parseRawDataWithBasicInfo(classInfo.name, rid, keyValue.val, classInfo.propertyInfo);
+                    auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, classInfo.name, rid, keyValue.val, classInfo.propertyInfo);
                     if ((*condition)(record)) {
                         result.push_back(RecordDescriptor{rid});
                     }
@@ -496,11 +455,11 @@ namespace nogdb {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = dsTxnHandler->openDbi(std::to_string(edge.first), true);
+                            classDBHandler = dsTxnHandler->openClassDbi(edge.first);
                             className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         }
                         auto keyValue = classDBHandler.get(edge.second);
-                        auto record = Parser::parseRawDataWithBasicInfo(className, edge, keyValue, classPropertyInfo);
+                        auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, edge, keyValue, classPropertyInfo);
                         if ((*condition)(record)) {
                             result.emplace_back(RecordDescriptor{edge});
                         }
@@ -25,6 +25,12 @@
 #include <map>
 #include <deque>
 #include <vector>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
 
 #include "spinlock.hpp"
 
@@ -35,24 +41,333 @@ namespace nogdb {
     template<typename Collection, typename Key, typename T>
     struct ConcurrentHashMap {
         void lockAndErase(const Key &key) {
-            RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            RWSpinLockGuard<StripedRWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
             elements.erase(key);
         }
 
         void lockAndClear() {
-            RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            RWSpinLockGuard<StripedRWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
             elements.clear();
         }
 
         void lockAndEmplace(const Key &key, const std::shared_ptr<T> &element) {
-            RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            RWSpinLockGuard<StripedRWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
             elements.emplace(key, element);
         }
 
-        RWSpinLock splock{};
+        void lockAndReplace(const Key &key, const std::shared_ptr<T> &element) {
+            RWSpinLockGuard<StripedRWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            elements[key] = element;
+        }
+
+        template<typename Predicate>
+        void lockAndEraseIf(const Key &key, Predicate predicate) {
+            RWSpinLockGuard<StripedRWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            auto iterator = elements.find(key);
+            if (iterator != elements.end() && predicate(*iterator->second)) {
+                elements.erase(iterator);
+            }
+        }
+
+        template<typename Iterator>
+        void lockAndInsert(Iterator first, Iterator last, size_t count) {
+            RWSpinLockGuard<StripedRWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            elements.reserve(elements.size() + count);
+            elements.insert(first, last);
+        }
+
+        StripedRWSpinLock splock{};
         Collection elements;
     };
 
+    // splits the elements into a power-of-two number of shards, each guarded by its own lock on its own cache line
+    template<typename Key, typename T, typename Hash, size_t NumShards = 64>
+    struct ShardedConcurrentHashMap {
+        static_assert(NumShards > 0 && (NumShards & (NumShards - 1)) == 0, "number of shards must be a power of two");
+
+        typedef std::unordered_map<Key, std::shared_ptr<T>, Hash> Collection;
+
+        std::shared_ptr<T> find(const Key &key) const {
+            auto &shard = getShard(key);
+            RWSpinLockGuard<StripedRWSpinLock> _(shard.splock);
+            auto iterator = shard.elements.find(key);
+            return (iterator == shard.elements.cend()) ? nullptr : iterator->second;
+        }
+
+        size_t size() const {
+            auto result = size_t{0};
+            for (auto &shard: shards) {
+                RWSpinLockGuard<StripedRWSpinLock> _(shard.splock);
+                result += shard.elements.size();
+            }
+            return result;
+        }
+
+        void lockAndErase(const Key &key) {
+            auto &shard = getShard(key);
+            RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            shard.elements.erase(key);
+        }
+
+        // erases the key only if it still maps to the given element
+        void lockAndErase(const Key &key, const std::shared_ptr<T> &element) {
+            lockAndEraseIf(key, [&element](const T &current) { return &current == element.get(); });
+        }
+
+        template<typename Predicate>
+        void lockAndEraseIf(const Key &key, Predicate predicate) {
+            auto &shard = getShard(key);
+            RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            auto iterator = shard.elements.find(key);
+            if (iterator != shard.elements.end() && predicate(*iterator->second)) {
+                shard.elements.erase(iterator);
+            }
+        }
+
+        void lockAndClear() {
+            for (auto &shard: shards) {
+                RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                shard.elements.clear();
+            }
+        }
+
+        void lockAndEmplace(const Key &key, const std::shared_ptr<T> &element) {
+            auto &shard = getShard(key);
+            RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            shard.elements.emplace(key, element);
+        }
+
+        void lockAndReplace(const Key &key, const std::shared_ptr<T> &element) {
+            auto &shard = getShard(key);
+            RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            shard.elements[key] = element;
+        }
+
+        template<typename Iterator>
+        void lockAndInsert(Iterator first, Iterator last, size_t count) {
+            auto groups = groupByShard(first, last, count);
+            for (size_t i = 0; i < NumShards; ++i) {
+                auto &shard = shards[i];
+                RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                shard.elements.reserve(shard.elements.size() + groups[i].size());
+                for (const auto &iterator: groups[i]) {
+                    shard.elements.insert(*iterator);
+                }
+            }
+        }
+
+        template<typename Iterator>
+        void lockAndReplace(Iterator first, Iterator last, size_t count) {
+            auto groups = groupByShard(first, last, count);
+            for (size_t i = 0; i < NumShards; ++i) {
+                auto &shard = shards[i];
+                RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                shard.elements.reserve(shard.elements.size() + groups[i].size());
+                for (const auto &iterator: groups[i]) {
+                    shard.elements[iterator->first] = iterator->second;
+                }
+            }
+        }
+
+    private:
+        struct Shard {
+            mutable StripedRWSpinLock splock{};
+            Collection elements;
+            char padding[CACHE_LINE_SIZE - (sizeof(StripedRWSpinLock) + sizeof(Collection)) % CACHE_LINE_SIZE];
+        };
+
+        // group by shard first so that every shard is locked once
+        template<typename Iterator>
+        std::array<std::vector<Iterator>, NumShards> groupByShard(Iterator first, Iterator last, size_t count) const {
+            auto groups = std::array<std::vector<Iterator>, NumShards>{};
+            for (auto &group: groups) {
+                group.reserve(count / NumShards + 1);
+            }
+            for (auto iterator = first; iterator != last; ++iterator) {
+                groups[getShardIndex(iterator->first)].emplace_back(iterator);
+            }
+            return groups;
+        }
+
+        size_t getShardIndex(const Key &key) const {
+            // the element hash may be weak in its low bits, e.g. for consecutive position ids
+            auto hash = static_cast<uint64_t>(Hash{}(key));
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33;
+            return static_cast<size_t>(hash & (NumShards - 1));
+        }
+
+        Shard &getShard(const Key &key) {
+            return shards[getShardIndex(key)];
+        }
+
+        const Shard &getShard(const Key &key) const {
+            return shards[getShardIndex(key)];
+        }
+
+        std::array<Shard, NumShards> shards{};
+    };
+
+    // keeps elements by value in pages of consecutive record ids of a class, each page guarded by the lock
+    // of its shard, so that a class whose records are added in order takes little more than its elements
+    template<typename T, size_t NumShards = 64>
+    struct ConcurrentSlab {
+        static_assert(NumShards > 0 && (NumShards & (NumShards - 1)) == 0, "number of shards must be a power of two");
+
+        std::pair<T, bool> find(const RecordId &rid) const {
+            auto const pageKey = getPageKey(rid);
+            auto &shard = getShard(pageKey);
+            RWSpinLockGuard<StripedRWSpinLock> _(shard.splock);
+            auto page = shard.pages.find(pageKey);
+            auto const slot = getSlot(rid);
+            if (page == shard.pages.cend() || !page->second->isUsed(slot)) {
+                return std::make_pair(T{}, false);
+            }
+            return std::make_pair(page->second->elements[slot], true);
+        }
+
+        size_t size() const {
+            return numElements.load(std::memory_order_relaxed);
+        }
+
+        void lockAndErase(const RecordId &rid) {
+            lockAndEraseIf(rid, [](const T &) { return true; });
+        }
+
+        template<typename Predicate>
+        void lockAndEraseIf(const RecordId &rid, Predicate predicate) {
+            auto const pageKey = getPageKey(rid);
+            auto &shard = getShard(pageKey);
+            RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            auto page = shard.pages.find(pageKey);
+            auto const slot = getSlot(rid);
+            if (page != shard.pages.end() && page->second->isUsed(slot) && predicate(page->second->elements[slot])) {
+                page->second->usedSlots &= ~(uint64_t{1} << slot);
+                --numElements;
+                if (page->second->usedSlots == 0) {
+                    shard.pages.erase(page);
+                }
+            }
+        }
+
+        void lockAndClear() {
+            for (auto &shard: shards) {
+                RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                for (const auto &page: shard.pages) {
+                    numElements -= std::bitset<PAGE_SIZE>{page.second->usedSlots}.count();
+                }
+                shard.pages.clear();
+            }
+        }
+
+        // return false if there is an element of the record id already
+        bool lockAndEmplace(const RecordId &rid, const T &element) {
+            auto const pageKey = getPageKey(rid);
+            auto &shard = getShard(pageKey);
+            RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            auto &page = shard.pages[pageKey];
+            if (page == nullptr) {
+                page.reset(new Page{});
+            }
+            if (page->isUsed(getSlot(rid))) {
+                return false;
+            }
+            assign(*page, rid, element);
+            return true;
+        }
+
+        void lockAndReplace(const RecordId &rid, const T &element) {
+            auto const pageKey = getPageKey(rid);
+            auto &shard = getShard(pageKey);
+            RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            auto &page = shard.pages[pageKey];
+            if (page == nullptr) {
+                page.reset(new Page{});
+            }
+            assign(*page, rid, element);
+        }
+
+        // replace many elements given as pairs of record ids and elements with one lock per shard
+        template<typename Iterator>
+        void lockAndReplace(Iterator first, Iterator last, size_t count) {
+            auto groups = std::array<std::vector<Iterator>, NumShards>{};
+            for (auto &group: groups) {
+                group.reserve(count / NumShards + 1);
+            }
+            for (auto iterator = first; iterator != last; ++iterator) {
+                groups[getShardIndex(getPageKey(iterator->first))].emplace_back(iterator);
+            }
+            for (size_t i = 0; i < NumShards; ++i) {
+                auto &shard = shards[i];
+                RWSpinLockGuard<StripedRWSpinLock> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                for (const auto &iterator: groups[i]) {
+                    auto &page = shard.pages[getPageKey(iterator->first)];
+                    if (page == nullptr) {
+                        page.reset(new Page{});
+                    }
+                    assign(*page, iterator->first, iterator->second);
+                }
+            }
+        }
+
+    private:
+        static constexpr size_t PAGE_BITS = 6;
+        static constexpr size_t PAGE_SIZE = size_t{1} << PAGE_BITS;
+
+        struct Page {
+            std::array<T, PAGE_SIZE> elements{};
+            uint64_t usedSlots{0};
+
+            bool isUsed(size_t slot) const {
+                return (usedSlots & (uint64_t{1} << slot)) != 0;
+            }
+        };
+
+        struct Shard {
+            mutable StripedRWSpinLock splock{};
+            std::unordered_map<uint64_t, std::unique_ptr<Page>> pages;
+            char padding[CACHE_LINE_SIZE -
+                         (sizeof(StripedRWSpinLock) + sizeof(std::unordered_map<uint64_t, std::unique_ptr<Page>>)) %
+                         CACHE_LINE_SIZE];
+        };
+
+        std::array<Shard, NumShards> shards{};
+        std::atomic<size_t> numElements{0};
+
+        static uint64_t getPageKey(const RecordId &rid) {
+            return ((static_cast<uint64_t>(rid.first) << 32) | rid.second) >> PAGE_BITS;
+        }
+
+        static size_t getSlot(const RecordId &rid) {
+            return static_cast<size_t>(rid.second & (PAGE_SIZE - 1));
+        }
+
+        static size_t getShardIndex(uint64_t pageKey) {
+            pageKey ^= pageKey >> 33;
+            pageKey *= 0xff51afd7ed558ccdULL;
+            pageKey ^= pageKey >> 33;
+            return static_cast<size_t>(pageKey & (NumShards - 1));
+        }
+
+        Shard &getShard(uint64_t pageKey) {
+            return shards[getShardIndex(pageKey)];
+        }
+
+        const Shard &getShard(uint64_t pageKey) const {
+            return shards[getShardIndex(pageKey)];
+        }
+
+        void assign(Page &page, const RecordId &rid, const T &element) {
+            auto const slot = getSlot(rid);
+            if (!page.isUsed(slot)) {
+                page.usedSlots |= uint64_t{1} << slot;
+                ++numElements;
+            }
+            page.elements[slot] = element;
+        }
+    };
+
     template<typename T>
     using DeleteQueue = std::deque<std::pair<T, TxnId>>;
 
@@ -73,7 +388,12 @@ namespace nogdb {
             elements.insert(elements.end(), deleteQueue.begin(), deleteQueue.end());
         }
 
-        RWSpinLock splock{};
+        size_t size() const {
+            RWSpinLockGuard<RWSpinLock> _(splock);
+            return elements.size();
+        }
+
+        mutable RWSpinLock splock{};
         DeleteQueue<T> elements;
     };
 
@@ -34,6 +34,11 @@ namespace nogdb {
     const std::string TB_PROPERTIES = ".properties";
     const std::string TB_RELATIONS = ".relations";
     const std::string TB_INDEXES = ".indexes";
+    const std::string TB_VERSIONS = ".versions";
+    const std::string TB_RELATIONS_SNAPSHOT = ".relations_snapshot";
+    const std::string TB_RELATIONS_DIRTY = ".relations_dirty";
+    const std::string TB_RELATIONS_UPGRADE = ".relations_upgrade";
+    const std::string TB_ADJACENCY = ".adjacency";
 
     const std::string TB_INDEXING_PREFIX = ".index_";
 
@@ -49,13 +54,33 @@ namespace nogdb {
     constexpr uint16_t TXN_VERSION_ID = 4;
     const std::string TXN_VERSION = "@txnVersion";
 
+    // a stored record never contains the property ids of generated basic info, so one of them
+    // at the beginning of a record marks its format
+    constexpr uint16_t RECORD_FORMAT_DIRECTORY = RECORD_ID_PROPERTY_ID;
+
     constexpr uint16_t UINT16_EM_INIT = 0;
     const std::string STRING_EM_INIT = ".init";
+    const std::string RELATIONS_FORMAT_KEY = ".format";
+    constexpr uint8_t RELATIONS_FORMAT_BINARY_KEY = 1;
+    const std::string ADJACENCY_SYNCED_KEY = ".synced";
+
+    // size of a single chunk of the adjacency snapshot and the share of changes that triggers a rewrite
+    constexpr size_t SNAPSHOT_CHUNK_SIZE = 4U * 1024U * 1024U;
+    constexpr size_t SNAPSHOT_REFRESH_RATIO = 8U;
     constexpr uint32_t EM_MAXRECNUM = 0;
 
     const std::string INDEX_POSITIVE_SUFFIX = "_p";
     const std::string INDEX_NEGATIVE_SUFFIX = "_n";
 
+    // cost model of the index planner (relative units, a sequential record read is 1.0)
+    constexpr double PLAN_RECORD_SCAN_COST = 1.0;
+    constexpr double PLAN_RECORD_FETCH_COST = 1.5;
+    constexpr double PLAN_INDEX_SEEK_COST = 1.0;
+    constexpr double PLAN_INDEX_ENTRY_COST = 0.1;
+    constexpr double PLAN_EQUAL_SELECTIVITY = 0.05;
+    constexpr double PLAN_RANGE_SELECTIVITY = 1.0 / 3.0;
+    constexpr double PLAN_BETWEEN_SELECTIVITY = 0.25;
+
 }
 
 #endif
@@ -20,7 +20,11 @@
  */
 
 #include <iostream> // for debugging
+#include <algorithm>
 #include <string>
+#include <vector>
+#include <thread>
+#include <unordered_set>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
@@ -36,11 +40,80 @@
 #include "graph.hpp"
 #include "validate.hpp"
 #include "schema.hpp"
+#include "index.hpp"
+#include "relation_snapshot.hpp"
+#include "adjacency.hpp"
+#include "record_version.hpp"
+#include "reclaimer.hpp"
+#include "flusher.hpp"
 
 #include "nogdb_context.h"
 
 namespace nogdb {
 
+    namespace {
+
+        // convert "classId:positionId" string keys written by older versions into binary keys
+        // NOTE: binary keys written into .relations while walking it could not be told from the legacy keys
+        // ahead of the cursor, so the converted relations are moved through a scratch table one at a time
+        // rather than kept in memory
+        void upgradeRelations(storage_engine::LMDBTxn &wtxn) {
+            auto relationDBHandler = wtxn.openDbi(TB_RELATIONS);
+            if (!relationDBHandler.get(RELATIONS_FORMAT_KEY).empty) {
+                return;
+            }
+            auto isUpgraded = false;
+            auto relationCursor = wtxn.openCursor(relationDBHandler);
+            for (auto relationKeyValue = relationCursor.getNext();
+                 !relationKeyValue.empty();
+                 relationKeyValue = relationCursor.getNext()) {
+                auto key = relationKeyValue.key.data.string();
+                if (key == STRING_EM_INIT) {
+                    continue;
+                }
+                auto sp = split(key, ':');
+                if (sp.size() != 2) {
+                    throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_UNKNOWN_ERR);
+                }
+                auto const rid = RecordId{
+                        static_cast<ClassId>(std::stoul(std::string{sp[0]}, nullptr, 0)),
+                        static_cast<PositionId>(std::stoul(std::string{sp[1]}, nullptr, 0))
+                };
+                wtxn.openDbi(storage_engine::LMDBDbiRegistry::relationsUpgradeKey())
+                        .put(rid2key(rid), relationKeyValue.val.data.blob());
+                relationCursor.del();
+                isUpgraded = true;
+            }
+            if (isUpgraded) {
+                {
+                    auto upgradeCursor = wtxn.openCursor(storage_engine::LMDBDbiRegistry::relationsUpgradeKey());
+                    for (auto relationKeyValue = upgradeCursor.getNext();
+                         !relationKeyValue.empty();
+                         relationKeyValue = upgradeCursor.getNext()) {
+                        relationDBHandler.put(relationKeyValue.key.data, relationKeyValue.val.data);
+                    }
+                }
+                wtxn.dropDbi(storage_engine::LMDBDbiRegistry::relationsUpgradeKey());
+            }
+            relationDBHandler.put(RELATIONS_FORMAT_KEY, RELATIONS_FORMAT_BINARY_KEY);
+        }
+
+        ContextOptions makeOptions(unsigned int maxDbNum, unsigned long maxDbSize) {
+            auto options = ContextOptions{};
+            options.maxDbNum = maxDbNum;
+            options.maxDbSize = maxDbSize;
+            return options;
+        }
+
+    }
+
+    ContextOptions::ContextOptions()
+            : maxDbNum{DEFAULT_NOGDB_MAX_DATABASE_NUMBER}, maxDbSize{DEFAULT_NOGDB_MAX_DATABASE_SIZE},
+              maxMapSize{DEFAULT_NOGDB_MAX_MAP_SIZE}, maxReaders{DEFAULT_NOGDB_MAX_READERS},
+              readTxnPoolSize{DEFAULT_NOGDB_READ_TXN_POOL_SIZE},
+              numLoadingThreads{DEFAULT_NOGDB_LOADING_THREADS}, adjacencyCacheSize{DEFAULT_NOGDB_ADJACENCY_CACHE_SIZE}, noSync{false}, noMetaSync{false},
+              writeMap{false}, mapAsync{false}, syncIntervalMs{DEFAULT_NOGDB_SYNC_INTERVAL_MS} {};
+
     Context::Context(const std::string &dbPath)
             : Context{dbPath, DEFAULT_NOGDB_MAX_DATABASE_NUMBER, DEFAULT_NOGDB_MAX_DATABASE_SIZE} {};
 
@@ -50,7 +123,10 @@ namespace nogdb {
     Context::Context(const std::string &dbPath, unsigned long maxDbSize)
             : Context{dbPath, DEFAULT_NOGDB_MAX_DATABASE_NUMBER, maxDbSize} {};
 
-    Context::Context(const std::string &dbPath, unsigned int maxDbNum, unsigned long maxDbSize) {
+    Context::Context(const std::string &dbPath, unsigned int maxDbNum, unsigned long maxDbSize)
+            : Context{dbPath, makeOptions(maxDbNum, maxDbSize)} {};
+
+    Context::Context(const std::string &dbPath, const ContextOptions &options) {
         if (!fileExists(dbPath)) {
             mkdir(dbPath.c_str(), 0755);
         }
@@ -63,23 +139,36 @@ namespace nogdb {
                 throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_UNKNOWN_ERR);
             }
         } else {
+            auto envFlag = storage_engine::lmdb::DEFAULT_ENV_FLAG;
+            envFlag |= (options.noSync) ? MDB_NOSYNC : 0U;
+            envFlag |= (options.noMetaSync) ? MDB_NOMETASYNC : 0U;
+            envFlag |= (options.writeMap) ? MDB_WRITEMAP : 0U;
+            envFlag |= (options.mapAsync) ? MDB_MAPASYNC : 0U;
             envHandler = std::make_shared<storage_engine::LMDBEnv>(
-                    dbPath, maxDbNum, maxDbSize, DEFAULT_NOGDB_MAX_READERS
+                    dbPath, options.maxDbNum, options.maxDbSize, options.maxReaders, envFlag, options.maxMapSize,
+                    options.readTxnPoolSize
             );
             dbInfo = std::make_shared<DBInfo>();
             dbSchema = std::make_shared<Schema>();
             dbTxnStat = std::make_shared<TxnStat>();
-            dbRelation = std::make_shared<Graph>();
+            dbRelation = std::make_shared<Graph>(options.adjacencyCacheSize, dbTxnStat);
+            dbTxnPool = std::make_shared<BaseTxnPool>(options.readTxnPoolSize);
             dbInfoMutex = std::make_shared<boost::shared_mutex>();
             dbWriterMutex = std::make_shared<boost::shared_mutex>();
             dbInfo->dbPath = dbPath;
-            dbInfo->maxDB = maxDbNum;
-            dbInfo->maxDBSize = maxDbSize;
+            dbInfo->maxDB = options.maxDbNum;
+            dbInfo->maxDBSize = options.maxDbSize;
             dbInfo->maxClassId = ClassId{INIT_NUM_CLASSES};
             dbInfo->maxPropertyId = PropertyId{INIT_NUM_PROPERTIES};
             dbInfo->numClass = ClassId{0};
             dbInfo->numProperty = PropertyId{0};
-            initDatabase();
+            initDatabase((options.numLoadingThreads != 0) ? options.numLoadingThreads
+                                                          : std::max(std::thread::hardware_concurrency(), 1U));
+            dbReclaimer = std::make_shared<Reclaimer>(dbSchema, dbRelation, dbTxnStat,
+                                                      DEFAULT_NOGDB_RECLAIM_INTERVAL_MS);
+            if (options.syncIntervalMs != 0) {
+                dbFlusher = std::make_shared<Flusher>(envHandler, options.syncIntervalMs);
+            }
         }
     }
 
@@ -89,7 +178,8 @@ namespace nogdb {
 
     Context::Context(const Context &ctx)
             : envHandler{ctx.envHandler}, dbInfo{ctx.dbInfo}, dbSchema{ctx.dbSchema}, dbTxnStat{ctx.dbTxnStat},
-              dbRelation{ctx.dbRelation}, dbInfoMutex{ctx.dbInfoMutex}, dbWriterMutex{ctx.dbWriterMutex} {};
+              dbRelation{ctx.dbRelation}, dbReclaimer{ctx.dbReclaimer}, dbFlusher{ctx.dbFlusher},
+              dbTxnPool{ctx.dbTxnPool}, dbInfoMutex{ctx.dbInfoMutex}, dbWriterMutex{ctx.dbWriterMutex} {};
 
     Context &Context::operator=(const Context &ctx) {
         if (this != &ctx) {
@@ -103,7 +193,9 @@ namespace nogdb {
     Context::Context(Context &&ctx) noexcept
             : envHandler{std::move(ctx.envHandler)}, dbInfo{std::move(ctx.dbInfo)}, dbSchema{std::move(ctx.dbSchema)},
               dbTxnStat{std::move(ctx.dbTxnStat)}, dbRelation{std::move(ctx.dbRelation)},
-              dbInfoMutex{std::move(ctx.dbInfoMutex)}, dbWriterMutex{std::move(ctx.dbWriterMutex)} {}
+              dbReclaimer{std::move(ctx.dbReclaimer)}, dbFlusher{std::move(ctx.dbFlusher)},
+              dbTxnPool{std::move(ctx.dbTxnPool)}, dbInfoMutex{std::move(ctx.dbInfoMutex)},
+              dbWriterMutex{std::move(ctx.dbWriterMutex)} {}
 
     Context &Context::operator=(Context &&ctx) noexcept {
         if (this != &ctx) {
@@ -112,6 +204,9 @@ namespace nogdb {
             dbSchema = std::move(ctx.dbSchema);
             dbTxnStat = std::move(ctx.dbTxnStat);
             dbRelation = std::move(ctx.dbRelation);
+            dbReclaimer = std::move(ctx.dbReclaimer);
+            dbFlusher = std::move(ctx.dbFlusher);
+            dbTxnPool = std::move(ctx.dbTxnPool);
             dbInfoMutex = std::move(ctx.dbInfoMutex);
             dbWriterMutex = std::move(ctx.dbWriterMutex);
         }
@@ -130,7 +225,15 @@ namespace nogdb {
         return dbTxnStat->minActiveTxnId();
     }
 
-    void Context::initDatabase() {
+    ReclaimStat Context::getReclaimStat() const {
+        return dbReclaimer->getStat();
+    }
+
+    void Context::sync() const {
+        envHandler->sync();
+    }
+
+    void Context::initDatabase(unsigned int numLoadingThreads) {
         auto currentTime = std::to_string(currentTimestamp());
         // perform read-write operations
         auto wtxn = storage_engine::LMDBTxn(envHandler.get(), storage_engine::lmdb::TXN_RW);
@@ -140,10 +243,20 @@ namespace nogdb {
             auto propDBHndler = wtxn.openDbi(TB_PROPERTIES, true);
             auto indexDBHandler = wtxn.openDbi(TB_INDEXES, true, false);
             auto relationDBHandler = wtxn.openDbi(TB_RELATIONS);
+            wtxn.openDbi(storage_engine::LMDBDbiRegistry::versionsKey(), true);
+            wtxn.openDbi(TB_RELATIONS_SNAPSHOT, true);
+            wtxn.openDbi(TB_RELATIONS_DIRTY);
+            wtxn.openDbi(TB_ADJACENCY);
             classDBHandler.put(ClassId{UINT16_EM_INIT}, currentTime);
             propDBHndler.put(PropertyId{UINT16_EM_INIT}, currentTime);
 //            indexDBHandler.put(PropertyId{UINT16_EM_INIT}, currentTime);
             relationDBHandler.put(STRING_EM_INIT, currentTime);
+            upgradeRelations(wtxn);
+            if (dbRelation->isAdjacencyCached()) {
+                Adjacency::synchronize(wtxn);
+            } else {
+                Adjacency::invalidate(wtxn);
+            }
             wtxn.commit();
         } catch (const Error &err) {
             wtxn.rollback();
@@ -175,6 +288,7 @@ namespace nogdb {
                 data.retrieve(nameBytes, offset, nameLength);
                 auto className = std::string(reinterpret_cast<char *>(nameBytes), nameLength);
                 auto classDescriptor = std::make_shared<Schema::ClassDescriptor>(key, className, classType);
+                rtxn.openClassDbi(key);
                 dbSchema->insert(baseTxn, classDescriptor);
                 inheritanceInfo.emplace_back(std::make_pair(classDescriptor->id, superClassId));
                 if (classDescriptor->id > dbInfo->maxClassId) {
@@ -231,6 +345,22 @@ namespace nogdb {
                     offset = data.retrieve(&indexId, offset, sizeof(IndexId));
                     offset = data.retrieve(&classId, offset, sizeof(ClassId));
                     propertyDescriptor.indexInfo.emplace(classId, std::make_pair(indexId, isUniqueNumeric));
+                    switch (propType) {
+                        case PropertyType::TINYINT:
+                        case PropertyType::SMALLINT:
+                        case PropertyType::INTEGER:
+                        case PropertyType::BIGINT:
+                        case PropertyType::REAL:
+                            rtxn.openDbi(Index::getIndexingKey(indexId, true), true, isUniqueNumeric);
+                            rtxn.openDbi(Index::getIndexingKey(indexId, false), true, isUniqueNumeric);
+                            break;
+                        case PropertyType::TEXT:
+                            rtxn.openDbi(Index::getIndexingKey(indexId), false, isUniqueNumeric);
+                            break;
+                        default:
+                            rtxn.openDbi(Index::getIndexingKey(indexId), true, isUniqueNumeric);
+                            break;
+                    }
                     if (indexId > baseTxn.dbInfo.maxIndexId) {
                         baseTxn.dbInfo.maxIndexId = indexId;
                     }
@@ -251,51 +381,50 @@ namespace nogdb {
             throw err;
         }
 
-        // retrieve relations information
+        // retrieve relations information, with a bounded adjacency cache they are loaded on demand instead
+        auto relations = RelationSnapshot::Relations{};
         try {
-            auto relationCursor = rtxn.openCursor(TB_RELATIONS);
-            for (auto relationKeyValue = relationCursor.getNext();
-                 !relationKeyValue.empty();
-                 relationKeyValue = relationCursor.getNext()) {
-                auto key = relationKeyValue.key.data.string();
-                if (key == STRING_EM_INIT) {
-                    continue;
-                }
-                auto data = relationKeyValue.val.data.blob();
-                // resolve a rid of an edge from a key
-                auto sp = split(key, ':');
-                if (sp.size() != 2) {
-                    throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_UNKNOWN_ERR);
+            if (!dbRelation->isAdjacencyCached()) {
+                auto edgeClassIds = std::vector<ClassId>{};
+                auto vertexClassIds = std::unordered_set<ClassId>{};
+                for (const auto &nameToDesc: dbSchema->getNameToDescMapping(baseTxn)) {
+                    if (auto classDescriptor = nameToDesc.second.lock()) {
+                        if (classDescriptor->type == ClassType::EDGE) {
+                            edgeClassIds.emplace_back(classDescriptor->id);
+                        } else if (classDescriptor->type == ClassType::VERTEX) {
+                            vertexClassIds.insert(classDescriptor->id);
+                        }
+                    }
                 }
-                auto edgeId = RecordId{
-                        static_cast<ClassId>(std::stoul(std::string{sp[0]}, nullptr, 0)),
-                        static_cast<PositionId>(std::stoul(std::string{sp[1]}, nullptr, 0))
-                };
-                // resolve a rid of source and destination vertices from a value
-                auto classId = ClassId{0};
-                auto positionId = PositionId{0};
-                auto offset = data.retrieve(&classId, 0, sizeof(ClassId));
-                offset = data.retrieve(&positionId, offset, sizeof(PositionId));
-                auto srcRid = RecordId{classId, positionId};
-                offset = data.retrieve(&classId, offset, sizeof(ClassId));
-                data.retrieve(&positionId, offset, sizeof(PositionId));
-                auto dstRid = RecordId{classId, positionId};
-                auto ptrEdgeClassDescriptor = dbSchema->find(baseTxn, edgeId.first);
-                require(ptrEdgeClassDescriptor != nullptr);
-                auto ptrSrcVertexClassDescriptor = dbSchema->find(baseTxn, srcRid.first);
-                require(ptrSrcVertexClassDescriptor != nullptr);
-                auto ptrDstVertexClassDescriptor = dbSchema->find(baseTxn, dstRid.first);
-                require(ptrDstVertexClassDescriptor != nullptr);
-                // update the relation in the graph structure
-                dbRelation->createEdge(baseTxn, edgeId, srcRid, dstRid);
+                relations = RelationSnapshot::load(envHandler.get(), rtxn, edgeClassIds, vertexClassIds,
+                                                   numLoadingThreads);
+                // update the relations in the graph structure
+                dbRelation->loadEdges(relations.partitions, baseTxn.getVersionId());
+                RecordVersion::restore(rtxn, *dbRelation);
             }
             baseTxn.commit(*this);
+            rtxn.openDbi(storage_engine::LMDBDbiRegistry::versionsKey(), true);
+            // keep all handles opened while loading in the context-wide registry
+            rtxn.commit();
         } catch (const Error &err) {
             baseTxn.rollback(*this);
             dbRelation->clear();
             dbSchema->clear();
             throw err;
         }
+        // rewrite the adjacency snapshot if too many relations had to be replayed
+        if (relations.isStale) {
+            auto stxn = storage_engine::LMDBTxn(envHandler.get(), storage_engine::lmdb::TXN_RW);
+            try {
+                RelationSnapshot::write(stxn, relations.partitions);
+                stxn.commit();
+            } catch (const Error &err) {
+                stxn.rollback();
+                dbRelation->clear();
+                dbSchema->clear();
+                throw err;
+            }
+        }
         // end of transaction
     }
 
@@ -26,6 +26,7 @@
 
 #include "nogdb_errors.h"
 #include "nogdb_types.h"
+#include "nogdb_compare.h"
 
 namespace nogdb {
 
@@ -40,6 +41,7 @@ namespace nogdb {
         metadata = rc.metadata;
         classPropertyInfos.reset(new ClassPropertyCache(*rc.classPropertyInfos));
         currentIndex = rc.currentIndex;
+        propertyNames = rc.propertyNames;
     }
 
     ResultSetCursor &ResultSetCursor::operator=(const ResultSetCursor &rc) {
@@ -48,6 +50,7 @@ namespace nogdb {
             classPropertyInfos.reset(new ClassPropertyCache(*rc.classPropertyInfos));
             metadata = rc.metadata;
             currentIndex = rc.currentIndex;
+            propertyNames = rc.propertyNames;
         }
         return *this;
     }
@@ -56,6 +59,7 @@ namespace nogdb {
         txn = rc.txn;
         metadata = std::move(rc.metadata);
         currentIndex = rc.currentIndex;
+        propertyNames = std::move(rc.propertyNames);
         classPropertyInfos = std::move(rc.classPropertyInfos);
         rc.classPropertyInfos = nullptr;
     }
@@ -65,6 +69,7 @@ namespace nogdb {
             txn = rc.txn;
             metadata = std::move(rc.metadata);
             currentIndex = rc.currentIndex;
+            propertyNames = std::move(rc.propertyNames);
             classPropertyInfos = std::move(rc.classPropertyInfos);
             rc.classPropertyInfos = nullptr;
         }
@@ -92,7 +97,7 @@ namespace nogdb {
             return false;
         }
         auto cursor = metadata.begin() + currentIndex;
-        result = Generic::getRecordResult(txn, resolveClassPropertyInfo(cursor->rid.first), *(cursor));
+        result = retrieve(*cursor);
         return true;
     }
 
@@ -105,7 +110,7 @@ namespace nogdb {
             return false;
         }
         auto cursor = metadata.begin() + currentIndex;
-        result = Generic::getRecordResult(txn, resolveClassPropertyInfo(cursor->rid.first), *(cursor));
+        result = retrieve(*cursor);
         return true;
     }
 
@@ -125,8 +130,7 @@ namespace nogdb {
         if (!metadata.empty()) {
             currentIndex = 0;
             auto cursor = metadata.begin();
-            auto classPropertyInfo = resolveClassPropertyInfo(cursor->rid.first);
-            result = Generic::getRecordResult(txn, classPropertyInfo, *(cursor));
+            result = retrieve(*cursor);
         }
     }
 
@@ -134,8 +138,7 @@ namespace nogdb {
         if (!metadata.empty()) {
             currentIndex = static_cast<long long>(metadata.size() - 1);
             auto cursor = metadata.end() - 1;
-            auto classPropertyInfo = resolveClassPropertyInfo(cursor->rid.first);
-            result = Generic::getRecordResult(txn, classPropertyInfo, *(cursor));
+            result = retrieve(*cursor);
         }
     }
 
@@ -145,8 +148,7 @@ namespace nogdb {
         }
         currentIndex = index;
         auto cursor = metadata.begin() + currentIndex;
-        auto classPropertyInfo = resolveClassPropertyInfo(cursor->rid.first);
-        result = Generic::getRecordResult(txn, classPropertyInfo, *(cursor));
+        result = retrieve(*cursor);
         return true;
     }
 
@@ -158,17 +160,27 @@ namespace nogdb {
         return &(operator*());
     }
 
-    const ClassPropertyInfo ResultSetCursor::resolveClassPropertyInfo(ClassId classId) {
-        auto classPropertyInfo = ClassPropertyInfo{};
+    ResultSetCursor &ResultSetCursor::setPropertyFilter(const PropertyFilter &propertyFilter) {
+        propertyNames = propertyFilter.getPropertyName();
+        return *this;
+    }
+
+    Result ResultSetCursor::retrieve(const RecordDescriptor &recordDescriptor) {
+        const auto &classPropertyInfo = resolveClassPropertyInfo(recordDescriptor.rid.first);
+        if (propertyNames.empty()) {
+            return Generic::getRecordResult(txn, classPropertyInfo, recordDescriptor);
+        }
+        return Generic::getRecordResult(txn, classPropertyInfo, recordDescriptor, propertyNames);
+    }
+
+    const ClassPropertyInfo &ResultSetCursor::resolveClassPropertyInfo(ClassId classId) {
         auto findCacheClassInfo = classPropertyInfos->find(classId);
         if (findCacheClassInfo == classPropertyInfos->cend()) {
             auto classDescriptor = Generic::getClassDescriptor(txn, classId, ClassType::UNDEFINED);
             auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-            classPropertyInfos->emplace(classId, classPropertyInfo);
-            return classPropertyInfo;
-        } else {
-            return findCacheClassInfo->second;
+            findCacheClassInfo = classPropertyInfos->emplace(classId, std::move(classPropertyInfo)).first;
         }
+        return findCacheClassInfo->second;
     }
 
 }
\ No newline at end of file
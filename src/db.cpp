@@ -20,12 +20,14 @@
  */
 
 #include <cstring>
+#include <vector>
 
 #include "shared_lock.hpp"
 #include "schema.hpp"
 #include "lmdb_engine.hpp"
 #include "parser.hpp"
 #include "generic.hpp"
+#include "validate.hpp"
 
 #include "nogdb.h"
 
@@ -35,12 +37,12 @@ namespace nogdb {
         auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
         auto className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(classDescriptor->id), true);
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
         auto dsResult = classDBHandler.get(recordDescriptor.rid.second);
         if (dsResult.data.empty()) {
             throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_NOEXST_RECORD);
         }
-        return Parser::parseRawDataWithBasicInfo(className, recordDescriptor.rid, dsResult, classPropertyInfo);
+        return Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, recordDescriptor.rid, dsResult, classPropertyInfo);
     }
 
     const std::vector<ClassDescriptor> Db::getSchema(const Txn &txn) {
@@ -63,6 +65,28 @@ namespace nogdb {
         return foundClass->transform(*txn.txnBase);
     }
 
+    size_t Db::upgradeRecordFormat(Txn &txn, const std::string &className) {
+        Validate::isTransactionValid(txn);
+        auto classDescriptor = Generic::getClassDescriptor(txn, className, ClassType::UNDEFINED);
+        auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+        auto positionIds = std::vector<PositionId>{};
+        {
+            auto cursorHandler = dsTxnHandler->openClassCursor(classDescriptor->id);
+            for (auto keyValue = cursorHandler.getNext(); !keyValue.empty(); keyValue = cursorHandler.getNext()) {
+                auto key = keyValue.key.data.numeric<PositionId>();
+                if (key != EM_MAXRECNUM && RecordView{keyValue.val}.isLegacyFormat()) {
+                    positionIds.emplace_back(key);
+                }
+            }
+        }
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
+        for (const auto &positionId: positionIds) {
+            auto value = Parser::upgradeRawData(RecordView{classDBHandler.get(positionId)});
+            classDBHandler.put(positionId, value);
+        }
+        return positionIds.size();
+    }
+
     const DBInfo Db::getDbInfo(const Txn &txn) {
         auto ctx = txn.txnCtx;
         if (txn.txnMode == Txn::Mode::READ_ONLY) {
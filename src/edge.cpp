@@ -19,6 +19,7 @@
  *
  */
 
+#include <iterator>
 #include <tuple>
 
 #include "shared_lock.hpp"
@@ -30,6 +31,8 @@
 #include "compare.hpp"
 #include "index.hpp"
 #include "generic.hpp"
+#include "record_version.hpp"
+#include "relation_snapshot.hpp"
 
 #include "nogdb.h"
 
@@ -51,30 +54,28 @@ namespace nogdb {
         auto value = Parser::parseRecord(*txn.txnBase, classDescriptor, record, classInfo, indexInfos);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
 
-        auto srcDBHandler = dsTxnHandler->openDbi(std::to_string(srcVertexRecordDescriptor.rid.first), true);
+        auto srcDBHandler = dsTxnHandler->openClassDbi(srcVertexRecordDescriptor.rid.first);
         auto srcKeyValue = srcDBHandler.get(srcVertexRecordDescriptor.rid.second);
         if (srcKeyValue.data.empty()) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_SRC);
         }
-        auto dstDBHandler = dsTxnHandler->openDbi(std::to_string(dstVertexRecordDescriptor.rid.first), true);
+        auto dstDBHandler = dsTxnHandler->openClassDbi(dstVertexRecordDescriptor.rid.first);
         auto dstKeyValue = dstDBHandler.get(dstVertexRecordDescriptor.rid.second);
         if (dstKeyValue.data.empty()) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_DST);
         }
 
         // update src and dst version
-        Vertex::update(txn, srcVertexRecordDescriptor, Db::getRecord(txn, srcVertexRecordDescriptor.rid));
-        Vertex::update(txn, dstVertexRecordDescriptor, Db::getRecord(txn, dstVertexRecordDescriptor.rid));
+        RecordVersion::bump(*txn.txnBase, srcVertexRecordDescriptor.rid);
+        RecordVersion::bump(*txn.txnBase, dstVertexRecordDescriptor.rid);
 
         // set version
         record.setBasicInfo(TXN_VERSION, txn.getVersionId());
         record.setBasicInfo(VERSION_PROPERTY, 1ULL);
 
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(classDescriptor->id), true);
-        auto dsResult = classDBHandler.get(EM_MAXRECNUM);
-        auto maxRecordNum = dsResult.data.numeric<PositionId>();
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
+        auto const maxRecordNum = txn.txnBase->allocatePositionId(classDescriptor->id);
         classDBHandler.put(maxRecordNum, value, true);
-        classDBHandler.put(EM_MAXRECNUM, PositionId{maxRecordNum + 1});
 
         // add index if applied
         for (const auto &indexInfo: indexInfos) {
@@ -92,7 +93,7 @@ namespace nogdb {
         edgeRecord.append(&dstVertexRecordDescriptor.rid.first, sizeof(ClassId));
         edgeRecord.append(&dstVertexRecordDescriptor.rid.second, sizeof(PositionId));
         auto key = RecordId{classDescriptor->id, maxRecordNum};
-        relationDBHandler.put(rid2str(key), edgeRecord);
+        relationDBHandler.put(rid2key(key), edgeRecord);
 
         // update in-memory relations
         txn.txnCtx.dbRelation->createEdge(*txn.txnBase, key, srcVertexRecordDescriptor.rid,
@@ -113,7 +114,7 @@ namespace nogdb {
         auto value = Parser::parseRecord(*txn.txnBase, classDescriptor, record, classInfo, indexInfos);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
 
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(classDescriptor->id), true);
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
         auto keyValue = classDBHandler.get(recordDescriptor.rid.second);
         if (keyValue.data.empty()) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_EDGE);
@@ -158,18 +159,24 @@ namespace nogdb {
         classDBHandler.put(recordDescriptor.rid.second, value);
     }
 
+    void Edge::patch(Txn &txn, const RecordDescriptor &recordDescriptor, const Record &record) {
+        Generic::patchRecord(txn, ClassType::EDGE, recordDescriptor, record);
+    }
+
+    Bytes Edge::increment(Txn &txn, const RecordDescriptor &recordDescriptor, const std::string &propertyName,
+                          int64_t delta) {
+        return Generic::incrementProperty(txn, ClassType::EDGE, recordDescriptor, propertyName, delta);
+    }
+
     void Edge::destroy(Txn &txn, const RecordDescriptor &recordDescriptor) {
         // transaction validations
         Validate::isTransactionValid(txn);
 
         try {
             // update src and dst version
-            ResultSet srcDst = Edge::getSrcDst(txn, recordDescriptor);
-            Result src = srcDst[0], dst = srcDst[1];
-
-            Vertex::update(txn, src.descriptor, src.record);
-            Vertex::update(txn, dst.descriptor, dst.record);
-
+            auto srcDst = txn.txnCtx.dbRelation->getVertexSrcDst(*txn.txnBase, recordDescriptor.rid);
+            RecordVersion::bump(*txn.txnBase, srcDst.first);
+            RecordVersion::bump(*txn.txnBase, srcDst.second);
         } catch (const Error &err) {
             // do nothing
         }
@@ -179,9 +186,10 @@ namespace nogdb {
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
 
         auto relationDBHandler = dsTxnHandler->openDbi(TB_RELATIONS);
-        relationDBHandler.del(rid2str(recordDescriptor.rid));
+        relationDBHandler.del(rid2key(recordDescriptor.rid));
+        RelationSnapshot::markDirty(*txn.txnBase, recordDescriptor.rid);
 
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(classDescriptor->id), true);
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
         // delete index if existing
         auto dsResult = classDBHandler.get(recordDescriptor.rid.second);
         if (!dsResult.data.empty()) {
@@ -256,7 +264,7 @@ namespace nogdb {
                 case PropertyType::UNSIGNED_SMALLINT:
                 case PropertyType::UNSIGNED_INTEGER:
                 case PropertyType::UNSIGNED_BIGINT: {
-                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingName(indexId), true, isUnique);
+                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingKey(indexId), true, isUnique);
                     dataIndexDBHandler.drop();
                     break;
                 }
@@ -265,14 +273,14 @@ namespace nogdb {
                 case PropertyType::INTEGER:
                 case PropertyType::BIGINT:
                 case PropertyType::REAL: {
-                    auto dataIndexDBHandlerPositive = dsTxnHandler->openDbi(Index::getIndexingName(indexId, true), true, isUnique);
-                    auto dataIndexDBHandlerNegative = dsTxnHandler->openDbi(Index::getIndexingName(indexId, false), true, isUnique);
+                    auto dataIndexDBHandlerPositive = dsTxnHandler->openDbi(Index::getIndexingKey(indexId, true), true, isUnique);
+                    auto dataIndexDBHandlerNegative = dsTxnHandler->openDbi(Index::getIndexingKey(indexId, false), true, isUnique);
                     dataIndexDBHandlerPositive.drop();
                     dataIndexDBHandlerNegative.drop();
                     break;
                 }
                 case PropertyType::TEXT: {
-                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingName(indexId), false, isUnique);
+                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingKey(indexId), false, isUnique);
                     dataIndexDBHandler.drop();
                     break;
                 }
@@ -282,7 +290,7 @@ namespace nogdb {
         }
 
         // remove all records in database
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(classDescriptor->id), true);
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
         auto cursorHandler = dsTxnHandler->openCursor(classDBHandler);
         auto relationDBHandler = dsTxnHandler->openDbi(TB_RELATIONS);
         auto keyValue = cursorHandler.getNext();
@@ -291,26 +299,25 @@ namespace nogdb {
             if (key != EM_MAXRECNUM) {
                 auto recordDescriptor = RecordDescriptor{classDescriptor->id, key};
                 recordIds.push_back(recordDescriptor.rid);
-                // delete from relations
-                relationDBHandler.del(rid2str(recordDescriptor.rid));
-
                 // update src and dst version
                 try {
-                    auto res = getSrcDst(txn, recordDescriptor);
-                    Result src = res[0], dst = res[1];
-
-                    Vertex::update(txn, src.descriptor, src.record);
-                    Vertex::update(txn, dst.descriptor, src.record);
+                    auto srcDst = txn.txnCtx.dbRelation->getVertexSrcDst(*txn.txnBase, recordDescriptor.rid);
+                    RecordVersion::bump(*txn.txnBase, srcDst.first);
+                    RecordVersion::bump(*txn.txnBase, srcDst.second);
                 } catch (const Error& err) {
                     // do nothing
                 }
 
+                // delete from relations
+                relationDBHandler.del(rid2key(recordDescriptor.rid));
             }
             keyValue = cursorHandler.getNext();
         }
 
-        // empty a database
+        // empty a database, keeping the position counter so that positions are not reused
+        txn.txnBase->getNextPositionId(classDescriptor->id);
         classDBHandler.drop();
+        RelationSnapshot::invalidate(*txn.txnBase);
 
         // update in-memory relations
         for (const auto &recordId: recordIds) {
@@ -326,16 +333,15 @@ namespace nogdb {
 
         // update source
         try {
-            Result currentSrc = getSrc(txn, recordDescriptor);
-            Vertex::update(txn, currentSrc.descriptor, currentSrc.record);
+            auto currentSrc = txn.txnCtx.dbRelation->getVertexSrc(*txn.txnBase, recordDescriptor.rid);
+            RecordVersion::bump(*txn.txnBase, currentSrc);
         } catch (const Error &err) {
             // do nothing
         }
 
         // update new source
         try {
-            Record newSrcRecord = Db::getRecord(txn, newSrcVertexRecordDescriptor);
-            Vertex::update(txn, newSrcVertexRecordDescriptor, newSrcRecord);
+            RecordVersion::bump(*txn.txnBase, newSrcVertexRecordDescriptor.rid);
         } catch (const Error &err) {
             // do nothing
         }
@@ -344,17 +350,17 @@ namespace nogdb {
         auto vertexDescriptor = Generic::getClassDescriptor(txn, newSrcVertexRecordDescriptor.rid.first,
                                                             ClassType::VERTEX);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(classDescriptor->id), true);
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
         auto dsResult = classDBHandler.get(recordDescriptor.rid.second);
         if (dsResult.data.empty()) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_EDGE);
         }
-        auto srcDBHandler = dsTxnHandler->openDbi(std::to_string(newSrcVertexRecordDescriptor.rid.first), true);
+        auto srcDBHandler = dsTxnHandler->openClassDbi(newSrcVertexRecordDescriptor.rid.first);
         dsResult = srcDBHandler.get(newSrcVertexRecordDescriptor.rid.second);
         if (dsResult.data.empty()) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_SRC);
         }
-        auto key = rid2str(recordDescriptor.rid);
+        auto key = rid2key(recordDescriptor.rid);
         auto relationDBHandler = dsTxnHandler->openDbi(TB_RELATIONS);
         dsResult = relationDBHandler.get(key);
         auto data = dsResult.data.blob();
@@ -368,6 +374,7 @@ namespace nogdb {
         edge.append(&dstClassId, sizeof(ClassId));
         edge.append(&dstPositionId, sizeof(PositionId));
         relationDBHandler.put(key, edge);
+        RelationSnapshot::markDirty(*txn.txnBase, recordDescriptor.rid);
 
         // update in-memory relations
         txn.txnCtx.dbRelation->alterVertexSrc(*txn.txnBase, recordDescriptor.rid, newSrcVertexRecordDescriptor.rid);
@@ -381,17 +388,17 @@ namespace nogdb {
         auto classDescriptor = Generic::getClassDescriptor(txn, recordDescriptor.rid.first, ClassType::EDGE);
         auto vertexDescriptor = Generic::getClassDescriptor(txn, newDstVertexDescriptor.rid.first, ClassType::VERTEX);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(classDescriptor->id), true);
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
         auto dsResult = classDBHandler.get(recordDescriptor.rid.second);
         if (dsResult.data.empty()) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_EDGE);
         }
-        auto srcDBHandler = dsTxnHandler->openDbi(std::to_string(newDstVertexDescriptor.rid.first), true);
+        auto srcDBHandler = dsTxnHandler->openClassDbi(newDstVertexDescriptor.rid.first);
         dsResult = srcDBHandler.get(newDstVertexDescriptor.rid.second);
         if (dsResult.data.empty()) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_DST);
         }
-        auto key = rid2str(recordDescriptor.rid);
+        auto key = rid2key(recordDescriptor.rid);
         auto relationDBHandler = dsTxnHandler->openDbi(TB_RELATIONS);
         dsResult = relationDBHandler.get(key);
         auto data = dsResult.data.blob();
@@ -405,6 +412,7 @@ namespace nogdb {
         edge.append(&newDstVertexDescriptor.rid.first, sizeof(ClassId));
         edge.append(&newDstVertexDescriptor.rid.second, sizeof(PositionId));
         relationDBHandler.put(key, edge);
+        RelationSnapshot::markDirty(*txn.txnBase, recordDescriptor.rid);
 
         // update in-memory relations
         txn.txnCtx.dbRelation->alterVertexDst(*txn.txnBase, recordDescriptor.rid, newDstVertexDescriptor.rid);
@@ -418,7 +426,7 @@ namespace nogdb {
             auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
             auto classInfo = ClassInfo{classDescriptor->id, className, classPropertyInfo};
             auto partial = Generic::getRecordFromClassInfo(txn, classInfo);
-            result.insert(result.end(), partial.cbegin(), partial.cend());
+            result.insert(result.end(), std::make_move_iterator(partial.begin()), std::make_move_iterator(partial.end()));
         }
         return result;
     }
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "flusher.hpp"
+
+namespace nogdb {
+
+    Flusher::Flusher(const std::shared_ptr<storage_engine::LMDBEnv> &env_, unsigned int intervalMs_)
+            : env{env_}, interval{intervalMs_} {
+        worker = std::thread{&Flusher::run, this};
+    }
+
+    Flusher::~Flusher() noexcept {
+        {
+            std::lock_guard<std::mutex> _(mutex);
+            isStopping = true;
+        }
+        condition.notify_one();
+        worker.join();
+        try { env->sync(); } catch (...) {}
+    }
+
+    void Flusher::run() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (condition.wait_for(lock, interval, [this]() { return isStopping; })) {
+                    return;
+                }
+            }
+            // a failed flush leaves the data in the OS buffers, the next round retries it
+            try { env->sync(); } catch (...) {}
+        }
+    }
+
+}
@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __FLUSHER_HPP_INCLUDED_
+#define __FLUSHER_HPP_INCLUDED_
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "storage_engine.hpp"
+
+namespace nogdb {
+
+    // Flushes the environment to disk in a background thread, bounding what a system crash may lose when commits
+    // do not flush by themselves.
+    class Flusher {
+    public:
+        Flusher(const std::shared_ptr<storage_engine::LMDBEnv> &env_, unsigned int intervalMs_);
+
+        // flushes once more before stopping
+        ~Flusher() noexcept;
+
+        Flusher(const Flusher &) = delete;
+
+        Flusher &operator=(const Flusher &) = delete;
+
+    private:
+        std::shared_ptr<storage_engine::LMDBEnv> env;
+        std::chrono::milliseconds interval;
+
+        std::mutex mutex{};
+        std::condition_variable condition{};
+        bool isStopping{false};
+
+        std::thread worker;
+
+        void run();
+    };
+
+}
+
+#endif
@@ -19,18 +19,23 @@
  *
  */
 
+#include <algorithm>
 #include <iostream> // for debugging
+#include <limits>
 #include <map>
 #include <unordered_map>
 #include <vector>
 #include <utility>
 #include <set>
 #include <queue>
+#include <tuple>
 
 #include "datatype.hpp"
 #include "constant.hpp"
 #include "lmdb_engine.hpp"
 #include "parser.hpp"
+#include "index.hpp"
+#include "record_version.hpp"
 #include "generic.hpp"
 #include "schema.hpp"
 #include "utils.hpp"
@@ -38,16 +43,87 @@
 #include "nogdb_errors.h"
 
 namespace nogdb {
+
+    namespace {
+
+        template<typename T>
+        Bytes incrementSigned(const Bytes &value, int64_t delta) {
+            auto const current = static_cast<int64_t>(value.empty() ? T{} : value.convert<T>());
+            if ((delta > 0 && current > std::numeric_limits<T>::max() - delta) ||
+                (delta < 0 && current < std::numeric_limits<T>::min() - delta)) {
+                throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_OUT_OF_RANGE_VALUE);
+            }
+            return Bytes{static_cast<T>(current + delta)};
+        }
+
+        template<typename T>
+        Bytes incrementUnsigned(const Bytes &value, int64_t delta) {
+            auto const current = static_cast<uint64_t>(value.empty() ? T{} : value.convert<T>());
+            if (delta >= 0) {
+                if (static_cast<uint64_t>(delta) > std::numeric_limits<T>::max() - current) {
+                    throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_OUT_OF_RANGE_VALUE);
+                }
+                return Bytes{static_cast<T>(current + static_cast<uint64_t>(delta))};
+            }
+            auto const magnitude = static_cast<uint64_t>(-(delta + 1)) + 1;
+            if (magnitude > current) {
+                throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_OUT_OF_RANGE_VALUE);
+            }
+            return Bytes{static_cast<T>(current - magnitude)};
+        }
+
+        Bytes increment(const Bytes &value, PropertyType type, int64_t delta) {
+            switch (type) {
+                case PropertyType::TINYINT:
+                    return incrementSigned<int8_t>(value, delta);
+                case PropertyType::UNSIGNED_TINYINT:
+                    return incrementUnsigned<uint8_t>(value, delta);
+                case PropertyType::SMALLINT:
+                    return incrementSigned<int16_t>(value, delta);
+                case PropertyType::UNSIGNED_SMALLINT:
+                    return incrementUnsigned<uint16_t>(value, delta);
+                case PropertyType::INTEGER:
+                    return incrementSigned<int32_t>(value, delta);
+                case PropertyType::UNSIGNED_INTEGER:
+                    return incrementUnsigned<uint32_t>(value, delta);
+                case PropertyType::BIGINT:
+                    return incrementSigned<int64_t>(value, delta);
+                case PropertyType::UNSIGNED_BIGINT:
+                    return incrementUnsigned<uint64_t>(value, delta);
+                case PropertyType::REAL:
+                    return Bytes{(value.empty() ? 0.0 : value.toReal()) + static_cast<double>(delta)};
+                default:
+                    throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_INVALID_PROPTYPE);
+            }
+        }
+
+    }
     Result Generic::getRecordResult(Txn &txn, const ClassPropertyInfo &classPropertyInfo,
                                     const RecordDescriptor &recordDescriptor) {
         auto classDescriptor = getClassDescriptor(txn, recordDescriptor.rid.first, ClassType::UNDEFINED);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(recordDescriptor.rid.first), true);
+        auto classDBHandler = dsTxnHandler->openClassDbi(recordDescriptor.rid.first);
         auto dsResult = classDBHandler.get(recordDescriptor.rid.second);
         auto className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
-        auto record = Parser::parseRawDataWithBasicInfo(className, recordDescriptor.rid, dsResult, classPropertyInfo);
+        auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, recordDescriptor.rid, dsResult, classPropertyInfo);
         record.setBasicInfo(DEPTH_PROPERTY, recordDescriptor.depth);
-        return Result{recordDescriptor, record};
+        return Result{recordDescriptor, std::move(record)};
+    }
+
+    Result Generic::getRecordResult(Txn &txn, const ClassPropertyInfo &classPropertyInfo,
+                                    const RecordDescriptor &recordDescriptor,
+                                    const std::set<std::string> &propertyNames) {
+        auto classDescriptor = getClassDescriptor(txn, recordDescriptor.rid.first, ClassType::UNDEFINED);
+        auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+        auto classDBHandler = dsTxnHandler->openClassDbi(recordDescriptor.rid.first);
+        auto recordView = RecordView{classDBHandler.get(recordDescriptor.rid.second)};
+        auto className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
+        auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, recordDescriptor.rid, recordView,
+                                                        classPropertyInfo, propertyNames);
+        if (propertyNames.find(DEPTH_PROPERTY) != propertyNames.cend()) {
+            record.setBasicInfo(DEPTH_PROPERTY, recordDescriptor.depth);
+        }
+        return Result{recordDescriptor, std::move(record)};
     }
 
     ResultSet Generic::getRecordFromRdesc(const Txn &txn, const RecordDescriptor &recordDescriptor) {
@@ -55,12 +131,12 @@ namespace nogdb {
         auto classDescriptor = getClassDescriptor(txn, recordDescriptor.rid.first, ClassType::UNDEFINED);
         auto classPropertyInfo = getClassMapProperty(*txn.txnBase, classDescriptor);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(recordDescriptor.rid.first), true);
+        auto classDBHandler = dsTxnHandler->openClassDbi(recordDescriptor.rid.first);
         auto dsResult = classDBHandler.get(recordDescriptor.rid.second);
         auto className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
-        auto record = Parser::parseRawDataWithBasicInfo(className, recordDescriptor.rid, dsResult, classPropertyInfo);
+        auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, recordDescriptor.rid, dsResult, classPropertyInfo);
         record.setBasicInfo(DEPTH_PROPERTY, recordDescriptor.depth);
-        result.emplace_back(Result{recordDescriptor, record});
+        result.emplace_back(Result{recordDescriptor, std::move(record)});
         return result;
     }
 
@@ -73,11 +149,27 @@ namespace nogdb {
             auto classDescriptor = getClassDescriptor(txn, classId, ClassType::UNDEFINED);
             auto classPropertyInfo = getClassMapProperty(*txn.txnBase, classDescriptor);
             auto className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
-            auto classDBHandler = dsTxnHandler->openDbi( std::to_string(classId), true);
+            auto classDBHandler = dsTxnHandler->openClassDbi(classId);
             for (const auto &recordDescriptor: recordDescriptors) {
                 auto dsResult = classDBHandler.get(recordDescriptor.rid.second);
-                auto record = Parser::parseRawDataWithBasicInfo(className, recordDescriptor.rid, dsResult, classPropertyInfo);
-                result.emplace_back(Result{recordDescriptor, record});
+                auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, recordDescriptor.rid, dsResult, classPropertyInfo);
+                result.emplace_back(Result{recordDescriptor, std::move(record)});
+            }
+        }
+        return result;
+    }
+
+    ResultSet Generic::getMultipleRecordFromRdesc(const Txn &txn, const ClassInfo &classInfo,
+                                                  const std::vector<RecordDescriptor> &recordDescriptors) {
+        auto result = ResultSet{};
+        if (!recordDescriptors.empty()) {
+            auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+            auto classDBHandler = dsTxnHandler->openClassDbi(classInfo.id);
+            for (const auto &recordDescriptor: recordDescriptors) {
+                auto dsResult = classDBHandler.get(recordDescriptor.rid.second);
+                auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, classInfo.name, recordDescriptor.rid, dsResult,
+                                                                classInfo.propertyInfo);
+                result.emplace_back(Result{recordDescriptor, std::move(record)});
             }
         }
         return result;
@@ -86,14 +178,14 @@ namespace nogdb {
     ResultSet Generic::getRecordFromClassInfo(const Txn &txn, const ClassInfo &classInfo) {
         auto result = ResultSet{};
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-        auto cursorHandler = dsTxnHandler->openCursor(std::to_string(classInfo.id), true);
+        auto cursorHandler = dsTxnHandler->openClassCursor(classInfo.id);
         auto keyValue = cursorHandler.getNext();
         while (!keyValue.empty()) {
             auto key = keyValue.key.data.numeric<PositionId>();
             if (key != EM_MAXRECNUM) {
                 auto rid = RecordId{classInfo.id, key};
-                auto record = Parser::parseRawDataWithBasicInfo(classInfo.name, rid, keyValue.val, classInfo.propertyInfo);
-                result.push_back(Result{RecordDescriptor{rid}, record});
+                auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, classInfo.name, rid, keyValue.val, classInfo.propertyInfo);
+                result.push_back(Result{RecordDescriptor{rid}, std::move(record)});
             }
             keyValue = cursorHandler.getNext();
         }
@@ -103,7 +195,7 @@ namespace nogdb {
     std::vector<RecordDescriptor> Generic::getRdescFromClassInfo(Txn &txn, const ClassInfo &classInfo) {
         auto result = std::vector<RecordDescriptor>{};
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-        auto cursorHandler = dsTxnHandler->openCursor(std::to_string(classInfo.id), true);
+        auto cursorHandler = dsTxnHandler->openClassCursor(classInfo.id);
         auto keyValue = cursorHandler.getNext();
         while (!keyValue.empty()) {
             auto key = keyValue.key.data.numeric<PositionId>();
@@ -146,12 +238,12 @@ namespace nogdb {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = dsTxnHandler->openDbi( std::to_string(edge.first), true);
+                            classDBHandler = dsTxnHandler->openClassDbi(edge.first);
                             className = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         }
                         auto dsResult = classDBHandler.get(edge.second);
-                        auto record = Parser::parseRawDataWithBasicInfo(className, edge, dsResult, classPropertyInfo);
-                        result.push_back(Result{RecordDescriptor{edge}, record});
+                        auto record = Parser::parseRawDataWithBasicInfo(*txn.txnBase, className, edge, dsResult, classPropertyInfo);
+                        result.push_back(Result{RecordDescriptor{edge}, std::move(record)});
                     };
                     if (edgeClassIds.empty()) {
                         for (const auto &edge: ((*txn.txnCtx.dbRelation).*func)(*txn.txnBase, recordDescriptor.rid, 0)) {
@@ -216,14 +308,14 @@ namespace nogdb {
             return RECORD_EXIST;
         } else {
             auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-            auto classDBHandler = dsTxnHandler->openDbi(std::to_string(recordDescriptor.rid.first), true);
+            auto classDBHandler = dsTxnHandler->openClassDbi(recordDescriptor.rid.first);
             auto dsResult = classDBHandler.get(recordDescriptor.rid.second);
             return (dsResult.data.empty()) ? RECORD_NOT_EXIST : RECORD_NOT_EXIST_IN_MEMORY;
         }
     }
 
-    std::set<Schema::ClassDescriptorPtr>
-    Generic::getClassExtend(const BaseTxn &txn, const std::set<Schema::ClassDescriptorPtr> &classDescriptors) {
+    Schema::ClassDescriptorPtrSet
+    Generic::getClassExtend(const BaseTxn &txn, const Schema::ClassDescriptorPtrSet &classDescriptors) {
         auto subClasses = classDescriptors;
         std::function<void(const Schema::ClassDescriptorPtr &classDescriptor)>
                 resolveSubclass = [&txn, &subClasses, &resolveSubclass](
@@ -244,6 +336,7 @@ namespace nogdb {
     const ClassPropertyInfo
     Generic::getClassMapProperty(const BaseTxn &txn, const Schema::ClassDescriptorPtr &classDescriptor) {
         auto classPropertyInfo = ClassPropertyInfo{};
+        classPropertyInfo.classType = classDescriptor->type;
         classPropertyInfo.insert(CLASS_NAME_PROPERTY_ID, CLASS_NAME_PROPERTY, PropertyType::TEXT);
         classPropertyInfo.insert(RECORD_ID_PROPERTY_ID, RECORD_ID_PROPERTY, PropertyType::TEXT);
         classPropertyInfo.insert(DEPTH_PROPERTY_ID, DEPTH_PROPERTY, PropertyType::UNSIGNED_INTEGER);
@@ -269,9 +362,9 @@ namespace nogdb {
         return classPropertyInfo;
     }
 
-    std::set<Schema::ClassDescriptorPtr>
+    Schema::ClassDescriptorPtrSet
     Generic::getMultipleClassDescriptor(const Txn &txn, const std::vector<ClassId> &classIds, const ClassType &type) {
-        auto setOfClassDescriptors = std::set<Schema::ClassDescriptorPtr>();
+        auto setOfClassDescriptors = Schema::ClassDescriptorPtrSet();
         if (!classIds.empty()) {
             for (const auto &classId: classIds) {
                 if (classId > 0) {
@@ -281,12 +374,12 @@ namespace nogdb {
             // check inheritance before return
             return getClassExtend(*txn.txnBase, setOfClassDescriptors);
         }
-        return std::set<Schema::ClassDescriptorPtr>{};
+        return Schema::ClassDescriptorPtrSet{};
     }
 
-    std::set<Schema::ClassDescriptorPtr>
+    Schema::ClassDescriptorPtrSet
     Generic::getMultipleClassDescriptor(const Txn &txn, const std::set<std::string> &className, const ClassType &type) {
-        auto setOfClassDescriptors = std::set<Schema::ClassDescriptorPtr>();
+        auto setOfClassDescriptors = Schema::ClassDescriptorPtrSet();
         if (!className.empty()) {
             for (const auto &name: className) {
                 if (name.length() > 0) {
@@ -296,12 +389,12 @@ namespace nogdb {
             // check inheritance before return
             return getClassExtend(*txn.txnBase, setOfClassDescriptors);
         }
-        return std::set<Schema::ClassDescriptorPtr>{};
+        return Schema::ClassDescriptorPtrSet{};
     }
 
     std::vector<ClassInfo>
     Generic::getMultipleClassMapProperty(const BaseTxn &txn,
-                                         const std::set<Schema::ClassDescriptorPtr> &classDescriptors) {
+                                         const Schema::ClassDescriptorPtrSet &classDescriptors) {
         auto result = std::vector<ClassInfo> {};
         if (!classDescriptors.empty()) {
             for (const auto &classDescriptor: classDescriptors) {
@@ -317,4 +410,97 @@ namespace nogdb {
         return result;
     }
 
+    void Generic::patchRecord(Txn &txn, ClassType type, const RecordDescriptor &recordDescriptor,
+                              const Record &record) {
+        Validate::isTransactionValid(txn);
+        auto classDescriptor = getClassDescriptor(txn, recordDescriptor.rid.first, type);
+        auto classInfo = getClassMapProperty(*txn.txnBase, classDescriptor);
+        patchRecord(txn, classDescriptor, classInfo, recordDescriptor, record.getAll());
+    }
+
+    Bytes Generic::incrementProperty(Txn &txn, ClassType type, const RecordDescriptor &recordDescriptor,
+                                     const std::string &propertyName, int64_t delta) {
+        Validate::isTransactionValid(txn);
+        auto classDescriptor = getClassDescriptor(txn, recordDescriptor.rid.first, type);
+        auto classInfo = getClassMapProperty(*txn.txnBase, classDescriptor);
+        auto foundProperty = classInfo.nameToDesc.find(propertyName);
+        if (Parser::isBasicInfo(propertyName) || foundProperty == classInfo.nameToDesc.cend()) {
+            throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_NOEXST_PROPERTY);
+        }
+        auto dsResult = txn.txnBase->getDsTxnHandler()->openClassDbi(classDescriptor->id).get(recordDescriptor.rid.second);
+        auto value = Bytes{};
+        if (!dsResult.data.empty()) {
+            value = increment(RecordView{dsResult}.get(foundProperty->second.id), foundProperty->second.type, delta);
+        }
+        patchRecord(txn, classDescriptor, classInfo, recordDescriptor, Record::PropertyToBytesMap{{propertyName, value}});
+        return value;
+    }
+
+    void Generic::patchRecord(Txn &txn, const Schema::ClassDescriptorPtr &classDescriptor,
+                              const ClassPropertyInfo &classInfo, const RecordDescriptor &recordDescriptor,
+                              const Record::PropertyToBytesMap &properties) {
+        auto const &rid = recordDescriptor.rid;
+        // a version bumped by edge operations takes precedence over the one stored in the record
+        auto version = RecordVersion::find(*txn.txnBase, rid, classDescriptor->type);
+        auto classDBHandler = txn.txnBase->getDsTxnHandler()->openClassDbi(classDescriptor->id);
+        auto dsResult = classDBHandler.get(rid.second);
+        if (dsResult.data.empty()) {
+            if (classDescriptor->type == ClassType::VERTEX) {
+                throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_VERTEX);
+            }
+            throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_EDGE);
+        }
+
+        // NOTE: the stored bytes are only valid until the next write, so read everything needed beforehand
+        auto recordView = RecordView{dsResult};
+        auto changes = std::map<PropertyId, Bytes>{};
+        auto indexChanges = std::vector<std::tuple<const PropertyDescriptor *, Bytes, Bytes>>{};
+        for (const auto &property: properties) {
+            auto foundProperty = classInfo.nameToDesc.find(property.first);
+            if (foundProperty == classInfo.nameToDesc.cend()) {
+                throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_NOEXST_PROPERTY);
+            }
+            auto existingValue = recordView.get(foundProperty->second.id);
+            if (existingValue.size() == property.second.size() &&
+                std::equal(property.second.getRaw(), property.second.getRaw() + property.second.size(),
+                           existingValue.getRaw())) {
+                continue;
+            }
+            indexChanges.emplace_back(&foundProperty->second, std::move(existingValue), property.second);
+            changes.emplace(foundProperty->second.id, property.second);
+        }
+        if (!version.second) {
+            auto storedVersion = recordView.get(VERSION_PROPERTY_ID);
+            auto storedTxnVersion = recordView.get(TXN_VERSION_ID);
+            version.first.first = storedVersion.empty() ? 0ULL : storedVersion.toBigIntU();
+            version.first.second = storedTxnVersion.empty() ? 0ULL : storedTxnVersion.toBigIntU();
+        }
+        if (version.first.second != txn.getVersionId()) {
+            changes[VERSION_PROPERTY_ID] = Bytes{static_cast<uint64_t>(version.first.first + 1ULL)};
+            changes[TXN_VERSION_ID] = Bytes{static_cast<uint64_t>(txn.getVersionId())};
+        } else if (version.second) {
+            changes[VERSION_PROPERTY_ID] = Bytes{static_cast<uint64_t>(version.first.first)};
+            changes[TXN_VERSION_ID] = Bytes{static_cast<uint64_t>(version.first.second)};
+        }
+        auto value = Parser::mergeRawData(recordView, changes);
+
+        for (const auto &indexChange: indexChanges) {
+            auto const &propertyDescriptor = *std::get<0>(indexChange);
+            for (const auto &indexIter: propertyDescriptor.indexInfo) {
+                if (indexIter.second.first == classDescriptor->id) {
+                    Index::deleteIndex(*txn.txnBase, indexIter.first, rid.second, std::get<1>(indexChange),
+                                       propertyDescriptor.type, indexIter.second.second);
+                    Index::addIndex(*txn.txnBase, indexIter.first, rid.second, std::get<2>(indexChange),
+                                    propertyDescriptor.type, indexIter.second.second);
+                    break;
+                }
+            }
+        }
+        classDBHandler.put(rid.second, value);
+        if (version.second) {
+            // the stored record now carries the latest version
+            RecordVersion::remove(*txn.txnBase, rid);
+        }
+    }
+
 }
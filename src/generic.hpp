@@ -64,11 +64,19 @@ namespace nogdb {
                                       const ClassPropertyInfo &classPropertyInfo,
                                       const RecordDescriptor &recordDescriptor);
 
+        static Result getRecordResult(Txn &txn,
+                                      const ClassPropertyInfo &classPropertyInfo,
+                                      const RecordDescriptor &recordDescriptor,
+                                      const std::set<std::string> &propertyNames);
+
         static ResultSet getRecordFromRdesc(const Txn &txn, const RecordDescriptor &recordDescriptor);
 
         static ResultSet
         getMultipleRecordFromRdesc(const Txn &txn, const std::vector<RecordDescriptor> &recordDescriptors);
 
+        static ResultSet getMultipleRecordFromRdesc(const Txn &txn, const ClassInfo &classInfo,
+                                                    const std::vector<RecordDescriptor> &recordDescriptors);
+
         static ResultSet getRecordFromClassInfo(const Txn &txn, const ClassInfo &classInfo);
 
         static std::vector<RecordDescriptor> getRdescFromClassInfo(Txn &txn, const ClassInfo &classInfo);
@@ -92,20 +100,32 @@ namespace nogdb {
 
         static std::vector<ClassId> getEdgeClassId(const Txn &txn, const std::set<std::string> &className);
 
-        static std::set<Schema::ClassDescriptorPtr>
-        getClassExtend(const BaseTxn &txn, const std::set<Schema::ClassDescriptorPtr> &classDescriptors);
+        static Schema::ClassDescriptorPtrSet
+        getClassExtend(const BaseTxn &txn, const Schema::ClassDescriptorPtrSet &classDescriptors);
 
         static const ClassPropertyInfo
         getClassMapProperty(const BaseTxn &txn, const Schema::ClassDescriptorPtr &classDescriptor);
 
-        static std::set<Schema::ClassDescriptorPtr>
+        static Schema::ClassDescriptorPtrSet
         getMultipleClassDescriptor(const Txn &txn, const std::vector<ClassId> &classIds, const ClassType &type);
 
-        static std::set<Schema::ClassDescriptorPtr>
+        static Schema::ClassDescriptorPtrSet
         getMultipleClassDescriptor(const Txn &txn, const std::set<std::string> &className, const ClassType &type);
 
         static std::vector<ClassInfo>
-        getMultipleClassMapProperty(const BaseTxn &txn, const std::set<Schema::ClassDescriptorPtr> &classDescriptors);
+        getMultipleClassMapProperty(const BaseTxn &txn, const Schema::ClassDescriptorPtrSet &classDescriptors);
+
+        // merges the given properties into a stored record, maintaining only the indexes of changed values
+        static void patchRecord(Txn &txn, ClassType type, const RecordDescriptor &recordDescriptor,
+                                const Record &record);
+
+        static Bytes incrementProperty(Txn &txn, ClassType type, const RecordDescriptor &recordDescriptor,
+                                       const std::string &propertyName, int64_t delta);
+
+    private:
+        static void patchRecord(Txn &txn, const Schema::ClassDescriptorPtr &classDescriptor,
+                                const ClassPropertyInfo &classInfo, const RecordDescriptor &recordDescriptor,
+                                const Record::PropertyToBytesMap &properties);
 
     };
 }
@@ -28,15 +28,19 @@
 #include <memory>
 #include <sstream>
 #include <utility>
+#include <tuple>
 #include <cstdint>
+#include <limits>
 #include <atomic>
 #include <thread>
+#include <list>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
+#include <functional>
 
 #include "boost/functional/hash.hpp"
-#include "multiversion_hashmap.hpp"
+#include "adjacency_list.hpp"
 #include "concurrent.hpp"
 #include "txn_object.hpp"
 
@@ -50,6 +54,9 @@ namespace nogdb {
     struct Graph {
         Graph() = default;
 
+        Graph(size_t adjacencyCacheSize_, const std::shared_ptr<TxnStat> &txnStat_)
+                : adjacencyCacheSize{adjacencyCacheSize_}, txnStat{txnStat_} {};
+
         ~Graph() noexcept = default;
 
         typedef boost::hash<RecordId> RecordIdHash;
@@ -58,37 +65,63 @@ namespace nogdb {
         using GraphElements = std::unordered_map<RecordId, std::shared_ptr<T>, RecordIdHash>;
 
         template<typename T>
-        using ConcurrentGraphElements = ConcurrentHashMap<GraphElements<T>, RecordId, T>;
-
-        struct Edge;
+        using ConcurrentGraphElements = ShardedConcurrentHashMap<RecordId, T, RecordIdHash>;
 
         struct Vertex : public TxnObject {
-            Vertex(RecordId rid_)
-                    : TxnObject{}, rid{rid_} {};
+            Vertex(RecordId rid_, bool isLoaded_ = true)
+                    : TxnObject{}, rid{rid_}, isLoaded{isLoaded_} {};
             const RecordId rid;
 
-            TwoLevelMultiVersionHashMap<ClassId, PositionId, std::weak_ptr<Edge>> in{};
-            TwoLevelMultiVersionHashMap<ClassId, PositionId, std::weak_ptr<Edge>> out{};
+            AdjacencyList in{};
+            AdjacencyList out{};
+
+            // book-keeping of a bounded adjacency cache
+            std::atomic<bool> isLoaded;             // false if in and out hold only the edges cached for neighbours
+            std::atomic<bool> isReferenced{true};   // second chance of the clock eviction
+            std::atomic<uint32_t> numPins{0};       // number of transactions which must not see it evicted
+            std::atomic<TxnId> lastModified{0};     // version of the last commit which changed in or out
+
+            // the version from which .versions holds no version bump of the vertex, the maximum if unknown,
+            // so that reading the record of a vertex which has not been bumped needs no lookup in .versions
+            std::atomic<TxnId> noVersionBumpSince{std::numeric_limits<TxnId>::max()};
         };
 
-        struct Edge : public TxnObject {
-            Edge(RecordId rid_, const std::weak_ptr<Vertex> source_, const std::weak_ptr<Vertex> target_)
-                    : TxnObject{}, rid{rid_} {
-                source.addLatestVersion(source_);
-                target.addLatestVersion(target_);
-            }
+        // an edge is kept by value in a slab indexed by its record id, its endpoints are resolved through vertices
+        // NOTE: only the latest committed state is kept, a reader of an older version follows the edge back
+        // through the adjacency deltas of its endpoints
+        struct Edge {
+            Edge() = default;
 
-            const RecordId rid;
+            Edge(const RecordId &source_, const RecordId &target_, TxnId versionId_ = 0,
+                 TxnObject::StatusFlag status_ = TxnObject::StatusFlag::UNCOMMITTED_CREATE)
+                    : source{source_}, target{target_}, versionId{versionId_}, status{status_} {};
 
-            VersionControl<std::weak_ptr<Vertex>> source{};
-            VersionControl<std::weak_ptr<Vertex>> target{};
+            RecordId source{};
+            RecordId target{};
+            TxnId versionId{0};     // of the last commit which created, moved or deleted the edge
+            TxnObject::StatusFlag status{TxnObject::StatusFlag::UNCOMMITTED_CREATE};
         };
 
         ConcurrentGraphElements<Vertex> vertices{};
-        ConcurrentGraphElements<Edge> edges{};
+        ConcurrentSlab<Edge> edges{};
         ConcurrentDeleteQueue<RecordId> deletedVertices;
         ConcurrentDeleteQueue<RecordId> deletedEdges;
 
+        // maximum number of edges kept in memory, 0 if the whole graph is kept in memory
+        // NOTE: with a bounded cache, the adjacency of a vertex is loaded from .adjacency on demand
+        // and vertices and edges in memory are evicted once no transaction can see them differently
+        const size_t adjacencyCacheSize{0};
+
+        inline bool isAdjacencyCached() const {
+            return adjacencyCacheSize != 0;
+        }
+
+        // register a vertex created by a committed transaction for eviction
+        void trackVertex(const std::shared_ptr<Vertex> &vertex);
+
+        // evict adjacency of the least recently used vertices until the cache fits its size
+        void evictAdjacency();
+
         // return false if there is an existing vertex in a graph, otherwise, true
         bool createVertex(BaseTxn &txn, const RecordId &rid);
 
@@ -96,7 +129,8 @@ namespace nogdb {
 
         void forceDeleteVertex(const RecordId &rid) noexcept;
 
-        void forceDeleteVertices(const std::vector<RecordId> &rids) noexcept;
+        // remove vertices deleted at or before versionId, leaving any newer vertex reusing the same record id
+        void forceDeleteVertices(const std::vector<RecordId> &rids, TxnId versionId) noexcept;
 
         std::vector<RecordId> getEdgeIn(const BaseTxn &txn, const RecordId &rid, const ClassId &classId = 0);
 
@@ -114,11 +148,23 @@ namespace nogdb {
 
         void createEdge(BaseTxn &txn, const RecordId &rid, const RecordId &srcRid, const RecordId &dstRid);
 
+        // create many edges given as tuples of (edge, source, destination) record ids in a single pass,
+        // the adjacency of a vertex whose record isNewVertex is built at once as in loadEdges, and the edges
+        // are added to the transaction with a single entry in its undo log
+        // NOTE: the edge record ids must not exist in a graph yet, e.g. freshly allocated by a bulk loader
+        void createEdges(BaseTxn &txn, const std::vector<std::tuple<RecordId, RecordId, RecordId>> &edgeRids,
+                         const std::function<bool(const RecordId &)> &isNewVertex);
+
+        // populate an empty graph with edges partitioned across loading threads as committed at versionId
+        // NOTE: only for the context start-up when no other transactions can see the graph yet
+        void loadEdges(const std::vector<std::vector<std::tuple<RecordId, RecordId, RecordId>>> &partitions,
+                       TxnId versionId);
+
         void deleteEdge(BaseTxn &txn, const RecordId &rid) noexcept;
 
         void forceDeleteEdge(const RecordId &rid) noexcept;
 
-        void forceDeleteEdges(const std::vector<RecordId> &rids) noexcept;
+        void forceDeleteEdges(const std::vector<RecordId> &rids, TxnId versionId) noexcept;
 
         RecordId getVertexSrc(const BaseTxn &txn, const RecordId &rid);
 
@@ -131,24 +177,100 @@ namespace nogdb {
 
         void alterVertexDst(BaseTxn &txn, const RecordId &rid, const RecordId &dstRid);
 
-        std::shared_ptr<Edge> lookupEdge(const BaseTxn &txn, const RecordId &rid);
+        // the edge as seen by a transaction, false if it is not visible
+        std::pair<Edge, bool> lookupEdge(const BaseTxn &txn, const RecordId &rid);
 
         //NOTE: should be called only when the transaction is safe.
         inline void clear() noexcept {
             edges.lockAndClear();
             vertices.lockAndClear();
+            std::lock_guard<std::mutex> _(adjacencyMutex);
+            adjacencyClock.clear();
+            adjacencyClockHand = adjacencyClock.end();
         }
 
-        inline void clearDeletedElements(TxnId versionId) {
-            forceDeleteEdges(deletedEdges.pop_front(versionId));
-            forceDeleteVertices(deletedVertices.pop_front(versionId));
+        inline size_t clearDeletedElements(TxnId versionId) {
+            auto edgeRids = deletedEdges.pop_front(versionId);
+            auto vertexRids = deletedVertices.pop_front(versionId);
+            forceDeleteEdges(edgeRids, versionId);
+            forceDeleteVertices(vertexRids, versionId);
+            return edgeRids.size() + vertexRids.size();
         }
+
+    private:
+        std::shared_ptr<TxnStat> txnStat{};
+        std::mutex adjacencyMutex{};
+        std::list<std::weak_ptr<Vertex>> adjacencyClock{};
+        std::list<std::weak_ptr<Vertex>>::iterator adjacencyClockHand{adjacencyClock.end()};
+
+        void pinVertex(const BaseTxn &txn, const std::shared_ptr<Vertex> &vertex);
+
+        // load the complete adjacency of a vertex from .adjacency into the cache
+        std::shared_ptr<Vertex> loadVertex(const BaseTxn &txn, const RecordId &rid);
+
+        // load an edge into the cache through the adjacency of its source vertex
+        std::pair<Edge, bool> loadEdge(const BaseTxn &txn, const RecordId &rid);
+
+        // the edge as seen by a transaction among the edges in memory
+        std::pair<Edge, bool> findEdge(const BaseTxn &txn, const RecordId &rid);
+
+        // the endpoint of an edge seen by a reader of versionId, which is followed back from its latest endpoint
+        // through the vertices the edge has been moved from, false if the edge did not exist at versionId
+        std::pair<RecordId, bool> traceEndpoint(const RecordId &rid, RecordId endpoint,
+                                                AdjacencyList Vertex::*direction, TxnId versionId);
+
+        // the vertex at an end of an edge in memory, which is the uncommitted one of a writer if any
+        std::shared_ptr<Vertex> findEndpointVertex(const BaseTxn &txn, const RecordId &rid);
+
+        // the endpoints an edge has been committed with, which the changes of a writer move it from
+        Edge getCommittedEdge(const Edge &edge, const RecordId &rid);
+
+        void evictAdjacencyLocked();
+
+        void demoteVertex(const std::shared_ptr<Vertex> &vertex, TxnId versionId);
+
+        void addAdjacency(const BaseTxn &txn, const RecordId &rid, const RecordId &srcRid, const RecordId &dstRid);
+
+        void removeAdjacency(const BaseTxn &txn, const RecordId &rid, const RecordId &srcRid, const RecordId &dstRid);
+
+        // changes of a writer which are logged to be undone when a savepoint is rolled back, an edge is inserted
+        // along with the vertex it has been committed at, if any, which is where a reader of an older version finds it
+        void updateAdjacency(BaseTxn &txn, const std::shared_ptr<Vertex> &vertex, AdjacencyList Vertex::*direction,
+                             const RecordId &rid, bool isInsert, const RecordId &from = RecordId{});
+
+        void updateStatus(BaseTxn &txn, const std::shared_ptr<TxnObject> &element, TxnObject::StatusFlag status);
+
+        // move an edge of the writer to another vertex at one of its ends
+        void moveEdge(BaseTxn &txn, const RecordId &rid, const RecordId &vertexRid, bool isSource);
     };
 
     inline std::string rid2str(const RecordId &rid) {
-        std::stringstream ss{};
-        ss << std::to_string(rid.first) << ":" << std::to_string(rid.second);
-        return ss.str();
+        return std::to_string(rid.first) + ":" + std::to_string(rid.second);
+    }
+
+    // NOTE: a key of .relations is a record id of an edge encoded in big-endian order
+    // so that relations of the same edge class are stored next to each other
+    struct RelationKey {
+        uint8_t bytes[sizeof(ClassId) + sizeof(PositionId)];
+    };
+
+    inline RelationKey rid2key(const RecordId &rid) {
+        auto key = RelationKey{};
+        key.bytes[0] = static_cast<uint8_t>(rid.first >> 8);
+        key.bytes[1] = static_cast<uint8_t>(rid.first);
+        key.bytes[2] = static_cast<uint8_t>(rid.second >> 24);
+        key.bytes[3] = static_cast<uint8_t>(rid.second >> 16);
+        key.bytes[4] = static_cast<uint8_t>(rid.second >> 8);
+        key.bytes[5] = static_cast<uint8_t>(rid.second);
+        return key;
+    }
+
+    inline RecordId key2rid(const RelationKey &key) {
+        return RecordId{
+                static_cast<ClassId>((static_cast<ClassId>(key.bytes[0]) << 8) | key.bytes[1]),
+                (static_cast<PositionId>(key.bytes[2]) << 24) | (static_cast<PositionId>(key.bytes[3]) << 16) |
+                (static_cast<PositionId>(key.bytes[4]) << 8) | static_cast<PositionId>(key.bytes[5])
+        };
     }
 
 }
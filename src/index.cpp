@@ -21,7 +21,10 @@
 
 #include <utility>
 #include <algorithm>
+#include <functional>
+#include <cmath>
 
+#include "constant.hpp"
 #include "index.hpp"
 #include "generic.hpp"
 #include "parser.hpp"
@@ -60,7 +63,7 @@ namespace nogdb {
                     case PropertyType::UNSIGNED_SMALLINT:
                     case PropertyType::UNSIGNED_INTEGER:
                     case PropertyType::UNSIGNED_BIGINT: {
-                        auto dataIndexDBHandler = dsTxnHandler->openDbi(getIndexingName(indexId), true, isUnique);
+                        auto dataIndexDBHandler = dsTxnHandler->openDbi(getIndexingKey(indexId), true, isUnique);
                         if (type == PropertyType::UNSIGNED_TINYINT) {
                             //NOTE: convert uint8_t to uint64_t for being compatible with all compilers
                             dataIndexDBHandler.put(static_cast<uint64_t>(bytesValue.toTinyIntU()), indexRecord, false, !isUnique);
@@ -78,8 +81,8 @@ namespace nogdb {
                     case PropertyType::INTEGER:
                     case PropertyType::BIGINT:
                     case PropertyType::REAL: {
-                        auto dataIndexDBHandlerPositive = dsTxnHandler->openDbi(getIndexingName(indexId, true), true, isUnique);
-                        auto dataIndexDBHandlerNegative = dsTxnHandler->openDbi(getIndexingName(indexId, false), true, isUnique);
+                        auto dataIndexDBHandlerPositive = dsTxnHandler->openDbi(getIndexingKey(indexId, true), true, isUnique);
+                        auto dataIndexDBHandlerNegative = dsTxnHandler->openDbi(getIndexingKey(indexId, false), true, isUnique);
                         if (type == PropertyType::TINYINT) {
                             //NOTE: convert int8_t to int64_t for being compatible with all compilers
                             auto value = bytesValue.toTinyInt();
@@ -120,7 +123,7 @@ namespace nogdb {
                         break;
                     }
                     case PropertyType::TEXT: {
-                        auto dataIndexDBHandler = dsTxnHandler->openDbi(getIndexingName(indexId), false, isUnique);
+                        auto dataIndexDBHandler = dsTxnHandler->openDbi(getIndexingKey(indexId), false, isUnique);
                         auto value = bytesValue.toText();
                         if (!value.empty()) {
                             dataIndexDBHandler.put(value, indexRecord, false, !isUnique);
@@ -149,7 +152,7 @@ namespace nogdb {
                 case PropertyType::UNSIGNED_SMALLINT:
                 case PropertyType::UNSIGNED_INTEGER:
                 case PropertyType::UNSIGNED_BIGINT: {
-                    auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), true, isUnique);
+                    auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), true, isUnique);
                     if (type == PropertyType::UNSIGNED_TINYINT) {
                         deleteIndexCursor(cursorHandler, positionId, static_cast<uint64_t>(bytesValue.toTinyIntU()));
                     } else if (type == PropertyType::UNSIGNED_SMALLINT) {
@@ -166,8 +169,8 @@ namespace nogdb {
                 case PropertyType::INTEGER:
                 case PropertyType::BIGINT:
                 case PropertyType::REAL: {
-                    auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingName(indexId, true), true, isUnique);
-                    auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingName(indexId, false), true, isUnique);
+                    auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingKey(indexId, true), true, isUnique);
+                    auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingKey(indexId, false), true, isUnique);
                     if (type == PropertyType::TINYINT) {
                         auto value = static_cast<int64_t>(bytesValue.toTinyInt());
                         (value < 0) ? deleteIndexCursor(cursorHandlerNegative, positionId, value)
@@ -192,7 +195,7 @@ namespace nogdb {
                     break;
                 }
                 case PropertyType::TEXT: {
-                    auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), false, isUnique);
+                    auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), false, isUnique);
                     auto value = bytesValue.toText();
                     if (!value.empty()) {
                         deleteIndexCursor(cursorHandler, positionId, value);
@@ -212,6 +215,10 @@ namespace nogdb {
             if (condition.comp == Condition::Comparator::EQUAL && condition.isNegative) {
                 return std::make_pair(IndexPropertyType{}, false);
             }
+            // index keys are case sensitive
+            if (condition.isIgnoreCase) {
+                return std::make_pair(IndexPropertyType{}, false);
+            }
             auto foundProperty = classInfo.propertyInfo.nameToDesc.find(condition.propName);
             if (foundProperty != classInfo.propertyInfo.nameToDesc.cend()) {
                 for (const auto &index: foundProperty->second.indexInfo) {
@@ -419,10 +426,166 @@ namespace nogdb {
             }
             return result;
         };
-        getRecordFromIndex(conditions.root.get(), false);
+        return getRecordFromIndex(conditions.root.get(), false);
+    }
+
+    std::vector<RecordDescriptor> Index::getIndexRecord(const Txn &txn, ClassId classId, const PlanNodePtr &plan) {
+        require(plan != nullptr);
+        switch (plan->path) {
+            case AccessPath::INDEX_SEEK:
+            case AccessPath::INDEX_RANGE:
+                return getIndexRecord(txn, classId, plan->indexPropertyType, *plan->condition);
+            case AccessPath::INDEX_INTERSECT:
+            case AccessPath::INDEX_UNION: {
+                auto result = std::vector<RecordDescriptor>{};
+                auto leftResult = getIndexRecord(txn, classId, plan->left);
+                auto rightResult = getIndexRecord(txn, classId, plan->right);
+                if (plan->path == AccessPath::INDEX_INTERSECT) {
+                    std::set_intersection(leftResult.begin(), leftResult.end(),
+                                          rightResult.begin(), rightResult.end(),
+                                          std::back_inserter(result), cmpRecordDescriptor);
+                } else {
+                    std::set_union(leftResult.begin(), leftResult.end(),
+                                   rightResult.begin(), rightResult.end(),
+                                   std::back_inserter(result), cmpRecordDescriptor);
+                }
+                return result;
+            }
+            default:
+                break;
+        }
         return std::vector<RecordDescriptor>{};
     }
 
+    size_t Index::getClassSize(const Txn &txn, ClassId classId) {
+        auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+        auto classDBHandler = dsTxnHandler->openClassDbi(classId);
+        auto numOfEntries = classDBHandler.size();
+        // exclude the EM_MAXRECNUM entry, which is missing from a destroyed class until its writer commits
+        return (numOfEntries > 0 && !classDBHandler.get(EM_MAXRECNUM).empty) ? numOfEntries - 1 : numOfEntries;
+    }
+
+    size_t Index::getIndexSize(const Txn &txn, const IndexPropertyType &indexPropertyType) {
+        auto &indexId = std::get<0>(indexPropertyType);
+        auto &isUnique = std::get<1>(indexPropertyType);
+        auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+        switch (std::get<2>(indexPropertyType)) {
+            case PropertyType::TINYINT:
+            case PropertyType::SMALLINT:
+            case PropertyType::INTEGER:
+            case PropertyType::BIGINT:
+            case PropertyType::REAL:
+                return dsTxnHandler->openDbi(getIndexingKey(indexId, true), true, isUnique).size() +
+                       dsTxnHandler->openDbi(getIndexingKey(indexId, false), true, isUnique).size();
+            case PropertyType::TEXT:
+                return dsTxnHandler->openDbi(getIndexingKey(indexId), false, isUnique).size();
+            default:
+                return dsTxnHandler->openDbi(getIndexingKey(indexId), true, isUnique).size();
+        }
+    }
+
+    Index::PlanNodePtr Index::planCondition(const Txn &txn, const ClassInfo &classInfo, const Condition &condition) {
+        auto foundIndex = hasIndex(classInfo.id, classInfo, condition);
+        if (!foundIndex.second) {
+            return nullptr;
+        }
+        auto indexSize = static_cast<double>(getIndexSize(txn, foundIndex.first));
+        auto plan = std::make_shared<PlanNode>();
+        plan->condition = &condition;
+        plan->indexPropertyType = foundIndex.first;
+        plan->isExact = true;
+        switch (condition.comp) {
+            case Condition::Comparator::EQUAL:
+                plan->path = AccessPath::INDEX_SEEK;
+                plan->estimatedRows = (std::get<1>(foundIndex.first)) ?
+                                      std::min(1.0, indexSize) : indexSize * PLAN_EQUAL_SELECTIVITY;
+                break;
+            case Condition::Comparator::BETWEEN:
+            case Condition::Comparator::BETWEEN_NO_UPPER:
+            case Condition::Comparator::BETWEEN_NO_LOWER:
+            case Condition::Comparator::BETWEEN_NO_BOUND:
+                plan->path = AccessPath::INDEX_RANGE;
+                plan->estimatedRows = indexSize * PLAN_BETWEEN_SELECTIVITY;
+                break;
+            default:
+                plan->path = AccessPath::INDEX_RANGE;
+                plan->estimatedRows = indexSize * PLAN_RANGE_SELECTIVITY;
+                break;
+        }
+        if (condition.isNegative) {
+            plan->path = AccessPath::INDEX_RANGE;
+            plan->estimatedRows = indexSize - plan->estimatedRows;
+        }
+        plan->cost = PLAN_INDEX_SEEK_COST * std::log2(indexSize + 2.0) + PLAN_INDEX_ENTRY_COST * plan->estimatedRows;
+        return plan;
+    }
+
+    Index::PlanNodePtr Index::planMultiCondition(const Txn &txn, const ClassInfo &classInfo,
+                                                 const MultiCondition &conditions) {
+        auto classSize = std::max(1.0, static_cast<double>(getClassSize(txn, classInfo.id)));
+        auto totalCost = [](const PlanNodePtr &plan) {
+            return plan->cost + plan->estimatedRows * PLAN_RECORD_FETCH_COST;
+        };
+        std::function<PlanNodePtr(const std::shared_ptr<MultiCondition::ExprNode> &)>
+                planExprNode = [&](const std::shared_ptr<MultiCondition::ExprNode> &exprNode) -> PlanNodePtr {
+            if (exprNode->checkIfCondition()) {
+                auto conditionNodePtr = (MultiCondition::ConditionNode *) exprNode.get();
+                return planCondition(txn, classInfo, conditionNodePtr->getCondition());
+            }
+            auto compositeNodePtr = (MultiCondition::CompositeNode *) exprNode.get();
+            // a negated composite node also matches records with null properties which never appear in indexes
+            if (compositeNodePtr->getIsNegative()) {
+                return nullptr;
+            }
+            auto leftPlan = planExprNode(compositeNodePtr->getLeftNode());
+            auto rightPlan = planExprNode(compositeNodePtr->getRightNode());
+            if (compositeNodePtr->getOperator() == MultiCondition::Operator::AND) {
+                auto plan = PlanNodePtr{nullptr};
+                if (leftPlan != nullptr && rightPlan != nullptr) {
+                    plan = std::make_shared<PlanNode>();
+                    plan->path = AccessPath::INDEX_INTERSECT;
+                    plan->estimatedRows = leftPlan->estimatedRows * rightPlan->estimatedRows / classSize;
+                    plan->cost = leftPlan->cost + rightPlan->cost;
+                    plan->isExact = leftPlan->isExact && rightPlan->isExact;
+                    plan->left = leftPlan;
+                    plan->right = rightPlan;
+                }
+                // reading only one side of AND yields candidates which must be filtered again
+                for (const auto &sidePlan: {leftPlan, rightPlan}) {
+                    if (sidePlan != nullptr && (plan == nullptr || totalCost(sidePlan) < totalCost(plan))) {
+                        plan = sidePlan;
+                        plan->isExact = false;
+                    }
+                }
+                return plan;
+            } else {
+                if (leftPlan == nullptr || rightPlan == nullptr) {
+                    return nullptr;
+                }
+                auto plan = std::make_shared<PlanNode>();
+                plan->path = AccessPath::INDEX_UNION;
+                plan->estimatedRows = std::min(classSize, leftPlan->estimatedRows + rightPlan->estimatedRows);
+                plan->cost = leftPlan->cost + rightPlan->cost;
+                plan->isExact = leftPlan->isExact && rightPlan->isExact;
+                plan->left = leftPlan;
+                plan->right = rightPlan;
+                return plan;
+            }
+        };
+        return planExprNode(conditions.root);
+    }
+
+    bool Index::isIndexPlanPreferred(const Txn &txn, ClassId classId, const PlanNodePtr &plan, bool isFetchRequired) {
+        if (plan == nullptr) {
+            return false;
+        }
+        auto indexCost = plan->cost;
+        if (isFetchRequired || !plan->isExact) {
+            indexCost += plan->estimatedRows * PLAN_RECORD_FETCH_COST;
+        }
+        return indexCost < static_cast<double>(getClassSize(txn, classId)) * PLAN_RECORD_SCAN_COST;
+    }
+
     std::vector<RecordDescriptor>
     Index::getLessEqual(const Txn &txn, ClassId classId, const IndexPropertyType &indexPropertyType,
                         const Bytes &value) {
@@ -435,7 +598,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), true, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), true, isUnique);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return backwardSearchIndex(cursorHandler, classId, static_cast<uint64_t>(value.toTinyIntU()), true, true);
                 } else if (propertyType == PropertyType::UNSIGNED_SMALLINT) {
@@ -457,7 +620,7 @@ namespace nogdb {
             case PropertyType::REAL:
                 return getLess(txn, classId, indexId, isUnique, value.toReal(), true);
             case PropertyType::TEXT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), false, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), false, isUnique);
                 return backwardSearchIndex(cursorHandler, classId, value.toText(), true, true);
             }
             default:
@@ -477,7 +640,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), true, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), true, isUnique);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return backwardSearchIndex(cursorHandler, classId, static_cast<uint64_t>(value.toTinyIntU()), true);
                 } else if (propertyType == PropertyType::UNSIGNED_SMALLINT) {
@@ -499,7 +662,7 @@ namespace nogdb {
             case PropertyType::REAL:
                 return getLess(txn, classId, indexId, isUnique, value.toReal());
             case PropertyType::TEXT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), false, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), false, isUnique);
                 return backwardSearchIndex(cursorHandler, classId, value.toText(), true);
             }
             default:
@@ -519,7 +682,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), true, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), true, isUnique);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return exactMatchIndex(cursorHandler, classId, static_cast<uint64_t>(value.toTinyIntU()));
                 } else if (propertyType == PropertyType::UNSIGNED_SMALLINT) {
@@ -541,7 +704,7 @@ namespace nogdb {
             case PropertyType::REAL:
                 return getEqual(txn, classId, indexId, isUnique, value.toReal());
             case PropertyType::TEXT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), false, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), false, isUnique);
                 return exactMatchIndex(cursorHandler, classId, value.toText());
             }
             default:
@@ -562,7 +725,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), true, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), true, isUnique);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return forwardSearchIndex(cursorHandler, classId, static_cast<uint64_t>(value.toTinyIntU()), true, true);
                 } else if (propertyType == PropertyType::UNSIGNED_SMALLINT) {
@@ -584,7 +747,7 @@ namespace nogdb {
             case PropertyType::REAL:
                 return getGreater(txn, classId, indexId, isUnique, value.toReal(), true);
             case PropertyType::TEXT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), false, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), false, isUnique);
                 return forwardSearchIndex(cursorHandler, classId, value.toText(), true);
             }
             default:
@@ -604,7 +767,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), true, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), true, isUnique);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return forwardSearchIndex(cursorHandler, classId, static_cast<uint64_t>(value.toTinyIntU()), true);
                 } else if (propertyType == PropertyType::UNSIGNED_SMALLINT) {
@@ -626,7 +789,7 @@ namespace nogdb {
             case PropertyType::REAL:
                 return getGreater(txn, classId, indexId, isUnique, value.toReal());
             case PropertyType::TEXT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), false, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), false, isUnique);
                 return forwardSearchIndex(cursorHandler, classId, value.toText());
             }
             default:
@@ -650,7 +813,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), true, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), true, isUnique);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return betweenSearchIndex(cursorHandler, classId,
                                               static_cast<uint64_t>(lowerBound.toTinyIntU()),
@@ -695,7 +858,7 @@ namespace nogdb {
                 return getBetween(txn, classId, indexId, isUnique, lowerBound.toReal(), upperBound.toReal(),
                                   isIncludeBound);
             case PropertyType::TEXT: {
-                auto cursorHandler = dsTxnHandler->openCursor(getIndexingName(indexId), false, isUnique);
+                auto cursorHandler = dsTxnHandler->openCursor(getIndexingKey(indexId), false, isUnique);
                 return betweenSearchIndex(cursorHandler, classId, lowerBound.toText(), upperBound.toText(),
                                           isIncludeBound);
             }
@@ -25,6 +25,7 @@
 #include <iostream> // for debugging
 #include <vector>
 #include <tuple>
+#include <memory>
 #include <type_traits>
 
 #include "schema.hpp"
@@ -43,6 +44,30 @@ namespace nogdb {
 
         typedef std::tuple<IndexId, bool, PropertyType> IndexPropertyType;
 
+        enum class AccessPath {
+            FULL_SCAN,
+            INDEX_SEEK,
+            INDEX_RANGE,
+            INDEX_INTERSECT,
+            INDEX_UNION
+        };
+
+        struct PlanNode;
+
+        typedef std::shared_ptr<PlanNode> PlanNodePtr;
+
+        // an access plan of a single class, leaf nodes read one index, inner nodes merge their children
+        struct PlanNode {
+            AccessPath path{AccessPath::FULL_SCAN};
+            double estimatedRows{0.0};
+            double cost{0.0};
+            bool isExact{false};
+            const Condition *condition{nullptr};
+            IndexPropertyType indexPropertyType{};
+            PlanNodePtr left{nullptr};
+            PlanNodePtr right{nullptr};
+        };
+
         static void addIndex(BaseTxn &txn, IndexId indexId, PositionId positionId, const Bytes &bytesValue,
                              PropertyType type, bool isUnique);
 
@@ -85,12 +110,12 @@ namespace nogdb {
             }
         }
 
-        inline static std::string getIndexingName(IndexId indexId) {
-            return TB_INDEXING_PREFIX + std::to_string(indexId);
+        inline static storage_engine::LMDBDbiRegistry::Key getIndexingKey(IndexId indexId) {
+            return storage_engine::LMDBDbiRegistry::indexKey(indexId);
         }
 
-        inline static std::string getIndexingName(IndexId indexId, bool isPositive) {
-            return getIndexingName(indexId) + ((isPositive)? INDEX_POSITIVE_SUFFIX: INDEX_NEGATIVE_SUFFIX);
+        inline static storage_engine::LMDBDbiRegistry::Key getIndexingKey(IndexId indexId, bool isPositive) {
+            return storage_engine::LMDBDbiRegistry::indexKey(indexId, isPositive);
         }
 
         static std::pair<IndexPropertyType, bool>
@@ -109,6 +134,20 @@ namespace nogdb {
                                                             const std::map<std::string, IndexPropertyType> &indexPropertyTypes,
                                                             const MultiCondition &conditions);
 
+        static std::vector<RecordDescriptor> getIndexRecord(const Txn &txn, ClassId classId, const PlanNodePtr &plan);
+
+        static size_t getClassSize(const Txn &txn, ClassId classId);
+
+        static size_t getIndexSize(const Txn &txn, const IndexPropertyType &indexPropertyType);
+
+        static PlanNodePtr planCondition(const Txn &txn, const ClassInfo &classInfo, const Condition &condition);
+
+        static PlanNodePtr planMultiCondition(const Txn &txn, const ClassInfo &classInfo,
+                                              const MultiCondition &conditions);
+
+        static bool isIndexPlanPreferred(const Txn &txn, ClassId classId, const PlanNodePtr &plan,
+                                         bool isFetchRequired);
+
         static std::vector<RecordDescriptor>
         getLessEqual(const Txn &txn, ClassId classId, const IndexPropertyType &indexPropertyType, const Bytes &value);
 
@@ -137,11 +176,11 @@ namespace nogdb {
         getLess(const Txn &txn, ClassId classId, IndexId indexId, bool isUnique, T value, bool includeEqual = false) {
             auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
             if (value < 0) {
-                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingName(indexId, false), true, isUnique);
+                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingKey(indexId, false), true, isUnique);
                 return backwardSearchIndex(cursorHandlerNegative, classId, value, false, includeEqual);
             } else {
-                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingName(indexId, true), true, isUnique);
-                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingName(indexId, false), true, isUnique);
+                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingKey(indexId, true), true, isUnique);
+                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingKey(indexId, false), true, isUnique);
                 auto positiveResult = backwardSearchIndex(cursorHandlerPositive, classId, value, true, includeEqual);
                 auto negativeResult = fullScanIndex(cursorHandlerNegative, classId);
                 positiveResult.insert(positiveResult.end(), negativeResult.cbegin(), negativeResult.cend());
@@ -154,10 +193,10 @@ namespace nogdb {
         getEqual(const Txn &txn, ClassId classId, IndexId indexId, bool isUnique, T value) {
             auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
             if (value < 0) {
-                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingName(indexId, false), true, isUnique);
+                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingKey(indexId, false), true, isUnique);
                 return exactMatchIndex(cursorHandlerNegative, classId, value);
             } else {
-                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingName(indexId, true), true, isUnique);
+                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingKey(indexId, true), true, isUnique);
                 return exactMatchIndex(cursorHandlerPositive, classId, value);
             }
         };
@@ -168,14 +207,14 @@ namespace nogdb {
                    bool includeEqual = false) {
             auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
             if (value < 0) {
-                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingName(indexId, true), true, isUnique);
-                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingName(indexId, false), true, isUnique);
+                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingKey(indexId, true), true, isUnique);
+                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingKey(indexId, false), true, isUnique);
                 auto positiveResult = fullScanIndex(cursorHandlerPositive, classId);
                 auto negativeResult = forwardSearchIndex(cursorHandlerNegative, classId, value, false, includeEqual);
                 positiveResult.insert(positiveResult.end(), negativeResult.cbegin(), negativeResult.cend());
                 return positiveResult;
             } else {
-                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingName(indexId, true), true, isUnique);
+                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingKey(indexId, true), true, isUnique);
                 return forwardSearchIndex(cursorHandlerPositive, classId, value, true, includeEqual);
             }
         };
@@ -186,11 +225,11 @@ namespace nogdb {
                                                         const std::pair<bool, bool> &isIncludeBound) {
             auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
             if (lowerBound < 0 && upperBound < 0) {
-                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingName(indexId, false), true, isUnique);
+                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingKey(indexId, false), true, isUnique);
                 return betweenSearchIndex(cursorHandlerNegative, classId, lowerBound, upperBound, false, isIncludeBound);
             } else if (lowerBound < 0 && upperBound >= 0) {
-                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingName(indexId, true), true, isUnique);
-                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingName(indexId, false), true, isUnique);
+                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingKey(indexId, true), true, isUnique);
+                auto cursorHandlerNegative = dsTxnHandler->openCursor(getIndexingKey(indexId, false), true, isUnique);
                 auto positiveResult = betweenSearchIndex(cursorHandlerPositive, classId,
                                                          static_cast<T>(0), upperBound,
                                                          true, {true, isIncludeBound.second});
@@ -200,7 +239,7 @@ namespace nogdb {
                 positiveResult.insert(positiveResult.end(), negativeResult.cbegin(), negativeResult.cend());
                 return positiveResult;
             } else {
-                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingName(indexId, true), true, isUnique);
+                auto cursorHandlerPositive = dsTxnHandler->openCursor(getIndexingKey(indexId, true), true, isUnique);
                 return betweenSearchIndex(cursorHandlerPositive, classId, lowerBound, upperBound, true, isIncludeBound);
             }
         };
@@ -261,11 +300,11 @@ namespace nogdb {
                     auto partialResult = exactMatchIndex(cursorHandler, classId, value);
                     result.insert(result.end(), partialResult.cbegin(), partialResult.cend());
                 }
-                cursorHandler.findRange(value);
-                for (auto keyValue = cursorHandler.getPrev();
+                // MDB_PREV is unreliable on a cursor left unpositioned by a failed MDB_SET_RANGE
+                auto isFoundRange = !cursorHandler.findRange(value).empty();
+                for (auto keyValue = (isFoundRange) ? cursorHandler.getPrev() : cursorHandler.getLast();
                      !keyValue.empty();
                      keyValue = cursorHandler.getPrev()) {
-                    auto key = keyValue.key.data.template numeric<T>();
                     auto positionId = keyValue.val.data.template numeric<PositionId>();
                     result.emplace_back(RecordDescriptor{classId, positionId});
                 }
@@ -307,8 +346,8 @@ namespace nogdb {
                     auto partialResult = exactMatchIndex(cursorHandler, classId, value);
                     result.insert(result.end(), partialResult.cbegin(), partialResult.cend());
                 }
-                cursorHandler.findRange(value);
-                for (auto keyValue = cursorHandler.getPrev();
+                auto isFoundRange = !cursorHandler.findRange(value).empty();
+                for (auto keyValue = (isFoundRange) ? cursorHandler.getPrev() : cursorHandler.getLast();
                      !keyValue.empty();
                      keyValue = cursorHandler.getPrev()) {
                     auto positionId = keyValue.val.data.template numeric<PositionId>();
@@ -359,13 +398,13 @@ namespace nogdb {
                     auto partialResult = exactMatchIndex(cursorHandler, classId, lower);
                     result.insert(result.end(), partialResult.cbegin(), partialResult.cend());
                 }
-                cursorHandler.findRange(lower);
-                for (auto keyValue = cursorHandler.getPrev();
+                auto isFoundRange = !cursorHandler.findRange(lower).empty();
+                for (auto keyValue = (isFoundRange) ? cursorHandler.getPrev() : cursorHandler.getLast();
                      !keyValue.empty();
                      keyValue = cursorHandler.getPrev()) {
-                    auto key = keyValue.key.data.numeric<T>();
+                    auto key = keyValue.key.data.template numeric<T>();
                     if ((!isIncludeBound.second && key == upper) || key > upper) break;
-                    auto positionId = keyValue.val.data.numeric<PositionId>();
+                    auto positionId = keyValue.val.data.template numeric<PositionId>();
                     result.emplace_back(RecordDescriptor{classId, positionId});
                 }
             }
@@ -22,6 +22,7 @@
 #ifndef __LMDB_ENGINE_HPP_INCLUDED_
 #define __LMDB_ENGINE_HPP_INCLUDED_
 
+#include <atomic>
 #include <string>
 #include <cstring>
 
@@ -140,6 +141,21 @@ namespace nogdb {
             typedef MDB_dbi DBHandler;
             typedef MDB_cursor CursorHandler;
 
+            // the owner of an environment may register a flag, as its user context, to learn about writes
+            // which have failed because the map is full
+            inline void notifyMapFull(EnvHandler *const env) noexcept {
+                if (auto isMapFull = static_cast<std::atomic<bool> *>(mdb_env_get_userctx(env))) {
+                    isMapFull->store(true);
+                }
+            }
+
+            inline int checkMapFull(TxnHandler *const txn, int error) noexcept {
+                if (error == MDB_MAP_FULL) {
+                    notifyMapFull(mdb_txn_env(txn));
+                }
+                return error;
+            }
+
             struct Result {
                 Value data{};
                 bool empty{false};
@@ -213,7 +229,7 @@ namespace nogdb {
 
                 void sync(const bool force = true) {
                     if (auto error = mdb_env_sync(_handle, force)) {
-                        throw error;
+                        throw NOGDB_STORAGE_ERROR(error);
                     }
                 }
 
@@ -286,10 +302,16 @@ namespace nogdb {
                 }
 
                 void commit() {
-                    if (auto error = mdb_txn_commit(_handle)) {
+                    auto env = mdb_txn_env(_handle);
+                    // the transaction is freed even if it fails to commit
+                    auto error = mdb_txn_commit(_handle);
+                    _handle = nullptr;
+                    if (error) {
+                        if (error == MDB_MAP_FULL) {
+                            notifyMapFull(env);
+                        }
                         throw NOGDB_STORAGE_ERROR(error);
                     }
-                    _handle = nullptr;
                 }
 
                 void abort() noexcept {
@@ -297,6 +319,13 @@ namespace nogdb {
                     _handle = nullptr;
                 }
 
+                // give up the ownership of the handle
+                TxnHandler *release() noexcept {
+                    auto handle = _handle;
+                    _handle = nullptr;
+                    return handle;
+                }
+
                 void reset() noexcept {
                     mdb_txn_reset(_handle);
                 }
@@ -321,7 +350,7 @@ namespace nogdb {
                     DBHandler dbHandler = 0;
                     auto flags = ((numericKey) ? MDB_INTEGERKEY : 0U) | ((!unique) ? MDB_DUPSORT : 0U);
                     if (auto error = mdb_open(txnHandler, dbName.c_str(), MDB_CREATE | flags, &dbHandler)) {
-                        throw NOGDB_STORAGE_ERROR(error);
+                        throw NOGDB_STORAGE_ERROR(checkMapFull(txnHandler, error));
                     } else {
                         return Dbi{txnHandler, dbHandler};
                     }
@@ -377,7 +406,7 @@ namespace nogdb {
 
                 void drop(const bool del = false) {
                     if (auto error = mdb_drop(_txn, _handle, del)) {
-                        throw NOGDB_STORAGE_ERROR(error);
+                        throw NOGDB_STORAGE_ERROR(checkMapFull(_txn, error));
                     }
                 }
 
@@ -580,7 +609,7 @@ namespace nogdb {
                                   const MDB_val* const data,
                                   const unsigned int flags = 0) {
                     if (auto error = mdb_put(_txn, _handle, const_cast<MDB_val*>(key), const_cast<MDB_val*>(data), flags)) {
-                        throw NOGDB_STORAGE_ERROR(error);
+                        throw NOGDB_STORAGE_ERROR(checkMapFull(_txn, error));
                     }
                 }
 
@@ -588,7 +617,7 @@ namespace nogdb {
                                   const MDB_val* const data = nullptr) {
                     if (auto error = mdb_del(_txn, _handle, const_cast<MDB_val*>(key), const_cast<MDB_val*>(data))) {
                         if (error != MDB_NOTFOUND) {
-                            throw NOGDB_STORAGE_ERROR(error);
+                            throw NOGDB_STORAGE_ERROR(checkMapFull(_txn, error));
                         }
                     }
                 }
@@ -661,10 +690,18 @@ namespace nogdb {
 
                 void del(bool duplicate = false) const {
                     if (auto error = mdb_cursor_del(_handle, duplicate)) {
-                        throw NOGDB_STORAGE_ERROR(error);
+                        throw NOGDB_STORAGE_ERROR(checkMapFull(mdb_cursor_txn(_handle), error));
                     }
                 }
 
+                CursorResult getFirst() const {
+                    return get(MDB_FIRST);
+                }
+
+                CursorResult getLast() const {
+                    return get(MDB_LAST);
+                }
+
                 CursorResult getNext() const {
                     return get(MDB_NEXT);
                 }
@@ -0,0 +1,240 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "constant.hpp"
+#include "lmdb_engine.hpp"
+#include "base_txn.hpp"
+#include "adjacency.hpp"
+#include "graph.hpp"
+
+namespace nogdb {
+
+    namespace {
+
+        // return true if not visible, otherwise false
+        bool checkVisibility(const BaseTxn &txn, const TxnObject &object) {
+            return (txn.getType() == BaseTxn::TxnType::READ_ONLY && object.checkReadOnly(txn.getVersionId())) ||
+                   (txn.getType() == BaseTxn::TxnType::READ_WRITE && object.checkReadWrite());
+        }
+
+    }
+
+    void Graph::trackVertex(const std::shared_ptr<Vertex> &vertex) {
+        if (isAdjacencyCached()) {
+            std::lock_guard<std::mutex> _(adjacencyMutex);
+            adjacencyClock.emplace_back(vertex);
+        }
+    }
+
+    void Graph::evictAdjacency() {
+        if (isAdjacencyCached()) {
+            std::lock_guard<std::mutex> _(adjacencyMutex);
+            evictAdjacencyLocked();
+        }
+    }
+
+    void Graph::pinVertex(const BaseTxn &txn, const std::shared_ptr<Vertex> &vertex) {
+        if (isAdjacencyCached()) {
+            txn.pinVertex(vertex);
+        }
+    }
+
+    void Graph::addAdjacency(const BaseTxn &txn, const RecordId &rid,
+                             const RecordId &srcRid, const RecordId &dstRid) {
+        if (isAdjacencyCached() && txn.getDsTxnHandler() != nullptr) {
+            Adjacency::add(*txn.getDsTxnHandler(), rid, srcRid, dstRid);
+        }
+    }
+
+    void Graph::removeAdjacency(const BaseTxn &txn, const RecordId &rid,
+                                const RecordId &srcRid, const RecordId &dstRid) {
+        if (isAdjacencyCached() && txn.getDsTxnHandler() != nullptr) {
+            Adjacency::remove(*txn.getDsTxnHandler(), rid, srcRid, dstRid);
+        }
+    }
+
+    std::shared_ptr<Graph::Vertex> Graph::loadVertex(const BaseTxn &txn, const RecordId &rid) {
+        // the vertex might have been committed or loaded by another transaction in the meantime,
+        // returns the vertex and whether it needs no loading
+        auto lookup = [&]() {
+            auto vertex = vertices.find(rid);
+            if (vertex != nullptr && checkVisibility(txn, *vertex)) {
+                return std::make_pair(std::shared_ptr<Vertex>{}, true);
+            }
+            if (vertex != nullptr && vertex->isLoaded) {
+                txn.pinVertex(vertex);
+                vertex->isReferenced = true;
+                return std::make_pair(vertex, true);
+            }
+            return std::make_pair(vertex, false);
+        };
+        {
+            std::lock_guard<std::mutex> _(adjacencyMutex);
+            auto const found = lookup();
+            if (found.second) {
+                return found.first;
+            }
+        }
+        // the snapshot of a transaction is what .adjacency holds for its version,
+        // which is read without blocking the transactions loading other vertices
+        auto const entries = Adjacency::find(*txn.getDsTxnHandler(), rid);
+        std::lock_guard<std::mutex> _(adjacencyMutex);
+        auto const found = lookup();
+        if (found.second) {
+            return found.first;
+        }
+        auto vertex = found.first;
+        if (vertex == nullptr) {
+            if (entries.empty()) {
+                return nullptr;
+            }
+            vertex = std::make_shared<Vertex>(rid, false);
+            vertex->updateState(0);
+            vertices.lockAndEmplace(rid, vertex);
+        }
+        for (const auto &entry: entries) {
+            auto const &edgeRid = std::get<1>(entry);
+            if (edges.find(edgeRid).second) {
+                continue;
+            }
+            if (txn.getType() == BaseTxn::TxnType::READ_WRITE && txn.findUncommittedEdge(edgeRid) != nullptr) {
+                continue;
+            }
+            auto const &otherRid = std::get<2>(entry);
+            auto other = (otherRid == rid) ? vertex : vertices.find(otherRid);
+            if (other == nullptr) {
+                other = std::make_shared<Vertex>(otherRid, false);
+                other->updateState(0);
+                vertices.lockAndEmplace(otherRid, other);
+            }
+            auto const isOut = (std::get<0>(entry) == Adjacency::Direction::OUT);
+            auto const &sourceVertex = isOut ? vertex : other;
+            auto const &targetVertex = isOut ? other : vertex;
+            // edges read from .adjacency have been committed for every version which can still load them
+            sourceVertex->out.load(edgeRid);
+            targetVertex->in.load(edgeRid);
+            edges.lockAndEmplace(edgeRid, Edge{sourceVertex->rid, targetVertex->rid, 0,
+                                               TxnObject::StatusFlag::COMMITTED_CREATE});
+        }
+        vertex->isLoaded = true;
+        vertex->isReferenced = true;
+        adjacencyClock.emplace_back(vertex);
+        txn.pinVertex(vertex);
+        evictAdjacencyLocked();
+        return vertex;
+    }
+
+    std::pair<Graph::Edge, bool> Graph::loadEdge(const BaseTxn &txn, const RecordId &rid) {
+        auto relationDBHandler = txn.getDsTxnHandler()->openDbi(TB_RELATIONS);
+        auto result = relationDBHandler.get(rid2key(rid));
+        if (result.empty) {
+            return std::make_pair(Edge{}, false);
+        }
+        auto srcRid = RecordId{};
+        auto data = result.data.blob();
+        auto offset = data.retrieve(&srcRid.first, 0, sizeof(ClassId));
+        data.retrieve(&srcRid.second, offset, sizeof(PositionId));
+        if (lookupVertex(txn, srcRid) == nullptr) {
+            return std::make_pair(Edge{}, false);
+        }
+        auto edge = findEdge(txn, rid);
+        if (edge.second) {
+            if (auto targetVertex = findEndpointVertex(txn, edge.first.target)) {
+                txn.pinVertex(targetVertex);
+            }
+        }
+        return edge;
+    }
+
+    void Graph::evictAdjacencyLocked() {
+        if (edges.size() <= adjacencyCacheSize) {
+            return;
+        }
+        // vertices changed after the oldest active snapshot must stay as they are seen by that snapshot
+        auto const minActive = txnStat->minActiveTxnId();
+        auto const safeVersionId = (minActive.first == 0) ? txnStat->maxVersionId.load() : minActive.second;
+        // every vertex gets at most a second chance in a single run
+        for (auto budget = adjacencyClock.size() * 2;
+             budget > 0 && !adjacencyClock.empty() && edges.size() > adjacencyCacheSize;
+             --budget) {
+            if (adjacencyClockHand == adjacencyClock.end()) {
+                adjacencyClockHand = adjacencyClock.begin();
+            }
+            auto vertex = adjacencyClockHand->lock();
+            if (vertex == nullptr || !vertex->isLoaded) {
+                adjacencyClockHand = adjacencyClock.erase(adjacencyClockHand);
+                continue;
+            }
+            if (vertex->isReferenced) {
+                vertex->isReferenced = false;
+                ++adjacencyClockHand;
+                continue;
+            }
+            if (vertex->lastModified > safeVersionId || vertex->numPins > 0) {
+                ++adjacencyClockHand;
+                continue;
+            }
+            // a transaction pinning the vertex concurrently re-checks isLoaded afterwards
+            vertex->isLoaded = false;
+            if (vertex->numPins > 0) {
+                vertex->isLoaded = true;
+                ++adjacencyClockHand;
+                continue;
+            }
+            adjacencyClockHand = adjacencyClock.erase(adjacencyClockHand);
+            demoteVertex(vertex, safeVersionId);
+        }
+    }
+
+    void Graph::demoteVertex(const std::shared_ptr<Vertex> &vertex, TxnId versionId) {
+        auto dropIfUnused = [this](const std::shared_ptr<Vertex> &element) {
+            if (element->numPins == 0 && element->in.empty() && element->out.empty()) {
+                vertices.lockAndErase(element->rid, element);
+            }
+        };
+        auto demote = [&](AdjacencyList &adjacency, bool isOut) {
+            for (const auto &edgeRid: adjacency.getAllEdges()) {
+                auto const edge = edges.find(edgeRid);
+                if (!edge.second || (isOut ? edge.first.source : edge.first.target) != vertex->rid) {
+                    adjacency.evict(edgeRid);
+                    continue;
+                }
+                auto const &otherRid = isOut ? edge.first.target : edge.first.source;
+                auto other = (otherRid == vertex->rid) ? vertex : vertices.find(otherRid);
+                // an edge stays in memory as long as its other end is still needed
+                if (other != nullptr && other != vertex &&
+                    (other->isLoaded || other->numPins > 0 || other->lastModified > versionId)) {
+                    continue;
+                }
+                edges.lockAndErase(edgeRid);
+                if (other != nullptr && other != vertex) {
+                    (isOut ? other->in : other->out).evict(edgeRid);
+                    dropIfUnused(other);
+                }
+                adjacency.evict(edgeRid);
+            }
+        };
+        demote(vertex->out, true);
+        demote(vertex->in, false);
+        dropIfUnused(vertex);
+    }
+
+}
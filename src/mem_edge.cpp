@@ -19,6 +19,11 @@
  *
  */
 
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <limits>
+
 #include "base_txn.hpp"
 #include "graph.hpp"
 
@@ -27,8 +32,7 @@
 namespace nogdb {
 
     void Graph::createEdge(BaseTxn &txn, const RecordId &rid, const RecordId &srcRid, const RecordId &dstRid) {
-        auto edge = lookupEdge(txn, rid);
-        if (edge != nullptr) {
+        if (lookupEdge(txn, rid).second) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_DUP_EDGE);
         }
         auto sourceVertex = lookupVertex(txn, srcRid);
@@ -41,170 +45,345 @@ namespace nogdb {
             targetVertex = std::make_shared<Graph::Vertex>(dstRid);
             txn.addUncommittedVertex(targetVertex);
         }
-        auto newEdge = std::make_shared<Graph::Edge>(rid, sourceVertex, targetVertex);
-        txn.addUncommittedEdge(newEdge);
+        txn.addUncommittedEdge(rid, Edge{srcRid, dstRid});
         // update outgoing edge of a source vertex
-        sourceVertex->out.insert(rid.first, rid.second, newEdge);
+        updateAdjacency(txn, sourceVertex, &Vertex::out, rid, true);
         // update incoming edge of a target vertex
-        targetVertex->in.insert(rid.first, rid.second, newEdge);
+        updateAdjacency(txn, targetVertex, &Vertex::in, rid, true);
+        addAdjacency(txn, rid, srcRid, dstRid);
     }
 
-    void Graph::deleteEdge(BaseTxn &txn, const RecordId &rid) noexcept {
-        if (auto edge = lookupEdge(txn, rid)) {
-            auto findSrcVertex = edge->source.getLatestVersion();
-            if (findSrcVertex.second) {
-                if (auto sourceVertex = findSrcVertex.first.lock()) {
-                    sourceVertex->out.erase(rid.first, rid.second);
-                }
+    void Graph::createEdges(BaseTxn &txn, const std::vector<std::tuple<RecordId, RecordId, RecordId>> &edgeRids,
+                            const std::function<bool(const RecordId &)> &isNewVertex) {
+        // resolve each endpoint once rather than once per incident edge, a vertex is staged if it is created
+        // here, so that its adjacency can be appended to and sorted once all edges are known
+        auto vertexCache = std::unordered_map<RecordId, std::pair<std::shared_ptr<Graph::Vertex>, bool>,
+                RecordIdHash>{};
+        auto resolveVertex = [&](const RecordId &rid) -> const std::pair<std::shared_ptr<Graph::Vertex>, bool> & {
+            auto found = vertexCache.find(rid);
+            if (found != vertexCache.cend()) {
+                return found->second;
             }
-            auto findTgtVertex = edge->target.getLatestVersion();
-            if (findTgtVertex.second) {
-                if (auto targetVertex = findTgtVertex.first.lock()) {
-                    targetVertex->in.erase(rid.first, rid.second);
-                }
+            auto isStaged = isNewVertex(rid) && vertices.find(rid) == nullptr &&
+                            txn.findUncommittedVertex(rid) == nullptr;
+            auto vertex = (isStaged) ? nullptr : lookupVertex(txn, rid);
+            if (vertex == nullptr) {
+                vertex = std::make_shared<Graph::Vertex>(rid);
+                txn.addUncommittedVertex(vertex);
             }
-            if (edge->getState().second == TxnObject::StatusFlag::UNCOMMITTED_CREATE) {
-                //forceDeleteEdge(rid);
-                txn.deleteUncommittedEdge(rid);
+            return vertexCache.emplace(rid, std::make_pair(std::move(vertex), isStaged)).first->second;
+        };
+        auto newEdges = std::vector<std::pair<RecordId, Edge>>{};
+        newEdges.reserve(edgeRids.size());
+        for (const auto &edgeRid: edgeRids) {
+            auto const &rid = std::get<0>(edgeRid);
+            auto const &source = resolveVertex(std::get<1>(edgeRid));
+            auto const &target = resolveVertex(std::get<2>(edgeRid));
+            if (source.second) {
+                source.first->out.append(rid);
             } else {
-                edge->setStatus(TxnObject::StatusFlag::UNCOMMITTED_DELETE);
-                txn.addUncommittedEdge(edge);
+                updateAdjacency(txn, source.first, &Vertex::out, rid, true);
+            }
+            if (target.second) {
+                target.first->in.append(rid);
+            } else {
+                updateAdjacency(txn, target.first, &Vertex::in, rid, true);
+            }
+            newEdges.emplace_back(rid, Edge{source.first->rid, target.first->rid});
+            addAdjacency(txn, rid, source.first->rid, target.first->rid);
+        }
+        for (const auto &vertex: vertexCache) {
+            if (vertex.second.second) {
+                vertex.second.first->in.sort();
+                vertex.second.first->out.sort();
+            }
+        }
+        txn.addUncommittedEdges(std::move(newEdges));
+    }
+
+    void Graph::loadEdges(const std::vector<std::vector<std::tuple<RecordId, RecordId, RecordId>>> &partitions,
+                          TxnId versionId) {
+        auto const numThreads = std::max(partitions.size(), size_t{1});
+        auto runInParallel = [numThreads](const std::function<void(size_t)> &task) {
+            auto workers = std::vector<std::future<void>>{};
+            for (auto workerId = size_t{1}; workerId < numThreads; ++workerId) {
+                workers.emplace_back(std::async(std::launch::async, task, workerId));
+            }
+            task(0);
+            for (auto &worker: workers) {
+                worker.get();
+            }
+        };
+        auto const hasher = RecordIdHash{};
+
+        // each vertex is owned by exactly one thread, so hand endpoints over to their owners first
+        auto outboxes = std::vector<std::vector<std::vector<RecordId>>>(
+                numThreads, std::vector<std::vector<RecordId>>(numThreads));
+        runInParallel([&](size_t workerId) {
+            if (workerId >= partitions.size()) {
+                return;
+            }
+            auto &outbox = outboxes[workerId];
+            for (const auto &edgeRid: partitions[workerId]) {
+                outbox[hasher(std::get<1>(edgeRid)) % numThreads].emplace_back(std::get<1>(edgeRid));
+                outbox[hasher(std::get<2>(edgeRid)) % numThreads].emplace_back(std::get<2>(edgeRid));
+            }
+        });
+        auto stagedVertices = std::vector<GraphElements<Vertex>>(numThreads);
+        runInParallel([&](size_t workerId) {
+            auto &vertexMap = stagedVertices[workerId];
+            for (const auto &outbox: outboxes) {
+                for (const auto &rid: outbox[workerId]) {
+                    if (vertexMap.find(rid) == vertexMap.cend()) {
+                        auto vertex = std::make_shared<Vertex>(rid);
+                        vertex->updateState(versionId);
+                        // vertices with a version bump are marked once the graph is loaded
+                        vertex->noVersionBumpSince = versionId;
+                        vertexMap.emplace(rid, vertex);
+                    }
+                }
+            }
+        });
+        outboxes.clear();
+
+        // link edges to their endpoints, the staged vertex maps are read-only from here on,
+        // while the slab of edges takes the edges of each thread with one lock per shard
+        runInParallel([&](size_t workerId) {
+            if (workerId >= partitions.size()) {
+                return;
+            }
+            auto lookup = [&](const RecordId &rid) -> const std::shared_ptr<Vertex> & {
+                return stagedVertices[hasher(rid) % numThreads].at(rid);
+            };
+            auto newEdges = std::vector<std::pair<RecordId, Edge>>{};
+            newEdges.reserve(partitions[workerId].size());
+            for (const auto &edgeRid: partitions[workerId]) {
+                auto const &rid = std::get<0>(edgeRid);
+                lookup(std::get<1>(edgeRid))->out.append(rid);
+                lookup(std::get<2>(edgeRid))->in.append(rid);
+                newEdges.emplace_back(rid, Edge{std::get<1>(edgeRid), std::get<2>(edgeRid), versionId,
+                                                TxnObject::StatusFlag::COMMITTED_CREATE});
             }
+            edges.lockAndReplace(newEdges.cbegin(), newEdges.cend(), newEdges.size());
+        });
+
+        runInParallel([&](size_t workerId) {
+            for (const auto &vertex: stagedVertices[workerId]) {
+                vertex.second->in.sort();
+                vertex.second->out.sort();
+            }
+        });
+
+        // merge staged vertices into the graph
+        for (const auto &vertexMap: stagedVertices) {
+            vertices.lockAndInsert(vertexMap.cbegin(), vertexMap.cend(), vertexMap.size());
+        }
+    }
+
+    void Graph::deleteEdge(BaseTxn &txn, const RecordId &rid) noexcept {
+        auto const edge = lookupEdge(txn, rid);
+        if (!edge.second) {
+            return;
+        }
+        auto const committedEdge = getCommittedEdge(edge.first, rid);
+        if (auto sourceVertex = findEndpointVertex(txn, edge.first.source)) {
+            updateAdjacency(txn, sourceVertex, &Vertex::out, rid, false, committedEdge.source);
+        }
+        if (auto targetVertex = findEndpointVertex(txn, edge.first.target)) {
+            updateAdjacency(txn, targetVertex, &Vertex::in, rid, false, committedEdge.target);
+        }
+        removeAdjacency(txn, rid, edge.first.source, edge.first.target);
+        if (edge.first.status == TxnObject::StatusFlag::UNCOMMITTED_CREATE) {
+            txn.deleteUncommittedEdge(rid);
+        } else {
+            // a deleted edge keeps the endpoints whose adjacency a reader of an older version still finds it in
+            txn.addUncommittedEdge(rid, Edge{committedEdge.source, committedEdge.target, 0,
+                                             TxnObject::StatusFlag::UNCOMMITTED_DELETE});
         }
     }
 
     RecordId Graph::getVertexSrc(const BaseTxn &txn, const RecordId &rid) {
-        auto edge = lookupEdge(txn, rid);
-        if (edge == nullptr) {
+        auto const edge = lookupEdge(txn, rid);
+        if (!edge.second) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_EDGE);
         }
-        auto findSrcVertex = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                             edge->source.getStableVersion(txn.getVersionId()) : edge->source.getLatestVersion();
-        if (findSrcVertex.second) {
-            if (auto sourceVertex = findSrcVertex.first.lock()) {
-                return sourceVertex->rid;
-            }
-        }
-        throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_UNKNOWN_ERR);
+        return edge.first.source;
     }
 
     RecordId Graph::getVertexDst(const BaseTxn &txn, const RecordId &rid) {
-        auto edge = lookupEdge(txn, rid);
-        if (edge == nullptr) {
+        auto const edge = lookupEdge(txn, rid);
+        if (!edge.second) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_EDGE);
         }
-        auto findTgtVertex = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                             edge->target.getStableVersion(txn.getVersionId()) : edge->target.getLatestVersion();
-        if (findTgtVertex.second) {
-            if (auto targetVertex = findTgtVertex.first.lock()) {
-                return targetVertex->rid;
-            }
-        }
-        throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_UNKNOWN_ERR);
+        return edge.first.target;
     }
 
     std::pair<RecordId, RecordId> Graph::getVertexSrcDst(const BaseTxn &txn, const RecordId &rid) {
-        auto edge = lookupEdge(txn, rid);
-        if (edge == nullptr) {
+        auto const edge = lookupEdge(txn, rid);
+        if (!edge.second) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_EDGE);
         }
-        auto findSrcVertex = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                             edge->source.getStableVersion(txn.getVersionId()) : edge->source.getLatestVersion();
-        auto findTgtVertex = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                             edge->target.getStableVersion(txn.getVersionId()) : edge->target.getLatestVersion();
-        if (findSrcVertex.second && findTgtVertex.second) {
-            if (auto sourceVertex = findSrcVertex.first.lock()) {
-                if (auto targetVertex = findTgtVertex.first.lock()) {
-                    return std::make_pair(sourceVertex->rid, targetVertex->rid);
-                }
-            }
-        }
-        throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_UNKNOWN_ERR);
+        return std::make_pair(edge.first.source, edge.first.target);
     }
 
     void Graph::alterVertexSrc(BaseTxn &txn, const RecordId &rid, const RecordId &srcRid) {
+        moveEdge(txn, rid, srcRid, true);
+    }
+
+    void Graph::alterVertexDst(BaseTxn &txn, const RecordId &rid, const RecordId &dstRid) {
+        moveEdge(txn, rid, dstRid, false);
+    }
+
+    void Graph::moveEdge(BaseTxn &txn, const RecordId &rid, const RecordId &vertexRid, bool isSource) {
         auto edge = lookupEdge(txn, rid);
-        if (edge == nullptr) {
+        if (!edge.second) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_EDGE);
         }
-        auto findOldSrcVertex = edge->source.getLatestVersion();
-        if (findOldSrcVertex.second) {
-            if (auto oldSrcVertex = findOldSrcVertex.first.lock()) {
-                auto newSrcVertex = lookupVertex(txn, srcRid);
-                if (newSrcVertex == nullptr) {
-                    newSrcVertex = std::make_shared<Graph::Vertex>(srcRid);
-                    txn.addUncommittedVertex(newSrcVertex);
-                }
-                // update outgoing edge of an old source vertex
-                oldSrcVertex->out.erase(rid.first, rid.second);
-                // update edge
-                edge->source.addLatestVersion(newSrcVertex);
-                txn.addUncommittedEdge(edge);
-                // update outgoing edge of a new source vertex
-                newSrcVertex->out.insert(rid.first, rid.second, edge);
-                return;
-            }
+        auto const direction = (isSource) ? &Vertex::out : &Vertex::in;
+        auto &endpoint = (isSource) ? edge.first.source : edge.first.target;
+        auto const committedEdge = getCommittedEdge(edge.first, rid);
+        auto const &from = (isSource) ? committedEdge.source : committedEdge.target;
+        auto oldVertex = findEndpointVertex(txn, endpoint);
+        if (oldVertex == nullptr) {
+            throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_UNKNOWN_ERR);
         }
-        throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_UNKNOWN_ERR);
+        auto newVertex = lookupVertex(txn, vertexRid);
+        if (newVertex == nullptr) {
+            newVertex = std::make_shared<Graph::Vertex>(vertexRid);
+            txn.addUncommittedVertex(newVertex);
+        }
+        removeAdjacency(txn, rid, edge.first.source, edge.first.target);
+        // update an edge of an old vertex
+        updateAdjacency(txn, oldVertex, direction, rid, false, from);
+        // update an edge
+        endpoint = vertexRid;
+        txn.addUncommittedEdge(rid, edge.first);
+        // update an edge of a new vertex
+        updateAdjacency(txn, newVertex, direction, rid, true, from);
+        addAdjacency(txn, rid, edge.first.source, edge.first.target);
     }
 
-    void Graph::alterVertexDst(BaseTxn &txn, const RecordId &rid, const RecordId &dstRid) {
-        auto edge = lookupEdge(txn, rid);
-        if (edge == nullptr) {
-            throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_EDGE);
+    std::pair<Graph::Edge, bool> Graph::lookupEdge(const BaseTxn &txn, const RecordId &rid) {
+        auto const isCached = isAdjacencyCached() && txn.getDsTxnHandler() != nullptr;
+        if (!isCached) {
+            return findEdge(txn, rid);
         }
-        auto findOldDstVertex = edge->target.getLatestVersion();
-        if (findOldDstVertex.second) {
-            if (auto oldDstVertex = findOldDstVertex.first.lock()) {
-                auto newDstVertex = lookupVertex(txn, dstRid);
-                if (newDstVertex == nullptr) {
-                    newDstVertex = std::make_shared<Graph::Vertex>(dstRid);
-                    txn.addUncommittedVertex(newDstVertex);
-                }
-                // update incoming edge of an old destination vertex
-                oldDstVertex->in.erase(rid.first, rid.second);
-                // update edge
-                edge->target.addLatestVersion(newDstVertex);
-                txn.addUncommittedEdge(edge);
-                // update incoming edge of a new destination vertex
-                newDstVertex->in.insert(rid.first, rid.second, edge);
-                return;
+        auto const isInMemory = edges.find(rid).second ||
+                                (txn.getType() == BaseTxn::TxnType::READ_WRITE &&
+                                 txn.findUncommittedEdge(rid) != nullptr);
+        if (!isInMemory) {
+            return loadEdge(txn, rid);
+        }
+        auto edge = findEdge(txn, rid);
+        if (edge.second) {
+            // keep both ends alive for as long as the transaction may follow the edge
+            auto sourceVertex = findEndpointVertex(txn, edge.first.source);
+            auto targetVertex = findEndpointVertex(txn, edge.first.target);
+            if (sourceVertex == nullptr || targetVertex == nullptr) {
+                return loadEdge(txn, rid);
             }
+            txn.pinVertex(sourceVertex);
+            txn.pinVertex(targetVertex);
         }
-        throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_UNKNOWN_ERR);
+        return edge;
     }
 
-    std::shared_ptr<Graph::Edge> Graph::lookupEdge(const BaseTxn &txn, const RecordId &rid) {
-        RWSpinLockGuard<RWSpinLock> _(edges.splock);
-        auto iterator = edges.elements.find(rid);
-        if (iterator == edges.elements.cend()) {
-            if (txn.getType() == BaseTxn::TxnType::READ_ONLY) {
-                return nullptr;
-            } else {
-                auto edgePtr = txn.findUncommittedEdge(rid);
-                if (edgePtr != nullptr) {
-                    return (edgePtr->checkReadWrite()) ? nullptr : edgePtr;
-                }
-                return nullptr;
+    std::pair<Graph::Edge, bool> Graph::findEdge(const BaseTxn &txn, const RecordId &rid) {
+        if (txn.getType() == BaseTxn::TxnType::READ_WRITE) {
+            if (auto edgePtr = txn.findUncommittedEdge(rid)) {
+                return std::make_pair(*edgePtr, edgePtr->status != TxnObject::StatusFlag::UNCOMMITTED_DELETE);
             }
-        } else {
-            if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && iterator->second->checkReadOnly(txn.getVersionId())) ||
-                (txn.getType() == BaseTxn::TxnType::READ_WRITE && iterator->second->checkReadWrite())) {
-                return nullptr;
+        }
+        auto edge = edges.find(rid);
+        if (!edge.second) {
+            return edge;
+        }
+        if (txn.getType() == BaseTxn::TxnType::READ_WRITE || edge.first.versionId <= txn.getVersionId()) {
+            edge.second = edge.first.status == TxnObject::StatusFlag::COMMITTED_CREATE;
+            return edge;
+        }
+        // the edge has been created, moved or deleted after the version of a reader, which sees it where it was
+        auto const source = traceEndpoint(rid, edge.first.source, &Vertex::out, txn.getVersionId());
+        auto const target = traceEndpoint(rid, edge.first.target, &Vertex::in, txn.getVersionId());
+        edge.first.source = source.first;
+        edge.first.target = target.first;
+        edge.second = source.second && target.second;
+        return edge;
+    }
+
+    std::pair<RecordId, bool> Graph::traceEndpoint(const RecordId &rid, RecordId endpoint,
+                                                   AdjacencyList Vertex::*direction, TxnId versionId) {
+        auto untilVersionId = std::numeric_limits<TxnId>::max();
+        while (true) {
+            auto vertex = vertices.find(endpoint);
+            if (vertex == nullptr) {
+                return std::make_pair(RecordId{}, false);
+            }
+            // a vertex created in memory after the version, e.g. by a bulk loader which has built its adjacency
+            // at once, had no edges at that version
+            auto const &adjacency = (*vertex).*direction;
+            if (!vertex->checkReadOnly(versionId) && adjacency.contains(rid, versionId)) {
+                return std::make_pair(endpoint, true);
+            }
+            // every commit since the version which inserted the edge here tells where it has come from
+            auto const origin = adjacency.findOrigin(rid, versionId, untilVersionId);
+            if (origin.second == 0 || origin.first == RecordId{}) {
+                return std::make_pair(RecordId{}, false);
+            }
+            endpoint = origin.first;
+            untilVersionId = origin.second;
+        }
+    }
+
+    std::shared_ptr<Graph::Vertex> Graph::findEndpointVertex(const BaseTxn &txn, const RecordId &rid) {
+        if (txn.getType() == BaseTxn::TxnType::READ_WRITE) {
+            if (auto vertex = txn.findUncommittedVertex(rid)) {
+                return vertex;
             }
         }
-        return iterator->second;
+        return vertices.find(rid);
+    }
+
+    Graph::Edge Graph::getCommittedEdge(const Edge &edge, const RecordId &rid) {
+        return (edge.status == TxnObject::StatusFlag::UNCOMMITTED_CREATE) ? Edge{} : edges.find(rid).first;
     }
 
     void Graph::forceDeleteEdge(const RecordId &rid) noexcept {
         edges.lockAndErase(rid);
     }
 
-    void Graph::forceDeleteEdges(const std::vector<RecordId> &rids) noexcept {
-        RWSpinLockGuard<RWSpinLock> _(edges.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+    void Graph::forceDeleteEdges(const std::vector<RecordId> &rids, TxnId versionId) noexcept {
         for (const auto &rid: rids) {
-            edges.elements.erase(rid);
+            edges.lockAndEraseIf(rid, [versionId](const Edge &edge) {
+                return edge.status == TxnObject::StatusFlag::COMMITTED_DELETE && edge.versionId <= versionId;
+            });
+        }
+    }
+
+    void Graph::updateAdjacency(BaseTxn &txn, const std::shared_ptr<Vertex> &vertex,
+                                AdjacencyList Vertex::*direction, const RecordId &rid, bool isInsert,
+                                const RecordId &from) {
+        auto &adjacency = (*vertex).*direction;
+        auto const isChanged = (isInsert) ? adjacency.insert(rid, from) : adjacency.erase(rid);
+        if (isChanged) {
+            txn.addDirtyVertex(vertex);
+            if (txn.hasSavepoint()) {
+                // the uncommitted changes of an adjacency follow from its latest version, so the opposite change
+                // undoes it
+                txn.logUndo([vertex, direction, rid, isInsert, from]() {
+                    auto &adjacency = (*vertex).*direction;
+                    (isInsert) ? adjacency.erase(rid) : adjacency.insert(rid, from);
+                });
+            }
+        }
+    }
+
+    void Graph::updateStatus(BaseTxn &txn, const std::shared_ptr<TxnObject> &element, TxnObject::StatusFlag status) {
+        if (txn.hasSavepoint()) {
+            auto const prevStatus = element->getState().second;
+            txn.logUndo([element, prevStatus]() { element->setStatus(prevStatus); });
         }
+        element->setStatus(status);
     }
 
 }
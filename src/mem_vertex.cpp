@@ -29,6 +29,25 @@
 
 namespace nogdb {
 
+    namespace {
+
+        std::vector<RecordId> getEdges(const BaseTxn &txn, const AdjacencyList &adjacency, const ClassId &classId = 0) {
+            return (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
+                   adjacency.getStableEdges(txn.getVersionId(), classId) : adjacency.getLatestEdges(classId);
+        }
+
+        std::vector<ClassId> getEdgeClasses(const std::vector<RecordId> &edges) {
+            auto result = std::vector<ClassId>{};
+            for (const auto &edge: edges) {
+                result.push_back(edge.first);
+            }
+            std::sort(result.begin(), result.end());
+            result.erase(std::unique(result.begin(), result.end()), result.end());
+            return result;
+        }
+
+    }
+
     bool Graph::createVertex(BaseTxn &txn, const RecordId &rid) {
         if (auto vertex = lookupVertex(txn, rid)) {
             return false;
@@ -41,58 +60,44 @@ namespace nogdb {
     void Graph::deleteVertex(BaseTxn &txn, const RecordId &rid) noexcept {
         if (auto vertex = lookupVertex(txn, rid)) {
             // delete all in-edges
-            for (const auto &inEdgeRids: vertex->in.keys()) {
-                auto inEdgeClassId = inEdgeRids.first;
-                // get each in-edge
-                for (const auto &inEdgePosId: inEdgeRids.second) {
-                    auto findInEdge = vertex->in.find(inEdgeClassId, inEdgePosId);
-                    if (findInEdge.second) {
-                        if (auto inEdge = findInEdge.first.lock()) {
-                            // get a source vertex of an in-edge
-                            auto findSrcVertex = inEdge->source.getLatestVersion();
-                            if (findSrcVertex.second) {
-                                // delete an in-edge as an out-edge of a source vertex
-                                if (auto sourceVertex = findSrcVertex.first.lock()) {
-                                    sourceVertex->out.erase(inEdge->rid.first, inEdge->rid.second);
-                                }
-                            }
-                            // delete an in-edge
-                            if (inEdge->getState().second == TxnObject::StatusFlag::UNCOMMITTED_CREATE) {
-                                //forceDeleteEdge(inEdge->rid);
-                                txn.deleteUncommittedEdge(inEdge->rid);
-                            } else {
-                                inEdge->setStatus(TxnObject::StatusFlag::UNCOMMITTED_DELETE);
-                                txn.addUncommittedEdge(inEdge);
-                            }
-                        }
+            for (const auto &inEdgeRid: vertex->in.getLatestEdges()) {
+                auto const inEdge = lookupEdge(txn, inEdgeRid);
+                if (inEdge.second) {
+                    auto const committedEdge = getCommittedEdge(inEdge.first, inEdgeRid);
+                    // delete an in-edge as an out-edge of a source vertex
+                    if (auto sourceVertex = findEndpointVertex(txn, inEdge.first.source)) {
+                        pinVertex(txn, sourceVertex);
+                        updateAdjacency(txn, sourceVertex, &Vertex::out, inEdgeRid, false, committedEdge.source);
+                    }
+                    removeAdjacency(txn, inEdgeRid, inEdge.first.source, rid);
+                    // delete an in-edge
+                    if (inEdge.first.status == TxnObject::StatusFlag::UNCOMMITTED_CREATE) {
+                        updateAdjacency(txn, vertex, &Vertex::in, inEdgeRid, false, committedEdge.target);
+                        txn.deleteUncommittedEdge(inEdgeRid);
+                    } else {
+                        txn.addUncommittedEdge(inEdgeRid, Edge{committedEdge.source, committedEdge.target, 0,
+                                                               TxnObject::StatusFlag::UNCOMMITTED_DELETE});
                     }
                 }
             }
             // delete all out-edges
-            for (const auto &outEdgeRids: vertex->out.keys()) {
-                auto outEdgeClassId = outEdgeRids.first;
-                // get each out-edge
-                for (const auto &outEdgePosId: outEdgeRids.second) {
-                    auto findOutEdge = vertex->out.find(outEdgeClassId, outEdgePosId);
-                    if (findOutEdge.second) {
-                        if (auto outEdge = findOutEdge.first.lock()) {
-                            // get a target vertex of an out-edge
-                            auto findDstVertex = outEdge->target.getLatestVersion();
-                            if (findDstVertex.second) {
-                                // delete an out-edge as an in-edge of a target vertex
-                                if (auto targetVertex = findDstVertex.first.lock()) {
-                                    targetVertex->in.erase(outEdge->rid.first, outEdge->rid.second);
-                                }
-                            }
-                            // delete an out-edge
-                            if (outEdge->getState().second == TxnObject::StatusFlag::UNCOMMITTED_CREATE) {
-                                //forceDeleteEdge(outEdge->rid);
-                                txn.deleteUncommittedEdge(outEdge->rid);
-                            } else {
-                                outEdge->setStatus(TxnObject::StatusFlag::UNCOMMITTED_DELETE);
-                                txn.addUncommittedEdge(outEdge);
-                            }
-                        }
+            for (const auto &outEdgeRid: vertex->out.getLatestEdges()) {
+                auto const outEdge = lookupEdge(txn, outEdgeRid);
+                if (outEdge.second) {
+                    auto const committedEdge = getCommittedEdge(outEdge.first, outEdgeRid);
+                    // delete an out-edge as an in-edge of a target vertex
+                    if (auto targetVertex = findEndpointVertex(txn, outEdge.first.target)) {
+                        pinVertex(txn, targetVertex);
+                        updateAdjacency(txn, targetVertex, &Vertex::in, outEdgeRid, false, committedEdge.target);
+                    }
+                    removeAdjacency(txn, outEdgeRid, rid, outEdge.first.target);
+                    // delete an out-edge
+                    if (outEdge.first.status == TxnObject::StatusFlag::UNCOMMITTED_CREATE) {
+                        updateAdjacency(txn, vertex, &Vertex::out, outEdgeRid, false, committedEdge.source);
+                        txn.deleteUncommittedEdge(outEdgeRid);
+                    } else {
+                        txn.addUncommittedEdge(outEdgeRid, Edge{committedEdge.source, committedEdge.target, 0,
+                                                                TxnObject::StatusFlag::UNCOMMITTED_DELETE});
                     }
                 }
             }
@@ -101,7 +106,7 @@ namespace nogdb {
                 //forceDeleteVertex(vertex->rid);
                 txn.deleteUncommittedVertex(vertex->rid);
             } else {
-                vertex->setStatus(TxnObject::StatusFlag::UNCOMMITTED_DELETE);
+                updateStatus(txn, vertex, TxnObject::StatusFlag::UNCOMMITTED_DELETE);
                 txn.addUncommittedVertex(vertex);
             }
         }
@@ -112,33 +117,7 @@ namespace nogdb {
         if (vertex == nullptr) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_VERTEX);
         }
-        auto result = std::vector<RecordId> {};
-        if (classId) {
-            for (const auto &posId: vertex->in.keys(classId)) {
-                auto findInEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                  vertex->in.find(txn.getVersionId(), classId, posId) : vertex->in.find(classId, posId);
-                if (findInEdge.second) {
-                    if (auto inEdge = findInEdge.first.lock()) {
-                        result.push_back(inEdge->rid);
-                    }
-                }
-            }
-        } else {
-            for (const auto &inEdgeRids: vertex->in.keys()) {
-                auto inEdgeClassId = inEdgeRids.first;
-                for (const auto &inEdgePosId: inEdgeRids.second) {
-                    auto findInEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                      vertex->in.find(txn.getVersionId(), inEdgeClassId, inEdgePosId) :
-                                      vertex->in.find(inEdgeClassId, inEdgePosId);
-                    if (findInEdge.second) {
-                        if (auto inEdge = findInEdge.first.lock()) {
-                            result.push_back(inEdge->rid);
-                        }
-                    }
-                }
-            }
-        }
-        return result;
+        return getEdges(txn, vertex->in, classId);
     }
 
     std::vector<ClassId> Graph::getEdgeClassIn(const BaseTxn &txn, const RecordId &rid) {
@@ -146,22 +125,7 @@ namespace nogdb {
         if (vertex == nullptr) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_VERTEX);
         }
-        auto result = std::vector<ClassId> {};
-        for (const auto &inEdgeRids: vertex->in.keys()) {
-            auto inEdgeClassId = inEdgeRids.first;
-            for (const auto &inEdgePosId: inEdgeRids.second) {
-                auto findInEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                  vertex->in.find(txn.getVersionId(), inEdgeClassId, inEdgePosId) :
-                                  vertex->in.find(inEdgeClassId, inEdgePosId);
-                if (findInEdge.second) {
-                    if (auto inEdge = findInEdge.first.lock()) {
-                        result.push_back(inEdgeClassId);
-                        break;
-                    }
-                }
-            }
-        }
-        return result;
+        return getEdgeClasses(getEdges(txn, vertex->in));
     }
 
     std::vector<RecordId> Graph::getEdgeOut(const BaseTxn &txn, const RecordId &rid, const ClassId &classId) {
@@ -169,34 +133,7 @@ namespace nogdb {
         if (vertex == nullptr) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_VERTEX);
         }
-        auto result = std::vector<RecordId> {};
-        if (classId) {
-            for (const auto &posId: vertex->out.keys(classId)) {
-                auto findOutEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                   vertex->out.find(txn.getVersionId(), classId, posId) :
-                                   vertex->out.find(classId, posId);
-                if (findOutEdge.second) {
-                    if (auto outEdge = findOutEdge.first.lock()) {
-                        result.push_back(outEdge->rid);
-                    }
-                }
-            }
-        } else {
-            for (const auto &outEdgeRids: vertex->out.keys()) {
-                auto outEdgeClassId = outEdgeRids.first;
-                for (const auto &outEdgePosId: outEdgeRids.second) {
-                    auto findOutEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                       vertex->out.find(txn.getVersionId(), outEdgeClassId, outEdgePosId) :
-                                       vertex->out.find(outEdgeClassId, outEdgePosId);
-                    if (findOutEdge.second) {
-                        if (auto outEdge = findOutEdge.first.lock()) {
-                            result.push_back(outEdge->rid);
-                        }
-                    }
-                }
-            }
-        }
-        return result;
+        return getEdges(txn, vertex->out, classId);
     }
 
     std::vector<ClassId> Graph::getEdgeClassOut(const BaseTxn &txn, const RecordId &rid) {
@@ -204,22 +141,7 @@ namespace nogdb {
         if (vertex == nullptr) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_VERTEX);
         }
-        auto result = std::vector<ClassId> {};
-        for (const auto &outEdgeRids: vertex->out.keys()) {
-            auto outEdgeClassId = outEdgeRids.first;
-            for (const auto &outEdgePosId: outEdgeRids.second) {
-                auto findOutEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                   vertex->out.find(txn.getVersionId(), outEdgeClassId, outEdgePosId) :
-                                   vertex->out.find(outEdgeClassId, outEdgePosId);
-                if (findOutEdge.second) {
-                    if (auto outEdge = findOutEdge.first.lock()) {
-                        result.push_back(outEdgeClassId);
-                        break;
-                    }
-                }
-            }
-        }
-        return result;
+        return getEdgeClasses(getEdges(txn, vertex->out));
     }
 
     std::vector<RecordId> Graph::getEdgeInOut(const BaseTxn &txn, const RecordId &rid, const ClassId &classId) {
@@ -227,55 +149,9 @@ namespace nogdb {
         if (vertex == nullptr) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_VERTEX);
         }
-        auto result = std::vector<RecordId> {};
-        if (classId) {
-            for (const auto &posId: vertex->in.keys(classId)) {
-                auto findInEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                  vertex->in.find(txn.getVersionId(), classId, posId) : vertex->in.find(classId, posId);
-                if (findInEdge.second) {
-                    if (auto inEdge = findInEdge.first.lock()) {
-                        result.push_back(inEdge->rid);
-                    }
-                }
-            }
-            for (const auto &posId: vertex->out.keys(classId)) {
-                auto findOutEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                   vertex->out.find(txn.getVersionId(), classId, posId) :
-                                   vertex->out.find(classId, posId);
-                if (findOutEdge.second) {
-                    if (auto outEdge = findOutEdge.first.lock()) {
-                        result.push_back(outEdge->rid);
-                    }
-                }
-            }
-        } else {
-            for (const auto &inEdgeRids: vertex->in.keys()) {
-                auto inEdgeClassId = inEdgeRids.first;
-                for (const auto &inEdgePosId: inEdgeRids.second) {
-                    auto findInEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                      vertex->in.find(txn.getVersionId(), inEdgeClassId, inEdgePosId) :
-                                      vertex->in.find(inEdgeClassId, inEdgePosId);
-                    if (findInEdge.second) {
-                        if (auto inEdge = findInEdge.first.lock()) {
-                            result.push_back(inEdge->rid);
-                        }
-                    }
-                }
-            }
-            for (const auto &outEdgeRids: vertex->out.keys()) {
-                auto outEdgeClassId = outEdgeRids.first;
-                for (const auto &outEdgePosId: outEdgeRids.second) {
-                    auto findOutEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                       vertex->out.find(txn.getVersionId(), outEdgeClassId, outEdgePosId) :
-                                       vertex->out.find(outEdgeClassId, outEdgePosId);
-                    if (findOutEdge.second) {
-                        if (auto outEdge = findOutEdge.first.lock()) {
-                            result.push_back(outEdge->rid);
-                        }
-                    }
-                }
-            }
-        }
+        auto result = getEdges(txn, vertex->in, classId);
+        auto outEdges = getEdges(txn, vertex->out, classId);
+        result.insert(result.end(), outEdges.cbegin(), outEdges.cend());
         std::sort(result.begin(), result.end(), [](const RecordId &lhs, const RecordId &rhs) {
             return (lhs.first == rhs.first) ? lhs.second < rhs.second : lhs.first < rhs.first;
         });
@@ -288,70 +164,54 @@ namespace nogdb {
         if (vertex == nullptr) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_VERTEX);
         }
-        auto result = std::vector<ClassId> {};
-        for (const auto &inEdgeRids: vertex->in.keys()) {
-            auto inEdgeClassId = inEdgeRids.first;
-            for (const auto &inEdgePosId: inEdgeRids.second) {
-                auto findInEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                  vertex->in.find(txn.getVersionId(), inEdgeClassId, inEdgePosId) :
-                                  vertex->in.find(inEdgeClassId, inEdgePosId);
-                if (findInEdge.second) {
-                    if (auto inEdge = findInEdge.first.lock()) {
-                        result.push_back(inEdgeClassId);
-                        break;
-                    }
-                }
-            }
-        }
-        for (const auto &outEdgeRids: vertex->out.keys()) {
-            auto outEdgeClassId = outEdgeRids.first;
-            for (const auto &outEdgePosId: outEdgeRids.second) {
-                auto findOutEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                   vertex->out.find(txn.getVersionId(), outEdgeClassId, outEdgePosId) :
-                                   vertex->out.find(outEdgeClassId, outEdgePosId);
-                if (findOutEdge.second) {
-                    if (auto outEdge = findOutEdge.first.lock()) {
-                        result.push_back(outEdgeClassId);
-                        break;
-                    }
-                }
-            }
-        }
-        std::sort(result.begin(), result.end());
-        result.erase(std::unique(result.begin(), result.end()), result.end());
-        return result;
+        auto edges = getEdges(txn, vertex->in);
+        auto outEdges = getEdges(txn, vertex->out);
+        edges.insert(edges.end(), outEdges.cbegin(), outEdges.cend());
+        return getEdgeClasses(edges);
     }
 
     std::shared_ptr<Graph::Vertex> Graph::lookupVertex(const BaseTxn &txn, const RecordId &rid) {
-        RWSpinLockGuard<RWSpinLock> _(vertices.splock);
-        auto iterator = vertices.elements.find(rid);
-        if (iterator == vertices.elements.cend()) {
-            if (txn.getType() == BaseTxn::TxnType::READ_ONLY) {
-                return nullptr;
-            } else {
+        auto const isCached = isAdjacencyCached() && txn.getDsTxnHandler() != nullptr;
+        auto vertex = vertices.find(rid);
+        if (vertex == nullptr) {
+            if (txn.getType() == BaseTxn::TxnType::READ_WRITE) {
                 auto vertexPtr = txn.findUncommittedVertex(rid);
                 if (vertexPtr != nullptr) {
                     return (vertexPtr->checkReadWrite()) ? nullptr : vertexPtr;
                 }
+            }
+            if (!isCached) {
                 return nullptr;
             }
         } else {
-            if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && iterator->second->checkReadOnly(txn.getVersionId())) ||
-                (txn.getType() == BaseTxn::TxnType::READ_WRITE && iterator->second->checkReadWrite())) {
+            if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && vertex->checkReadOnly(txn.getVersionId())) ||
+                (txn.getType() == BaseTxn::TxnType::READ_WRITE && vertex->checkReadWrite())) {
                 return nullptr;
             }
+            if (!isCached) {
+                return vertex;
+            }
+        }
+        // the adjacency is complete only if it was still loaded after the vertex had been pinned
+        if (vertex != nullptr && vertex->isLoaded) {
+            txn.pinVertex(vertex);
+            if (vertex->isLoaded) {
+                vertex->isReferenced = true;
+                return vertex;
+            }
         }
-        return iterator->second;
+        return loadVertex(txn, rid);
     }
 
     void Graph::forceDeleteVertex(const RecordId &rid) noexcept {
         vertices.lockAndErase(rid);
     }
 
-    void Graph::forceDeleteVertices(const std::vector<RecordId> &rids) noexcept {
-        RWSpinLockGuard<RWSpinLock> _(vertices.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+    void Graph::forceDeleteVertices(const std::vector<RecordId> &rids, TxnId versionId) noexcept {
         for (const auto &rid: rids) {
-            vertices.elements.erase(rid);
+            vertices.lockAndEraseIf(rid, [versionId](const Vertex &vertex) {
+                return vertex.isDeletedBefore(versionId);
+            });
         }
     }
 
@@ -23,9 +23,12 @@
 #include <bitset> // for debugging
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <tuple>
 
 #include "generic.hpp"
 #include "parser.hpp"
+#include "record_version.hpp"
 #include "utils.hpp"
 
 #include "nogdb_errors.h"
@@ -34,37 +37,72 @@
 
 namespace nogdb {
 
-    auto emptyString = std::string{"\n"};
-    const size_t SIZE_OF_EMPTY_STRING = strlen(emptyString.c_str());
-
     Blob Parser::parseRecord(const BaseTxn &txn, size_t dataSize, const ClassProperty &properties, const Record &record) {
-        if (dataSize <= 0) {
-            // create an empty property as a raw data for a class
-            auto value = Blob(SIZE_OF_EMPTY_STRING);
-            value.append(static_cast<void *>(&emptyString), SIZE_OF_EMPTY_STRING);
-            return value;
-        } else {
-            // create properties as a raw data for a class
-            auto value = Blob(dataSize);
-            for (const auto &property: properties) {
-                auto propertyId = static_cast<PropertyId>(property.second.id);
-                auto rawData = record.get(property.first);
-                require(property.second.id < std::pow(2, UINT16_BITS_COUNT));
-                require(rawData.size() < std::pow(2, UINT32_BITS_COUNT - 1));
-                if (rawData.size() < std::pow(2, UINT8_BITS_COUNT - 1)) {
-                    auto size = static_cast<uint8_t>(rawData.size()) << 1;
-                    value.append(&propertyId, sizeof(PropertyId));
-                    value.append(&size, sizeof(uint8_t));
-                    value.append(static_cast<void *>(rawData.getRaw()), rawData.size());
-                } else {
-                    auto size = (static_cast<uint32_t>(rawData.size()) << 1) + 0x1;
-                    value.append(&propertyId, sizeof(PropertyId));
-                    value.append(&size, sizeof(uint32_t));
-                    value.append(static_cast<void *>(rawData.getRaw()), rawData.size());
-                }
+        auto rawData = std::vector<Bytes>{};
+        auto values = std::vector<std::tuple<PropertyId, const unsigned char *, size_t>>{};
+        rawData.reserve(properties.size());
+        values.reserve(properties.size());
+        for (const auto &property: properties) {
+            require(property.second.id < std::pow(2, UINT16_BITS_COUNT));
+            rawData.emplace_back(record.get(property.first));
+            values.emplace_back(static_cast<PropertyId>(property.second.id), rawData.back().getRaw(), rawData.back().size());
+        }
+        return encodeRawData(values, dataSize);
+    }
+
+    Blob Parser::upgradeRawData(const RecordView &recordView) {
+        auto values = std::vector<std::tuple<PropertyId, const unsigned char *, size_t>>{};
+        auto dataSize = size_t{0};
+        recordView.forEach([&](PropertyId propertyId, const unsigned char *value, size_t size) {
+            values.emplace_back(propertyId, value, size);
+            dataSize += getRawDataSize(size);
+            return true;
+        });
+        return encodeRawData(values, dataSize);
+    }
+
+    Blob Parser::mergeRawData(const RecordView &recordView, const std::map<PropertyId, Bytes> &properties) {
+        auto values = std::vector<std::tuple<PropertyId, const unsigned char *, size_t>>{};
+        auto dataSize = size_t{0};
+        recordView.forEach([&](PropertyId propertyId, const unsigned char *value, size_t size) {
+            if (properties.find(propertyId) == properties.cend()) {
+                values.emplace_back(propertyId, value, size);
+                dataSize += getRawDataSize(size);
+            }
+            return true;
+        });
+        for (const auto &property: properties) {
+            values.emplace_back(property.first, property.second.getRaw(), property.second.size());
+            dataSize += getRawDataSize(property.second.size());
+        }
+        return encodeRawData(values, dataSize);
+    }
+
+    Blob Parser::encodeRawData(std::vector<std::tuple<PropertyId, const unsigned char *, size_t>> &values, size_t dataSize) {
+        // NOTE: the directory format is described in RecordView
+        std::sort(values.begin(), values.end());
+        auto const headerSize = 2 * sizeof(uint16_t) + sizeof(uint32_t);
+        require(headerSize + dataSize < std::pow(2, UINT32_BITS_COUNT));
+        auto value = Blob(headerSize + dataSize);
+        auto format = RECORD_FORMAT_DIRECTORY;
+        auto count = static_cast<uint16_t>(values.size());
+        value.append(&format, sizeof(uint16_t));
+        value.append(&count, sizeof(uint16_t));
+        for (const auto &property: values) {
+            value.append(&std::get<0>(property), sizeof(PropertyId));
+        }
+        auto offset = uint32_t{0};
+        for (const auto &property: values) {
+            value.append(&offset, sizeof(uint32_t));
+            offset += static_cast<uint32_t>(std::get<2>(property));
+        }
+        value.append(&offset, sizeof(uint32_t));
+        for (const auto &property: values) {
+            if (std::get<2>(property) > 0) {
+                value.append(std::get<1>(property), std::get<2>(property));
             }
-            return value;
         }
+        return value;
     }
 
     Blob Parser::parseRecord(const BaseTxn &txn,
@@ -72,9 +110,17 @@ namespace nogdb {
                              const Record &record,
                              ClassPropertyInfo& classInfo,
                              std::map<std::string, std::tuple<PropertyType, IndexId, bool>>& indexInfos) {
+        classInfo = Generic::getClassMapProperty(txn, classDescriptor);
+        return parseRecord(txn, classDescriptor->id, classInfo, record, indexInfos);
+    }
+
+    Blob Parser::parseRecord(const BaseTxn &txn,
+                             const ClassId &classId,
+                             const ClassPropertyInfo &classInfo,
+                             const Record &record,
+                             std::map<std::string, std::tuple<PropertyType, IndexId, bool>>& indexInfos) {
         auto dataSize = size_t{0};
         auto properties = decltype(classInfo.nameToDesc) {};
-        classInfo = Generic::getClassMapProperty(txn, classDescriptor);
 
         // calculate a raw data size of properties in a record
         for (const auto &property: record.getAll()) {
@@ -84,7 +130,7 @@ namespace nogdb {
             }
             // check if having any index
             for (const auto &indexIter: foundProperty->second.indexInfo) {
-                if (indexIter.second.first == classDescriptor->id) {
+                if (indexIter.second.first == classId) {
                     indexInfos.emplace(
                             property.first,
                             std::make_tuple(
@@ -121,67 +167,93 @@ namespace nogdb {
 
     Record Parser::parseRawData(const storage_engine::lmdb::Result &rawData,
                                 const ClassPropertyInfo &classPropertyInfo) {
-        if (rawData.empty) {
-            return Record{};
-        }
-        auto rawDataBlob = rawData.data.blob();
-        auto offset = size_t{0};
-        Record::PropertyToBytesMap properties;
-        if (rawDataBlob.capacity() == 0) {
-            throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_UNKNOWN_ERR);
-        } else if (rawDataBlob.capacity() >= 2 * sizeof(uint16_t)) {
-            //TODO: should be concerned about ENDIAN?
-            // NOTE: each property block consists of property id, flag, size, and value
-            // when option flag = 0
-            // +----------------------+--------------------+-----------------------+-----------+
-            // | propertyId (16bits)  | option flag (1bit) | propertySize (7bits)  |   value   | (next block) ...
-            // +----------------------+--------------------+-----------------------+-----------+
-            // when option flag = 1 (for extra large size of value)
-            // +----------------------+--------------------+------------------------+-----------+
-            // | propertyId (16bits)  | option flag (1bit) | propertySize (31bits)  |   value   | (next block) ...
-            // +----------------------+--------------------+------------------------+-----------+
-            while (offset < rawDataBlob.size()) {
-                auto propertyId = PropertyId{};
-                auto optionFlag = uint8_t{};
-                offset = rawDataBlob.retrieve(&propertyId, offset, sizeof(PropertyId));
-                rawDataBlob.retrieve(&optionFlag, offset, sizeof(optionFlag));
-                auto propertySize = size_t{};
-                if ((optionFlag & 0x1) == 1) {
-                    //extra large size of value (exceed 127 bytes)
-                    auto tmpSize =  uint32_t{};
-                    offset = rawDataBlob.retrieve(&tmpSize, offset, sizeof(uint32_t));
-                    propertySize = static_cast<size_t>(tmpSize >> 1);
-                } else {
-                    //normal size of value (not exceed 127 bytes)
-                    auto tmpSize = uint8_t{};
-                    offset = rawDataBlob.retrieve(&tmpSize, offset, sizeof(uint8_t));
-                    propertySize = static_cast<size_t>(tmpSize >> 1);
-                }
-                auto foundInfo = classPropertyInfo.idToName.find(propertyId);
-                if (foundInfo != classPropertyInfo.idToName.cend()) {
-                    if (propertySize > 0) {
-                        Blob::Byte byteData[propertySize];
-                        offset = rawDataBlob.retrieve(byteData, offset, propertySize);
-                        properties[foundInfo->second] = Bytes{byteData, propertySize};
-                    } else {
-                        properties[foundInfo->second] = Bytes{};
-                    }
-                } else {
-                    offset += propertySize;
-                }
+        return parseRawData(RecordView{rawData}, classPropertyInfo);
+    }
+
+    Record Parser::parseRawData(const RecordView &recordView, const ClassPropertyInfo &classPropertyInfo) {
+        auto properties = Record::PropertyIdToBytes{};
+        properties.reserve(classPropertyInfo.propertyNames->idToName.size());
+        recordView.forEach([&](PropertyId propertyId, const unsigned char *value, size_t size) {
+            if (classPropertyInfo.propertyNames->idToName.find(propertyId) != classPropertyInfo.propertyNames->idToName.cend()) {
+                properties.emplace_back(propertyId, (size > 0) ? Bytes{value, size} : Bytes{});
             }
-        }
-        return Record(properties);
+            return true;
+        });
+        return Record(std::move(properties), classPropertyInfo.propertyNames);
     }
 
-    Record Parser::parseRawDataWithBasicInfo(const std::string &className,
+    Record Parser::parseRawDataWithBasicInfo(const BaseTxn &txn,
+                                             const std::string &className,
                                              const RecordId& rid,
                                              const storage_engine::lmdb::Result &rawData,
                                              const ClassPropertyInfo &classPropertyInfo) {
-        return parseRawData(rawData, classPropertyInfo)
-                .setBasicInfoIfNotExists(CLASS_NAME_PROPERTY, className)
+        return parseRawDataWithBasicInfo(txn, className, rid, RecordView{rawData}, classPropertyInfo);
+    }
+
+    Record Parser::parseRawDataWithBasicInfo(const BaseTxn &txn,
+                                             const std::string &className,
+                                             const RecordId& rid,
+                                             const RecordView &recordView,
+                                             const ClassPropertyInfo &classPropertyInfo) {
+        auto record = parseRawData(recordView, classPropertyInfo);
+        // a version bumped by edge operations takes precedence over the one stored in the record
+        auto version = RecordVersion::find(txn, rid, classPropertyInfo.classType);
+        if (version.second) {
+            record.setBasicInfo(VERSION_PROPERTY, version.first.first);
+            record.setBasicInfo(TXN_VERSION, version.first.second);
+        }
+        record.setBasicInfoIfNotExists(CLASS_NAME_PROPERTY, className)
                 .setBasicInfoIfNotExists(RECORD_ID_PROPERTY, rid2str(rid))
                 .setBasicInfoIfNotExists(VERSION_PROPERTY, 1LL)
                 .setBasicInfoIfNotExists(DEPTH_PROPERTY, 0U);
+        return record;
+    }
+
+    Record Parser::parseRawDataWithBasicInfo(const BaseTxn &txn,
+                                             const std::string &className,
+                                             const RecordId& rid,
+                                             const RecordView &recordView,
+                                             const ClassPropertyInfo &classPropertyInfo,
+                                             const std::set<std::string> &propertyNames) {
+        auto record = parseRawData(recordView, classPropertyInfo, propertyNames);
+        auto isListed = [&propertyNames](const std::string &propertyName) {
+            return propertyNames.find(propertyName) != propertyNames.cend();
+        };
+        if (isListed(VERSION_PROPERTY) || isListed(TXN_VERSION)) {
+            auto version = RecordVersion::find(txn, rid, classPropertyInfo.classType);
+            if (version.second) {
+                if (isListed(VERSION_PROPERTY)) {
+                    record.setBasicInfo(VERSION_PROPERTY, version.first.first);
+                }
+                if (isListed(TXN_VERSION)) {
+                    record.setBasicInfo(TXN_VERSION, version.first.second);
+                }
+            }
+            if (isListed(VERSION_PROPERTY)) {
+                record.setBasicInfoIfNotExists(VERSION_PROPERTY, 1LL);
+            }
+        }
+        if (isListed(CLASS_NAME_PROPERTY)) {
+            record.setBasicInfo(CLASS_NAME_PROPERTY, className);
+        }
+        if (isListed(RECORD_ID_PROPERTY)) {
+            record.setBasicInfo(RECORD_ID_PROPERTY, rid2str(rid));
+        }
+        if (isListed(DEPTH_PROPERTY)) {
+            record.setBasicInfoIfNotExists(DEPTH_PROPERTY, 0U);
+        }
+        return record;
+    }
+
+    Bytes Parser::parseRawDataProperty(const BaseTxn &txn,
+                                       const std::string &className,
+                                       const RecordId& rid,
+                                       const RecordView &recordView,
+                                       const ClassPropertyInfo &classPropertyInfo,
+                                       const std::string &propertyName) {
+        if (isBasicInfo(propertyName)) {
+            return parseRawDataWithBasicInfo(txn, className, rid, recordView, classPropertyInfo).get(propertyName);
+        }
+        return recordView.get(classPropertyInfo, propertyName);
     }
 }
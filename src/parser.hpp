@@ -23,9 +23,13 @@
 #define __PARSER_HPP_INCLUDED_
 
 #include <map>
+#include <set>
+#include <tuple>
+#include <vector>
 
 #include "datatype.hpp"
 #include "lmdb_engine.hpp"
+#include "record_view.hpp"
 #include "schema.hpp"
 
 #include "nogdb_types.h"
@@ -49,16 +53,82 @@ namespace nogdb {
                                 ClassPropertyInfo& classInfo,
                                 std::map<std::string, std::tuple<PropertyType, IndexId, bool>>& indexInfos);
 
+        static Blob parseRecord(const BaseTxn &txn,
+                                const ClassId &classId,
+                                const ClassPropertyInfo &classInfo,
+                                const Record &record,
+                                std::map<std::string, std::tuple<PropertyType, IndexId, bool>>& indexInfos);
+
         static Record parseRawData(const storage_engine::lmdb::Result &rawData, const ClassPropertyInfo &classPropertyInfo);
 
-        static Record parseRawDataWithBasicInfo(const std::string &className,
+        static Record parseRawData(const RecordView &recordView, const ClassPropertyInfo &classPropertyInfo);
+
+        // decodes only the given properties, e.g. those needed to evaluate a condition, and skips the others
+        template<typename PropertyNames>
+        static Record parseRawData(const RecordView &recordView,
+                                   const ClassPropertyInfo &classPropertyInfo,
+                                   const PropertyNames &propertyNames) {
+            auto properties = Record::PropertyIdToBytes{};
+            auto remaining = propertyNames.size();
+            properties.reserve(remaining);
+            recordView.forEach([&](PropertyId propertyId, const unsigned char *value, size_t size) {
+                auto foundInfo = classPropertyInfo.propertyNames->idToName.find(propertyId);
+                if (foundInfo != classPropertyInfo.propertyNames->idToName.cend() &&
+                    propertyNames.find(foundInfo->second) != propertyNames.cend()) {
+                    properties.emplace_back(propertyId, (size > 0) ? Bytes{value, size} : Bytes{});
+                    --remaining;
+                }
+                return remaining > 0;
+            });
+            return Record(std::move(properties), classPropertyInfo.propertyNames);
+        }
+
+        static Record parseRawDataWithBasicInfo(const BaseTxn &txn,
+                                                const std::string &className,
                                                 const RecordId& rid,
                                                 const storage_engine::lmdb::Result &rawData,
                                                 const ClassPropertyInfo &classPropertyInfo);
 
+        static Record parseRawDataWithBasicInfo(const BaseTxn &txn,
+                                                const std::string &className,
+                                                const RecordId& rid,
+                                                const RecordView &recordView,
+                                                const ClassPropertyInfo &classPropertyInfo);
+
+        // a record with the given properties only, where basic info is generated only when it is listed
+        static Record parseRawDataWithBasicInfo(const BaseTxn &txn,
+                                                const std::string &className,
+                                                const RecordId& rid,
+                                                const RecordView &recordView,
+                                                const ClassPropertyInfo &classPropertyInfo,
+                                                const std::set<std::string> &propertyNames);
+
+        // the value of a single property, where basic info (e.g. @version) requires the whole record
+        static Bytes parseRawDataProperty(const BaseTxn &txn,
+                                          const std::string &className,
+                                          const RecordId& rid,
+                                          const RecordView &recordView,
+                                          const ClassPropertyInfo &classPropertyInfo,
+                                          const std::string &propertyName);
+
+        inline static bool isBasicInfo(const std::string &propertyName) {
+            return !propertyName.empty() && propertyName[0] == '@';
+        }
+
+        // re-encodes a record stored in the legacy format into the directory format
+        static Blob upgradeRawData(const RecordView &recordView);
+
+        // re-encodes a stored record with the given properties added or replaced
+        static Blob mergeRawData(const RecordView &recordView, const std::map<PropertyId, Bytes> &properties);
+
+        // the size of a property in the directory format, excluding the header
         inline static size_t getRawDataSize(size_t size) {
-            return sizeof(PropertyId) + size + ((size >= std::pow(2, UINT8_BITS_COUNT - 1))? sizeof(uint32_t): sizeof(uint8_t));
+            return sizeof(PropertyId) + sizeof(uint32_t) + size;
         };
+
+    private:
+        static Blob encodeRawData(std::vector<std::tuple<PropertyId, const unsigned char *, size_t>> &values,
+                                  size_t dataSize);
     };
 
 }
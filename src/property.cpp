@@ -193,9 +193,9 @@ namespace nogdb {
                 case PropertyType::UNSIGNED_SMALLINT:
                 case PropertyType::UNSIGNED_INTEGER:
                 case PropertyType::UNSIGNED_BIGINT: {
-                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingName(dbInfo.maxIndexId), true, isUnique);
+                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingKey(dbInfo.maxIndexId), true, isUnique);
                     auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, foundClass);
-                    auto cursorHandler = dsTxnHandler->openCursor(std::to_string(foundClass->id), true);
+                    auto cursorHandler = dsTxnHandler->openClassCursor(foundClass->id);
                     auto keyValue = cursorHandler.getNext();
                     while (!keyValue.empty()) {
                         auto key = keyValue.key.data.numeric<PositionId>();
@@ -226,10 +226,10 @@ namespace nogdb {
                 case PropertyType::INTEGER:
                 case PropertyType::BIGINT:
                 case PropertyType::REAL: {
-                    auto dataIndexDBHandlerPositive = dsTxnHandler->openDbi(Index::getIndexingName(dbInfo.maxIndexId, true), true, isUnique);
-                    auto dataIndexDBHandlerNegative = dsTxnHandler->openDbi(Index::getIndexingName(dbInfo.maxIndexId, false), true, isUnique);
+                    auto dataIndexDBHandlerPositive = dsTxnHandler->openDbi(Index::getIndexingKey(dbInfo.maxIndexId, true), true, isUnique);
+                    auto dataIndexDBHandlerNegative = dsTxnHandler->openDbi(Index::getIndexingKey(dbInfo.maxIndexId, false), true, isUnique);
                     auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, foundClass);
-                    auto cursorHandler = dsTxnHandler->openCursor(std::to_string(foundClass->id), true);
+                    auto cursorHandler = dsTxnHandler->openClassCursor(foundClass->id);
                     auto keyValue = cursorHandler.getNext();
                     while (!keyValue.empty()) {
                         auto key = keyValue.key.data.numeric<PositionId>();
@@ -283,9 +283,9 @@ namespace nogdb {
                     break;
                 }
                 case PropertyType::TEXT: {
-                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingName(dbInfo.maxIndexId), false, isUnique);
+                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingKey(dbInfo.maxIndexId), false, isUnique);
                     auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, foundClass);
-                    auto cursorHandler = dsTxnHandler->openCursor(std::to_string(foundClass->id), true);
+                    auto cursorHandler = dsTxnHandler->openClassCursor(foundClass->id);
                     auto keyValue = cursorHandler.getNext();
                     while (!keyValue.empty()) {
                         auto key = keyValue.key.data.numeric<PositionId>();
@@ -362,8 +362,7 @@ namespace nogdb {
                 case PropertyType::UNSIGNED_SMALLINT:
                 case PropertyType::UNSIGNED_INTEGER:
                 case PropertyType::UNSIGNED_BIGINT: {
-                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingName(indexId), true, isUnique);
-                    dataIndexDBHandler.drop(true);
+                    dsTxnHandler->dropDbi(Index::getIndexingKey(indexId), true, isUnique);
                     break;
                 }
                 case PropertyType::TINYINT:
@@ -371,15 +370,12 @@ namespace nogdb {
                 case PropertyType::INTEGER:
                 case PropertyType::BIGINT:
                 case PropertyType::REAL: {
-                    auto dataIndexDBHandlerPositive = dsTxnHandler->openDbi(Index::getIndexingName(indexId, true), true, isUnique);
-                    auto dataIndexDBHandlerNegative = dsTxnHandler->openDbi(Index::getIndexingName(indexId, false), true, isUnique);
-                    dataIndexDBHandlerPositive.drop(true);
-                    dataIndexDBHandlerNegative.drop(true);
+                    dsTxnHandler->dropDbi(Index::getIndexingKey(indexId, true), true, isUnique);
+                    dsTxnHandler->dropDbi(Index::getIndexingKey(indexId, false), true, isUnique);
                     break;
                 }
                 case PropertyType::TEXT: {
-                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingName(indexId), false, isUnique);
-                    dataIndexDBHandler.drop(true);
+                    dsTxnHandler->dropDbi(Index::getIndexingKey(indexId), false, isUnique);
                     break;
                 }
                 default:
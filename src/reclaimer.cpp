@@ -0,0 +1,152 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <algorithm>
+
+#include "reclaimer.hpp"
+
+namespace nogdb {
+
+    Reclaimer::Reclaimer(const std::shared_ptr<Schema> &schema_, const std::shared_ptr<Graph> &graph_,
+                         const std::shared_ptr<TxnStat> &txnStat_, unsigned int intervalMs_)
+            : schema{schema_}, graph{graph_}, txnStat{txnStat_}, interval{intervalMs_} {
+        worker = std::thread{&Reclaimer::run, this};
+    }
+
+    Reclaimer::~Reclaimer() noexcept {
+        {
+            std::lock_guard<std::mutex> _(mutex);
+            isStopping = true;
+        }
+        condition.notify_one();
+        worker.join();
+    }
+
+    void Reclaimer::addStaleVersions(const std::shared_ptr<Schema::ClassDescriptor> &classDescriptor) {
+        std::lock_guard<std::mutex> _(mutex);
+        staleClassDescriptors.emplace(classDescriptor->id, classDescriptor);
+    }
+
+    void Reclaimer::addDirtyVertex(const std::shared_ptr<Graph::Vertex> &vertex) {
+        std::lock_guard<std::mutex> _(mutex);
+        dirtyVertices[vertex->rid] = vertex;
+    }
+
+    void Reclaimer::notify() {
+        {
+            std::lock_guard<std::mutex> _(mutex);
+            isNotified = true;
+        }
+        condition.notify_one();
+    }
+
+    ReclaimStat Reclaimer::getStat() const {
+        auto result = ReclaimStat{};
+        result.safeVersionId = safeVersionId;
+        result.versionLag = txnStat->maxVersionId - std::min(result.safeVersionId, txnStat->maxVersionId.load());
+        result.numPendingElements = schema->deletedClassId.size() + graph->deletedVertices.size() +
+                                    graph->deletedEdges.size();
+        {
+            std::lock_guard<std::mutex> _(mutex);
+            result.numPendingVersions = staleClassDescriptors.size() + dirtyVertices.size();
+        }
+        result.numReclaimedElements = numReclaimedElements;
+        result.numRuns = numRuns;
+        return result;
+    }
+
+    void Reclaimer::run() {
+        auto isPending = false;
+        auto lastRun = std::chrono::steady_clock::time_point{};
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                // leftovers wait for older readers, which complete without notifying
+                if (isPending) {
+                    condition.wait_for(lock, interval, [this]() { return isStopping || isNotified; });
+                } else {
+                    condition.wait(lock, [this]() { return isStopping || isNotified; });
+                }
+                // run at most once per interval, so a burst of commits shares a single merge of each adjacency
+                condition.wait_until(lock, lastRun + interval, [this]() { return isStopping; });
+                if (isStopping) {
+                    return;
+                }
+                isNotified = false;
+            }
+            isPending = reclaim();
+            lastRun = std::chrono::steady_clock::now();
+        }
+    }
+
+    bool Reclaimer::reclaim() {
+        // a reader missing from the scan starts at a version which is not older than this one
+        auto const maxVersionId = txnStat->maxVersionId.load();
+        auto const oldestTxn = txnStat->minActiveTxnId();
+        auto const currentSafeVersionId = (oldestTxn.first != 0) ? std::min(oldestTxn.second, maxVersionId)
+                                                                 : maxVersionId;
+        numReclaimedElements += schema->clearDeletedElements(currentSafeVersionId) +
+                                graph->clearDeletedElements(currentSafeVersionId);
+
+        auto classDescriptors = decltype(staleClassDescriptors){};
+        auto vertices = decltype(dirtyVertices){};
+        {
+            std::lock_guard<std::mutex> _(mutex);
+            classDescriptors.swap(staleClassDescriptors);
+            vertices.swap(dirtyVertices);
+        }
+        for (auto it = classDescriptors.begin(); it != classDescriptors.end();) {
+            auto classDescriptor = it->second.lock();
+            if (classDescriptor == nullptr ||
+                std::max({classDescriptor->name.clearStableVersion(currentSafeVersionId),
+                          classDescriptor->properties.clearStableVersion(currentSafeVersionId),
+                          classDescriptor->super.clearStableVersion(currentSafeVersionId),
+                          classDescriptor->sub.clearStableVersion(currentSafeVersionId)}) <= 1) {
+                it = classDescriptors.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (auto it = vertices.begin(); it != vertices.end();) {
+            auto vertex = it->second.lock();
+            if (vertex == nullptr ||
+                std::max(vertex->out.clear(currentSafeVersionId), vertex->in.clear(currentSafeVersionId)) == 0) {
+                it = vertices.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        auto isPending = false;
+        {
+            std::lock_guard<std::mutex> _(mutex);
+            // elements registered in the meantime are collapsed in the next run
+            staleClassDescriptors.insert(classDescriptors.cbegin(), classDescriptors.cend());
+            dirtyVertices.insert(vertices.cbegin(), vertices.cend());
+            isPending = !staleClassDescriptors.empty() || !dirtyVertices.empty();
+        }
+        safeVersionId = currentSafeVersionId;
+        ++numRuns;
+        return isPending || schema->deletedClassId.size() + graph->deletedVertices.size() +
+                            graph->deletedEdges.size() > 0;
+    }
+
+}
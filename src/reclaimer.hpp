@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RECLAIMER_HPP_INCLUDED_
+#define __RECLAIMER_HPP_INCLUDED_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "txn_object.hpp"
+#include "schema.hpp"
+#include "graph.hpp"
+
+#include "nogdb_types.h"
+
+namespace nogdb {
+
+    // Frees deleted schema and graph elements and collapses stale versions in a background thread, as soon as
+    // no active reader can see them anymore.
+    class Reclaimer {
+    public:
+        Reclaimer(const std::shared_ptr<Schema> &schema_, const std::shared_ptr<Graph> &graph_,
+                  const std::shared_ptr<TxnStat> &txnStat_, unsigned int intervalMs_);
+
+        ~Reclaimer() noexcept;
+
+        Reclaimer(const Reclaimer &) = delete;
+
+        Reclaimer &operator=(const Reclaimer &) = delete;
+
+        // register a class which has got a new stable version in a commit
+        void addStaleVersions(const std::shared_ptr<Schema::ClassDescriptor> &classDescriptor);
+
+        // register a vertex whose adjacency has got changes committed on top of its merged edges
+        void addDirtyVertex(const std::shared_ptr<Graph::Vertex> &vertex);
+
+        // wake up the background thread after a commit has left something to reclaim
+        void notify();
+
+        ReclaimStat getStat() const;
+
+    private:
+        std::shared_ptr<Schema> schema;
+        std::shared_ptr<Graph> graph;
+        std::shared_ptr<TxnStat> txnStat;
+        std::chrono::milliseconds interval;
+
+        mutable std::mutex mutex{};
+        std::condition_variable condition{};
+        bool isStopping{false};
+        bool isNotified{false};
+        std::unordered_map<ClassId, std::weak_ptr<Schema::ClassDescriptor>> staleClassDescriptors{};
+        std::unordered_map<RecordId, std::weak_ptr<Graph::Vertex>, Graph::RecordIdHash> dirtyVertices{};
+
+        std::atomic<TxnId> safeVersionId{0};
+        std::atomic<unsigned long> numReclaimedElements{0};
+        std::atomic<unsigned long> numRuns{0};
+
+        std::thread worker;
+
+        void run();
+
+        // returns true if there are still elements waiting for older readers
+        bool reclaim();
+    };
+
+}
+
+#endif
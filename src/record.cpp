@@ -33,8 +33,41 @@
 
 namespace nogdb {
 
+    Record::Record(const Record &other)
+            : properties(other.properties),
+              basicProperties(other.basicProperties),
+              compactProperties(other.compactProperties),
+              propertyNames(other.propertyNames),
+              expandedProperties(std::atomic_load(&other.expandedProperties)) {}
+
+    Record &Record::operator=(const Record &other) {
+        if (this != &other) {
+            properties = other.properties;
+            basicProperties = other.basicProperties;
+            compactProperties = other.compactProperties;
+            propertyNames = other.propertyNames;
+            expandedProperties = std::atomic_load(&other.expandedProperties);
+        }
+        return *this;
+    }
+
     const Record::PropertyToBytesMap &Record::getAll() const {
-        return properties;
+        if (!propertyNames) {
+            return properties;
+        }
+        auto expanded = std::atomic_load(&expandedProperties);
+        if (!expanded) {
+            auto result = std::make_shared<PropertyToBytesMap>();
+            for (const auto &property: compactProperties) {
+                result->emplace(propertyNames->idToName.at(property.first), property.second);
+            }
+            auto desired = std::shared_ptr<const PropertyToBytesMap>{std::move(result)};
+            // a concurrent reader may have built the same map first
+            if (std::atomic_compare_exchange_strong(&expandedProperties, &expanded, desired)) {
+                expanded = std::move(desired);
+            }
+        }
+        return *expanded;
     }
 
     const Record::PropertyToBytesMap &Record::getBasicInfo() const {
@@ -42,6 +75,19 @@ namespace nogdb {
     }
 
     Bytes Record::get(const std::string &propName) const {
+        if (propertyNames && !isBasicInfo(propName)) {
+            auto propertyId = propertyNames->nameToId.find(propName);
+            if (propertyId == propertyNames->nameToId.cend()) {
+                return Bytes{};
+            }
+            auto found = std::lower_bound(
+                    compactProperties.cbegin(), compactProperties.cend(), propertyId->second,
+                    [](const std::pair<PropertyId, Bytes> &property, PropertyId id) {
+                        return property.first < id;
+                    });
+            return (found != compactProperties.cend() && found->first == propertyId->second) ? found->second
+                                                                                             : Bytes{};
+        }
         const PropertyToBytesMap &prop = (isBasicInfo(propName) ? basicProperties : properties);
         const PropertyToBytesMap::const_iterator it = prop.find(propName);
         return it == prop.cend() ? Bytes{} : it->second;
@@ -49,6 +95,13 @@ namespace nogdb {
 
     std::vector<std::string> Record::getProperties() const {
         auto propertyNames = std::vector<std::string>{};
+        if (this->propertyNames) {
+            for (const auto &property: compactProperties) {
+                propertyNames.emplace_back(this->propertyNames->idToName.at(property.first));
+            }
+            std::sort(propertyNames.begin(), propertyNames.end());
+            return propertyNames;
+        }
         for (const auto &property: properties) {
             propertyNames.emplace_back(property.first);
         }
@@ -175,20 +228,24 @@ namespace nogdb {
     }
 
     void Record::unset(const std::string &propName) {
+        expand();
         (isBasicInfo(propName) ? basicProperties : properties).erase(propName);
     }
 
     size_t Record::size() const {
-        return properties.size();
+        return propertyNames ? compactProperties.size() : properties.size();
     }
 
     bool Record::empty() const {
-        return properties.empty();
+        return propertyNames ? compactProperties.empty() : properties.empty();
     }
 
     void Record::clear() {
         basicProperties.clear();
         properties.clear();
+        compactProperties.clear();
+        propertyNames.reset();
+        expandedProperties.reset();
     }
 
     Record::Record(PropertyToBytesMap properties) : properties(std::move(properties)) {
@@ -202,6 +259,35 @@ namespace nogdb {
         }
     }
 
+    Record::Record(PropertyIdToBytes properties, std::shared_ptr<const PropertyNameMap> propertyNames)
+            : compactProperties(std::move(properties)), propertyNames(std::move(propertyNames)) {
+        auto last = compactProperties.begin();
+        for (auto &property: compactProperties) {
+            auto &propertyName = this->propertyNames->idToName.at(property.first);
+            if (isBasicInfo(propertyName)) {
+                basicProperties[propertyName] = std::move(property.second);
+            } else {
+                *last++ = std::move(property);
+            }
+        }
+        compactProperties.erase(last, compactProperties.end());
+        std::sort(compactProperties.begin(), compactProperties.end(),
+                  [](const std::pair<PropertyId, Bytes> &lhs, const std::pair<PropertyId, Bytes> &rhs) {
+                      return lhs.first < rhs.first;
+                  });
+    }
+
+    void Record::expand() {
+        if (propertyNames) {
+            for (auto &property: compactProperties) {
+                properties[propertyNames->idToName.at(property.first)] = std::move(property.second);
+            }
+            compactProperties.clear();
+            propertyNames.reset();
+            expandedProperties.reset();
+        }
+    }
+
     const Record &Record::updateVersion(const Txn& txn) const {
         if (basicProperties.find(TXN_VERSION) == basicProperties.end() || getBigIntU(TXN_VERSION) != txn.getVersionId()) {
             setBasicInfo(TXN_VERSION, txn.getVersionId());
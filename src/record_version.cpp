@@ -0,0 +1,121 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "constant.hpp"
+#include "lmdb_engine.hpp"
+#include "storage_engine.hpp"
+#include "parser.hpp"
+#include "record_version.hpp"
+
+namespace nogdb {
+
+    std::pair<RecordVersion::Version, bool> RecordVersion::find(const BaseTxn &txn, const RecordId &rid) {
+        if (auto relation = txn.getRelation()) {
+            auto vertex = relation->vertices.find(rid);
+            if (vertex != nullptr && vertex->noVersionBumpSince <= txn.getVersionId()) {
+                return std::make_pair(Version{}, false);
+            }
+        }
+        auto versionDBHandler = txn.getDsTxnHandler()->openDbi(storage_engine::LMDBDbiRegistry::versionsKey(), true);
+        auto dsResult = versionDBHandler.get(getKey(rid));
+        if (dsResult.empty) {
+            return std::make_pair(Version{}, false);
+        }
+        auto version = Version{};
+        auto data = dsResult.data.blob();
+        auto offset = data.retrieve(&version.first, 0, sizeof(uint64_t));
+        data.retrieve(&version.second, offset, sizeof(TxnId));
+        return std::make_pair(version, true);
+    }
+
+    std::pair<RecordVersion::Version, bool>
+    RecordVersion::find(const BaseTxn &txn, const RecordId &rid, ClassType type) {
+        if (type == ClassType::EDGE) {
+            return std::make_pair(Version{}, false);
+        }
+        return find(txn, rid);
+    }
+
+    void RecordVersion::bump(BaseTxn &txn, const RecordId &rid) {
+        auto current = find(txn, rid);
+        if (!current.second) {
+            // fall back to the version stored in the record itself
+            auto classDBHandler = txn.getDsTxnHandler()->openClassDbi(rid.first);
+            auto classPropertyInfo = ClassPropertyInfo{};
+            classPropertyInfo.insert(TXN_VERSION_ID, TXN_VERSION, PropertyType::UNSIGNED_BIGINT);
+            auto dsResult = classDBHandler.get(rid.second);
+            if (dsResult.data.empty()) {
+                return;
+            }
+            auto record = Parser::parseRawData(dsResult, classPropertyInfo);
+            current.first.first = record.getVersion();
+            if (current.first.first == 0ULL) {
+                current.first.first = 1ULL;
+            }
+            auto txnVersion = record.getBasicInfo().find(TXN_VERSION);
+            current.first.second = (txnVersion != record.getBasicInfo().cend()) ? txnVersion->second.toBigIntU() : 0ULL;
+        }
+        // readers of any version look the vertex up from now on, until a commit rewrites its record
+        if (auto relation = txn.getRelation()) {
+            if (auto vertex = relation->vertices.find(rid)) {
+                vertex->noVersionBumpSince = std::numeric_limits<TxnId>::max();
+            }
+        }
+        txn.trackVersionBump(rid, true);
+        if (current.first.second != txn.getVersionId()) {
+            auto value = Blob(sizeof(uint64_t) + sizeof(TxnId));
+            auto const version = current.first.first + 1ULL;
+            auto const versionId = txn.getVersionId();
+            value.append(&version, sizeof(uint64_t));
+            value.append(&versionId, sizeof(TxnId));
+            txn.getDsTxnHandler()->openDbi(storage_engine::LMDBDbiRegistry::versionsKey(), true)
+                    .put(getKey(rid), value);
+        }
+    }
+
+    void RecordVersion::remove(BaseTxn &txn, const RecordId &rid) {
+        txn.getDsTxnHandler()->openDbi(storage_engine::LMDBDbiRegistry::versionsKey(), true).del(getKey(rid));
+        txn.trackVersionBump(rid, false);
+    }
+
+    void RecordVersion::removeAll(const BaseTxn &txn, const ClassId &classId) {
+        auto versionCursor = txn.getDsTxnHandler()->openCursor(storage_engine::LMDBDbiRegistry::versionsKey(), true);
+        auto const lastKey = getKey(RecordId{classId, UINT32_MAX});
+        for (auto keyValue = versionCursor.findRange(getKey(RecordId{classId, 0}));
+             !keyValue.empty() && keyValue.key.data.numeric<uint64_t>() <= lastKey;
+             keyValue = versionCursor.getNext()) {
+            versionCursor.del();
+        }
+    }
+
+    void RecordVersion::restore(storage_engine::LMDBTxn &dsTxn, Graph &graph) {
+        auto versionCursor = dsTxn.openCursor(storage_engine::LMDBDbiRegistry::versionsKey(), true);
+        for (auto keyValue = versionCursor.getNext(); !keyValue.empty(); keyValue = versionCursor.getNext()) {
+            auto const key = keyValue.key.data.numeric<uint64_t>();
+            if (auto vertex = graph.vertices.find(RecordId{static_cast<ClassId>(key >> 32),
+                                                           static_cast<PositionId>(key)})) {
+                vertex->noVersionBumpSince = std::numeric_limits<TxnId>::max();
+            }
+        }
+    }
+
+}
@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RECORD_VERSION_HPP_INCLUDED_
+#define __RECORD_VERSION_HPP_INCLUDED_
+
+#include <limits>
+#include <utility>
+
+#include "base_txn.hpp"
+
+#include "nogdb_types.h"
+
+namespace nogdb {
+
+    // NOTE: version bumps of vertices caused by edge operations are kept in a side table
+    // instead of rewriting the whole vertex record (and its index entries).
+    // An entry exists only while the stored record carries an out-of-date version.
+    // A vertex kept in the in-memory graph knows whether it may have an entry, so that reading it does not
+    // look up the side table otherwise. Edges are never bumped.
+    struct RecordVersion {
+        RecordVersion() = delete;
+
+        ~RecordVersion() noexcept = delete;
+
+        typedef std::pair<uint64_t, TxnId> Version;
+
+        static std::pair<Version, bool> find(const BaseTxn &txn, const RecordId &rid);
+
+        static std::pair<Version, bool> find(const BaseTxn &txn, const RecordId &rid, ClassType type);
+
+        static void bump(BaseTxn &txn, const RecordId &rid);
+
+        static void remove(BaseTxn &txn, const RecordId &rid);
+
+        static void removeAll(const BaseTxn &txn, const ClassId &classId);
+
+        // mark the vertices loaded at the context start-up which have an entry
+        static void restore(storage_engine::LMDBTxn &dsTxn, Graph &graph);
+
+    private:
+        inline static uint64_t getKey(const RecordId &rid) {
+            return (static_cast<uint64_t>(rid.first) << 32) | rid.second;
+        }
+    };
+
+}
+
+#endif
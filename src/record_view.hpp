@@ -0,0 +1,194 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RECORD_VIEW_HPP_INCLUDED_
+#define __RECORD_VIEW_HPP_INCLUDED_
+
+#include <cstring>
+
+#include "constant.hpp"
+#include "lmdb_engine.hpp"
+#include "schema.hpp"
+#include "utils.hpp"
+
+#include "nogdb_errors.h"
+#include "nogdb_types.h"
+
+namespace nogdb {
+
+    // NOTE: a read-only view of a stored record which points into the memory map, so it is only valid
+    // until the transaction (or the cursor position) that has read the value moves on.
+    // Properties are decoded on demand without copying the whole record.
+    //
+    // A record in the directory format keeps its property ids sorted and the offsets of their values
+    // in a table, so that a property is found with a binary search and two loads
+    // +--------------------+-------------------+-------------------------+-----------------------------+--------+
+    // | format (16bits)    | count n (16bits)  | propertyIds (n x 16bits)| offsets ((n + 1) x 32bits)  | values |
+    // +--------------------+-------------------+-------------------------+-----------------------------+--------+
+    // where the value of propertyIds[i] spans from offsets[i] to offsets[i + 1] within the values.
+    //
+    // A record in the legacy format is a sequence of property blocks
+    // when option flag = 0
+    // +----------------------+--------------------+-----------------------+-----------+
+    // | propertyId (16bits)  | option flag (1bit) | propertySize (7bits)  |   value   | (next block) ...
+    // +----------------------+--------------------+-----------------------+-----------+
+    // when option flag = 1 (for extra large size of value)
+    // +----------------------+--------------------+------------------------+-----------+
+    // | propertyId (16bits)  | option flag (1bit) | propertySize (31bits)  |   value   | (next block) ...
+    // +----------------------+--------------------+------------------------+-----------+
+    // and a record without properties is a single placeholder character.
+    class RecordView {
+    public:
+        RecordView() = default;
+
+        explicit RecordView(const storage_engine::lmdb::Result &rawData)
+                : data_{rawData.empty ? nullptr : rawData.data.data<unsigned char>()},
+                  size_{rawData.empty ? 0 : rawData.data.size()},
+                  isEmpty_{rawData.empty} {
+            if (!isEmpty_ && size_ == 0) {
+                throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_UNKNOWN_ERR);
+            }
+            if (size_ >= 2 * sizeof(uint16_t) && load<uint16_t>(0) < VERSION_PROPERTY_ID) {
+                if (load<uint16_t>(0) != RECORD_FORMAT_DIRECTORY) {
+                    throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_UNKNOWN_ERR);
+                }
+                count_ = load<uint16_t>(sizeof(uint16_t));
+                values_ = 2 * sizeof(uint16_t) + count_ * sizeof(PropertyId) + (count_ + 1) * sizeof(uint32_t);
+                require(values_ <= size_ && values_ + offset(count_) == size_);
+                isDirectory_ = true;
+            }
+        }
+
+        bool empty() const noexcept {
+            return isEmpty_;
+        }
+
+        bool isLegacyFormat() const noexcept {
+            return !isEmpty_ && !isDirectory_;
+        }
+
+        // calls visitor(propertyId, value, size) on each property until the visitor returns false
+        template<typename Visitor>
+        void forEach(Visitor &&visitor) const {
+            if (isDirectory_) {
+                for (auto i = size_t{0}; i < count_; ++i) {
+                    auto begin = offset(i);
+                    auto end = offset(i + 1);
+                    require(begin <= end);
+                    if (!visitor(propertyId(i), data_ + values_ + begin, end - begin)) {
+                        return;
+                    }
+                }
+                return;
+            }
+            // records without properties are stored as a single placeholder character
+            if (size_ < 2 * sizeof(uint16_t)) {
+                return;
+            }
+            auto offset = size_t{0};
+            while (offset < size_) {
+                require(offset + sizeof(PropertyId) + sizeof(uint8_t) <= size_);
+                auto propertyId = load<PropertyId>(offset);
+                offset += sizeof(PropertyId);
+                auto propertySize = size_t{};
+                if ((data_[offset] & 0x1) == 1) {
+                    require(offset + sizeof(uint32_t) <= size_);
+                    propertySize = static_cast<size_t>(load<uint32_t>(offset) >> 1);
+                    offset += sizeof(uint32_t);
+                } else {
+                    propertySize = static_cast<size_t>(data_[offset] >> 1);
+                    offset += sizeof(uint8_t);
+                }
+                require(offset + propertySize <= size_);
+                if (!visitor(propertyId, data_ + offset, propertySize)) {
+                    return;
+                }
+                offset += propertySize;
+            }
+        }
+
+        Bytes get(PropertyId propertyId) const {
+            if (isDirectory_) {
+                auto first = size_t{0};
+                auto last = count_;
+                while (first < last) {
+                    auto middle = first + (last - first) / 2;
+                    auto id = this->propertyId(middle);
+                    if (id == propertyId) {
+                        auto begin = offset(middle);
+                        auto end = offset(middle + 1);
+                        require(begin <= end);
+                        return (end > begin) ? Bytes{data_ + values_ + begin, end - begin} : Bytes{};
+                    } else if (id < propertyId) {
+                        first = middle + 1;
+                    } else {
+                        last = middle;
+                    }
+                }
+                return Bytes{};
+            }
+            auto result = Bytes{};
+            forEach([&](PropertyId id, const unsigned char *value, size_t size) {
+                if (id == propertyId) {
+                    result = (size > 0) ? Bytes{value, size} : Bytes{};
+                    return false;
+                }
+                return true;
+            });
+            return result;
+        }
+
+        Bytes get(const ClassPropertyInfo &classPropertyInfo, const std::string &propertyName) const {
+            auto foundDesc = classPropertyInfo.nameToDesc.find(propertyName);
+            if (foundDesc == classPropertyInfo.nameToDesc.cend()) {
+                return Bytes{};
+            }
+            return get(foundDesc->second.id);
+        }
+
+    private:
+        const unsigned char *data_{nullptr};
+        size_t size_{0};
+        bool isEmpty_{true};
+        bool isDirectory_{false};
+        size_t count_{0};
+        size_t values_{0};
+
+        template<typename T>
+        T load(size_t offset) const {
+            auto value = T{};
+            memcpy(&value, data_ + offset, sizeof(T));
+            return value;
+        }
+
+        PropertyId propertyId(size_t index) const {
+            return load<PropertyId>(2 * sizeof(uint16_t) + index * sizeof(PropertyId));
+        }
+
+        size_t offset(size_t index) const {
+            return load<uint32_t>(2 * sizeof(uint16_t) + count_ * sizeof(PropertyId) + index * sizeof(uint32_t));
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,289 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "constant.hpp"
+#include "lmdb_engine.hpp"
+#include "graph.hpp"
+#include "utils.hpp"
+#include "relation_snapshot.hpp"
+
+namespace nogdb {
+
+    namespace {
+
+        constexpr uint32_t SNAPSHOT_HEADER_KEY = 0;
+        constexpr size_t RID_SIZE = sizeof(ClassId) + sizeof(PositionId);
+
+        inline const char *readRid(const char *data, RecordId &rid) {
+            memcpy(&rid.first, data, sizeof(ClassId));
+            memcpy(&rid.second, data + sizeof(ClassId), sizeof(PositionId));
+            return data + RID_SIZE;
+        }
+
+        inline void appendRid(Blob &blob, const RecordId &rid) {
+            blob.append(&rid.first, sizeof(ClassId));
+            blob.append(&rid.second, sizeof(PositionId));
+        }
+
+    }
+
+    RelationSnapshot::Relations RelationSnapshot::load(storage_engine::LMDBEnv *env,
+                                                       storage_engine::LMDBTxn &txn,
+                                                       const std::vector<ClassId> &edgeClassIds,
+                                                       const std::unordered_set<ClassId> &vertexClassIds,
+                                                       unsigned int numThreads) {
+        numThreads = std::max(numThreads, 1U);
+        auto result = Relations{};
+        result.partitions.resize(numThreads);
+        auto snapshotDBHandler = txn.openDbi(TB_RELATIONS_SNAPSHOT, true);
+        auto relationDBHandler = txn.openDbi(TB_RELATIONS);
+
+        // read the header: number of edges, number of chunks, and the next position id of each edge class
+        auto nextPositionIds = std::unordered_map<ClassId, PositionId>{};
+        auto numEdges = uint64_t{0};
+        auto numChunks = uint32_t{0};
+        auto header = snapshotDBHandler.get(SNAPSHOT_HEADER_KEY);
+        if (!header.empty) {
+            const char *data = header.data.data();
+            memcpy(&numEdges, data, sizeof(uint64_t));
+            data += sizeof(uint64_t);
+            memcpy(&numChunks, data, sizeof(uint32_t));
+            data += sizeof(uint32_t);
+            auto numClasses = uint16_t{0};
+            memcpy(&numClasses, data, sizeof(uint16_t));
+            data += sizeof(uint16_t);
+            for (auto i = 0U; i < numClasses; ++i) {
+                auto nextPosition = RecordId{};
+                data = readRid(data, nextPosition);
+                nextPositionIds.emplace(nextPosition.first, nextPosition.second);
+            }
+        }
+        auto getNextPositionId = [&nextPositionIds](const ClassId &classId) {
+            auto found = nextPositionIds.find(classId);
+            return (found != nextPositionIds.cend()) ? found->second : PositionId{0};
+        };
+        auto getRelation = [&vertexClassIds](const RecordId &edgeRid, const storage_engine::lmdb::Value &value) {
+            auto srcRid = RecordId{};
+            auto dstRid = RecordId{};
+            readRid(readRid(value.data(), srcRid), dstRid);
+            require(vertexClassIds.find(srcRid.first) != vertexClassIds.cend());
+            require(vertexClassIds.find(dstRid.first) != vertexClassIds.cend());
+            return EdgeRids{edgeRid, srcRid, dstRid};
+        };
+
+        // edges covered by the snapshot but deleted or re-linked afterwards
+        auto dirtyRids = std::unordered_set<RecordId, Graph::RecordIdHash>{};
+        if (!header.empty) {
+            auto dirtyCursor = txn.openCursor(TB_RELATIONS_DIRTY);
+            for (auto keyValue = dirtyCursor.getNext(); !keyValue.empty(); keyValue = dirtyCursor.getNext()) {
+                auto edgeRid = key2rid(keyValue.key.data.numeric<RelationKey>());
+                if (edgeRid.second < getNextPositionId(edgeRid.first)) {
+                    dirtyRids.insert(edgeRid);
+                }
+            }
+        }
+
+        // replay the current state of dirty edges which still exist
+        auto const edgeClassIdSet = std::unordered_set<ClassId>{edgeClassIds.cbegin(), edgeClassIds.cend()};
+        for (const auto &edgeRid: dirtyRids) {
+            auto relation = relationDBHandler.get(rid2key(edgeRid));
+            if (!relation.empty) {
+                require(edgeClassIdSet.find(edgeRid.first) != edgeClassIdSet.cend());
+                result.partitions.front().emplace_back(getRelation(edgeRid, relation.data));
+                ++result.numReplayed;
+            }
+        }
+
+        // split positions created after the snapshot into (class id, first position, last position + 1) ranges
+        typedef std::tuple<ClassId, PositionId, PositionId> PositionRange;
+        auto ranges = std::vector<PositionRange>{};
+        auto numPositions = uint64_t{0};
+        for (const auto &classId: edgeClassIds) {
+            auto dsResult = txn.openClassDbi(classId).get(EM_MAXRECNUM);
+            auto const endPositionId = (dsResult.empty) ? PositionId{0} : dsResult.data.numeric<PositionId>();
+            auto const nextPositionId = getNextPositionId(classId);
+            if (endPositionId > nextPositionId) {
+                ranges.emplace_back(classId, nextPositionId, endPositionId);
+                numPositions += endPositionId - nextPositionId;
+            }
+        }
+        auto workerRanges = std::vector<std::vector<PositionRange>>(numThreads);
+        auto const positionsPerWorker = (numPositions + numThreads - 1) / numThreads;
+        auto worker = size_t{0};
+        auto assigned = uint64_t{0};
+        for (const auto &range: ranges) {
+            auto begin = std::get<1>(range);
+            while (begin < std::get<2>(range)) {
+                auto const available = positionsPerWorker - assigned;
+                auto const end = static_cast<PositionId>(
+                        std::min<uint64_t>(std::get<2>(range), uint64_t{begin} + available));
+                workerRanges[worker].emplace_back(std::get<0>(range), begin, end);
+                assigned += end - begin;
+                begin = end;
+                if (assigned == positionsPerWorker && worker + 1 < numThreads) {
+                    ++worker;
+                    assigned = 0;
+                }
+            }
+        }
+
+        // each worker restores its share of snapshot chunks and replays its share of position ranges
+        auto numWorkerReplayed = std::vector<size_t>(numThreads, 0);
+        auto loadPartition = [&](unsigned int workerId) {
+            auto workerTxn = storage_engine::LMDBTxn(env, storage_engine::lmdb::TXN_RO);
+            auto &edges = result.partitions[workerId];
+            auto const firstChunkId = static_cast<uint32_t>(uint64_t{numChunks} * workerId / numThreads) + 1;
+            auto const lastChunkId = static_cast<uint32_t>(uint64_t{numChunks} * (workerId + 1) / numThreads);
+            edges.reserve(edges.size() + numEdges / numThreads);
+            auto workerSnapshotDBHandler = workerTxn.openDbi(TB_RELATIONS_SNAPSHOT, true);
+            for (auto chunkId = firstChunkId; chunkId <= lastChunkId; ++chunkId) {
+                // stream a chunk of the snapshot straight from the memory map
+                auto chunk = workerSnapshotDBHandler.get(chunkId);
+                require(!chunk.empty);
+                const char *data = chunk.data.data();
+                auto const end = data + chunk.data.size();
+                while (data < end) {
+                    auto srcRid = RecordId{};
+                    auto numOutEdges = uint32_t{0};
+                    data = readRid(data, srcRid);
+                    memcpy(&numOutEdges, data, sizeof(uint32_t));
+                    data += sizeof(uint32_t);
+                    for (auto i = 0U; i < numOutEdges; ++i) {
+                        auto edgeRid = RecordId{};
+                        auto dstRid = RecordId{};
+                        data = readRid(readRid(data, edgeRid), dstRid);
+                        if (dirtyRids.empty() || dirtyRids.find(edgeRid) == dirtyRids.cend()) {
+                            edges.emplace_back(edgeRid, srcRid, dstRid);
+                        }
+                    }
+                }
+            }
+            auto relationCursor = workerTxn.openCursor(TB_RELATIONS);
+            for (const auto &range: workerRanges[workerId]) {
+                auto const classId = std::get<0>(range);
+                for (auto keyValue = relationCursor.findRange(rid2key(RecordId{classId, std::get<1>(range)}));
+                     !keyValue.empty();
+                     keyValue = relationCursor.getNext()) {
+                    // skip non-relation entries (e.g. .init and .format)
+                    if (keyValue.key.data.size() != sizeof(RelationKey)) {
+                        continue;
+                    }
+                    auto edgeRid = key2rid(keyValue.key.data.numeric<RelationKey>());
+                    if (edgeRid.first != classId || edgeRid.second >= std::get<2>(range)) {
+                        break;
+                    }
+                    edges.emplace_back(getRelation(edgeRid, keyValue.val.data));
+                    ++numWorkerReplayed[workerId];
+                }
+            }
+        };
+        auto workers = std::vector<std::future<void>>{};
+        for (auto workerId = 1U; workerId < numThreads; ++workerId) {
+            workers.emplace_back(std::async(std::launch::async, loadPartition, workerId));
+        }
+        loadPartition(0);
+        for (auto &workerResult: workers) {
+            workerResult.get();
+        }
+
+        for (const auto &numReplayed: numWorkerReplayed) {
+            result.numReplayed += numReplayed;
+        }
+        result.isStale = header.empty ||
+                         (result.numReplayed + dirtyRids.size()) * SNAPSHOT_REFRESH_RATIO > numEdges;
+        return result;
+    }
+
+    void RelationSnapshot::write(storage_engine::LMDBTxn &txn, const std::vector<std::vector<EdgeRids>> &partitions) {
+        auto snapshotDBHandler = txn.openDbi(TB_RELATIONS_SNAPSHOT, true);
+        snapshotDBHandler.drop();
+        txn.openDbi(TB_RELATIONS_DIRTY).drop();
+
+        // group edges by their source vertices
+        auto orderedEdgeRids = std::vector<const EdgeRids *>{};
+        auto nextPositionIds = std::unordered_map<ClassId, PositionId>{};
+        for (const auto &edgeRids: partitions) {
+            for (const auto &edgeRid: edgeRids) {
+                orderedEdgeRids.emplace_back(&edgeRid);
+                auto const &rid = std::get<0>(edgeRid);
+                auto &nextPositionId = nextPositionIds[rid.first];
+                nextPositionId = std::max(nextPositionId, PositionId{rid.second + 1});
+            }
+        }
+        std::sort(orderedEdgeRids.begin(), orderedEdgeRids.end(), [](const EdgeRids *lhs, const EdgeRids *rhs) {
+            return std::tie(std::get<1>(*lhs), std::get<0>(*lhs)) < std::tie(std::get<1>(*rhs), std::get<0>(*rhs));
+        });
+
+        auto numChunks = uint32_t{0};
+        auto chunk = Blob(SNAPSHOT_CHUNK_SIZE);
+        for (auto iter = orderedEdgeRids.cbegin(); iter != orderedEdgeRids.cend();) {
+            auto const &srcRid = std::get<1>(**iter);
+            auto groupEnd = iter;
+            while (groupEnd != orderedEdgeRids.cend() && std::get<1>(**groupEnd) == srcRid) {
+                ++groupEnd;
+            }
+            auto const numOutEdges = static_cast<uint32_t>(groupEnd - iter);
+            auto const groupSize = RID_SIZE + sizeof(uint32_t) + numOutEdges * RID_SIZE * 2;
+            if (chunk.size() + groupSize > chunk.capacity()) {
+                if (chunk.size() > 0) {
+                    snapshotDBHandler.put(++numChunks, chunk, true);
+                }
+                chunk = Blob(std::max(SNAPSHOT_CHUNK_SIZE, groupSize));
+            }
+            appendRid(chunk, srcRid);
+            chunk.append(&numOutEdges, sizeof(uint32_t));
+            for (; iter != groupEnd; ++iter) {
+                appendRid(chunk, std::get<0>(**iter));
+                appendRid(chunk, std::get<2>(**iter));
+            }
+        }
+        if (chunk.size() > 0) {
+            snapshotDBHandler.put(++numChunks, chunk, true);
+        }
+
+        auto const numEdges = static_cast<uint64_t>(orderedEdgeRids.size());
+        auto const numClasses = static_cast<uint16_t>(nextPositionIds.size());
+        auto header = Blob(sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint16_t) + numClasses * RID_SIZE);
+        header.append(&numEdges, sizeof(uint64_t));
+        header.append(&numChunks, sizeof(uint32_t));
+        header.append(&numClasses, sizeof(uint16_t));
+        for (const auto &nextPositionId: nextPositionIds) {
+            appendRid(header, RecordId{nextPositionId.first, nextPositionId.second});
+        }
+        snapshotDBHandler.put(SNAPSHOT_HEADER_KEY, header);
+    }
+
+    void RelationSnapshot::markDirty(const BaseTxn &txn, const RecordId &edgeRid) {
+        txn.getDsTxnHandler()->openDbi(TB_RELATIONS_DIRTY).put(rid2key(edgeRid), uint8_t{0});
+    }
+
+    void RelationSnapshot::invalidate(const BaseTxn &txn) {
+        txn.getDsTxnHandler()->openDbi(TB_RELATIONS_SNAPSHOT, true).del(SNAPSHOT_HEADER_KEY);
+    }
+
+}
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __RELATION_SNAPSHOT_HPP_INCLUDED_
+#define __RELATION_SNAPSHOT_HPP_INCLUDED_
+
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+#include "storage_engine.hpp"
+#include "base_txn.hpp"
+
+#include "nogdb_types.h"
+
+namespace nogdb {
+
+    // NOTE: a persisted copy of .relations grouped by source vertices (CSR-style) for a fast context startup.
+    // The header keeps the next position id of every edge class at the time of writing, so that edges
+    // created later are found by seeking .relations past it. Edges deleted or re-linked later are listed
+    // in .relations_dirty while the snapshot is deleted whenever position ids may be reused.
+    struct RelationSnapshot {
+        RelationSnapshot() = delete;
+
+        ~RelationSnapshot() noexcept = delete;
+
+        // (edge, source vertex, destination vertex)
+        typedef std::tuple<RecordId, RecordId, RecordId> EdgeRids;
+
+        struct Relations {
+            // edges split into independent partitions, one per loading thread
+            std::vector<std::vector<EdgeRids>> partitions{};
+            // number of edges read from .relations rather than from the snapshot
+            size_t numReplayed{0};
+            // true if the snapshot is missing or too far behind .relations
+            bool isStale{true};
+        };
+
+        // read relations with the given number of threads, each of which uses its own read-only txn
+        // NOTE: replayed edges must belong to the given edge classes and connect the given vertex classes
+        static Relations load(storage_engine::LMDBEnv *env,
+                              storage_engine::LMDBTxn &txn,
+                              const std::vector<ClassId> &edgeClassIds,
+                              const std::unordered_set<ClassId> &vertexClassIds,
+                              unsigned int numThreads);
+
+        static void write(storage_engine::LMDBTxn &txn, const std::vector<std::vector<EdgeRids>> &partitions);
+
+        static void markDirty(const BaseTxn &txn, const RecordId &edgeRid);
+
+        static void invalidate(const BaseTxn &txn);
+    };
+
+}
+
+#endif
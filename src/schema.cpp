@@ -37,7 +37,7 @@ namespace nogdb {
     }
 
     Schema::ClassDescriptorPtr Schema::find(const BaseTxn &txn, const ClassId &classId) {
-        RWSpinLockGuard<RWSpinLock> _(schemaInfo.splock);
+        RWSpinLockGuard<StripedRWSpinLock> _(schemaInfo.splock);
         auto foundClass = schemaInfo.elements.find(classId);
         if (foundClass == schemaInfo.elements.cend()) {
             if (txn.getType() == BaseTxn::TxnType::READ_ONLY) {
@@ -69,13 +69,14 @@ namespace nogdb {
                 }
             }
         }
-        RWSpinLockGuard<RWSpinLock> _(schemaInfo.splock);
+        RWSpinLockGuard<StripedRWSpinLock> _(schemaInfo.splock);
         for (const auto &element: schemaInfo.elements) {
             if (auto classPtr = element.second) {
                 if (className == BaseTxn::getCurrentVersion(txn, classPtr->name).first) {
+                    // a deleted class may still be kept for older readers while its name has been reused
                     if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && classPtr->checkReadOnly(txn.getVersionId())) ||
                         (txn.getType() == BaseTxn::TxnType::READ_WRITE && classPtr->checkReadWrite())) {
-                        return nullptr;
+                        continue;
                     }
                     return classPtr;
                 }
@@ -96,10 +97,11 @@ namespace nogdb {
         }
     }
 
-    void Schema::forceDelete(const std::vector<ClassId> &classId) noexcept {
-        RWSpinLockGuard<RWSpinLock> _(schemaInfo.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+    void Schema::forceDelete(const std::vector<ClassId> &classId, TxnId versionId) noexcept {
         for (const auto &cid: classId) {
-            schemaInfo.elements.erase(cid);
+            schemaInfo.lockAndEraseIf(cid, [versionId](const ClassDescriptor &classDescriptor) {
+                return classDescriptor.isDeletedBefore(versionId);
+            });
         }
     }
 
@@ -233,7 +235,7 @@ namespace nogdb {
                 }
             }
         }
-        RWSpinLockGuard<RWSpinLock> _(schemaInfo.splock);
+        RWSpinLockGuard<StripedRWSpinLock> _(schemaInfo.splock);
         for (const auto &element: schemaInfo.elements) {
             if (auto classDescPtr = element.second) {
                 if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && classDescPtr->checkReadOnly(txn.getVersionId())) ||
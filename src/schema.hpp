@@ -24,10 +24,12 @@
 
 #include <map>
 #include <memory>
+#include <set>
 
 #include "spinlock.hpp"
 #include "concurrent.hpp"
 #include "graph.hpp"
+#include "version_control.hpp"
 
 #include "nogdb_types.h"
 
@@ -93,6 +95,15 @@ namespace nogdb {
 
         typedef std::shared_ptr<ClassDescriptor> ClassDescriptorPtr;
 
+        // order by class id rather than by address so that results do not depend on allocation
+        struct ClassDescriptorPtrLess {
+            bool operator()(const ClassDescriptorPtr &lhs, const ClassDescriptorPtr &rhs) const {
+                return *lhs < *rhs;
+            }
+        };
+
+        typedef std::set<ClassDescriptorPtr, ClassDescriptorPtrLess> ClassDescriptorPtrSet;
+
         ConcurrentSchemaElements<ClassId, ClassDescriptor> schemaInfo;
         ConcurrentDeleteQueue<ClassId> deletedClassId;
 
@@ -108,7 +119,8 @@ namespace nogdb {
 
         void erase(BaseTxn &baseTxn, const ClassId &classId) noexcept;
 
-        void forceDelete(const std::vector<ClassId> &classId) noexcept;
+        // remove classes dropped at or before versionId, leaving any newer class reusing the same class id
+        void forceDelete(const std::vector<ClassId> &classId, TxnId versionId) noexcept;
 
         void clear() noexcept;
 
@@ -129,30 +141,46 @@ namespace nogdb {
 
         void apply(BaseTxn &txn, const InheritanceInfo &info);
 
-        inline void clearDeletedElements(TxnId versionId) {
-            forceDelete(deletedClassId.pop_front(versionId));
+        inline size_t clearDeletedElements(TxnId versionId) {
+            auto classIds = deletedClassId.pop_front(versionId);
+            forceDelete(classIds, versionId);
+            return classIds.size();
         }
     };
 
     struct ClassPropertyInfo {
-        ClassPropertyInfo() {
+        typedef Record::PropertyNameMap PropertyNameMap;
+
+        ClassPropertyInfo() : propertyNames{std::make_shared<PropertyNameMap>()} {
             auto propertyDescriptor = PropertyDescriptor{VERSION_PROPERTY_ID, PropertyType::UNSIGNED_BIGINT};
-            idToName.emplace(VERSION_PROPERTY_ID, VERSION_PROPERTY);
+            propertyNames->idToName.emplace(VERSION_PROPERTY_ID, VERSION_PROPERTY);
+            propertyNames->nameToId.emplace(VERSION_PROPERTY, VERSION_PROPERTY_ID);
             nameToDesc.emplace(VERSION_PROPERTY, propertyDescriptor);
         }
 
         void insert(PropertyId propertyId, const std::string &propertyName, PropertyType type) {
-            idToName.emplace(std::make_pair(propertyId, propertyName));
+            insertName(propertyId, propertyName);
             nameToDesc.emplace(std::make_pair(propertyName, PropertyDescriptor{propertyId, type}));
         }
 
         void insert(const std::string &propertyName, const Schema::PropertyDescriptor &propertyDescriptor) {
-            idToName.emplace(std::make_pair(propertyDescriptor.id, propertyName));
+            insertName(propertyDescriptor.id, propertyName);
             nameToDesc.emplace(std::make_pair(propertyName, propertyDescriptor.transform()));
         }
 
-        std::map<PropertyId, std::string> idToName{};
+        // shared with the records decoded through this schema, hence copied before being modified
+        std::shared_ptr<PropertyNameMap> propertyNames;
         ClassProperty nameToDesc{};
+        ClassType classType{ClassType::UNDEFINED};
+
+    private:
+        void insertName(PropertyId propertyId, const std::string &propertyName) {
+            if (propertyNames.use_count() > 1) {
+                propertyNames = std::make_shared<PropertyNameMap>(*propertyNames);
+            }
+            propertyNames->idToName.emplace(propertyId, propertyName);
+            propertyNames->nameToId.emplace(propertyName, propertyId);
+        }
     };
 
     struct ClassInfo {
@@ -23,8 +23,19 @@
 #define __SPINLOCK_HPP_INCLUDED_
 
 #include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <thread>
 
+#ifdef __linux__
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#endif
+
 namespace nogdb {
 
     class SpinLock {
@@ -66,13 +77,13 @@ namespace nogdb {
 
 #define SPINLOCK_MAXCOUNT_DELAY        1000
 
-    class RWSpinLock {
+    class SpinningRWLock {
     public:
-        RWSpinLock() = default;
+        SpinningRWLock() = default;
 
-        RWSpinLock(const RWSpinLock &) = delete;
+        SpinningRWLock(const SpinningRWLock &) = delete;
 
-        RWSpinLock &operator=(const RWSpinLock &) = delete;
+        SpinningRWLock &operator=(const SpinningRWLock &) = delete;
 
         void lock() {
             auto delayCount = 0U;
@@ -131,6 +142,188 @@ namespace nogdb {
         std::atomic<bool> isWriting{false};
     };
 
+#define CACHE_LINE_SIZE                64
+#define RWLOCK_MAXCOUNT_SPIN           128
+#define RWLOCK_NUM_READER_STRIPES      32
+
+    struct Futex {
+        Futex() = delete;
+
+        ~Futex() noexcept = delete;
+
+        // blocks as long as the word still holds the expected value, unless woken up in the meantime
+        static void wait(std::atomic<uint32_t> &word, uint32_t expected) {
+#ifdef __linux__
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+            std::this_thread::yield();
+#endif
+        }
+
+        static void wakeAll(std::atomic<uint32_t> &word) {
+#ifdef __linux__
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+        }
+    };
+
+    template<size_t NumStripes>
+    struct ReaderStripe {
+        std::atomic<uint32_t> count{0};
+        char padding[CACHE_LINE_SIZE - sizeof(std::atomic<uint32_t>)];
+    };
+
+    template<>
+    struct ReaderStripe<1> {
+        std::atomic<uint32_t> count{0};
+    };
+
+    // A reader-writer lock which prefers writers and parks its waiters on a futex after a bounded spin.
+    // Readers are counted in NumStripes cache-line padded counters selected by the calling thread.
+    template<size_t NumStripes>
+    class ParkingRWLock {
+    public:
+        static_assert(NumStripes > 0 && (NumStripes & (NumStripes - 1)) == 0, "number of stripes must be a power of two");
+
+        ParkingRWLock() = default;
+
+        ParkingRWLock(const ParkingRWLock &) = delete;
+
+        ParkingRWLock &operator=(const ParkingRWLock &) = delete;
+
+        void lock() {
+            // a pending writer holds back new readers
+            state.fetch_add(1U, std::memory_order_seq_cst);
+            auto spinCount = 0U;
+            auto current = state.load(std::memory_order_relaxed);
+            while (true) {
+                if ((current & WRITER) == 0) {
+                    if (state.compare_exchange_weak(current, (current - 1U) | WRITER, std::memory_order_seq_cst)) {
+                        break;
+                    }
+                } else {
+                    current = park(current, spinCount);
+                }
+            }
+            spinCount = 0U;
+            while (true) {
+                auto const epoch = readerEpoch.load(std::memory_order_seq_cst);
+                if (!hasReaders()) {
+                    break;
+                }
+                if (++spinCount < RWLOCK_MAXCOUNT_SPIN) {
+                    pause();
+                } else {
+                    Futex::wait(readerEpoch, epoch);
+                }
+            }
+        }
+
+        bool tryLock() {
+            auto current = state.load(std::memory_order_relaxed);
+            if ((current & ~PARKED) != 0 ||
+                !state.compare_exchange_strong(current, current | WRITER, std::memory_order_seq_cst)) {
+                return false;
+            }
+            if (hasReaders()) {
+                unlock();
+                return false;
+            }
+            return true;
+        }
+
+        void unlock() {
+            auto const previous = state.fetch_and(~(WRITER | PARKED), std::memory_order_release);
+            if ((previous & PARKED) != 0) {
+                Futex::wakeAll(state);
+            }
+        }
+
+        void lockShared() {
+            auto spinCount = 0U;
+            auto current = state.load(std::memory_order_seq_cst);
+            while (!tryLockShared(current)) {
+                current = park(current, spinCount);
+            }
+        }
+
+        bool tryLockShared() {
+            return tryLockShared(state.load(std::memory_order_seq_cst));
+        }
+
+        void unlockShared() {
+            getReaders().fetch_sub(1U, std::memory_order_seq_cst);
+            // the last readers have to wake up a writer waiting for them to leave
+            if ((state.load(std::memory_order_seq_cst) & WRITER) != 0) {
+                readerEpoch.fetch_add(1U, std::memory_order_seq_cst);
+                Futex::wakeAll(readerEpoch);
+            }
+        }
+
+    private:
+        static constexpr uint32_t WRITER = 1U << 31;
+        static constexpr uint32_t PARKED = 1U << 30;
+
+        // the remaining bits of the state count the writers waiting for the lock
+        std::atomic<uint32_t> state{0};
+        std::atomic<uint32_t> readerEpoch{0};
+        ReaderStripe<NumStripes> readers[NumStripes];
+
+        static void pause() {
+            asm volatile("pause\n": : :"memory");
+        }
+
+        static size_t getStripeIndex() {
+            static std::atomic<size_t> nextStripeIndex{0};
+            static thread_local size_t stripeIndex = nextStripeIndex.fetch_add(1U, std::memory_order_relaxed);
+            return stripeIndex & (NumStripes - 1);
+        }
+
+        std::atomic<uint32_t> &getReaders() {
+            return readers[(NumStripes == 1) ? 0 : getStripeIndex()].count;
+        }
+
+        bool hasReaders() const {
+            for (const auto &stripe: readers) {
+                if (stripe.count.load(std::memory_order_seq_cst) != 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool tryLockShared(uint32_t current) {
+            if ((current & ~PARKED) != 0) {
+                return false;
+            }
+            getReaders().fetch_add(1U, std::memory_order_seq_cst);
+            if ((state.load(std::memory_order_seq_cst) & ~PARKED) != 0) {
+                unlockShared();
+                return false;
+            }
+            return true;
+        }
+
+        uint32_t park(uint32_t current, unsigned int &spinCount) {
+            if (++spinCount < RWLOCK_MAXCOUNT_SPIN) {
+                pause();
+            } else if ((current & PARKED) != 0 ||
+                       state.compare_exchange_weak(current, current | PARKED, std::memory_order_relaxed)) {
+                Futex::wait(state, current | PARKED);
+            }
+            return state.load(std::memory_order_seq_cst);
+        }
+    };
+
+#ifdef NOGDB_SPINNING_RWLOCK
+    typedef SpinningRWLock RWSpinLock;
+    typedef SpinningRWLock StripedRWSpinLock;
+#else
+    // a single reader counter keeps the lock small enough to be embedded into every graph element
+    typedef ParkingRWLock<1> RWSpinLock;
+    typedef ParkingRWLock<RWLOCK_NUM_READER_STRIPES> StripedRWSpinLock;
+#endif
+
     enum RWSpinLockMode {
         SHARED_SPLOCK = 0, EXCLUSIVE_SPLOCK = 1
     };
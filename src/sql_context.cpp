@@ -450,7 +450,8 @@ void Context::dropIndex(const Token &tClassName, const Token &tPropName) {
 #pragma mark -- private
 
 ResultSet Context::selectPrivate(const SelectArgs &stmt) {
-    ResultSet result = this->select(stmt.from, stmt.where, stmt.skip, stmt.limit);
+    ResultSet result = this->select(stmt.from, stmt.where, stmt.skip, stmt.limit,
+                                    Context::getPropertyFilter(stmt.projections));
     result = this->selectProjection(result, stmt.projections);
     return this->selectGroupBy(result, stmt.group);
 }
@@ -459,7 +460,8 @@ ResultSet Context::select(const Target &target, const Where &where) {
     return this->select(target, where, -1, -1);
 }
 
-ResultSet Context::select(const Target &target, const Where &where, int skip, int limit) {
+ResultSet Context::select(const Target &target, const Where &where, int skip, int limit,
+                          const PropertyFilter &propertyFilter) {
     switch (target.type) {
         case TargetType::NO_TARGET:
             return ResultSet{};
@@ -469,9 +471,11 @@ ResultSet Context::select(const Target &target, const Where &where, int skip, in
             ClassType type = Context::findClassType(this->txn, className);
             if (type == ClassType::VERTEX) {
                 ResultSetCursor res = this->selectVertex(className, where);
+                res.setPropertyFilter(propertyFilter);
                 return ResultSet(res, skip, limit);
             } else if (type == ClassType::EDGE) {
                 ResultSetCursor res = this->selectEdge(className, where);
+                res.setPropertyFilter(propertyFilter);
                 return ResultSet(res, skip, limit);
             } else {
                 throw NOGDB_CONTEXT_ERROR(NOGDB_CTX_INVALID_CLASSTYPE);
@@ -665,6 +669,18 @@ ResultSet Context::traversePrivate(const TraverseArgs &args) {
     return func(this->txn, args.root, args.minDepth, args.maxDepth, ClassFilter(args.filter));
 }
 
+nogdb::PropertyFilter Context::getPropertyFilter(const vector<Projection> &projs) {
+    PropertyFilter propertyFilter{};
+    for (const Projection &proj: projs) {
+        const Projection &item = (proj.type == ProjectionType::ALIAS ? proj.get<pair<Projection, string>>().first : proj);
+        if (item.type != ProjectionType::PROPERTY) {
+            return PropertyFilter{};
+        }
+        propertyFilter.add(item.get<string>());
+    }
+    return propertyFilter;
+}
+
 Bytes Context::getProjectionItem(Txn &txn, const Result &input, const Projection &proj, const PropertyMapType &map) {
     switch (proj.type) {
         case ProjectionType::PROPERTY:
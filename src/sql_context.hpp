@@ -112,7 +112,8 @@ namespace nogdb {
 
             ResultSet select(const Target &target, const Where &where);
 
-            ResultSet select(const Target &target, const Where &where, int skip, int limit);
+            ResultSet select(const Target &target, const Where &where, int skip, int limit,
+                             const PropertyFilter &propertyFilter = PropertyFilter{});
 
             ResultSet select(const RecordDescriptorSet &rids);
 
@@ -140,6 +141,9 @@ namespace nogdb {
 
             static ClassType findClassType(Txn &txn, const string &className);
 
+            // properties read by a projection list, or an empty filter when it needs whole records
+            static PropertyFilter getPropertyFilter(const vector<Projection> &projs);
+
             static PropertyMapType getPropertyMapTypeFromClassDescriptor(Txn &txn, ClassId classID);
 
             static ResultSet executeCondition(Txn &txn, const ResultSet &input, const MultiCondition &conds);
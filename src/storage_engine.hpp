@@ -23,14 +23,23 @@
 #define __STORAGE_ENGINE_HPP_INCLUDED_
 
 #include <type_traits>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <cstdlib>
 #include <map>
 #include <unordered_map>
+#include <vector>
 #include <sys/file.h>
 #include <sys/stat.h>
 
 #include "lmdb_engine.hpp"
+#include "constant.hpp"
+#include "shared_lock.hpp"
+#include "spinlock.hpp"
 
 #include "nogdb/nogdb_context.h"
 #include "utils.hpp"
@@ -38,39 +47,163 @@
 #define DEFAULT_NOGDB_MAX_DATABASE_NUMBER   1024U
 #define DEFAULT_NOGDB_MAX_DATABASE_SIZE     1073741824UL  // 1GB
 #define DEFAULT_NOGDB_MAX_READERS           65536U
+#define DEFAULT_NOGDB_LOADING_THREADS       0U            // one per hardware thread
+#define DEFAULT_NOGDB_ADJACENCY_CACHE_SIZE  0UL           // keep the whole graph in memory
+#define DEFAULT_NOGDB_RECLAIM_INTERVAL_MS   10U
+#define DEFAULT_NOGDB_GROUP_COMMIT_SIZE     256U
+#define DEFAULT_NOGDB_GROUP_COMMIT_DELAY_US 0U            // commit as soon as the writer is idle
+#define DEFAULT_NOGDB_SYNC_INTERVAL_MS      0U            // no background flush
+#define DEFAULT_NOGDB_MAX_MAP_SIZE          1099511627776UL  // 1TB of address space, the file grows as needed
+#define DEFAULT_NOGDB_MAP_RESIZE_TIMEOUT_MS 1000U
+#define DEFAULT_NOGDB_READ_TXN_POOL_SIZE    64U
 
 namespace nogdb {
 
     namespace storage_engine {
 
+        // context-wide registry of DBI handles, a handle is registered once the transaction
+        // which opened it has committed and stays valid until its database is dropped
+        class LMDBDbiRegistry {
+        public:
+            typedef uint64_t Key;
+
+            enum DbiType : uint8_t {
+                CLASS_DBI = 1,
+                INDEX_DBI = 2,
+                INDEX_POSITIVE_DBI = 3,
+                INDEX_NEGATIVE_DBI = 4,
+                VERSIONS_DBI = 5,
+                RELATIONS_UPGRADE_DBI = 6
+            };
+
+            LMDBDbiRegistry() = default;
+
+            ~LMDBDbiRegistry() noexcept = default;
+
+            inline static Key classKey(ClassId classId) {
+                return makeKey(CLASS_DBI, classId);
+            }
+
+            inline static Key indexKey(IndexId indexId) {
+                return makeKey(INDEX_DBI, indexId);
+            }
+
+            inline static Key indexKey(IndexId indexId, bool isPositive) {
+                return makeKey((isPositive) ? INDEX_POSITIVE_DBI : INDEX_NEGATIVE_DBI, indexId);
+            }
+
+            inline static Key versionsKey() {
+                return makeKey(VERSIONS_DBI, 0);
+            }
+
+            inline static Key relationsUpgradeKey() {
+                return makeKey(RELATIONS_UPGRADE_DBI, 0);
+            }
+
+            static std::string getName(Key key) {
+                auto id = std::to_string(static_cast<uint32_t>(key));
+                switch (static_cast<DbiType>(key >> 32)) {
+                    case CLASS_DBI:
+                        return id;
+                    case INDEX_DBI:
+                        return TB_INDEXING_PREFIX + id;
+                    case INDEX_POSITIVE_DBI:
+                        return TB_INDEXING_PREFIX + id + INDEX_POSITIVE_SUFFIX;
+                    case INDEX_NEGATIVE_DBI:
+                        return TB_INDEXING_PREFIX + id + INDEX_NEGATIVE_SUFFIX;
+                    case VERSIONS_DBI:
+                        return TB_VERSIONS;
+                    case RELATIONS_UPGRADE_DBI:
+                        return TB_RELATIONS_UPGRADE;
+                    default:
+                        throw NOGDB_STORAGE_ERROR(MDB_BAD_DBI);
+                }
+            }
+
+            bool find(Key key, lmdb::DBHandler &handle) const {
+                ReadLock<boost::shared_mutex> _(_mutex);
+                auto found = _dbis.find(key);
+                if (found != _dbis.cend()) {
+                    handle = found->second;
+                    return true;
+                }
+                return false;
+            }
+
+            bool find(const std::string &dbName, lmdb::DBHandler &handle) const {
+                ReadLock<boost::shared_mutex> _(_mutex);
+                auto found = _namedDbis.find(dbName);
+                if (found != _namedDbis.cend()) {
+                    handle = found->second;
+                    return true;
+                }
+                return false;
+            }
+
+            void insert(const std::unordered_map<Key, lmdb::DBHandler> &dbis,
+                        const std::unordered_map<std::string, lmdb::DBHandler> &namedDbis) {
+                WriteLock<boost::shared_mutex> _(_mutex);
+                _dbis.insert(dbis.cbegin(), dbis.cend());
+                _namedDbis.insert(namedDbis.cbegin(), namedDbis.cend());
+            }
+
+            void erase(Key key) {
+                WriteLock<boost::shared_mutex> _(_mutex);
+                _dbis.erase(key);
+            }
+
+        private:
+            mutable boost::shared_mutex _mutex{};
+            std::unordered_map<Key, lmdb::DBHandler> _dbis{};
+            std::unordered_map<std::string, lmdb::DBHandler> _namedDbis{};
+
+            inline static Key makeKey(DbiType type, uint32_t id) {
+                return (static_cast<Key>(type) << 32) | id;
+            }
+        };
+
+        // An environment whose memory map grows geometrically up to maxDbSize: a write transaction which begins
+        // once the map is three quarters full, or after a write has failed with MDB_MAP_FULL, first drains
+        // the transactions in flight and remaps with a doubled size. A write transaction which begins on a full map
+        // that cannot be drained, because of a long-lived reader, fails with MDB_MAP_FULL.
         class LMDBEnv {
         public:
 
-            LMDBEnv(const std::string &dbPath, unsigned int dbNum, unsigned long dbSize, unsigned int readers) {
+            LMDBEnv(const std::string &dbPath, unsigned int dbNum, unsigned long dbSize, unsigned int readers,
+                    lmdb::Flag flag = lmdb::DEFAULT_ENV_FLAG, unsigned long maxDbSize = 0,
+                    unsigned int readTxnPoolSize = DEFAULT_NOGDB_READ_TXN_POOL_SIZE,
+                    unsigned int resizeTimeoutMs = DEFAULT_NOGDB_MAP_RESIZE_TIMEOUT_MS)
+                    // a pooled read transaction keeps its reader slot
+                    : _resizeTimeout{resizeTimeoutMs}, _maxPooledReadTxns{std::min(readTxnPoolSize, readers / 2)} {
+                _pooledReadTxns.reserve(_maxPooledReadTxns);
                 if (!fileExists(dbPath)) {
                     mkdir(dbPath.c_str(), 0755);
                 }
-                _env = std::move(lmdb::Env::create(dbNum, dbSize, readers).open(dbPath));
+                _env = std::move(lmdb::Env::create(dbNum, dbSize, readers).open(dbPath, flag));
+                // an existing database may be larger than the requested size
+                auto info = MDB_envinfo{};
+                auto stat = MDB_stat{};
+                mdb_env_info(_env.handle(), &info);
+                mdb_env_stat(_env.handle(), &stat);
+                _mapSize = info.me_mapsize;
+                _maxMapSize = std::max(_mapSize.load(), maxDbSize);
+                _pageSize = stat.ms_psize;
+                mdb_env_set_userctx(_env.handle(), &_isMapFull);
             }
 
             ~LMDBEnv() noexcept {
                 try { close(); } catch (...) {}
             }
 
-            LMDBEnv(LMDBEnv &&other) noexcept {
-                using std::swap;
-                swap(_env, other._env);
-            }
+            LMDBEnv(const LMDBEnv &) = delete;
 
-            LMDBEnv &operator=(LMDBEnv &&other) noexcept {
-                if (this != &other) {
-                    using std::swap;
-                    swap(_env, other._env);
-                }
-                return *this;
-            }
+            LMDBEnv &operator=(const LMDBEnv &) = delete;
 
             void close() noexcept {
+                for (auto handle: _pooledReadTxns) {
+                    mdb_txn_abort(handle);
+                }
+                _pooledReadTxns.clear();
                 _env.close();
             }
 
@@ -78,16 +211,151 @@ namespace nogdb {
                 return _env.handle();
             }
 
+            void sync() {
+                _env.sync();
+            }
+
+            LMDBDbiRegistry *dbiRegistry() noexcept {
+                return &_dbiRegistry;
+            }
+
+            unsigned long mapSize() const noexcept {
+                return _mapSize.load();
+            }
+
+            // nested transactions are not supported with a writable memory map
+            bool isWriteMap() const noexcept {
+                auto flags = 0U;
+                mdb_env_get_flags(_env.handle(), &flags);
+                return (flags & MDB_WRITEMAP) != 0;
+            }
+
+            // must be paired with endTxn once the transaction has been committed or aborted
+            void beginTxn(bool isReadWrite) {
+                if (isReadWrite && _mapSize.load() < _maxMapSize) {
+                    grow();
+                }
+                while (true) {
+                    ++_numActiveTxns;
+                    if (!_isResizing.load()) {
+                        return;
+                    }
+                    // give way to a resize in progress
+                    endTxn();
+                    std::unique_lock<std::mutex> lock(_resizeMutex);
+                    _resized.wait(lock, [this]() { return !_isResizing.load(); });
+                }
+            }
+
+            void endTxn() noexcept {
+                if (--_numActiveTxns == 0 && _isResizing.load()) {
+                    std::lock_guard<std::mutex> _(_resizeMutex);
+                    _drained.notify_all();
+                }
+            }
+
+            // begin a read transaction on a handle recycled with mdb_txn_reset/mdb_txn_renew when there is one
+            lmdb::Txn beginReadTxn() {
+                lmdb::TxnHandler *handle = nullptr;
+                {
+                    SpinLockGuard<SpinLock> _(_readTxnLock);
+                    if (!_pooledReadTxns.empty()) {
+                        handle = _pooledReadTxns.back();
+                        _pooledReadTxns.pop_back();
+                    }
+                }
+                if (handle == nullptr) {
+                    return lmdb::Txn::begin(_env.handle(), lmdb::TXN_RO);
+                }
+                auto txn = lmdb::Txn{handle};
+                txn.renew();
+                return txn;
+            }
+
+            void endReadTxn(lmdb::Txn &txn) noexcept {
+                auto handle = txn.release();
+                mdb_txn_reset(handle);
+                {
+                    SpinLockGuard<SpinLock> _(_readTxnLock);
+                    if (_pooledReadTxns.size() < _maxPooledReadTxns) {
+                        _pooledReadTxns.push_back(handle);
+                        return;
+                    }
+                }
+                mdb_txn_abort(handle);
+            }
+
         private:
             lmdb::Env _env{nullptr};
+            LMDBDbiRegistry _dbiRegistry{};
+
+            std::atomic<unsigned long> _mapSize{0};
+            unsigned long _maxMapSize{0};
+            unsigned int _pageSize{0};
+            std::chrono::milliseconds _resizeTimeout;
+            std::atomic<bool> _isMapFull{false};
+            std::atomic<bool> _isResizing{false};
+            bool _isResizeWaitTimedOut{false};
+            std::atomic<unsigned int> _numActiveTxns{0};
+            std::mutex _resizeMutex{};
+            std::condition_variable _drained{};
+            std::condition_variable _resized{};
+            SpinLock _readTxnLock{};
+            std::vector<lmdb::TxnHandler *> _pooledReadTxns{};
+            unsigned int _maxPooledReadTxns{0};
+
+            // the meta pages are read from the map, which is only remapped while holding _resizeMutex
+            bool isAlmostFull() const noexcept {
+                auto info = MDB_envinfo{};
+                mdb_env_info(_env.handle(), &info);
+                return (info.me_last_pgno + 1) * _pageSize >= _mapSize.load() / 4 * 3;
+            }
+
+            void grow() {
+                std::unique_lock<std::mutex> lock(_resizeMutex);
+                if (_mapSize.load() >= _maxMapSize || !(_isMapFull.load() || isAlmostFull())) {
+                    return;
+                }
+                // readers hold pointers into the map, a writer which failed for a full map waits for them, a writer
+                // growing the map ahead of time only takes an idle moment. New readers are held off during a wait,
+                // so once a wait has timed out behind a long-lived reader, the next writers only take an idle moment
+                // rather than stalling everyone again.
+                auto timeout = (_isMapFull.load() && !_isResizeWaitTimedOut) ? _resizeTimeout
+                                                                             : std::chrono::milliseconds{0};
+                _isResizing = true;
+                if (_drained.wait_for(lock, timeout, [this]() { return _numActiveTxns.load() == 0; })) {
+                    auto size = std::min(_mapSize.load() * 2, _maxMapSize);
+                    if (!mdb_env_set_mapsize(_env.handle(), size)) {
+                        _mapSize = size;
+                        _isMapFull = false;
+                        _isResizeWaitTimedOut = false;
+                    }
+                } else if (timeout.count() > 0) {
+                    _isResizeWaitTimedOut = true;
+                }
+                _isResizing = false;
+                _resized.notify_all();
+                if (_isMapFull.load()) {
+                    throw NOGDB_STORAGE_ERROR(MDB_MAP_FULL);
+                }
+            }
         };
 
 
         class LMDBTxn {
         public:
 
-            LMDBTxn(LMDBEnv *const env, const unsigned int txnMode) {
-                _txn = lmdb::Txn::begin(env->handle(), txnMode);
+            LMDBTxn(LMDBEnv *const env, const unsigned int txnMode)
+                    : _dbiRegistry{env->dbiRegistry()} {
+                env->beginTxn(txnMode == lmdb::TXN_RW);
+                try {
+                    _isReadOnly = txnMode == lmdb::TXN_RO;
+                    _txn = (_isReadOnly) ? env->beginReadTxn() : lmdb::Txn::begin(env->handle(), txnMode);
+                } catch (...) {
+                    env->endTxn();
+                    throw;
+                }
+                _env = env;
             }
 
             ~LMDBTxn() noexcept {
@@ -99,25 +367,69 @@ namespace nogdb {
 
             LMDBTxn(LMDBTxn &&other) noexcept {
                 using std::swap;
+                swap(_env, other._env);
+                swap(_isReadOnly, other._isReadOnly);
                 swap(_txn, other._txn);
+                swap(_parents, other._parents);
+                swap(_dbiRegistry, other._dbiRegistry);
+                swap(_openedDbis, other._openedDbis);
+                swap(_openedNamedDbis, other._openedNamedDbis);
             }
 
             LMDBTxn &operator=(LMDBTxn &&other) noexcept {
                 if (this != &other) {
                     using std::swap;
+                    swap(_env, other._env);
+                    swap(_isReadOnly, other._isReadOnly);
                     swap(_txn, other._txn);
+                    swap(_parents, other._parents);
+                    swap(_dbiRegistry, other._dbiRegistry);
+                    swap(_openedDbis, other._openedDbis);
+                    swap(_openedNamedDbis, other._openedNamedDbis);
                 }
                 return *this;
             }
 
             lmdb::Dbi openDbi(const std::string &dbName, bool numericKey = false, bool unique = true) {
                 if (_txn.handle()) {
-                    return lmdb::Dbi::open(_txn.handle(), dbName, numericKey, unique);
+                    auto handle = lmdb::DBHandler{};
+                    if (_dbiRegistry->find(dbName, handle)) {
+                        return lmdb::Dbi{_txn.handle(), handle};
+                    }
+                    auto opened = _openedNamedDbis.find(dbName);
+                    if (opened != _openedNamedDbis.cend()) {
+                        return lmdb::Dbi{_txn.handle(), opened->second};
+                    }
+                    auto dbi = lmdb::Dbi::open(_txn.handle(), dbName, numericKey, unique);
+                    _openedNamedDbis.emplace(dbName, dbi.handle());
+                    return dbi;
                 } else {
                     throw NOGDB_STORAGE_ERROR(MDB_BAD_TXN);
                 }
             }
 
+            lmdb::Dbi openDbi(LMDBDbiRegistry::Key key, bool numericKey = false, bool unique = true) {
+                if (_txn.handle()) {
+                    auto handle = lmdb::DBHandler{};
+                    if (_dbiRegistry->find(key, handle)) {
+                        return lmdb::Dbi{_txn.handle(), handle};
+                    }
+                    auto opened = _openedDbis.find(key);
+                    if (opened != _openedDbis.cend()) {
+                        return lmdb::Dbi{_txn.handle(), opened->second};
+                    }
+                    auto dbi = lmdb::Dbi::open(_txn.handle(), LMDBDbiRegistry::getName(key), numericKey, unique);
+                    _openedDbis.emplace(key, dbi.handle());
+                    return dbi;
+                } else {
+                    throw NOGDB_STORAGE_ERROR(MDB_BAD_TXN);
+                }
+            }
+
+            lmdb::Dbi openClassDbi(ClassId classId) {
+                return openDbi(LMDBDbiRegistry::classKey(classId), true);
+            }
+
             lmdb::Cursor openCursor(const lmdb::Dbi &dbi) {
                 require(_txn.handle() == dbi.txn());
                 return lmdb::Cursor::open(_txn.handle(), dbi.handle());
@@ -127,12 +439,98 @@ namespace nogdb {
                 return openCursor(openDbi(dbName, numericKey, unique));
             }
 
+            lmdb::Cursor openCursor(LMDBDbiRegistry::Key key, bool numericKey = false, bool unique = true) {
+                return openCursor(openDbi(key, numericKey, unique));
+            }
+
+            lmdb::Cursor openClassCursor(ClassId classId) {
+                return openCursor(openClassDbi(classId));
+            }
+
+            void dropDbi(LMDBDbiRegistry::Key key, bool numericKey = false, bool unique = true) {
+                openDbi(key, numericKey, unique).drop(true);
+                // the handle is closed once the drop is committed
+                _openedDbis.erase(key);
+                _dbiRegistry->erase(key);
+            }
+
+            // begin a nested transaction whose changes can be aborted apart from the enclosing ones,
+            // and return its depth
+            // NOTE: LMDB does not support nested transactions with MDB_WRITEMAP
+            size_t beginNested() {
+                if (!_txn.handle() || _isReadOnly) {
+                    throw NOGDB_STORAGE_ERROR(MDB_BAD_TXN);
+                }
+                auto flags = 0U;
+                mdb_env_get_flags(_txn.env(), &flags);
+                if (flags & MDB_WRITEMAP) {
+                    throw NOGDB_STORAGE_ERROR(MDB_INCOMPATIBLE);
+                }
+                auto child = lmdb::Txn::begin(_txn.env(), lmdb::TXN_RW, _txn.handle());
+                _parents.emplace_back(Parent{std::move(_txn), _openedDbis, _openedNamedDbis});
+                _txn = std::move(child);
+                return _parents.size();
+            }
+
+            // abort the nested transactions from the given depth inwards
+            void rollbackNested(size_t depth) noexcept {
+                while (!_parents.empty() && _parents.size() >= depth) {
+                    // handles opened in an aborted transaction are closed by LMDB
+                    auto &parent = _parents.back();
+                    _txn.abort();
+                    _txn = std::move(parent.txn);
+                    _openedDbis = std::move(parent.openedDbis);
+                    _openedNamedDbis = std::move(parent.openedNamedDbis);
+                    _parents.pop_back();
+                }
+            }
+
+            // commit the nested transactions from the given depth inwards into their parents
+            void commitNested(size_t depth) {
+                while (!_parents.empty() && _parents.size() >= depth) {
+                    auto parent = std::move(_parents.back());
+                    _parents.pop_back();
+                    try {
+                        _txn.commit();
+                    } catch (...) {
+                        _txn = std::move(parent.txn);
+                        _openedDbis = std::move(parent.openedDbis);
+                        _openedNamedDbis = std::move(parent.openedNamedDbis);
+                        throw;
+                    }
+                    _txn = std::move(parent.txn);
+                }
+            }
+
+            size_t depth() const noexcept {
+                return _parents.size();
+            }
+
             void commit() {
-                _txn.commit();
+                try {
+                    commitNested(1);
+                    _txn.commit();
+                } catch (...) {
+                    release();
+                    throw;
+                }
+                release();
+                _dbiRegistry->insert(_openedDbis, _openedNamedDbis);
+                _openedDbis.clear();
+                _openedNamedDbis.clear();
             }
 
             void rollback() {
-                _txn.abort();
+                // handles opened in an aborted transaction are closed by LMDB
+                rollbackNested(1);
+                _openedDbis.clear();
+                _openedNamedDbis.clear();
+                if (_isReadOnly && _txn.handle() && _env) {
+                    _env->endReadTxn(_txn);
+                } else {
+                    _txn.abort();
+                }
+                release();
             }
 
             lmdb::TxnHandler *handle() const noexcept {
@@ -140,7 +538,26 @@ namespace nogdb {
             }
 
         private:
+            LMDBEnv *_env{nullptr};
+            bool _isReadOnly{false};
+            struct Parent {
+                lmdb::Txn txn;
+                std::unordered_map<LMDBDbiRegistry::Key, lmdb::DBHandler> openedDbis;
+                std::unordered_map<std::string, lmdb::DBHandler> openedNamedDbis;
+            };
+
             lmdb::Txn _txn{nullptr};
+            std::vector<Parent> _parents{};
+            LMDBDbiRegistry *_dbiRegistry{nullptr};
+            std::unordered_map<LMDBDbiRegistry::Key, lmdb::DBHandler> _openedDbis{};
+            std::unordered_map<std::string, lmdb::DBHandler> _openedNamedDbis{};
+
+            void release() noexcept {
+                if (_env) {
+                    _env->endTxn();
+                    _env = nullptr;
+                }
+            }
         };
 
     }
@@ -32,7 +32,8 @@ namespace nogdb {
 
     Txn::Txn(Context &ctx, Mode mode) : txnCtx{ctx}, txnMode{mode} {
         try {
-            txnBase = std::make_shared<BaseTxn>(txnCtx, txnMode == Mode::READ_WRITE);
+            txnBase = (txnMode == Mode::READ_ONLY) ? txnCtx.dbTxnPool->acquire(txnCtx)
+                                                   : std::make_shared<BaseTxn>(txnCtx, true);
         } catch (const Error &err) {
             throw err;
         } catch (...) {
@@ -42,6 +43,9 @@ namespace nogdb {
 
     Txn::~Txn() noexcept {
         rollback();
+        if (txnBase != nullptr && txnMode == Mode::READ_ONLY && txnBase.unique()) {
+            txnCtx.dbTxnPool->release(std::move(txnBase));
+        }
     }
 
     Txn::Txn(const Txn &txn) : txnCtx{txn.txnCtx}, txnMode{txn.txnMode}, txnBase{txn.txnBase} {}
@@ -84,6 +88,18 @@ namespace nogdb {
         }
     }
 
+    Txn::Savepoint Txn::savepoint() {
+        return txnBase->savepoint();
+    }
+
+    void Txn::rollbackTo(Savepoint savepoint) {
+        txnBase->rollbackTo(txnCtx, savepoint);
+    }
+
+    void Txn::releaseSavepoint(Savepoint savepoint) {
+        txnBase->releaseSavepoint(txnCtx, savepoint);
+    }
+
     TxnId Txn::getTxnId() const {
         return txnBase->getTxnId();
     }
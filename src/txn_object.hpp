@@ -23,6 +23,8 @@
 #define __TXN_OBJECT_HPP_INCLUDED_
 
 #include <atomic>
+#include <limits>
+#include <map>
 #include <set>
 #include <utility>
 
@@ -86,6 +88,12 @@ namespace nogdb {
                     (currentState.status == StatusFlag::COMMITTED_CREATE && versionId < currentState.versionId));
         }
 
+        // return true if deleted by a commit at or before versionId
+        bool isDeletedBefore(TxnId versionId) const {
+            State currentState = state;
+            return currentState.status == StatusFlag::COMMITTED_DELETE && currentState.versionId <= versionId;
+        }
+
         // return true if not visible, otherwise false
         bool checkReadWrite() const {
             State currentState = state;
@@ -101,51 +109,130 @@ namespace nogdb {
         AtomicState state{State{}};
     };
 
+#define TXNSTAT_NUM_READER_SLOTS       128
+
+    // Read-only transactions register themselves in a table of reader slots, similar to the reader table of LMDB.
+    // Registering and unregistering touch a single slot, and the oldest reader is found by scanning the table
+    // without taking a lock. Readers beyond the capacity of the table fall back to a locked overflow map.
     struct TxnStat {
+        static constexpr size_t NO_SLOT = TXNSTAT_NUM_READER_SLOTS;
+
         TxnId fetchAddMaxTxnId() {
             return maxTxnId.fetch_add(static_cast<TxnId>(1), std::memory_order_relaxed);
         }
 
         TxnId fetchAddMaxVersionId() {
-            return maxVersionId.fetch_add(static_cast<TxnId>(1), std::memory_order_relaxed);
-        }
-
-        void addActiveTxnId(TxnId txnId, TxnId versionId) {
-            SpinLockGuard<SpinLock> _(lockActiveTxnIds);
-            activeTxnIds.emplace(txnId, versionId);
+            return maxVersionId.fetch_add(static_cast<TxnId>(1), std::memory_order_seq_cst);
         }
 
-        void removeActiveTxnId(TxnId txnId) {
-            SpinLockGuard<SpinLock> _(lockActiveTxnIds);
-            activeTxnIds.erase(txnId);
+        // registers a reader at the recent committed version and returns its slot and version
+        std::pair<size_t, TxnId> addActiveTxnId(TxnId txnId) {
+            auto const slot = acquireSlot();
+            auto versionId = maxVersionId.load(std::memory_order_seq_cst);
+            if (slot == NO_SLOT) {
+                SpinLockGuard<SpinLock> _(lockOverflowTxnIds);
+                overflowTxnIds.emplace(txnId, versionId);
+                numOverflowTxnIds.fetch_add(1U, std::memory_order_seq_cst);
+                return std::make_pair(slot, versionId);
+            }
+            auto &readerSlot = readerSlots[slot];
+            readerSlot.versionId.store(versionId, std::memory_order_seq_cst);
+            readerSlot.txnId.store(txnId, std::memory_order_seq_cst);
+            // a writer which has missed the slot must have published a newer version in the meantime
+            for (auto recentVersionId = maxVersionId.load(std::memory_order_seq_cst);
+                 recentVersionId != versionId;
+                 recentVersionId = maxVersionId.load(std::memory_order_seq_cst)) {
+                versionId = recentVersionId;
+                readerSlot.versionId.store(versionId, std::memory_order_seq_cst);
+            }
+            return std::make_pair(slot, versionId);
         }
 
-        std::pair<TxnId, TxnId> minActiveTxnId() {
-            SpinLockGuard<SpinLock> _(lockActiveTxnIds);
-            auto iter = activeTxnIds.cbegin();
-            if (iter == activeTxnIds.cend()) {
-                return std::make_pair(TxnId{0}, TxnId{0});
+        void removeActiveTxnId(size_t slot, TxnId txnId) {
+            if (slot == NO_SLOT) {
+                SpinLockGuard<SpinLock> _(lockOverflowTxnIds);
+                overflowTxnIds.erase(txnId);
+                numOverflowTxnIds.fetch_sub(1U, std::memory_order_seq_cst);
+            } else {
+                readerSlots[slot].txnId.store(FREE_SLOT, std::memory_order_release);
             }
-            return std::make_pair(iter->first, iter->second);
         }
 
-        bool isLastMinVersionId(TxnId txnId) {
-            SpinLockGuard<SpinLock> _(lockActiveTxnIds);
-            auto iter = activeTxnIds.find(txnId);
-            if (iter == activeTxnIds.cbegin()) {
-                auto version = iter->second;
-                if (++iter != activeTxnIds.cend()) {
-                    return version < iter->second;
+        // returns the reader which sees the oldest version, and that version; a reader may register at a newer
+        // version than a reader with a greater txnId, so the version rather than the txnId is compared
+        std::pair<TxnId, TxnId> minActiveTxnId() {
+            auto result = std::make_pair(TxnId{0}, TxnId{0});
+            forEachActiveTxnId([&result](TxnId txnId, TxnId versionId) {
+                if (result.first == 0 || versionId < result.second ||
+                    (versionId == result.second && txnId < result.first)) {
+                    result = std::make_pair(txnId, versionId);
                 }
                 return true;
-            }
-            return false;
+            });
+            return result;
         }
 
         TxnObject::AtomicTxnId maxTxnId{1};
         TxnObject::AtomicTxnId maxVersionId{0};
-        SpinLock lockActiveTxnIds{};
-        std::map<TxnId, TxnId> activeTxnIds{};
+
+    private:
+        static constexpr TxnId FREE_SLOT = 0;
+        static constexpr TxnId RESERVED_SLOT = std::numeric_limits<TxnId>::max();
+
+        struct ReaderSlot {
+            std::atomic<TxnId> txnId{FREE_SLOT};
+            std::atomic<TxnId> versionId{0};
+            char padding[CACHE_LINE_SIZE - 2 * sizeof(std::atomic<TxnId>)];
+        };
+
+        ReaderSlot readerSlots[TXNSTAT_NUM_READER_SLOTS];
+        std::atomic<size_t> nextSlot{0};
+        std::atomic<size_t> numOverflowTxnIds{0};
+        SpinLock lockOverflowTxnIds{};
+        std::map<TxnId, TxnId> overflowTxnIds{};
+
+        size_t acquireSlot() {
+            // each thread starts probing from its own slot so that its registrations do not collide with others
+            static thread_local size_t preferredSlot = TXNSTAT_NUM_READER_SLOTS;
+            if (preferredSlot == TXNSTAT_NUM_READER_SLOTS) {
+                preferredSlot = nextSlot.fetch_add(1U, std::memory_order_relaxed) % TXNSTAT_NUM_READER_SLOTS;
+            }
+            for (size_t i = 0; i < TXNSTAT_NUM_READER_SLOTS; ++i) {
+                auto const slot = (preferredSlot + i) % TXNSTAT_NUM_READER_SLOTS;
+                auto expected = FREE_SLOT;
+                if (readerSlots[slot].txnId.load(std::memory_order_relaxed) == FREE_SLOT &&
+                    readerSlots[slot].txnId.compare_exchange_strong(expected, RESERVED_SLOT,
+                                                                    std::memory_order_seq_cst)) {
+                    return slot;
+                }
+            }
+            return NO_SLOT;
+        }
+
+        // visits every registered reader until the visitor returns false
+        template<typename Visitor>
+        bool forEachActiveTxnId(Visitor &&visitor) {
+            for (const auto &readerSlot: readerSlots) {
+                auto const txnId = readerSlot.txnId.load(std::memory_order_seq_cst);
+                if (txnId == FREE_SLOT || txnId == RESERVED_SLOT) {
+                    continue;
+                }
+                // a version read while the slot has changed hands belongs to a newer reader and is ignored
+                auto const versionId = readerSlot.versionId.load(std::memory_order_seq_cst);
+                if (readerSlot.txnId.load(std::memory_order_seq_cst) == txnId && !visitor(txnId, versionId)) {
+                    return false;
+                }
+            }
+            if (numOverflowTxnIds.load(std::memory_order_seq_cst) > 0) {
+                SpinLockGuard<SpinLock> _(lockOverflowTxnIds);
+                for (const auto &overflowTxnId: overflowTxnIds) {
+                    if (!visitor(overflowTxnId.first, overflowTxnId.second)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
     };
 
 }
@@ -121,23 +121,23 @@ namespace nogdb {
             return std::make_pair(T{}, false);
         }
 
+        // drops the versions superseded by a later one which is visible at baseVersionId and returns
+        // the number of remaining stable versions
         size_t clearStableVersion(TxnId baseVersionId) {
             RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
             if (stableVersions_.size() > 0) {
-                for (auto it = stableVersions_.begin(); it != stableVersions_.end() - 1;) {
-                    if (it->versionId < baseVersionId) {
-                        it = stableVersions_.erase(it);
-                    } else {
-                        break; //++it;
-                    }
+                auto first = stableVersions_.begin();
+                while (first + 1 != stableVersions_.end() && (first + 1)->versionId <= baseVersionId) {
+                    ++first;
                 }
+                stableVersions_.erase(stableVersions_.begin(), first);
                 if (stableVersions_.size() == 1 &&
-                    (stableVersions_.cbegin())->versionId < baseVersionId &&
+                    (stableVersions_.cbegin())->versionId <= baseVersionId &&
                     (stableVersions_.cbegin())->status == INACTIVE) {
                     stableVersions_.clear();
                 }
             }
-            return stableVersions_.size() + ((unstableVersion_.second == VISIBLE) ? 1 : 0);
+            return stableVersions_.size();
         }
 
         size_t clearUnstableVersion() {
@@ -166,6 +166,17 @@ namespace nogdb {
             unstableVersion_.second = INVISIBLE;
         }
 
+        // the unstable version belongs to the only writer, so it can be saved and restored for a savepoint
+        typedef std::pair<ControlObject, Visibility> Checkpoint;
+
+        Checkpoint getCheckpoint() const {
+            return unstableVersion_;
+        }
+
+        void restoreCheckpoint(const Checkpoint &checkpoint) {
+            unstableVersion_ = checkpoint;
+        }
+
         friend bool operator<(const ControlObject &lhs, const ControlObject &rhs) {
             return lhs.versionId < rhs.versionId;
         }
@@ -19,6 +19,7 @@
  *
  */
 
+#include <iterator>
 #include <tuple>
 
 #include "shared_lock.hpp"
@@ -30,6 +31,8 @@
 #include "compare.hpp"
 #include "index.hpp"
 #include "generic.hpp"
+#include "record_version.hpp"
+#include "relation_snapshot.hpp"
 
 #include "nogdb.h"
 
@@ -48,11 +51,9 @@ namespace nogdb {
         auto indexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
         auto value = Parser::parseRecord(*txn.txnBase, classDescriptor, record, classInfo, indexInfos);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(classDescriptor->id), true);
-        auto dsResult = classDBHandler.get(EM_MAXRECNUM);
-        auto const maxRecordNum = dsResult.data.numeric<PositionId>();
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
+        auto const maxRecordNum = txn.txnBase->allocatePositionId(classDescriptor->id);
         classDBHandler.put(maxRecordNum, value, true);
-        classDBHandler.put(EM_MAXRECNUM, PositionId{maxRecordNum + 1});
 
         // add index if applied
         for (const auto &indexInfo: indexInfos) {
@@ -76,7 +77,7 @@ namespace nogdb {
         auto indexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
         auto value = Parser::parseRecord(*txn.txnBase, classDescriptor, record, classInfo, indexInfos);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(classDescriptor->id), true);
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
         auto dsResult = classDBHandler.get(recordDescriptor.rid.second);
         if (dsResult.data.empty()) {
             throw NOGDB_GRAPH_ERROR(NOGDB_GRAPH_NOEXST_VERTEX);
@@ -118,6 +119,17 @@ namespace nogdb {
         }
 
         classDBHandler.put(recordDescriptor.rid.second, value);
+        // the stored record now carries the latest version
+        RecordVersion::remove(*txn.txnBase, recordDescriptor.rid);
+    }
+
+    void Vertex::patch(Txn &txn, const RecordDescriptor &recordDescriptor, const Record &record) {
+        Generic::patchRecord(txn, ClassType::VERTEX, recordDescriptor, record);
+    }
+
+    Bytes Vertex::increment(Txn &txn, const RecordDescriptor &recordDescriptor, const std::string &propertyName,
+                          int64_t delta) {
+        return Generic::incrementProperty(txn, ClassType::VERTEX, recordDescriptor, propertyName, delta);
     }
 
     void Vertex::destroy(Txn &txn, const RecordDescriptor &recordDescriptor) {
@@ -140,7 +152,7 @@ namespace nogdb {
         }
         // delete a record in a datastore
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(classDescriptor->id), true);
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
         // delete index if existing
         auto dsResult = classDBHandler.get(recordDescriptor.rid.second);
         if (!dsResult.data.empty()) {
@@ -175,6 +187,7 @@ namespace nogdb {
         }
         // delete actual record
         classDBHandler.del(recordDescriptor.rid.second);
+        RecordVersion::remove(*txn.txnBase, recordDescriptor.rid);
         // update in-memory relations
         txn.txnCtx.dbRelation->deleteVertex(*txn.txnBase, recordDescriptor.rid);
     }
@@ -213,7 +226,7 @@ namespace nogdb {
                 case PropertyType::UNSIGNED_SMALLINT:
                 case PropertyType::UNSIGNED_INTEGER:
                 case PropertyType::UNSIGNED_BIGINT: {
-                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingName(indexId), true, isUnique);
+                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingKey(indexId), true, isUnique);
                     dataIndexDBHandler.drop();
                     break;
                 }
@@ -222,14 +235,14 @@ namespace nogdb {
                 case PropertyType::INTEGER:
                 case PropertyType::BIGINT:
                 case PropertyType::REAL: {
-                    auto dataIndexDBHandlerPositive = dsTxnHandler->openDbi(Index::getIndexingName(indexId, true), true, isUnique);
-                    auto dataIndexDBHandlerNegative = dsTxnHandler->openDbi(Index::getIndexingName(indexId, false), true, isUnique);
+                    auto dataIndexDBHandlerPositive = dsTxnHandler->openDbi(Index::getIndexingKey(indexId, true), true, isUnique);
+                    auto dataIndexDBHandlerNegative = dsTxnHandler->openDbi(Index::getIndexingKey(indexId, false), true, isUnique);
                     dataIndexDBHandlerPositive.drop();
                     dataIndexDBHandlerNegative.drop();
                     break;
                 }
                 case PropertyType::TEXT: {
-                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingName(indexId), false, isUnique);
+                    auto dataIndexDBHandler = dsTxnHandler->openDbi(Index::getIndexingKey(indexId), false, isUnique);
                     dataIndexDBHandler.drop();
                     break;
                 }
@@ -238,7 +251,7 @@ namespace nogdb {
             }
         }
         // remove all records in a database
-        auto classDBHandler = dsTxnHandler->openDbi(std::to_string(classDescriptor->id), true);
+        auto classDBHandler = dsTxnHandler->openClassDbi(classDescriptor->id);
         auto cursorHandler = dsTxnHandler->openCursor(classDBHandler);
         auto relationDBHandler = dsTxnHandler->openDbi(TB_RELATIONS);
         for(auto keyValue = cursorHandler.getNext();
@@ -260,14 +273,17 @@ namespace nogdb {
                 }
                 // delete from relations
                 for (const auto &edge: edgeRecordDescriptors) {
-                    relationDBHandler.del(rid2str(edge.rid));
-                    auto edgeClassHandler = dsTxnHandler->openDbi(std::to_string(edge.rid.first), true);
+                    relationDBHandler.del(rid2key(edge.rid));
+                    RelationSnapshot::markDirty(*txn.txnBase, edge.rid);
+                    auto edgeClassHandler = dsTxnHandler->openClassDbi(edge.rid.first);
                     edgeClassHandler.del(edge.rid.second);
                 }
             }
         }
-        // empty a database
+        // empty a database, keeping the position counter so that positions are not reused
+        txn.txnBase->getNextPositionId(classDescriptor->id);
         classDBHandler.drop();
+        RecordVersion::removeAll(*txn.txnBase, classDescriptor->id);
         // update in-memory
         for (const auto &recordId: recordIds) {
             txn.txnCtx.dbRelation->deleteVertex(*txn.txnBase, recordId);
@@ -281,7 +297,7 @@ namespace nogdb {
             auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
             auto classInfo = ClassInfo{classDescriptor->id, className, classPropertyInfo};
             auto partial = Generic::getRecordFromClassInfo(txn, classInfo);
-            result.insert(result.end(), partial.cbegin(), partial.cend());
+            result.insert(result.end(), std::make_move_iterator(partial.begin()), std::make_move_iterator(partial.end()));
         }
         return result;
     }
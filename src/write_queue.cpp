@@ -0,0 +1,193 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "storage_engine.hpp"
+
+#include "nogdb.h"
+
+namespace nogdb {
+
+    struct WriteQueue::QueueState {
+        QueueState(unsigned int maxBatchSize_, unsigned int maxDelayUs_)
+                : maxBatchSize{std::max(maxBatchSize_, 1U)}, maxDelay{maxDelayUs_} {}
+
+        const size_t maxBatchSize;
+        const std::chrono::microseconds maxDelay;
+
+        std::mutex mutex{};
+        std::condition_variable condition{};
+        std::deque<std::shared_ptr<Request>> requests{};
+        std::chrono::steady_clock::time_point firstArrival{};
+        bool isStopping{false};
+
+        std::thread writer{};
+    };
+
+    WriteQueue::WriteQueue(Context &ctx_)
+            : WriteQueue(ctx_, DEFAULT_NOGDB_GROUP_COMMIT_SIZE, DEFAULT_NOGDB_GROUP_COMMIT_DELAY_US) {}
+
+    WriteQueue::WriteQueue(Context &ctx_, unsigned int maxBatchSize, unsigned int maxDelayUs)
+            : ctx{ctx_}, state{new QueueState{maxBatchSize, maxDelayUs}} {
+        state->writer = std::thread{&WriteQueue::run, this};
+    }
+
+    WriteQueue::~WriteQueue() noexcept {
+        {
+            std::lock_guard<std::mutex> _(state->mutex);
+            state->isStopping = true;
+        }
+        state->condition.notify_one();
+        state->writer.join();
+    }
+
+    void WriteQueue::enqueue(const std::shared_ptr<Request> &request) {
+        {
+            std::lock_guard<std::mutex> _(state->mutex);
+            if (state->isStopping) {
+                throw NOGDB_TXN_ERROR(NOGDB_TXN_COMPLETED);
+            }
+            if (state->requests.empty()) {
+                state->firstArrival = std::chrono::steady_clock::now();
+            }
+            state->requests.push_back(request);
+            // the writer only needs waking up to start a window or to close a full one
+            if (state->requests.size() != 1 && state->requests.size() != state->maxBatchSize) {
+                return;
+            }
+        }
+        state->condition.notify_one();
+    }
+
+    void WriteQueue::run() {
+        auto requests = std::vector<std::shared_ptr<Request>>{};
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->condition.wait(lock, [this]() { return state->isStopping || !state->requests.empty(); });
+                if (state->requests.empty()) {
+                    return;
+                }
+                // no commit is in flight, so the group is committed at once unless a window to wait in is given,
+                // the mutations arriving during its commit form the next group
+                if (state->maxDelay.count() > 0) {
+                    state->condition.wait_until(lock, state->firstArrival + state->maxDelay, [this]() {
+                        return state->isStopping || state->requests.size() >= state->maxBatchSize;
+                    });
+                }
+                auto const numRequests = std::min(state->requests.size(), state->maxBatchSize);
+                requests.assign(state->requests.begin(), state->requests.begin() + numRequests);
+                state->requests.erase(state->requests.begin(), state->requests.begin() + numRequests);
+                // mutations left behind by a full group start the next window right away
+                state->firstArrival = std::chrono::steady_clock::now() - state->maxDelay;
+            }
+            commit(requests);
+            requests.clear();
+        }
+    }
+
+    void WriteQueue::commit(std::vector<std::shared_ptr<Request>> &requests) {
+        // the map size at which the group has run out of space, the group is applied again once the map has grown
+        auto fullMapSize = 0UL;
+        // a failed function is undone through a savepoint of its own, unless nested transactions are not supported
+        auto const hasSavepoints = !ctx.envHandler->isWriteMap();
+        while (!requests.empty()) {
+            try {
+                auto txn = Txn{ctx, Txn::Mode::READ_WRITE};
+                auto const mapSize = ctx.envHandler->mapSize();
+                if (mapSize == fullMapSize) {
+                    throw NOGDB_STORAGE_ERROR(MDB_MAP_FULL);
+                }
+                auto error = std::exception_ptr{};
+                auto isMapFull = false;
+                // the loop stops at a failure which the group cannot get past
+                auto request = requests.begin();
+                while (request != requests.end()) {
+                    auto const savepoint = (hasSavepoints) ? txn.savepoint() : Txn::Savepoint{0};
+                    try {
+                        (*request)->apply(txn);
+                        if (hasSavepoints) {
+                            txn.releaseSavepoint(savepoint);
+                        }
+                        ++request;
+                        continue;
+                    } catch (const Error &err) {
+                        isMapFull = err.code() == MDB_MAP_FULL;
+                        error = std::current_exception();
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                    if (isMapFull || !hasSavepoints) {
+                        break;
+                    }
+                    // only the changes of the failed function are undone, the rest of the group stays applied
+                    txn.rollbackTo(savepoint);
+                    txn.releaseSavepoint(savepoint);
+                    (*request)->complete(error);
+                    request = requests.erase(request);
+                }
+                if (isMapFull) {
+                    // not a failure of the function, the next transaction begins with a larger map
+                    txn.rollback();
+                    fullMapSize = mapSize;
+                    continue;
+                }
+                if (request != requests.end()) {
+                    // without savepoints, a function may have left the transaction half-done,
+                    // so apply the rest of the group again
+                    txn.rollback();
+                    (*request)->complete(error);
+                    requests.erase(request);
+                    continue;
+                }
+                try {
+                    txn.commit();
+                } catch (const Error &err) {
+                    if (err.code() != MDB_MAP_FULL) {
+                        throw;
+                    }
+                    fullMapSize = mapSize;
+                    continue;
+                }
+            } catch (...) {
+                auto error = std::current_exception();
+                for (const auto &request: requests) {
+                    request->complete(error);
+                }
+                requests.clear();
+                return;
+            }
+            for (const auto &request: requests) {
+                request->complete(nullptr);
+            }
+            requests.clear();
+        }
+    }
+
+}
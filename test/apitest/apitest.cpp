@@ -90,6 +90,7 @@ int main() {
 #ifdef TEST_RECORD_OPERATIONS
     std::cout << "\n\x1B[96mEnd-to-end tests for types in a database should:\x1B[0m\n";
     exec(test_bytes_only, "converting primitive types to bytes");
+    exec(test_bytes_copy_and_move, "copying and moving small and large bytes");
     exec(test_record_with_bytes, "getting/setting bytes from/to record");
     exec(test_invalid_record_with_bytes, "getting values from record with invalid properties");
     exec(test_invalid_record_property_name, "setting values into record with invalid property names");
@@ -105,6 +106,10 @@ int main() {
     exec(test_get_invalid_vertices, "retrieving data from invalid vertices");
     exec(test_get_vertex_cursor, "retrieving data from vertices with result set cursor");
     exec(test_get_invalid_vertex_cursor, "retrieving data from invalid vertices with result set cursor");
+    exec(test_get_vertex_cursor_property_filter, "retrieving selected properties from vertices with result set cursor");
+    exec(test_upgrade_record_format, "upgrading records of a class to the current format");
+    exec(test_get_vertex_record_properties, "accessing and modifying properties of a retrieved record");
+    exec(test_get_vertex_record_concurrently, "getting properties of a shared vertex record from many threads");
     exec(test_get_edge_in, "retrieving incoming edges from a vertex");
     exec(test_get_invalid_edge_in, "retrieving incoming edges from an invalid vertex");
     exec(test_get_edge_out, "retrieving outgoing edges from a vertex");
@@ -119,15 +124,19 @@ int main() {
     exec(test_get_invalid_edge_all_cursor, "retrieving a cursor of incoming and outgoing edges from an invalid vertex");
     exec(test_update_vertex, "updating a vertex");
     exec(test_update_vertex_version, "updating version of a vertex");
+    exec(test_patch_vertex, "patching some properties of a vertex");
+    exec(test_increment_vertex_property, "incrementing numeric properties of a vertex");
     exec(test_update_invalid_vertex, "updating an invalid vertex");
     exec(test_delete_vertex_only, "deleting a vertex (without edges)");
     exec(test_delete_all_vertices, "deleting all vertices in the same class");
+    exec(test_create_vertex_after_delete_all, "creating vertices after deleting all vertices in the same class");
     exec(test_delete_invalid_vertex, "deleting an invalid vertex");
 #endif
     // edge
 #ifdef TEST_RECORD_OPERATIONS
     std::cout << "\n\x1B[96mEnd-to-end tests for basic operations for edges should:\x1B[0m\n";
     exec(test_create_edges, "creating edges");
+    exec(test_create_edges_version, "creating edges with versioned endpoints");
     exec(test_create_invalid_edge, "creating an invalid edge");
     exec(test_get_edge, "retrieving data from edges");
     exec(test_get_invalid_edges, "retrieving data from invalid edges");
@@ -141,6 +150,7 @@ int main() {
     exec(test_get_invalid_vertex_all, "retrieving source and destination vertices from an invalid edge");
     exec(test_update_edge, "updating an edge");
     exec(test_update_invalid_edge, "updating an invalid edge");
+    exec(test_patch_edge, "patching and incrementing properties of an edge");
     exec(test_update_vertex_src, "updating a source vertex of an edge");
     exec(test_update_invalid_edge_src, "updating an invalid source vertex of an edge");
     exec(test_update_vertex_dst, "updating a destination vertex of an edge");
@@ -169,6 +179,12 @@ int main() {
     exec(test_add_delete_prop_with_records, "adding/deleting properties with records");
     exec(test_alter_class_with_records, "modifying a class name with records");
     exec(test_drop_class_with_relations, "dropping a class with some relations and reloading the database");
+    exec(test_bulk_load_graph, "bulk loading vertices and edges");
+    exec(test_bulk_load_new_vertices, "bulk loading edges between new vertices");
+    exec(test_bulk_load_with_index, "bulk loading vertices with indexed properties");
+    exec(test_bulk_load_invalid, "bulk loading invalid vertices and edges");
+    exec(test_bulk_load_unfinished, "committing a transaction with an unfinished bulk loading");
+    exec(test_bulk_load_savepoint, "using savepoints with an unfinished bulk loading");
 #endif
     // graph
 #ifdef TEST_GRAPH_OPERATIONS
@@ -350,11 +366,18 @@ int main() {
     exec(test_search_by_index_extended_class_cursor_condition, "getting cursor from indexing with extended class with condition");
     exec(test_search_by_index_extended_class_multicondition, "getting records from indexing with extended class with condition");
     exec(test_search_by_index_extended_class_cursor_multicondition, "getting cursor from indexing with extended class with condition");
+    exec(test_patch_with_index, "patching indexed properties");
 #endif
     // ctx
 #ifdef TEST_CONTEXT_OPERATIONS
     std::cout << "\n\x1B[96mEnd-to-end tests for a database context with indexing should:\x1B[0m\n";
     exec(test_reopen_ctx_v6, "reopening a context with records, extended classes, and indexing");
+    exec(test_reopen_ctx_v7, "reopening a context with relations restored from a snapshot");
+    exec(test_reopen_ctx_v8, "reopening a context with relations loaded by multiple threads");
+    exec(test_reopen_ctx_v9, "reopening a context with a bounded adjacency cache");
+    exec(test_reopen_ctx_v10, "reopening a context opened with relaxed durability modes");
+    exec(test_reopen_ctx_v11, "growing the map of a context as it fills up");
+    exec(test_reopen_ctx_v12, "failing fast on a full map held by a long-lived reader");
 #endif
     // schema txn
 #ifdef TEST_SCHEMA_TXN_OPERATIONS
@@ -430,6 +453,14 @@ int main() {
     exec(test_txn_reopen_ctx, "reopening context and committing txn with vertices and edges");
     exec(test_txn_invalid_operations, "committing txn with invalid operations");
     exec(test_txn_stat, "getting txn stat including current txn id, current version id, and active txn correctly");
+    exec(test_txn_stat_many_readers, "getting active txn correctly with more readers than the reader slots");
+    exec(test_txn_reclaim_deleted_elements, "reclaiming deleted elements after older readers have completed");
+    exec(test_txn_reclaim_adjacency, "merging changes in adjacencies after older readers have completed");
+    exec(test_txn_write_queue, "group-committing mutations submitted to a write queue by multiple threads");
+    exec(test_txn_write_queue_failures, "undoing only the failed mutations of a group committed by a write queue");
+    exec(test_txn_reuse_read_txn, "reusing completed read-only transactions");
+    exec(test_txn_savepoint, "rolling back to savepoints of a txn with nested transactions");
+    exec(test_txn_moved_edge_versions, "reading edges moved and deleted after the version of a txn");
     //exec(test_txn_invalid_concurrent_version, "committing multi-version txn when using over a maximum number of concurrent versions");
     //exec(test_txn_multithreads, "committing txn with multi-threads programming");
 #endif
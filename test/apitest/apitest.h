@@ -47,6 +47,12 @@ extern void test_reopen_ctx_v3(); // with records and relations
 extern void test_reopen_ctx_v4(); // with records, relations, and renaming class/property
 extern void test_reopen_ctx_v5(); // with records, relations, and extended classes
 extern void test_reopen_ctx_v6(); // with records, extended classes, and indexing
+extern void test_reopen_ctx_v7(); // with relations restored from a snapshot
+extern void test_reopen_ctx_v8(); // with relations loaded by multiple threads
+extern void test_reopen_ctx_v9(); // with a bounded adjacency cache
+extern void test_reopen_ctx_v10(); // with relaxed durability modes
+extern void test_reopen_ctx_v11(); // with a growing map
+extern void test_reopen_ctx_v12(); // with a growing map held by a long-lived reader
 extern void test_locked_ctx();
 extern void test_invalid_ctx();
 
@@ -73,6 +79,7 @@ extern void test_alter_invalid_property();
 // record operations testing
 #ifdef TEST_RECORD_OPERATIONS
 extern void test_bytes_only();
+extern void test_bytes_copy_and_move();
 extern void test_record_with_bytes();
 extern void test_invalid_record_with_bytes();
 extern void test_invalid_record_property_name();
@@ -84,13 +91,21 @@ extern void test_get_vertex_v2();
 extern void test_get_invalid_vertices();
 extern void test_get_vertex_cursor();
 extern void test_get_invalid_vertex_cursor();
+extern void test_get_vertex_cursor_property_filter();
+extern void test_upgrade_record_format();
+extern void test_get_vertex_record_properties();
+extern void test_get_vertex_record_concurrently();
 extern void test_update_vertex();
 extern void test_update_vertex_version();
+extern void test_patch_vertex();
+extern void test_increment_vertex_property();
 extern void test_update_invalid_vertex();
 extern void test_delete_vertex_only();
 extern void test_delete_invalid_vertex();
 extern void test_delete_all_vertices();
+extern void test_create_vertex_after_delete_all();
 extern void test_create_edges();
+extern void test_create_edges_version();
 extern void test_create_invalid_edge();
 extern void test_get_edge();
 extern void test_get_invalid_edges();
@@ -116,6 +131,7 @@ extern void test_get_invalid_edge_out_cursor();
 extern void test_get_invalid_edge_all_cursor();
 extern void test_update_edge();
 extern void test_update_invalid_edge();
+extern void test_patch_edge();
 extern void test_update_vertex_src();
 extern void test_update_vertex_dst();
 extern void test_update_invalid_edge_src();
@@ -139,6 +155,12 @@ extern void test_alter_class_with_records();
 extern void test_drop_class_with_relations();
 extern void test_drop_and_find_extended_class();
 extern void test_conflict_property();
+extern void test_bulk_load_graph();
+extern void test_bulk_load_new_vertices();
+extern void test_bulk_load_with_index();
+extern void test_bulk_load_invalid();
+extern void test_bulk_load_unfinished();
+extern void test_bulk_load_savepoint();
 #endif
 
 // graph operations testing
@@ -309,6 +331,7 @@ extern void test_search_by_index_extended_class_condition();
 extern void test_search_by_index_extended_class_cursor_condition();
 extern void test_search_by_index_extended_class_multicondition();
 extern void test_search_by_index_extended_class_cursor_multicondition();
+extern void test_patch_with_index();
 #endif
 
 // schema transaction testing
@@ -383,6 +406,14 @@ extern void test_txn_rollback_when_destroy();
 extern void test_txn_reopen_ctx();
 extern void test_txn_invalid_operations();
 extern void test_txn_stat();
+extern void test_txn_stat_many_readers();
+extern void test_txn_reclaim_deleted_elements();
+extern void test_txn_reclaim_adjacency();
+extern void test_txn_write_queue();
+extern void test_txn_write_queue_failures();
+extern void test_txn_reuse_read_txn();
+extern void test_txn_savepoint();
+extern void test_txn_moved_edge_versions();
 //extern void test_txn_invalid_concurrent_version();
 extern void test_txn_multithreads();
 #endif
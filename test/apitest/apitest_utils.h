@@ -392,7 +392,7 @@ inline bool rdescCursorCompare(const std::string& propertyName,
     return compareRes;
 }
 
-auto removeLast = [](const std::string& str) {
+static auto removeLast = [](const std::string& str) {
     return str.substr(0, str.size() - 1);
 };
 
@@ -1781,4 +1781,121 @@ void nonUniqueIndexCursorConditionTester(nogdb::Context *ctx, const std::string&
 
 }
 
+inline std::vector<nogdb::RecordDescriptor> indexMultiConditionInsert(nogdb::Context *ctx, const std::string& className) {
+    auto result = std::vector<nogdb::RecordDescriptor>{};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        result.push_back(nogdb::Vertex::create(txn, className, nogdb::Record{}
+                .set("index_text", "alpha").set("index_int", int32_t{10}).set("index_real", 1.5)));
+        result.push_back(nogdb::Vertex::create(txn, className, nogdb::Record{}
+                .set("index_text", "bravo").set("index_int", int32_t{-5}).set("index_real", 0.5)));
+        result.push_back(nogdb::Vertex::create(txn, className, nogdb::Record{}
+                .set("index_text", "charlie").set("index_int", int32_t{0}).set("index_real", -1.0)));
+        result.push_back(nogdb::Vertex::create(txn, className, nogdb::Record{}
+                .set("index_text", "delta").set("index_int", int32_t{7})));
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    return result;
+}
+
+inline void indexMultiConditionTester(nogdb::Context *ctx, const std::string& className,
+                                      const std::vector<nogdb::RecordDescriptor>& rdescs) {
+    auto &rdesc1 = rdescs[0], &rdesc2 = rdescs[1], &rdesc3 = rdescs[2], &rdesc4 = rdescs[3];
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto cond1 = nogdb::Condition("index_int").ge(int32_t{0}) && nogdb::Condition("index_text").eq("alpha");
+        auto res = nogdb::Vertex::getIndex(txn, className, cond1);
+        assert(rdescCompare("index_int && index_text", res, {rdesc1}));
+        res = nogdb::Vertex::get(txn, className, cond1);
+        assert(rdescCompare("index_int && index_text", res, {rdesc1}));
+
+        auto cond2 = nogdb::Condition("index_int").lt(int32_t{0}) || nogdb::Condition("index_text").eq("charlie");
+        res = nogdb::Vertex::getIndex(txn, className, cond2);
+        assert(rdescCompare("index_int || index_text", res, {rdesc2, rdesc3}));
+        res = nogdb::Vertex::get(txn, className, cond2);
+        assert(rdescCompare("index_int || index_text", res, {rdesc2, rdesc3}));
+
+        auto cond3 = (nogdb::Condition("index_int").between(int32_t{0}, int32_t{10}) &&
+                      nogdb::Condition("index_text").ge("bravo")) || nogdb::Condition("index_text").eq("alpha");
+        res = nogdb::Vertex::getIndex(txn, className, cond3);
+        assert(rdescCompare("(index_int && index_text) || index_text", res, {rdesc1, rdesc3, rdesc4}));
+        res = nogdb::Vertex::get(txn, className, cond3);
+        assert(rdescCompare("(index_int && index_text) || index_text", res, {rdesc1, rdesc3, rdesc4}));
+
+        // a non-indexed property in AND is applied as a filter on the index candidates
+        auto cond4 = nogdb::Condition("index_int").gt(int32_t{-100}) && nogdb::Condition("index_real").lt(1.0);
+        res = nogdb::Vertex::getIndex(txn, className, cond4);
+        assert(rdescCompare("index_int && index_real", res, {rdesc2, rdesc3}));
+        res = nogdb::Vertex::get(txn, className, cond4);
+        assert(rdescCompare("index_int && index_real", res, {rdesc2, rdesc3}));
+
+        // a non-indexed property in OR cannot be served by indexes
+        auto cond5 = nogdb::Condition("index_int").lt(int32_t{0}) || nogdb::Condition("index_real").gt(1.0);
+        res = nogdb::Vertex::getIndex(txn, className, cond5);
+        assert(rdescCompare("index_int || index_real", res, {}));
+        res = nogdb::Vertex::get(txn, className, cond5);
+        assert(rdescCompare("index_int || index_real", res, {rdesc1, rdesc2}));
+
+        // a negated multi-condition also matches null values which are not indexed
+        auto cond6 = !(nogdb::Condition("index_int").ge(int32_t{0}) && nogdb::Condition("index_real").ge(0.0));
+        res = nogdb::Vertex::getIndex(txn, className, cond6);
+        assert(rdescCompare("!(index_int && index_real)", res, {}));
+        res = nogdb::Vertex::get(txn, className, cond6);
+        assert(rdescCompare("!(index_int && index_real)", res, {rdesc2, rdesc3, rdesc4}));
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+}
+
+inline void indexCursorMultiConditionTester(nogdb::Context *ctx, const std::string& className,
+                                            const std::vector<nogdb::RecordDescriptor>& rdescs) {
+    auto &rdesc1 = rdescs[0], &rdesc2 = rdescs[1], &rdesc3 = rdescs[2], &rdesc4 = rdescs[3];
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto cond1 = nogdb::Condition("index_int").ge(int32_t{0}) && nogdb::Condition("index_text").eq("alpha");
+        auto res = nogdb::Vertex::getIndexCursor(txn, className, cond1);
+        assert(rdescCursorCompare("index_int && index_text", res, {rdesc1}));
+        res = nogdb::Vertex::getCursor(txn, className, cond1);
+        assert(rdescCursorCompare("index_int && index_text", res, {rdesc1}));
+
+        auto cond2 = nogdb::Condition("index_int").lt(int32_t{0}) || nogdb::Condition("index_text").eq("charlie");
+        res = nogdb::Vertex::getIndexCursor(txn, className, cond2);
+        assert(rdescCursorCompare("index_int || index_text", res, {rdesc2, rdesc3}));
+        res = nogdb::Vertex::getCursor(txn, className, cond2);
+        assert(rdescCursorCompare("index_int || index_text", res, {rdesc2, rdesc3}));
+
+        auto cond3 = (nogdb::Condition("index_int").between(int32_t{0}, int32_t{10}) &&
+                      nogdb::Condition("index_text").ge("bravo")) || nogdb::Condition("index_text").eq("alpha");
+        res = nogdb::Vertex::getIndexCursor(txn, className, cond3);
+        assert(rdescCursorCompare("(index_int && index_text) || index_text", res, {rdesc1, rdesc3, rdesc4}));
+        res = nogdb::Vertex::getCursor(txn, className, cond3);
+        assert(rdescCursorCompare("(index_int && index_text) || index_text", res, {rdesc1, rdesc3, rdesc4}));
+
+        auto cond4 = nogdb::Condition("index_int").gt(int32_t{-100}) && nogdb::Condition("index_real").lt(1.0);
+        res = nogdb::Vertex::getIndexCursor(txn, className, cond4);
+        assert(rdescCursorCompare("index_int && index_real", res, {rdesc2, rdesc3}));
+        res = nogdb::Vertex::getCursor(txn, className, cond4);
+        assert(rdescCursorCompare("index_int && index_real", res, {rdesc2, rdesc3}));
+
+        auto cond5 = nogdb::Condition("index_int").lt(int32_t{0}) || nogdb::Condition("index_real").gt(1.0);
+        res = nogdb::Vertex::getIndexCursor(txn, className, cond5);
+        assert(rdescCursorCompare("index_int || index_real", res, {}));
+        res = nogdb::Vertex::getCursor(txn, className, cond5);
+        assert(rdescCursorCompare("index_int || index_real", res, {rdesc1, rdesc2}));
+
+        auto cond6 = !(nogdb::Condition("index_int").ge(int32_t{0}) && nogdb::Condition("index_real").ge(0.0));
+        res = nogdb::Vertex::getIndexCursor(txn, className, cond6);
+        assert(rdescCursorCompare("!(index_int && index_real)", res, {}));
+        res = nogdb::Vertex::getCursor(txn, className, cond6);
+        assert(rdescCursorCompare("!(index_int && index_real)", res, {rdesc2, rdesc3, rdesc4}));
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+}
+
 #endif
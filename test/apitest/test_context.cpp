@@ -19,6 +19,9 @@
  *
  */
 
+#include <chrono>
+#include <thread>
+
 #include "apitest.h"
 
 void assert_dbinfo(const nogdb::DBInfo &info1, const nogdb::DBInfo &info2) {
@@ -700,6 +703,203 @@ void test_reopen_ctx_v6() {
 
 }
 
+void test_reopen_ctx_v7() {
+	auto vertices = std::vector<nogdb::RecordDescriptor>{};
+	auto edges = std::vector<nogdb::RecordDescriptor>{};
+	auto reopen = []() {
+		delete ctx;
+		try {
+			ctx = new nogdb::Context(DATABASE_PATH);
+		} catch(const nogdb::Error& ex) {
+			std::cout << "\nError: " << ex.what() << std::endl;
+			assert(false);
+		}
+	};
+	auto assert_relations = [&vertices](const std::vector<std::pair<size_t, size_t>>& expected) {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			auto numOut = std::count_if(expected.cbegin(), expected.cend(),
+			                            [i](const std::pair<size_t, size_t>& e) { return e.first == i; });
+			auto numIn = std::count_if(expected.cbegin(), expected.cend(),
+			                           [i](const std::pair<size_t, size_t>& e) { return e.second == i; });
+			assert(nogdb::Vertex::getOutEdge(txn, vertices[i]).size() == static_cast<size_t>(numOut));
+			assert(nogdb::Vertex::getInEdge(txn, vertices[i]).size() == static_cast<size_t>(numIn));
+		}
+	};
+
+	auto expected = std::vector<std::pair<size_t, size_t>>{};
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "snapshot_vertex", nogdb::ClassType::VERTEX);
+		nogdb::Class::create(txn, "snapshot_edge", nogdb::ClassType::EDGE);
+		for (size_t i = 0; i < 20; ++i) {
+			vertices.emplace_back(nogdb::Vertex::create(txn, "snapshot_vertex"));
+		}
+		for (size_t i = 0; i < 60; ++i) {
+			expected.emplace_back(i % 20, (i * 7) % 20);
+			edges.emplace_back(nogdb::Edge::create(txn, "snapshot_edge", vertices[i % 20], vertices[(i * 7) % 20]));
+		}
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// the first reopening writes a snapshot and the second one restores from it
+	reopen();
+	assert_relations(expected);
+	reopen();
+	assert_relations(expected);
+
+	// changes made after the snapshot are replayed
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Edge::destroy(txn, edges[3]);
+		nogdb::Edge::destroy(txn, edges[59]);
+		nogdb::Edge::updateSrc(txn, edges[10], vertices[5]);
+		nogdb::Edge::updateDst(txn, edges[11], vertices[6]);
+		expected[10].first = 5;
+		expected[11].second = 6;
+		expected.erase(expected.begin() + 59);
+		expected.erase(expected.begin() + 3);
+		for (size_t i = 0; i < 3; ++i) {
+			expected.emplace_back(19, i);
+			nogdb::Edge::create(txn, "snapshot_edge", vertices[19], vertices[i]);
+		}
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	reopen();
+	assert_relations(expected);
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+		assert(nogdb::Edge::getSrc(txn, edges[10]).descriptor == vertices[5]);
+		assert(nogdb::Edge::getDst(txn, edges[11]).descriptor == vertices[6]);
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// a dropped edge class may hand its class id over to a new one
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::drop(txn, "snapshot_edge");
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	reopen();
+	expected.clear();
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "snapshot_edge", nogdb::ClassType::EDGE);
+		expected.emplace_back(1, 2);
+		nogdb::Edge::create(txn, "snapshot_edge", vertices[1], vertices[2]);
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	reopen();
+	assert_relations(expected);
+
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::drop(txn, "snapshot_edge");
+		nogdb::Class::drop(txn, "snapshot_vertex");
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+}
+
+void test_reopen_ctx_v8() {
+	auto vertices = std::vector<nogdb::RecordDescriptor>{};
+	auto reopen = [](unsigned int numLoadingThreads) {
+		delete ctx;
+		try {
+			auto options = nogdb::ContextOptions{};
+			options.numLoadingThreads = numLoadingThreads;
+			ctx = new nogdb::Context(DATABASE_PATH, options);
+		} catch(const nogdb::Error& ex) {
+			std::cout << "\nError: " << ex.what() << std::endl;
+			assert(false);
+		}
+	};
+	auto assert_relations = [&vertices](const std::vector<std::pair<size_t, size_t>>& expected) {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			auto numOut = std::count_if(expected.cbegin(), expected.cend(),
+			                            [i](const std::pair<size_t, size_t>& e) { return e.first == i; });
+			auto numIn = std::count_if(expected.cbegin(), expected.cend(),
+			                           [i](const std::pair<size_t, size_t>& e) { return e.second == i; });
+			assert(nogdb::Vertex::getOutEdge(txn, vertices[i]).size() == static_cast<size_t>(numOut));
+			assert(nogdb::Vertex::getInEdge(txn, vertices[i]).size() == static_cast<size_t>(numIn));
+		}
+	};
+	auto add_edges = [&vertices](std::vector<std::pair<size_t, size_t>>& expected, size_t numEdges) {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		for (size_t i = 0; i < numEdges; ++i) {
+			auto src = (i * 3) % vertices.size();
+			auto dst = (i * 11 + 5) % vertices.size();
+			expected.emplace_back(src, dst);
+			nogdb::Edge::create(txn, (i % 2 == 0) ? "parallel_edge1" : "parallel_edge2", vertices[src], vertices[dst]);
+		}
+		txn.commit();
+	};
+
+	auto expected = std::vector<std::pair<size_t, size_t>>{};
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "parallel_vertex1", nogdb::ClassType::VERTEX);
+		nogdb::Class::create(txn, "parallel_vertex2", nogdb::ClassType::VERTEX);
+		nogdb::Class::create(txn, "parallel_edge1", nogdb::ClassType::EDGE);
+		nogdb::Class::create(txn, "parallel_edge2", nogdb::ClassType::EDGE);
+		for (size_t i = 0; i < 50; ++i) {
+			vertices.emplace_back(nogdb::Vertex::create(txn, (i % 2 == 0) ? "parallel_vertex1" : "parallel_vertex2"));
+		}
+		txn.commit();
+		add_edges(expected, 200);
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// replaying every relation and restoring them from a snapshot are both split across loading threads
+	reopen(4);
+	assert_relations(expected);
+	reopen(3);
+	assert_relations(expected);
+
+	// relations created after the snapshot are split across loading threads too
+	try {
+		add_edges(expected, 7);
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	reopen(5);
+	assert_relations(expected);
+	reopen(1);
+	assert_relations(expected);
+
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::drop(txn, "parallel_edge1");
+		nogdb::Class::drop(txn, "parallel_edge2");
+		nogdb::Class::drop(txn, "parallel_vertex1");
+		nogdb::Class::drop(txn, "parallel_vertex2");
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+}
+
 void test_locked_ctx() {
 	try {
 		new nogdb::Context(DATABASE_PATH);
@@ -731,3 +931,398 @@ void test_invalid_ctx() {
 	}
     txn.rollback();
 }
+
+void test_reopen_ctx_v9() {
+	auto vertices = std::vector<nogdb::RecordDescriptor>{};
+	auto edges = std::vector<nogdb::RecordDescriptor>{};
+	auto expected = std::vector<std::pair<size_t, size_t>>{};
+	auto reopen = [](unsigned long adjacencyCacheSize) {
+		delete ctx;
+		try {
+			auto options = nogdb::ContextOptions{};
+			options.numLoadingThreads = 1U;
+			options.adjacencyCacheSize = adjacencyCacheSize;
+			ctx = new nogdb::Context(DATABASE_PATH, options);
+		} catch(const nogdb::Error& ex) {
+			std::cout << "\nError: " << ex.what() << std::endl;
+			assert(false);
+		}
+	};
+	auto assert_relations = [&](const nogdb::Txn& txn, const std::vector<std::pair<size_t, size_t>>& expected) {
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			auto numOut = std::count_if(expected.cbegin(), expected.cend(),
+			                            [i](const std::pair<size_t, size_t>& e) { return e.first == i; });
+			auto numIn = std::count_if(expected.cbegin(), expected.cend(),
+			                           [i](const std::pair<size_t, size_t>& e) { return e.second == i; });
+			assert(nogdb::Vertex::getOutEdge(txn, vertices[i]).size() == static_cast<size_t>(numOut));
+			assert(nogdb::Vertex::getInEdge(txn, vertices[i]).size() == static_cast<size_t>(numIn));
+		}
+		for (size_t i = 0; i < edges.size(); ++i) {
+			if (expected[i].first == vertices.size()) {
+				continue;
+			}
+			assert(nogdb::Edge::getSrc(txn, edges[i]).descriptor == vertices[expected[i].first]);
+			assert(nogdb::Edge::getDst(txn, edges[i]).descriptor == vertices[expected[i].second]);
+		}
+	};
+
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "lazy_vertex", nogdb::ClassType::VERTEX);
+		nogdb::Class::create(txn, "lazy_edge", nogdb::ClassType::EDGE);
+		for (size_t i = 0; i < 40; ++i) {
+			vertices.emplace_back(nogdb::Vertex::create(txn, "lazy_vertex"));
+		}
+		for (size_t i = 0; i < 120; ++i) {
+			auto src = (i * 7) % vertices.size();
+			auto dst = (i * 13 + 3) % vertices.size();
+			expected.emplace_back(src, dst);
+			edges.emplace_back(nogdb::Edge::create(txn, "lazy_edge", vertices[src], vertices[dst]));
+		}
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// the whole graph does not fit into a cache of 8 edges
+	reopen(8UL);
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+		assert_relations(txn, expected);
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// a reader keeps its snapshot while a writer changes vertices which are evicted afterwards
+	try {
+		auto rtxn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+		auto before = expected;
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Edge::destroy(txn, edges[0]);
+		expected[0].first = expected[0].second = vertices.size();
+		nogdb::Edge::updateSrc(txn, edges[1], vertices[0]);
+		expected[1].first = 0;
+		auto src = size_t{5}, dst = size_t{9};
+		edges.emplace_back(nogdb::Edge::create(txn, "lazy_edge", vertices[src], vertices[dst]));
+		expected.emplace_back(src, dst);
+		txn.commit();
+
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			auto numOut = std::count_if(before.cbegin(), before.cend(),
+			                            [i](const std::pair<size_t, size_t>& e) { return e.first == i; });
+			auto numIn = std::count_if(before.cbegin(), before.cend(),
+			                           [i](const std::pair<size_t, size_t>& e) { return e.second == i; });
+			assert(nogdb::Vertex::getOutEdge(rtxn, vertices[i]).size() == static_cast<size_t>(numOut));
+			assert(nogdb::Vertex::getInEdge(rtxn, vertices[i]).size() == static_cast<size_t>(numIn));
+		}
+		assert(nogdb::Edge::getSrc(rtxn, edges[0]).descriptor == vertices[before[0].first]);
+		assert(nogdb::Edge::getSrc(rtxn, edges[1]).descriptor == vertices[before[1].first]);
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+		assert_relations(txn, expected);
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// the adjacency maintained with a bounded cache is consistent with relations loaded eagerly
+	reopen(0UL);
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+		assert_relations(txn, expected);
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// changes made without a bounded cache are picked up when reopening with one
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Edge::destroy(txn, edges[2]);
+		expected[2].first = expected[2].second = vertices.size();
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	reopen(16UL);
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+		assert_relations(txn, expected);
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::drop(txn, "lazy_edge");
+		nogdb::Class::drop(txn, "lazy_vertex");
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	reopen(0UL);
+}
+
+void test_reopen_ctx_v10() {
+	auto reopen = [](const nogdb::ContextOptions& options) {
+		delete ctx;
+		try {
+			ctx = new nogdb::Context(DATABASE_PATH, options);
+		} catch(const nogdb::Error& ex) {
+			std::cout << "\nError: " << ex.what() << std::endl;
+			assert(false);
+		}
+	};
+
+	auto options = nogdb::ContextOptions{};
+	options.noSync = true;
+	options.writeMap = true;
+	options.mapAsync = true;
+	options.syncIntervalMs = 5U;
+	reopen(options);
+	auto vertices = std::vector<nogdb::RecordDescriptor>{};
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "nosync_vertex", nogdb::ClassType::VERTEX);
+		nogdb::Property::add(txn, "nosync_vertex", "index", nogdb::PropertyType::UNSIGNED_INTEGER);
+		txn.commit();
+		for (auto i = 0U; i < 20U; ++i) {
+			auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+			vertices.emplace_back(nogdb::Vertex::create(txn, "nosync_vertex", nogdb::Record{}.set("index", i)));
+			txn.commit();
+		}
+		// copies share the background flusher
+		auto copy = *ctx;
+		std::this_thread::sleep_for(std::chrono::milliseconds{20});
+		ctx->sync();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	options = nogdb::ContextOptions{};
+	options.noMetaSync = true;
+	reopen(options);
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		auto res = nogdb::Vertex::get(txn, "nosync_vertex");
+		assert(res.size() == vertices.size());
+		for (auto i = 0U; i < vertices.size(); ++i) {
+			assert(nogdb::Db::getRecord(txn, vertices[i]).getIntU("index") == i);
+		}
+		nogdb::Class::drop(txn, "nosync_vertex");
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	reopen(nogdb::ContextOptions{});
+}
+
+void test_reopen_ctx_v11() {
+	auto reopen = [](unsigned long maxDbSize, unsigned long maxMapSize) {
+		delete ctx;
+		try {
+			auto options = nogdb::ContextOptions{};
+			options.maxDbSize = maxDbSize;
+			options.maxMapSize = maxMapSize;
+			ctx = new nogdb::Context(DATABASE_PATH, options);
+		} catch(const nogdb::Error& ex) {
+			std::cout << "\nError: " << ex.what() << std::endl;
+			assert(false);
+		}
+	};
+	auto const text = std::string(16384, 'x');
+	auto write = [&text](nogdb::Txn& txn, unsigned int numRecords) {
+		for (auto i = 0U; i < numRecords; ++i) {
+			nogdb::Vertex::create(txn, "growing_vertex", nogdb::Record{}.set("text", text));
+		}
+	};
+
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "growing_vertex", nogdb::ClassType::VERTEX);
+		nogdb::Property::add(txn, "growing_vertex", "text", nogdb::PropertyType::TEXT);
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// a map of a fixed size runs out of space
+	reopen(1UL << 20, 0UL);
+	auto numRecords = 0U;
+	auto isMapFull = false;
+	for (auto i = 0U; i < 256U && !isMapFull; ++i) {
+		try {
+			auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+			write(txn, 4U);
+			txn.commit();
+			numRecords += 4U;
+		} catch(const nogdb::Error& ex) {
+			REQUIRE(ex, MDB_MAP_FULL, "MDB_MAP_FULL");
+			isMapFull = true;
+		}
+	}
+	assert(isMapFull);
+
+	// a growing map makes room ahead of the writers which fill it up gradually
+	reopen(1UL << 20, 1UL << 30);
+	try {
+		for (auto i = 0U; i < 64U; ++i) {
+			auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+			write(txn, 4U);
+			txn.commit();
+			numRecords += 4U;
+		}
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// a transaction overflowing the map fails, and the map grows before the next one
+	auto numAttempts = 0U;
+	while (true) {
+		++numAttempts;
+		try {
+			auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+			write(txn, 1024U);
+			txn.commit();
+			numRecords += 1024U;
+			break;
+		} catch(const nogdb::Error& ex) {
+			REQUIRE(ex, MDB_MAP_FULL, "MDB_MAP_FULL");
+			assert(numAttempts < 16U);
+		}
+	}
+
+	// a write queue applies a group which has run out of space again
+	try {
+		nogdb::WriteQueue queue{*ctx};
+		queue.submit([&](nogdb::Txn& txn) { write(txn, 2048U); }).get();
+		numRecords += 2048U;
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		assert(nogdb::Vertex::get(txn, "growing_vertex").size() == numRecords);
+		nogdb::Class::drop(txn, "growing_vertex");
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	reopen(1UL << 30, 1UL << 40);
+}
+
+void test_reopen_ctx_v12() {
+	delete ctx;
+	try {
+		auto options = nogdb::ContextOptions{};
+		options.maxDbSize = 1UL << 20;
+		options.maxMapSize = 1UL << 30;
+		ctx = new nogdb::Context(DATABASE_PATH, options);
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	auto const text = std::string(16384, 'x');
+	auto write = [&text](unsigned int numRecords) {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		for (auto i = 0U; i < numRecords; ++i) {
+			nogdb::Vertex::create(txn, "pinned_vertex", nogdb::Record{}.set("text", text));
+		}
+		txn.commit();
+	};
+	auto elapsed = [](const std::chrono::steady_clock::time_point &start) {
+		return std::chrono::steady_clock::now() - start;
+	};
+
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "pinned_vertex", nogdb::ClassType::VERTEX);
+		nogdb::Property::add(txn, "pinned_vertex", "text", nogdb::PropertyType::TEXT);
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// a long-lived reader keeps the map from growing until the writers fill it up
+	auto reader = std::unique_ptr<nogdb::Txn>(new nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY});
+	auto numRecords = 0U;
+	auto isMapFull = false;
+	for (auto i = 0U; i < 64U && !isMapFull; ++i) {
+		try {
+			write(1024U);
+			numRecords += 1024U;
+		} catch(const nogdb::Error& ex) {
+			REQUIRE(ex, MDB_MAP_FULL, "MDB_MAP_FULL");
+			isMapFull = true;
+		}
+	}
+	assert(isMapFull);
+
+	// the next writer waits for the reader once, then writers fail fast without holding off new readers
+	try {
+		write(1U);
+		assert(false);
+	} catch(const nogdb::Error& ex) {
+		REQUIRE(ex, MDB_MAP_FULL, "MDB_MAP_FULL");
+	}
+	for (auto i = 0U; i < 8U; ++i) {
+		auto start = std::chrono::steady_clock::now();
+		try {
+			write(1U);
+			assert(false);
+		} catch(const nogdb::Error& ex) {
+			REQUIRE(ex, MDB_MAP_FULL, "MDB_MAP_FULL");
+		}
+		assert(elapsed(start) < std::chrono::milliseconds{200});
+		start = std::chrono::steady_clock::now();
+		try {
+			auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+			assert(nogdb::Vertex::get(txn, "pinned_vertex").size() == numRecords);
+		} catch(const nogdb::Error& ex) {
+			std::cout << "\nError: " << ex.what() << std::endl;
+			assert(false);
+		}
+		assert(elapsed(start) < std::chrono::milliseconds{200});
+	}
+
+	// the map grows once the reader has gone, which is released before the context is reopened below
+	reader.reset();
+	try {
+		write(1024U);
+		numRecords += 1024U;
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		assert(nogdb::Vertex::get(txn, "pinned_vertex").size() == numRecords);
+		nogdb::Class::drop(txn, "pinned_vertex");
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	delete ctx;
+	try {
+		auto options = nogdb::ContextOptions{};
+		options.maxDbSize = 1UL << 30;
+		options.maxMapSize = 1UL << 40;
+		ctx = new nogdb::Context(DATABASE_PATH, options);
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+}
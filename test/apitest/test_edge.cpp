@@ -69,6 +69,79 @@ void test_create_edges() {
     destroy_vertex_book();
 }
 
+void test_create_edges_version() {
+    init_vertex_book();
+    init_vertex_person();
+    init_edge_author();
+
+    nogdb::RecordDescriptor v1{}, v2{};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::createIndex(txn, "books", "pages");
+        v1 = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Harry Potter").set("pages", 456));
+        v2 = nogdb::Vertex::create(txn, "persons", nogdb::Record{}.set("name", "J.K. Rowlings"));
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::create(txn, "authors", v1, v2, nogdb::Record{}.set("time_used", 365U));
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::create(txn, "authors", v1, v2, nogdb::Record{}.set("time_used", 180U));
+        auto res = nogdb::Vertex::getIndex(txn, "books", nogdb::Condition("pages").eq(456));
+        assert(res.size() == 1);
+        assert(res[0].record.getVersion() == 3ULL);
+        assert(res[0].record.get("title").toText() == "Harry Potter");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    // the bumped version survives reopening the context
+    delete ctx;
+    ctx = new nogdb::Context(DATABASE_PATH);
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        auto record = nogdb::Db::getRecord(txn, v1);
+        assert(record.getVersion() == 3ULL);
+        assert(nogdb::Db::getRecord(txn, v2).getVersion() == 3ULL);
+        nogdb::Vertex::update(txn, v1, record.set("pages", 457));
+        assert(nogdb::Db::getRecord(txn, v1).getVersion() == 4ULL);
+        assert(nogdb::Vertex::getIndex(txn, "books", nogdb::Condition("pages").eq(456)).empty());
+        nogdb::Vertex::destroy(txn, v2);
+        assert(nogdb::Db::getRecord(txn, v1).getVersion() == 4ULL);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "books", "pages");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_edge_author();
+    destroy_vertex_person();
+    destroy_vertex_book();
+}
+
 void test_create_invalid_edge() {
     init_vertex_book();
     init_vertex_person();
@@ -790,6 +863,50 @@ void test_update_invalid_edge() {
     destroy_vertex_book();
 }
 
+void test_patch_edge() {
+    init_vertex_book();
+    init_vertex_person();
+    init_edge_author();
+
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        auto v1 = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Harry Potter"));
+        auto v2 = nogdb::Vertex::create(txn, "persons", nogdb::Record{}.set("name", "J.K. Rowlings"));
+        auto e1 = nogdb::Edge::create(txn, "authors", v1, v2, nogdb::Record{}.set("time_used", 365U).set("profit", 1.5));
+
+        nogdb::Edge::patch(txn, e1, nogdb::Record{}.set("profit", 2.5));
+        assert(nogdb::Edge::increment(txn, e1, "time_used", 35).toIntU() == 400U);
+        auto res = nogdb::Edge::get(txn, "authors");
+        assert(res.size() == 1);
+        assert(res[0].record.getIntU("time_used") == 400U);
+        assert(res[0].record.getReal("profit") == 2.5);
+        assert(nogdb::Edge::getSrc(txn, e1).descriptor.rid == v1.rid);
+
+        try {
+            auto tmp = e1;
+            tmp.rid.second = -1;
+            nogdb::Edge::increment(txn, tmp, "time_used", 1);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_GRAPH_NOEXST_EDGE, "NOGDB_GRAPH_NOEXST_EDGE");
+        }
+        try {
+            nogdb::Edge::patch(txn, v1, nogdb::Record{}.set("profit", 1.0));
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_CTX_MISMATCH_CLASSTYPE, "NOGDB_CTX_MISMATCH_CLASSTYPE");
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.rollback();
+
+    destroy_edge_author();
+    destroy_vertex_person();
+    destroy_vertex_book();
+}
+
 void test_update_vertex_src() {
     init_vertex_book();
     init_vertex_person();
@@ -2009,25 +2009,252 @@ void test_search_by_index_extended_class_cursor_condition() {
 }
 
 void test_search_by_index_unique_multicondition() {
-    //TODO
+    init_vertex_index_test();
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::createIndex(txn, "index_test", "index_text", true);
+        nogdb::Property::createIndex(txn, "index_test", "index_int", true);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto rdescs = indexMultiConditionInsert(ctx, "index_test");
+    indexMultiConditionTester(ctx, "index_test", rdescs);
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test", "index_text");
+        nogdb::Property::dropIndex(txn, "index_test", "index_int");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_index_test();
 }
 
 void test_search_by_index_non_unique_multicondition() {
-    //TODO
+    init_vertex_index_test();
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::createIndex(txn, "index_test", "index_text", false);
+        nogdb::Property::createIndex(txn, "index_test", "index_int", false);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto rdescs = indexMultiConditionInsert(ctx, "index_test");
+    indexMultiConditionTester(ctx, "index_test", rdescs);
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test", "index_text");
+        nogdb::Property::dropIndex(txn, "index_test", "index_int");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_index_test();
 }
 
 void test_search_by_index_unique_cursor_multicondition() {
-    //TODO
+    init_vertex_index_test();
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::createIndex(txn, "index_test", "index_text", true);
+        nogdb::Property::createIndex(txn, "index_test", "index_int", true);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto rdescs = indexMultiConditionInsert(ctx, "index_test");
+    indexCursorMultiConditionTester(ctx, "index_test", rdescs);
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test", "index_text");
+        nogdb::Property::dropIndex(txn, "index_test", "index_int");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_index_test();
 }
 
 void test_search_by_index_non_unique_cursor_multicondition() {
-    //TODO
+    init_vertex_index_test();
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::createIndex(txn, "index_test", "index_text", false);
+        nogdb::Property::createIndex(txn, "index_test", "index_int", false);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto rdescs = indexMultiConditionInsert(ctx, "index_test");
+    indexCursorMultiConditionTester(ctx, "index_test", rdescs);
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test", "index_text");
+        nogdb::Property::dropIndex(txn, "index_test", "index_int");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_index_test();
 }
 
 void test_search_by_index_extended_class_multicondition() {
-    //TODO
+    init_vertex_index_test();
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::createExtend(txn, "index_test2", "index_test");
+        nogdb::Property::createIndex(txn, "index_test2", "index_text", true);
+        nogdb::Property::createIndex(txn, "index_test2", "index_int", true);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto rdescs = indexMultiConditionInsert(ctx, "index_test2");
+    auto superRdescs = indexMultiConditionInsert(ctx, "index_test");
+    indexMultiConditionTester(ctx, "index_test2", rdescs);
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto cond = nogdb::Condition("index_int").ge(int32_t{0}) && nogdb::Condition("index_text").eq("alpha");
+        auto res = nogdb::Vertex::getIndex(txn, "index_test", cond);
+        assert(rdescCompare("index_int && index_text", res, {rdescs[0]}));
+        res = nogdb::Vertex::get(txn, "index_test", cond);
+        assert(rdescCompare("index_int && index_text", res, {superRdescs[0], rdescs[0]}));
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test2", "index_text");
+        nogdb::Property::dropIndex(txn, "index_test2", "index_int");
+        nogdb::Class::drop(txn, "index_test2");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_index_test();
 }
 
 void test_search_by_index_extended_class_cursor_multicondition() {
-    //TODO
+    init_vertex_index_test();
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::createExtend(txn, "index_test2", "index_test");
+        nogdb::Property::createIndex(txn, "index_test2", "index_text", false);
+        nogdb::Property::createIndex(txn, "index_test2", "index_int", false);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto rdescs = indexMultiConditionInsert(ctx, "index_test2");
+    auto superRdescs = indexMultiConditionInsert(ctx, "index_test");
+    indexCursorMultiConditionTester(ctx, "index_test2", rdescs);
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto cond = nogdb::Condition("index_int").ge(int32_t{0}) && nogdb::Condition("index_text").eq("alpha");
+        auto res = nogdb::Vertex::getIndexCursor(txn, "index_test", cond);
+        assert(rdescCursorCompare("index_int && index_text", res, {rdescs[0]}));
+        res = nogdb::Vertex::getCursor(txn, "index_test", cond);
+        assert(rdescCursorCompare("index_int && index_text", res, {superRdescs[0], rdescs[0]}));
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test2", "index_text");
+        nogdb::Property::dropIndex(txn, "index_test2", "index_int");
+        nogdb::Class::drop(txn, "index_test2");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_index_test();
+}
+
+void test_patch_with_index() {
+    init_vertex_index_test();
+    auto rdesc1 = nogdb::RecordDescriptor{}, rdesc2 = nogdb::RecordDescriptor{};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::createIndex(txn, "index_test", "index_int", true);
+        nogdb::Property::createIndex(txn, "index_test", "index_text", false);
+        rdesc1 = nogdb::Vertex::create(txn, "index_test", nogdb::Record{}.set("index_int", 1).set("index_text", "a"));
+        rdesc2 = nogdb::Vertex::create(txn, "index_test", nogdb::Record{}.set("index_int", 2).set("index_text", "a"));
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Vertex::patch(txn, rdesc1, nogdb::Record{}.set("index_int", 10).set("index_text", "a"));
+        assert(nogdb::Vertex::increment(txn, rdesc2, "index_int", 1).toInt() == 3);
+
+        auto res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_int").eq(int32_t{10}));
+        assert(res.size() == 1 && res[0].descriptor == rdesc1);
+        assert(nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_int").eq(int32_t{1})).empty());
+        assert(nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_int").eq(int32_t{2})).empty());
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_int").eq(int32_t{3}));
+        assert(res.size() == 1 && res[0].descriptor == rdesc2);
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_text").eq("a"));
+        assert(res.size() == 2);
+
+        try {
+            nogdb::Vertex::patch(txn, rdesc2, nogdb::Record{}.set("index_int", 10));
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_CTX_UNIQUE_CONSTRAINT, "NOGDB_CTX_UNIQUE_CONSTRAINT");
+        }
+        txn.rollback();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test", "index_int");
+        nogdb::Property::dropIndex(txn, "index_test", "index_text");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_index_test();
 }
@@ -750,3 +750,366 @@ void test_conflict_property() {
 
 
 
+
+void test_bulk_load_graph() {
+    init_vertex_book();
+    init_vertex_person();
+    init_edge_author();
+
+    nogdb::RecordDescriptor vb1{}, vb2{}, vp1{}, e1{}, e2{};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        vp1 = nogdb::Vertex::create(txn, "persons", nogdb::Record{}.set("name", "J.K. Rowlings").set("age", 32));
+        nogdb::BulkLoader loader{txn};
+        vb1 = loader.addVertex("books", nogdb::Record{}.set("title", "Harry Potter").set("pages", 456));
+        vb2 = loader.addVertex("books", nogdb::Record{}.set("title", "Fantastic Beasts").set("pages", 342));
+        e1 = loader.addEdge("authors", vb1, vp1, nogdb::Record{}.set("time_used", 365U));
+        e2 = loader.addEdge("authors", vb2, vp1, nogdb::Record{}.set("time_used", 180U));
+        loader.finish();
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        auto vb3 = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Percy Jackson"));
+        assert(vb3.rid.second == vb2.rid.second + 1);
+        auto e3 = nogdb::Edge::create(txn, "authors", vb3, vp1);
+        assert(e3.rid.second == e2.rid.second + 1);
+        txn.rollback();
+
+        txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto res = nogdb::Vertex::get(txn, "books");
+        assertSize(res, 2);
+        assert(nogdb::Db::getRecord(txn, vb1).get("title").toText() == "Harry Potter");
+        assert(nogdb::Db::getRecord(txn, e2).get("time_used").toIntU() == 180U);
+        res = nogdb::Vertex::getInEdge(txn, vp1);
+        assertSize(res, 2);
+        res = nogdb::Vertex::getOutEdge(txn, vb1);
+        assertSize(res, 1);
+        assert(res[0].descriptor == e1);
+        assert(nogdb::Edge::getSrc(txn, e2).descriptor == vb2);
+        assert(nogdb::Edge::getDst(txn, e2).descriptor == vp1);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    delete ctx;
+    ctx = new nogdb::Context{DATABASE_PATH};
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto res = nogdb::Vertex::getInEdge(txn, vp1);
+        assertSize(res, 2);
+        assert(nogdb::Edge::getSrc(txn, e1).descriptor == vb1);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_edge_author();
+    destroy_vertex_person();
+    destroy_vertex_book();
+}
+
+void test_bulk_load_new_vertices() {
+    init_vertex_book();
+    init_vertex_person();
+    init_edge_author();
+
+    nogdb::RecordDescriptor vb1{}, vb2{}, vb3{}, vp1{}, vp2{}, e1{}, e2{}, e3{}, e4{}, e5{};
+    // the reader is released before the context is reopened below
+    auto reader = std::unique_ptr<nogdb::Txn>(new nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY});
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::BulkLoader loader{txn};
+        vb1 = loader.addVertex("books", nogdb::Record{}.set("title", "Harry Potter"));
+        vb2 = loader.addVertex("books", nogdb::Record{}.set("title", "Fantastic Beasts"));
+        vb3 = loader.addVertex("books", nogdb::Record{}.set("title", "Quidditch Through the Ages"));
+        vp1 = loader.addVertex("persons", nogdb::Record{}.set("name", "J.K. Rowlings"));
+        vp2 = loader.addVertex("persons", nogdb::Record{}.set("name", "Newt Scamander"));
+        e1 = loader.addEdge("authors", vb1, vp1);
+        e2 = loader.addEdge("authors", vb2, vp1);
+        e3 = loader.addEdge("authors", vb2, vp2);
+        e4 = loader.addEdge("authors", vb3, vp2);
+        loader.finish();
+
+        // the edges between the new vertices are seen by the writer only
+        assertSize(nogdb::Vertex::getInEdge(txn, vp1), 2);
+        assert(nogdb::Edge::getSrc(txn, e3).descriptor == vb2);
+        assertSize(nogdb::Vertex::get(*reader, "books"), 0);
+
+        // later changes of the same transaction are applied on top of them
+        nogdb::Edge::destroy(txn, e3);
+        nogdb::Vertex::destroy(txn, vb3);
+        e5 = nogdb::Edge::create(txn, "authors", vb1, vp2);
+        auto savepoint = txn.savepoint();
+        nogdb::Edge::destroy(txn, e1);
+        nogdb::Edge::updateSrc(txn, e2, vb1);
+        txn.rollbackTo(savepoint);
+        assertSize(nogdb::Vertex::getOutEdge(txn, vb1), 2);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto verify = [&]() {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assertSize(nogdb::Vertex::get(txn, "books"), 2);
+        assertSize(nogdb::Edge::get(txn, "authors"), 3);
+        assertSize(nogdb::Vertex::getInEdge(txn, vp1), 2);
+        assertSize(nogdb::Vertex::getOutEdge(txn, vb1), 2);
+        auto res = nogdb::Vertex::getOutEdge(txn, vb2);
+        assertSize(res, 1);
+        assert(res[0].descriptor == e2);
+        res = nogdb::Vertex::getInEdge(txn, vp2);
+        assertSize(res, 1);
+        assert(res[0].descriptor == e5);
+        assert(nogdb::Edge::getSrc(txn, e2).descriptor == vb2);
+        assert(nogdb::Edge::getDst(txn, e5).descriptor == vp2);
+        try {
+            nogdb::Edge::getSrc(txn, e4);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_GRAPH_NOEXST_EDGE, "NOGDB_GRAPH_NOEXST_EDGE");
+        }
+        txn.commit();
+    };
+    try {
+        assertSize(nogdb::Vertex::get(*reader, "books"), 0);
+        reader.reset();
+        verify();
+        delete ctx;
+        ctx = new nogdb::Context{DATABASE_PATH};
+        verify();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_edge_author();
+    destroy_vertex_person();
+    destroy_vertex_book();
+}
+
+void test_bulk_load_with_index() {
+    init_vertex_book();
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::createIndex(txn, "books", "pages", true);
+        nogdb::Property::createIndex(txn, "books", "title", false);
+        txn.commit();
+
+        txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::BulkLoader loader{txn};
+        for (auto i = 100; i > 0; --i) {
+            loader.addVertex("books", nogdb::Record{}.set("title", (i % 2) ? "odd" : "even").set("pages", i - 50));
+        }
+        loader.finish();
+        txn.commit();
+
+        txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto res = nogdb::Vertex::getIndex(txn, "books", nogdb::Condition("pages").lt(0));
+        assertSize(res, 49);
+        res = nogdb::Vertex::getIndex(txn, "books", nogdb::Condition("pages").eq(25));
+        assertSize(res, 1);
+        res = nogdb::Vertex::getIndex(txn, "books", nogdb::Condition("title").eq("odd"));
+        assertSize(res, 50);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::BulkLoader loader{txn};
+        loader.addVertex("books", nogdb::Record{}.set("pages", 1000));
+        loader.addVertex("books", nogdb::Record{}.set("pages", 1000));
+        loader.finish();
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, NOGDB_CTX_UNIQUE_CONSTRAINT, "NOGDB_CTX_UNIQUE_CONSTRAINT");
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "books", "pages");
+        nogdb::Property::dropIndex(txn, "books", "title");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_vertex_book();
+}
+
+void test_bulk_load_invalid() {
+    init_vertex_book();
+    init_vertex_person();
+    init_edge_author();
+
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    nogdb::BulkLoader loader{txn};
+    auto vb = loader.addVertex("books");
+    auto vp = loader.addVertex("persons");
+    try {
+        loader.addVertex("authors");
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, NOGDB_CTX_MISMATCH_CLASSTYPE, "NOGDB_CTX_MISMATCH_CLASSTYPE");
+    }
+    try {
+        loader.addVertex("movies");
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, NOGDB_CTX_NOEXST_CLASS, "NOGDB_CTX_NOEXST_CLASS");
+    }
+    try {
+        loader.addVertex("books", nogdb::Record{}.set("isbn", "0-7475-3269-9"));
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, NOGDB_CTX_NOEXST_PROPERTY, "NOGDB_CTX_NOEXST_PROPERTY");
+    }
+    try {
+        loader.addEdge("authors", nogdb::RecordDescriptor{vb.rid.first, vb.rid.second + 1}, vp);
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, NOGDB_GRAPH_NOEXST_SRC, "NOGDB_GRAPH_NOEXST_SRC");
+    }
+    try {
+        loader.addEdge("authors", vb, nogdb::RecordDescriptor{vp.rid.first, vp.rid.second + 1});
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, NOGDB_GRAPH_NOEXST_DST, "NOGDB_GRAPH_NOEXST_DST");
+    }
+    try {
+        loader.finish();
+        loader.addVertex("books");
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, NOGDB_TXN_COMPLETED, "NOGDB_TXN_COMPLETED");
+    }
+    txn.rollback();
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        nogdb::BulkLoader loader{txn};
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, NOGDB_TXN_INVALID_MODE, "NOGDB_TXN_INVALID_MODE");
+    }
+
+    destroy_edge_author();
+    destroy_vertex_person();
+    destroy_vertex_book();
+}
+
+void test_bulk_load_unfinished() {
+    init_vertex_book();
+
+    // a session which has added records must finish before its transaction commits
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        {
+            nogdb::BulkLoader loader{txn};
+            loader.addVertex("books", nogdb::Record{}.set("title", "Lion King"));
+        }
+        txn.commit();
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, NOGDB_TXN_UNFINISHED_BULK_LOAD, "NOGDB_TXN_UNFINISHED_BULK_LOAD");
+    }
+
+    // the refused commit has rolled the records back
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        assertSize(nogdb::Vertex::get(txn, "books"), 0);
+        // a session without records does not keep the transaction from committing
+        {
+            nogdb::BulkLoader loader{txn};
+        }
+        nogdb::BulkLoader loader{txn};
+        loader.addVertex("books", nogdb::Record{}.set("title", "Tarzan"));
+        loader.finish();
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+    try {
+        auto res = nogdb::Vertex::get(txn, "books");
+        assertSize(res, 1);
+        assert(res[0].record.getText("title") == "Tarzan");
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.rollback();
+
+    destroy_vertex_book();
+}
+
+void test_bulk_load_savepoint() {
+    init_vertex_book();
+
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        auto savepoint = txn.savepoint();
+        nogdb::BulkLoader loader{txn};
+        loader.addVertex("books", nogdb::Record{}.set("title", "Lion King"));
+        // an unfinished session keeps handles of the current savepoint
+        try {
+            txn.savepoint();
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_TXN_UNFINISHED_BULK_LOAD, "NOGDB_TXN_UNFINISHED_BULK_LOAD");
+        }
+        try {
+            txn.rollbackTo(savepoint);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_TXN_UNFINISHED_BULK_LOAD, "NOGDB_TXN_UNFINISHED_BULK_LOAD");
+        }
+        try {
+            txn.releaseSavepoint(savepoint);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_TXN_UNFINISHED_BULK_LOAD, "NOGDB_TXN_UNFINISHED_BULK_LOAD");
+        }
+        loader.finish();
+
+        // the refused calls have left the transaction and its savepoints as they were
+        auto nextSavepoint = txn.savepoint();
+        nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Tarzan"));
+        txn.rollbackTo(nextSavepoint);
+        txn.releaseSavepoint(savepoint);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+    try {
+        auto res = nogdb::Vertex::get(txn, "books");
+        assertSize(res, 1);
+        assert(res[0].record.getText("title") == "Lion King");
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.rollback();
+
+    destroy_vertex_book();
+}
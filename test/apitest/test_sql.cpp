@@ -595,6 +595,21 @@ void test_sql_select_property() {
         assert(false);
     }
 
+    // select properties and basic info from a class.
+    try {
+        SQL::Result result = SQL::execute(txn, "SELECT name, @className, @recordId FROM persons");
+        assert(result.type() == result.RESULT_SET);
+        auto res = result.get<ResultSet>();
+        assertSize(res, 1);
+        assert(res[0].record.get("name").toText() == "Jim Beans");
+        assert(res[0].record.get("age").empty());
+        assert(res[0].record.get("@className").toText() == "persons");
+        assert(res[0].record.get("@recordId").toText() == rid2str(rdesc.rid));
+    } catch (const Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
     // select non-exist property.
     try {
         SQL::Result result = SQL::execute(txn, "SELECT nonExist FROM " + to_string(rdesc));
@@ -18,6 +18,10 @@
  *  along with this program. If not, see <http://www.gnu.org/licenses/>.
  *
  */
+
+#include <chrono>
+#include <thread>
+
 #include "apitest.h"
 #include "test_prepare.h"
 
@@ -1771,6 +1775,493 @@ void test_txn_stat() {
     destroy_vertex_island();
 }
 
+void test_txn_stat_many_readers() {
+    init_vertex_island();
+
+    try {
+        auto numReaders = 300U;
+        auto readers = std::vector<nogdb::Txn>{};
+        auto firstTxnId = ctx->getMaxTxnId();
+        auto firstVersionId = ctx->getMaxVersionId();
+        for (auto i = 0U; i < numReaders / 2; ++i) {
+            readers.emplace_back(*ctx, nogdb::Txn::Mode::READ_ONLY);
+        }
+        nogdb::Txn txnRw{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Vertex::create(txnRw, "islands", nogdb::Record{}.set("name", "Koh Kood"));
+        txnRw.commit();
+        // readers beyond the capacity of the reader table are registered as well
+        for (auto i = numReaders / 2; i < numReaders; ++i) {
+            readers.emplace_back(*ctx, nogdb::Txn::Mode::READ_ONLY);
+        }
+        assert(ctx->getMaxTxnId() == firstTxnId + numReaders);
+        assert(ctx->getMinActiveTxnId() == std::make_pair(firstTxnId, firstVersionId));
+        for (auto i = 0U; i < numReaders; ++i) {
+            auto expectedVersionId = (i < numReaders / 2) ? firstVersionId : firstVersionId + 1;
+            assert(ctx->getMinActiveTxnId() == std::make_pair(firstTxnId + i, expectedVersionId));
+            readers[i].commit();
+        }
+        assert(ctx->getMinActiveTxnId() == std::make_pair((nogdb::TxnId) 0, (nogdb::TxnId) 0));
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_vertex_island();
+}
+
+void test_txn_reclaim_deleted_elements() {
+    init_vertex_island();
+    init_edge_bridge();
+
+    auto waitForReclaim = []() {
+        for (auto i = 0; i < 500 && ctx->getReclaimStat().numPendingElements > 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        return ctx->getReclaimStat();
+    };
+
+    try {
+        auto txnRw1 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        auto v1 = nogdb::Vertex::create(txnRw1, "islands", nogdb::Record{}.set("name", "Koh Mak"));
+        auto v2 = nogdb::Vertex::create(txnRw1, "islands", nogdb::Record{}.set("name", "Koh Kham"));
+        auto e1 = nogdb::Edge::create(txnRw1, "bridge", v1, v2, nogdb::Record{}.set("name", "Mak-Kham"));
+        txnRw1.commit();
+        auto before = waitForReclaim();
+
+        auto txnRo = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto txnRw2 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Vertex::destroy(txnRw2, v1);
+        txnRw2.commit();
+
+        // deleted elements are kept for as long as an older reader can see them
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        auto pending = ctx->getReclaimStat();
+        assert(pending.numPendingElements == 2);
+        assert(pending.versionLag >= 1);
+        assert(nogdb::Vertex::getOutEdge(txnRo, v1).size() == 1);
+        txnRo.commit();
+
+        auto after = waitForReclaim();
+        assert(after.numPendingElements == 0);
+        assert(after.numReclaimedElements == before.numReclaimedElements + 2);
+        assert(after.safeVersionId == ctx->getMaxVersionId());
+        assert(after.versionLag == 0);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_edge_bridge();
+    destroy_vertex_island();
+}
+
+void test_txn_reclaim_adjacency() {
+    init_vertex_island();
+    init_edge_bridge();
+
+    auto waitForReclaim = []() {
+        for (auto i = 0; i < 500 && ctx->getReclaimStat().numPendingVersions > 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+        return ctx->getReclaimStat();
+    };
+
+    try {
+        auto txnRw1 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        auto hub = nogdb::Vertex::create(txnRw1, "islands", nogdb::Record{}.set("name", "Koh Chang"));
+        txnRw1.commit();
+
+        auto txnRo1 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto edges = std::vector<nogdb::RecordDescriptor>{};
+        for (auto i = 0; i < 20; ++i) {
+            auto txnRw = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+            auto island = nogdb::Vertex::create(txnRw, "islands", nogdb::Record{}.set("name", "Koh " + std::to_string(i)));
+            edges.push_back(nogdb::Edge::create(txnRw, "bridge", hub, island));
+            txnRw.commit();
+        }
+
+        // changes in the adjacency are kept apart for as long as an older reader can see them
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        assert(ctx->getReclaimStat().numPendingVersions >= 1);
+        assert(nogdb::Vertex::getOutEdge(txnRo1, hub).empty());
+        auto txnRo2 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Vertex::getOutEdge(txnRo2, hub).size() == 20);
+        txnRo1.commit();
+        txnRo2.commit();
+        assert(waitForReclaim().numPendingVersions == 0);
+
+        auto txnRo3 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto txnRw2 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        for (auto i = 0; i < 20; i += 2) {
+            nogdb::Edge::destroy(txnRw2, edges[i]);
+        }
+        txnRw2.commit();
+        assert(nogdb::Vertex::getOutEdge(txnRo3, hub).size() == 20);
+        txnRo3.commit();
+        assert(waitForReclaim().numPendingVersions == 0);
+
+        auto txnRo4 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto res = nogdb::Vertex::getOutEdge(txnRo4, hub);
+        assert(res.size() == 10);
+        for (const auto &r: res) {
+            assert((std::find(edges.cbegin(), edges.cend(), r.descriptor) - edges.cbegin()) % 2 == 1);
+        }
+        txnRo4.commit();
+
+        // many commits behind a reader are kept as changes and looked up by edge
+        auto txnRo5 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto added = std::vector<nogdb::RecordDescriptor>{};
+        for (auto i = 0; i < 40; ++i) {
+            auto txnRw = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+            if (i < 10) {
+                nogdb::Edge::destroy(txnRw, edges[2 * i + 1]);
+            }
+            auto island = nogdb::Vertex::create(txnRw, "islands", nogdb::Record{}.set("name", "Koh " + std::to_string(i + 20)));
+            added.push_back(nogdb::Edge::create(txnRw, "bridge", hub, island));
+            txnRw.commit();
+        }
+        res = nogdb::Vertex::getOutEdge(txnRo5, hub);
+        assert(res.size() == 10);
+        for (const auto &r: res) {
+            assert((std::find(edges.cbegin(), edges.cend(), r.descriptor) - edges.cbegin()) % 2 == 1);
+        }
+        auto txnRw3 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::destroy(txnRw3, added[0]);
+        res = nogdb::Vertex::getOutEdge(txnRw3, hub);
+        assert(res.size() == 39);
+        // the most recent edges come first
+        assert(res[0].descriptor == added[39]);
+        assert(std::find_if(res.cbegin(), res.cend(), [&added](const nogdb::Result &r) {
+            return r.descriptor == added[0];
+        }) == res.cend());
+        txnRw3.rollback();
+        auto txnRo6 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Vertex::getOutEdge(txnRo6, hub).size() == 40);
+        txnRo5.commit();
+        txnRo6.commit();
+        assert(waitForReclaim().numPendingVersions == 0);
+
+        auto txnRo7 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        res = nogdb::Vertex::getOutEdge(txnRo7, hub);
+        assert(res.size() == 40);
+        for (const auto &r: res) {
+            assert(std::find(added.cbegin(), added.cend(), r.descriptor) != added.cend());
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_edge_bridge();
+    destroy_vertex_island();
+}
+
+void test_txn_write_queue() {
+    init_vertex_island();
+
+    const auto numThreads = 4U;
+    const auto numWrites = 25U;
+    try {
+        auto versionId = ctx->getMaxVersionId();
+        auto rdescs = std::vector<std::vector<nogdb::RecordDescriptor>>(numThreads);
+        {
+            nogdb::WriteQueue queue{*ctx, 64U, 20000U};
+            auto failure = queue.submit([](nogdb::Txn &txn) {
+                return nogdb::Vertex::create(txn, "no_such_class");
+            });
+            auto threads = std::vector<std::thread>{};
+            for (auto i = 0U; i < numThreads; ++i) {
+                threads.emplace_back([&queue, &rdescs, i]() {
+                    auto futures = std::vector<std::future<nogdb::RecordDescriptor>>{};
+                    for (auto j = 0U; j < numWrites; ++j) {
+                        auto name = "Koh " + std::to_string(i) + "-" + std::to_string(j);
+                        futures.push_back(queue.submit([name](nogdb::Txn &txn) {
+                            return nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", name));
+                        }));
+                    }
+                    for (auto &future: futures) {
+                        rdescs[i].push_back(future.get());
+                    }
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+            // a failing mutation does not affect the others in its group
+            try {
+                failure.get();
+                assert(false);
+            } catch (const nogdb::Error &ex) {
+                REQUIRE(ex, NOGDB_CTX_NOEXST_CLASS, "NOGDB_CTX_NOEXST_CLASS");
+            }
+            queue.submit([](nogdb::Txn &txn) {
+                nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", "Koh Kood"));
+            });
+        }
+        // mutations are group-committed, and ones still queued are committed before the queue is destroyed
+        assert(ctx->getMaxVersionId() - versionId < numThreads * numWrites);
+
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Vertex::get(txn, "islands").size() == numThreads * numWrites + 1);
+        for (auto i = 0U; i < numThreads; ++i) {
+            for (auto j = 0U; j < numWrites; ++j) {
+                auto record = nogdb::Db::getRecord(txn, rdescs[i][j]);
+                assert(record.getText("name") == "Koh " + std::to_string(i) + "-" + std::to_string(j));
+            }
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_vertex_island();
+}
+
+void test_txn_write_queue_failures() {
+    init_vertex_island();
+
+    const auto numWrites = 24U;
+    try {
+        auto numApplied = std::vector<std::atomic<unsigned int>>(numWrites);
+        auto rdescs = std::vector<nogdb::RecordDescriptor>{};
+        auto failures = 0U;
+        {
+            // one group, where every third mutation fails after having made changes
+            nogdb::WriteQueue queue{*ctx, numWrites, 200000U};
+            auto futures = std::vector<std::future<nogdb::RecordDescriptor>>{};
+            for (auto i = 0U; i < numWrites; ++i) {
+                futures.push_back(queue.submit([&numApplied, i](nogdb::Txn &txn) {
+                    ++numApplied[i];
+                    auto rdesc = nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", "Koh " + std::to_string(i)));
+                    if (i % 3 == 1) {
+                        nogdb::Vertex::update(txn, rdesc, nogdb::Record{}.set("name", "Koh Nowhere"));
+                        nogdb::Vertex::create(txn, "no_such_class");
+                    }
+                    return rdesc;
+                }));
+            }
+            for (auto i = 0U; i < numWrites; ++i) {
+                try {
+                    rdescs.push_back(futures[i].get());
+                    assert(i % 3 != 1);
+                } catch (const nogdb::Error &ex) {
+                    REQUIRE(ex, NOGDB_CTX_NOEXST_CLASS, "NOGDB_CTX_NOEXST_CLASS");
+                    assert(i % 3 == 1);
+                    ++failures;
+                }
+            }
+        }
+        assert(failures == numWrites / 3);
+        // the failed mutations are undone alone rather than by applying the group again
+        for (auto i = 0U; i < numWrites; ++i) {
+            assert(numApplied[i] == 1U);
+        }
+
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Vertex::get(txn, "islands").size() == numWrites - failures);
+        assert(nogdb::Vertex::get(txn, "islands", nogdb::Condition{"name"}.eq("Koh Nowhere")).empty());
+        for (const auto &rdesc: rdescs) {
+            auto name = nogdb::Db::getRecord(txn, rdesc).getText("name");
+            assert(name.compare(0, 4, "Koh ") == 0);
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_vertex_island();
+}
+
+void test_txn_reuse_read_txn() {
+    init_vertex_island();
+
+    try {
+        auto numIslands = 0U;
+        for (auto i = 0U; i < 8U; ++i) {
+            // a reused transaction sees what has been committed since it was completed
+            {
+                auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+                assert(nogdb::Vertex::get(txn, "islands").size() == numIslands);
+            }
+            auto rtxn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+            {
+                auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+                nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", "Koh " + std::to_string(i)));
+                txn.commit();
+            }
+            ++numIslands;
+            // one still in use keeps its snapshot
+            auto other = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+            assert(nogdb::Vertex::get(other, "islands").size() == numIslands);
+            assert(nogdb::Vertex::get(rtxn, "islands").size() == numIslands - 1);
+        }
+        // a completed transaction which has not gone away is not reused
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        txn.rollback();
+        auto next = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Vertex::get(next, "islands").size() == numIslands);
+        try {
+            nogdb::Vertex::get(txn, "islands");
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, MDB_BAD_TXN, "MDB_BAD_TXN");
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_vertex_island();
+}
+
+void test_txn_savepoint() {
+    init_vertex_island();
+    init_edge_bridge();
+
+    auto createIslands = [](nogdb::Txn &txn, const nogdb::RecordDescriptor &hub,
+                            const std::vector<std::string> &names) {
+        for (const auto &name: names) {
+            auto island = nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", name));
+            nogdb::Edge::create(txn, "bridge", hub, island);
+        }
+    };
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::createIndex(txn, "islands", "name", true);
+        auto hub = nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", "Koh Samui"));
+
+        // a sub-batch which violates a unique constraint is rolled back alone
+        auto savepoint = txn.savepoint();
+        try {
+            createIslands(txn, hub, {"Koh Tao", "Koh Phangan", "Koh Samui"});
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_CTX_UNIQUE_CONSTRAINT, "NOGDB_CTX_UNIQUE_CONSTRAINT");
+            txn.rollbackTo(savepoint);
+        }
+        assert(nogdb::Vertex::get(txn, "islands").size() == 1);
+        assert(nogdb::Vertex::getOutEdge(txn, hub).empty());
+
+        // the savepoint stays valid for the next sub-batch
+        createIslands(txn, hub, {"Koh Tao", "Koh Phangan"});
+        txn.releaseSavepoint(savepoint);
+        auto edges = nogdb::Vertex::getOutEdge(txn, hub);
+        assert(edges.size() == 2);
+
+        // rolling back to an outer savepoint drops the inner ones
+        auto outer = txn.savepoint();
+        nogdb::Edge::destroy(txn, edges[0].descriptor);
+        nogdb::Vertex::destroy(txn, nogdb::Edge::getDst(txn, edges[1].descriptor).descriptor);
+        auto inner = txn.savepoint();
+        nogdb::Class::create(txn, "reefs", nogdb::ClassType::VERTEX);
+        nogdb::Property::add(txn, "islands", "population", nogdb::PropertyType::UNSIGNED_INTEGER);
+        createIslands(txn, hub, {"Koh Nang Yuan"});
+        txn.rollbackTo(outer);
+        try {
+            txn.rollbackTo(inner);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_TXN_INVALID_SAVEPOINT, "NOGDB_TXN_INVALID_SAVEPOINT");
+        }
+        try {
+            nogdb::Db::getSchema(txn, "reefs");
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_CTX_NOEXST_CLASS, "NOGDB_CTX_NOEXST_CLASS");
+        }
+        assert(nogdb::Db::getSchema(txn, "islands").properties.count("population") == 0);
+        assert(nogdb::Vertex::get(txn, "islands").size() == 3);
+        assert(nogdb::Vertex::getOutEdge(txn, hub).size() == 2);
+        txn.releaseSavepoint(outer);
+        txn.commit();
+
+        auto rtxn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Vertex::get(rtxn, "islands").size() == 3);
+        assert(nogdb::Vertex::getOutEdge(rtxn, hub).size() == 2);
+        for (const auto &name: {"Koh Samui", "Koh Tao", "Koh Phangan"}) {
+            auto res = nogdb::Vertex::getIndex(rtxn, "islands", nogdb::Condition("name").eq(name));
+            assert(res.size() == 1);
+        }
+        try {
+            rtxn.savepoint();
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_TXN_INVALID_MODE, "NOGDB_TXN_INVALID_MODE");
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "islands", "name");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_edge_bridge();
+    destroy_vertex_island();
+}
+
+void test_txn_moved_edge_versions() {
+    init_vertex_island();
+    init_edge_bridge();
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        auto v1 = nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", "1"));
+        auto v2 = nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", "2"));
+        auto v3 = nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", "3"));
+        auto v4 = nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", "4"));
+        auto e = nogdb::Edge::create(txn, "bridge", v1, v2, nogdb::Record{}.set("name", "12"));
+        txn.commit();
+
+        // every reader follows the edge back to where it was at its version
+        auto txnRo0 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::updateSrc(txn, e, v3);
+        nogdb::Edge::updateDst(txn, e, v4);
+        txn.commit();
+
+        auto txnRo1 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::updateSrc(txn, e, v2);
+        nogdb::Edge::updateSrc(txn, e, v4);
+        txn.commit();
+
+        auto txnRo2 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::updateSrc(txn, e, v1);
+        nogdb::Edge::destroy(txn, e);
+        txn.commit();
+
+        auto txnRo3 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Edge::getSrc(txnRo0, e).descriptor == v1);
+        assert(nogdb::Edge::getDst(txnRo0, e).descriptor == v2);
+        assert(nogdb::Vertex::getOutEdge(txnRo0, v1).size() == 1);
+        assert(nogdb::Edge::getSrc(txnRo1, e).descriptor == v3);
+        assert(nogdb::Edge::getDst(txnRo1, e).descriptor == v4);
+        assert(nogdb::Vertex::getOutEdge(txnRo1, v1).empty());
+        assert(nogdb::Vertex::getInEdge(txnRo1, v4).size() == 1);
+        assert(nogdb::Edge::getSrc(txnRo2, e).descriptor == v4);
+        assert(nogdb::Edge::getDst(txnRo2, e).descriptor == v4);
+        assert(nogdb::Vertex::getOutEdge(txnRo2, v2).empty());
+        assert(nogdb::Vertex::getOutEdge(txnRo2, v3).empty());
+        assert(nogdb::Edge::get(txnRo3, "bridge").empty());
+        assert(nogdb::Vertex::getOutEdge(txnRo3, v1).empty());
+        assert(nogdb::Vertex::getInEdge(txnRo3, v4).empty());
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_edge_bridge();
+    destroy_vertex_island();
+}
+
 void test_txn_reopen_ctx() {
     init_vertex_island();
 
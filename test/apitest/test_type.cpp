@@ -100,6 +100,38 @@ void test_bytes_only() {
     assert(tmp.z == blob_value.z);
 }
 
+void test_bytes_copy_and_move() {
+    const auto long_text = std::string(100, 'x');
+    auto values = std::vector<nogdb::Bytes>{};
+    for (auto i = 0; i < 100; ++i) {
+        values.emplace_back(i);
+        values.emplace_back(i % 2 ? long_text : text_value);
+    }
+    for (auto i = 0; i < 100; ++i) {
+        assert(values[2 * i].toInt() == i);
+        assert(values[2 * i + 1].toText() == (i % 2 ? long_text : text_value));
+    }
+
+    auto small_vb = nogdb::Bytes{real_value};
+    auto large_vb = nogdb::Bytes{long_text};
+    auto small_copy = small_vb;
+    auto large_copy = large_vb;
+    assert(small_copy.toReal() == real_value && small_copy.getRaw() != small_vb.getRaw());
+    assert(large_copy.toText() == long_text && large_copy.getRaw() != large_vb.getRaw());
+
+    auto small_moved = std::move(small_copy);
+    auto large_moved = std::move(large_copy);
+    assert(small_moved.toReal() == real_value && small_copy.empty());
+    assert(large_moved.toText() == long_text && large_copy.empty());
+
+    small_moved = large_vb;
+    large_moved = small_vb;
+    assert(small_moved.toText() == long_text);
+    assert(large_moved.toReal() == real_value);
+    small_moved = std::move(large_moved);
+    assert(small_moved.toReal() == real_value && large_moved.empty());
+}
+
 void test_record_with_bytes() {
     nogdb::Record r{};
     r.set("int", int_value)
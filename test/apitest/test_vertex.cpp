@@ -21,8 +21,11 @@
 
 #include "apitest.h"
 #include "test_prepare.h"
+#include <atomic>
 #include <climits>
+#include <limits>
 #include <set>
+#include <thread>
 #include <vector>
 
 void test_create_vertex() {
@@ -368,6 +371,157 @@ void test_get_invalid_vertex_cursor() {
     destroy_vertex_person();
 }
 
+void test_get_vertex_cursor_property_filter() {
+    init_vertex_book();
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        auto rdesc = nogdb::Vertex::create(txn, "books",
+                                           nogdb::Record{}
+                                                   .set("title", "Percy Jackson")
+                                                   .set("pages", 456)
+                                                   .set("price", 24.5));
+
+        auto res = nogdb::Vertex::getCursor(txn, "books", nogdb::Condition("pages").gt(400));
+        res.setPropertyFilter(nogdb::PropertyFilter{"title", "@recordId"});
+        assert(res.next());
+        assert(res->descriptor == rdesc);
+        assert(res->record.get("title").toText() == "Percy Jackson");
+        assert(res->record.get("pages").empty());
+        assert(res->record.get("price").empty());
+        assert(res->record.getText("@recordId") == rid2str(rdesc.rid));
+        assert(res->record.get("@className").empty());
+        assert(res->record.get("@version").empty());
+        assert(!res.next());
+
+        res.setPropertyFilter(nogdb::PropertyFilter{"price", "@version"});
+        res.first();
+        assert(res->record.get("title").empty());
+        assert(res->record.getReal("price") == 24.5);
+        assert(res->record.getVersion() == 1ULL);
+
+        res.setPropertyFilter(nogdb::PropertyFilter{});
+        res.first();
+        assert(res->record.get("title").toText() == "Percy Jackson");
+        assert(res->record.getInt("pages") == 456);
+        assert(res->record.getClassName() == "books");
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.commit();
+    destroy_vertex_book();
+}
+
+void test_upgrade_record_format() {
+    init_vertex_book();
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        const auto longTitle = std::string(1000, 'a');
+        auto rdesc1 = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", longTitle).set("pages", 456));
+        auto rdesc2 = nogdb::Vertex::create(txn, "books");
+        // records are written in the current format
+        assert(nogdb::Db::upgradeRecordFormat(txn, "books") == 0);
+
+        auto record = nogdb::Db::getRecord(txn, rdesc1);
+        assert(record.getText("title") == longTitle);
+        assert(record.getInt("pages") == 456);
+        assert(record.get("price").empty());
+        assert(nogdb::Db::getRecord(txn, rdesc2).getProperties().empty());
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.commit();
+
+    txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+    try {
+        nogdb::Db::upgradeRecordFormat(txn, "books");
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        txn.rollback();
+        REQUIRE(ex, NOGDB_TXN_INVALID_MODE, "NOGDB_TXN_INVALID_MODE");
+    }
+    destroy_vertex_book();
+}
+
+void test_get_vertex_record_properties() {
+    init_vertex_book();
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        auto rdesc = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Percy Jackson").set("pages", 456));
+
+        auto record = nogdb::Db::getRecord(txn, rdesc);
+        assert(record.size() == 2);
+        assert(record.getProperties() == (std::vector<std::string>{"pages", "title"}));
+        assert(record.getText("title") == "Percy Jackson");
+        assert(record.get("price").empty());
+        assert(record.getText("@className") == "books");
+
+        auto copy = record;
+        record.set("price", 9.99).unset("pages");
+        assert(record.getAll().size() == 2);
+        assert(record.getReal("price") == 9.99);
+        assert(record.get("pages").empty());
+        assert(copy.getAll().size() == 2);
+        assert(copy.getInt("pages") == 456);
+
+        copy.setIfNotExists("title", "The Lightning Thief").setIfNotExists("price", 12.5);
+        assert(copy.getText("title") == "Percy Jackson");
+        assert(copy.getReal("price") == 12.5);
+        nogdb::Vertex::update(txn, rdesc, copy);
+
+        auto res = nogdb::Vertex::get(txn, "books");
+        assert(res.size() == 1);
+        assert(res[0].record.getProperties() == (std::vector<std::string>{"pages", "price", "title"}));
+        assert(res[0].record.getReal("price") == 12.5);
+        res[0].record.clear();
+        assert(res[0].record.empty());
+        assert(res[0].record.get("title").empty());
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.rollback();
+    destroy_vertex_book();
+}
+
+void test_get_vertex_record_concurrently() {
+    init_vertex_book();
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        for (auto i = 0; i < 10; ++i) {
+            nogdb::Vertex::create(txn, "books", nogdb::Record{}
+                    .set("title", "Percy Jackson " + std::to_string(i)).set("pages", 100 + i).set("price", 9.99));
+        }
+        const auto res = nogdb::Vertex::get(txn, "books");
+        assert(res.size() == 10);
+        // readers may share a const result set, even before any of its maps has been built
+        auto readers = std::vector<std::thread>{};
+        std::atomic<int> numMismatches{0};
+        for (auto i = 0; i < 4; ++i) {
+            readers.emplace_back([&res, &numMismatches]() {
+                for (const auto &result: res) {
+                    const auto &properties = result.record.getAll();
+                    auto pages = result.record.getInt("pages");
+                    if (properties.size() != 3 || properties.at("pages").toInt() != pages ||
+                        result.record.getText("title") != "Percy Jackson " + std::to_string(pages - 100)) {
+                        ++numMismatches;
+                    }
+                }
+            });
+        }
+        for (auto &reader: readers) {
+            reader.join();
+        }
+        assert(numMismatches == 0);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.rollback();
+    destroy_vertex_book();
+}
+
 void test_update_vertex() {
     init_vertex_book();
     auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
@@ -460,6 +614,132 @@ void test_update_vertex_version() {
     }
     destroy_vertex_book();
 }
+
+void test_patch_vertex() {
+    init_vertex_book();
+    auto rdesc = nogdb::RecordDescriptor{};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        rdesc = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Lion King").set("pages", 320));
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Vertex::patch(txn, rdesc, nogdb::Record{}.set("pages", 400).set("price", 50.0));
+        auto record = nogdb::Db::getRecord(txn, rdesc);
+        assert(record.getText("title") == "Lion King");
+        assert(record.getInt("pages") == 400);
+        assert(record.getReal("price") == 50.0);
+        assert(record.getVersion() == 2ULL);
+
+        nogdb::Vertex::patch(txn, rdesc, nogdb::Record{}.set("title", "Tarzan"));
+        record = nogdb::Db::getRecord(txn, rdesc);
+        assert(record.getText("title") == "Tarzan");
+        assert(record.getInt("pages") == 400);
+        assert(record.getVersion() == 2ULL);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Vertex::patch(txn, rdesc, nogdb::Record{}.set("pages", 400));
+        auto res = nogdb::Vertex::get(txn, "books");
+        assert(res.size() == 1);
+        assert(res[0].record.getText("title") == "Tarzan");
+        assert(res[0].record.getReal("price") == 50.0);
+        assert(res[0].record.getVersion() == 3ULL);
+        txn.rollback();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        nogdb::Vertex::patch(txn, rdesc, nogdb::Record{}.set("isbn", "0-00-000000-0"));
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, NOGDB_CTX_NOEXST_PROPERTY, "NOGDB_CTX_NOEXST_PROPERTY");
+    }
+    try {
+        auto tmp = rdesc;
+        tmp.rid.second = -1;
+        nogdb::Vertex::patch(txn, tmp, nogdb::Record{}.set("pages", 1));
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, NOGDB_GRAPH_NOEXST_VERTEX, "NOGDB_GRAPH_NOEXST_VERTEX");
+    }
+    txn.rollback();
+    destroy_vertex_book();
+}
+
+void test_increment_vertex_property() {
+    init_vertex_book();
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        auto rdesc = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Lion King").set("words", 10ULL));
+        assert(nogdb::Vertex::increment(txn, rdesc, "pages", 5).toInt() == 5);
+        assert(nogdb::Vertex::increment(txn, rdesc, "pages", -10).toInt() == -5);
+        assert(nogdb::Vertex::increment(txn, rdesc, "words", 3).toBigIntU() == 13ULL);
+        assert(nogdb::Vertex::increment(txn, rdesc, "price", 2).toReal() == 2.0);
+
+        auto record = nogdb::Db::getRecord(txn, rdesc);
+        assert(record.getInt("pages") == -5);
+        assert(record.getBigIntU("words") == 13ULL);
+        assert(record.getReal("price") == 2.0);
+        assert(record.getText("title") == "Lion King");
+
+        try {
+            nogdb::Vertex::increment(txn, rdesc, "words", -14);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_CTX_OUT_OF_RANGE_VALUE, "NOGDB_CTX_OUT_OF_RANGE_VALUE");
+        }
+        nogdb::Vertex::patch(txn, rdesc, nogdb::Record{}.set("pages", std::numeric_limits<int32_t>::max()));
+        try {
+            nogdb::Vertex::increment(txn, rdesc, "pages", 1);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_CTX_OUT_OF_RANGE_VALUE, "NOGDB_CTX_OUT_OF_RANGE_VALUE");
+        }
+        try {
+            nogdb::Vertex::increment(txn, rdesc, "title", 1);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_CTX_INVALID_PROPTYPE, "NOGDB_CTX_INVALID_PROPTYPE");
+        }
+        try {
+            nogdb::Vertex::increment(txn, rdesc, "@version", 1);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_CTX_NOEXST_PROPERTY, "NOGDB_CTX_NOEXST_PROPERTY");
+        }
+        record = nogdb::Db::getRecord(txn, rdesc);
+        assert(record.getInt("pages") == std::numeric_limits<int32_t>::max());
+        assert(record.getBigIntU("words") == 13ULL);
+        txn.commit();
+
+        txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        try {
+            nogdb::Vertex::increment(txn, rdesc, "words", 1);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, NOGDB_TXN_INVALID_MODE, "NOGDB_TXN_INVALID_MODE");
+        }
+        txn.rollback();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_book();
+}
 void test_update_invalid_vertex() {
     init_vertex_book();
     init_edge_author();
@@ -641,6 +921,63 @@ void test_delete_all_vertices() {
     }
 }
 
+void test_create_vertex_after_delete_all() {
+    init_vertex_book();
+    auto positions = std::vector<nogdb::PositionId>{};
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        positions.push_back(nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Lion King")).rid.second);
+        positions.push_back(nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Tarzan")).rid.second);
+        assert(positions[1] == positions[0] + 1);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.commit();
+
+    txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        nogdb::Vertex::destroy(txn, "books");
+        positions.push_back(nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Snow White")).rid.second);
+        assert(positions[2] == positions[1] + 1);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.commit();
+
+    txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        // positions handed out after a savepoint are given back when rolling back to it
+        auto savepoint = txn.savepoint();
+        auto rolledBack = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Bambi")).rid.second;
+        assert(rolledBack == positions[2] + 1);
+        txn.rollbackTo(savepoint);
+        positions.push_back(nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Cinderella")).rid.second);
+        assert(positions[3] == rolledBack);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.commit();
+
+    txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+    try {
+        auto res = nogdb::Vertex::get(txn, "books");
+        assertSize(res, 2);
+        assert(res[0].descriptor.rid.second == positions[2]);
+        assert(res[0].record.getText("title") == "Snow White");
+        assert(res[1].descriptor.rid.second == positions[3]);
+        assert(res[1].record.getText("title") == "Cinderella");
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.rollback();
+
+    destroy_vertex_book();
+}
+
 void test_get_edge_in() {
     init_vertex_book();
     init_vertex_person();
@@ -0,0 +1,142 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Compares the ingestion throughput of Vertex::create/Edge::create against nogdb::BulkLoader.
+// usage: benchmark_bulk_load [number of vertices] [number of edges]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nogdb/nogdb.h"
+
+#include "benchmark_utils.h"
+
+namespace {
+
+    const std::string DATABASE_PATH{"./benchmark_bulk_load.db"};
+
+    void initSchema(nogdb::Context &ctx) {
+        auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txn, "persons", nogdb::ClassType::VERTEX);
+        nogdb::Property::add(txn, "persons", "name", nogdb::PropertyType::TEXT);
+        nogdb::Property::add(txn, "persons", "age", nogdb::PropertyType::UNSIGNED_INTEGER);
+        nogdb::Property::createIndex(txn, "persons", "age");
+        nogdb::Class::create(txn, "knows", nogdb::ClassType::EDGE);
+        nogdb::Property::add(txn, "knows", "since", nogdb::PropertyType::UNSIGNED_INTEGER);
+        txn.commit();
+    }
+
+    template<typename VertexFunc, typename EdgeFunc, typename FinishFunc>
+    double run(const std::string &name, unsigned int numVertices, const std::vector<std::pair<size_t, size_t>> &edges,
+               VertexFunc addVertex, EdgeFunc addEdge, FinishFunc finish) {
+        clearDatabase(DATABASE_PATH);
+        auto ctx = nogdb::Context{DATABASE_PATH};
+        initSchema(ctx);
+
+        auto begin = std::chrono::steady_clock::now();
+        auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+        auto vertices = std::vector<nogdb::RecordDescriptor>{};
+        vertices.reserve(numVertices);
+        for (auto i = 0U; i < numVertices; ++i) {
+            auto record = nogdb::Record{};
+            record.set("name", "person" + std::to_string(i)).set("age", i % 100U);
+            vertices.emplace_back(addVertex(txn, record));
+        }
+        for (auto i = 0U; i < edges.size(); ++i) {
+            auto record = nogdb::Record{};
+            record.set("since", 2000U + i % 20U);
+            addEdge(txn, vertices[edges[i].first], vertices[edges[i].second], record);
+        }
+        finish(txn);
+        txn.commit();
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        auto throughput = (numVertices + edges.size()) / elapsed;
+        std::cout << std::left << std::setw(14) << name
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(10) << elapsed << " s"
+                  << std::setprecision(0) << std::setw(14) << throughput << " records/s" << std::endl;
+        return throughput;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    auto numVertices = (argc > 1) ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 20000U;
+    auto numEdges = (argc > 2) ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 100000U;
+    if (numVertices == 0) {
+        std::cerr << "usage: " << argv[0] << " [number of vertices] [number of edges]" << std::endl;
+        return 1;
+    }
+
+    auto generator = std::mt19937{42};
+    auto distribution = std::uniform_int_distribution<size_t>{0, numVertices - 1};
+    auto edges = std::vector<std::pair<size_t, size_t>>{};
+    edges.reserve(numEdges);
+    for (auto i = 0U; i < numEdges; ++i) {
+        edges.emplace_back(distribution(generator), distribution(generator));
+    }
+
+    std::cout << "loading " << numVertices << " vertices and " << numEdges << " edges" << std::endl;
+    try {
+        auto baseline = run(
+                "create", numVertices, edges,
+                [](nogdb::Txn &txn, const nogdb::Record &record) {
+                    return nogdb::Vertex::create(txn, "persons", record);
+                },
+                [](nogdb::Txn &txn, const nogdb::RecordDescriptor &src, const nogdb::RecordDescriptor &dst,
+                   const nogdb::Record &record) {
+                    nogdb::Edge::create(txn, "knows", src, dst, record);
+                },
+                [](nogdb::Txn &txn) {}
+        );
+
+        auto loader = std::unique_ptr<nogdb::BulkLoader>{};
+        auto bulk = run(
+                "BulkLoader", numVertices, edges,
+                [&loader](nogdb::Txn &txn, const nogdb::Record &record) {
+                    if (!loader) {
+                        loader.reset(new nogdb::BulkLoader{txn});
+                    }
+                    return loader->addVertex("persons", record);
+                },
+                [&loader](nogdb::Txn &txn, const nogdb::RecordDescriptor &src, const nogdb::RecordDescriptor &dst,
+                          const nogdb::Record &record) {
+                    loader->addEdge("knows", src, dst, record);
+                },
+                [&loader](nogdb::Txn &txn) {
+                    loader->finish();
+                    loader.reset();
+                }
+        );
+        std::cout << "speedup       " << std::setprecision(1) << std::setw(10) << bulk / baseline << "x" << std::endl;
+    } catch (const nogdb::Error &ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        clearDatabase(DATABASE_PATH);
+        return 1;
+    }
+    clearDatabase(DATABASE_PATH);
+    return 0;
+}
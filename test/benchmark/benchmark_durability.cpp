@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Compares the throughput of small write transactions under each durability mode of nogdb::ContextOptions.
+// usage: benchmark_durability [number of transactions] [number of records per transaction]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "nogdb/nogdb.h"
+
+#include "benchmark_utils.h"
+
+namespace {
+
+    const std::string DATABASE_PATH{"./benchmark_durability.db"};
+
+    double run(const std::string &name, const nogdb::ContextOptions &options, unsigned int numTxns,
+               unsigned int numRecords) {
+        clearDatabase(DATABASE_PATH);
+        auto elapsed = 0.0;
+        {
+            auto ctx = nogdb::Context{DATABASE_PATH, options};
+            {
+                auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+                nogdb::Class::create(txn, "persons", nogdb::ClassType::VERTEX);
+                nogdb::Property::add(txn, "persons", "name", nogdb::PropertyType::TEXT);
+                nogdb::Property::add(txn, "persons", "age", nogdb::PropertyType::UNSIGNED_INTEGER);
+                txn.commit();
+            }
+
+            auto begin = std::chrono::steady_clock::now();
+            for (auto i = 0U; i < numTxns; ++i) {
+                auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+                for (auto j = 0U; j < numRecords; ++j) {
+                    auto record = nogdb::Record{};
+                    record.set("name", "person" + std::to_string(i) + "-" + std::to_string(j)).set("age", j % 100U);
+                    nogdb::Vertex::create(txn, "persons", record);
+                }
+                txn.commit();
+            }
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        }
+
+        auto throughput = numTxns / elapsed;
+        std::cout << std::left << std::setw(24) << name
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(10) << elapsed << " s"
+                  << std::setprecision(0) << std::setw(12) << throughput << " commits/s" << std::endl;
+        return throughput;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    auto numTxns = (argc > 1) ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 2000U;
+    auto numRecords = (argc > 2) ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 1U;
+    if (numTxns == 0 || numRecords == 0) {
+        std::cerr << "usage: " << argv[0] << " [number of transactions] [number of records per transaction]"
+                  << std::endl;
+        return 1;
+    }
+
+    auto modes = std::vector<std::pair<std::string, nogdb::ContextOptions>>{};
+    auto options = nogdb::ContextOptions{};
+    modes.emplace_back("default", options);
+    options.noMetaSync = true;
+    modes.emplace_back("noMetaSync", options);
+    options = nogdb::ContextOptions{};
+    options.noSync = true;
+    modes.emplace_back("noSync", options);
+    options.syncIntervalMs = 100U;
+    modes.emplace_back("noSync + flush 100ms", options);
+    options = nogdb::ContextOptions{};
+    options.writeMap = true;
+    modes.emplace_back("writeMap", options);
+    options.mapAsync = true;
+    modes.emplace_back("writeMap + mapAsync", options);
+    options.noSync = true;
+    modes.emplace_back("writeMap + noSync", options);
+
+    std::cout << numTxns << " transactions writing " << numRecords << " vertices each" << std::endl;
+    try {
+        auto baseline = 0.0;
+        for (const auto &mode: modes) {
+            auto throughput = run(mode.first, mode.second, numTxns, numRecords);
+            if (baseline == 0.0) {
+                baseline = throughput;
+            } else {
+                std::cout << std::setw(24) << "" << std::setprecision(1) << std::setw(12) << throughput / baseline
+                          << "x" << std::endl;
+            }
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        clearDatabase(DATABASE_PATH);
+        return 1;
+    }
+    clearDatabase(DATABASE_PATH);
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Measures the read throughput of concurrent read-only transactions looking up the out-edges of random vertices
+// through the in-memory graph, for a doubling number of threads.
+// usage: benchmark_graph_read [max number of threads] [number of vertices] [number of edges] [seconds per run]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nogdb/nogdb.h"
+
+#include "benchmark_utils.h"
+
+namespace {
+
+    const std::string DATABASE_PATH{"./benchmark_graph_read.db"};
+
+    const unsigned int LOOKUPS_PER_TXN = 100U;
+
+    std::vector<nogdb::RecordDescriptor> initGraph(nogdb::Context &ctx, unsigned int numVertices,
+                                                   unsigned int numEdges) {
+        auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txn, "persons", nogdb::ClassType::VERTEX);
+        nogdb::Class::create(txn, "knows", nogdb::ClassType::EDGE);
+        auto vertices = std::vector<nogdb::RecordDescriptor>{};
+        vertices.reserve(numVertices);
+        nogdb::BulkLoader loader{txn};
+        for (auto i = 0U; i < numVertices; ++i) {
+            vertices.emplace_back(loader.addVertex("persons", nogdb::Record{}));
+        }
+        auto generator = std::mt19937{42};
+        auto distribution = std::uniform_int_distribution<size_t>{0, numVertices - 1};
+        for (auto i = 0U; i < numEdges; ++i) {
+            loader.addEdge("knows", vertices[distribution(generator)], vertices[distribution(generator)]);
+        }
+        loader.finish();
+        txn.commit();
+        return vertices;
+    }
+
+    double run(nogdb::Context &ctx, const std::vector<nogdb::RecordDescriptor> &vertices, unsigned int numThreads,
+               double seconds) {
+        std::atomic<bool> isRunning{true};
+        std::atomic<unsigned long long> numLookups{0};
+        std::atomic<unsigned long long> numEdges{0};
+        auto workers = std::vector<std::thread>{};
+        for (auto i = 0U; i < numThreads; ++i) {
+            workers.emplace_back([&, i]() {
+                auto generator = std::mt19937{i};
+                auto distribution = std::uniform_int_distribution<size_t>{0, vertices.size() - 1};
+                auto count = 0ULL;
+                auto edgeCount = 0ULL;
+                while (isRunning.load(std::memory_order_relaxed)) {
+                    auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_ONLY};
+                    for (auto j = 0U; j < LOOKUPS_PER_TXN; ++j) {
+                        auto &vertex = vertices[distribution(generator)];
+                        edgeCount += nogdb::Vertex::getOutEdgeCursor(txn, vertex).size();
+                    }
+                    txn.rollback();
+                    count += LOOKUPS_PER_TXN;
+                }
+                numLookups += count;
+                numEdges += edgeCount;
+            });
+        }
+        auto begin = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        isRunning = false;
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (numEdges == 0) {
+            std::cerr << "warning: no edges have been traversed" << std::endl;
+        }
+        return numLookups / elapsed;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    auto maxThreads = (argc > 1) ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10))
+                                 : std::max(std::thread::hardware_concurrency(), 1U);
+    auto numVertices = (argc > 2) ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 20000U;
+    auto numEdges = (argc > 3) ? static_cast<unsigned int>(std::strtoul(argv[3], nullptr, 10)) : 100000U;
+    auto seconds = (argc > 4) ? std::strtod(argv[4], nullptr) : 2.0;
+    if (maxThreads == 0 || numVertices == 0 || seconds <= 0.0) {
+        std::cerr << "usage: " << argv[0]
+                  << " [max number of threads] [number of vertices] [number of edges] [seconds per run]" << std::endl;
+        return 1;
+    }
+
+    clearDatabase(DATABASE_PATH);
+    try {
+        auto ctx = nogdb::Context{DATABASE_PATH};
+        auto vertices = initGraph(ctx, numVertices, numEdges);
+        std::cout << "traversing " << numVertices << " vertices and " << numEdges << " edges" << std::endl;
+        auto baseline = 0.0;
+        for (auto numThreads = 1U; numThreads <= maxThreads;
+             numThreads = (numThreads == maxThreads) ? maxThreads + 1 : std::min(numThreads * 2, maxThreads)) {
+            auto throughput = run(ctx, vertices, numThreads, seconds);
+            if (numThreads == 1) {
+                baseline = throughput;
+            }
+            std::cout << std::setw(3) << numThreads << " threads"
+                      << std::fixed << std::setprecision(0) << std::setw(14) << throughput << " vertices/s"
+                      << std::setprecision(2) << std::setw(8) << throughput / baseline << "x" << std::endl;
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        clearDatabase(DATABASE_PATH);
+        return 1;
+    }
+    clearDatabase(DATABASE_PATH);
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Compares the throughput of small writes from many threads, each committing its own write transaction,
+// against the same writes submitted to a nogdb::WriteQueue which group-commits them.
+// usage: benchmark_group_commit [number of threads] [number of writes per thread]
+
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nogdb/nogdb.h"
+
+#include "benchmark_utils.h"
+
+namespace {
+
+    const std::string DATABASE_PATH{"./benchmark_group_commit.db"};
+
+    nogdb::Record makeRecord(unsigned int threadId, unsigned int i) {
+        return nogdb::Record{}.set("name", "person" + std::to_string(threadId) + "-" + std::to_string(i))
+                              .set("age", i % 100U);
+    }
+
+    template<typename WriteFunc>
+    void run(const std::string &name, unsigned int numThreads, unsigned int numWrites, WriteFunc write) {
+        clearDatabase(DATABASE_PATH);
+        auto ctx = nogdb::Context{DATABASE_PATH};
+        {
+            auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+            nogdb::Class::create(txn, "persons", nogdb::ClassType::VERTEX);
+            nogdb::Property::add(txn, "persons", "name", nogdb::PropertyType::TEXT);
+            nogdb::Property::add(txn, "persons", "age", nogdb::PropertyType::UNSIGNED_INTEGER);
+            txn.commit();
+        }
+        auto versionId = ctx.getMaxVersionId();
+
+        auto begin = std::chrono::steady_clock::now();
+        write(ctx, numThreads, numWrites);
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        auto numCommits = ctx.getMaxVersionId() - versionId;
+        std::cout << std::left << std::setw(12) << name
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(10) << elapsed << " s"
+                  << std::setprecision(0) << std::setw(12) << numThreads * numWrites / elapsed << " writes/s"
+                  << std::setw(10) << numCommits << " commits" << std::endl;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    auto numThreads = (argc > 1) ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 8U;
+    auto numWrites = (argc > 2) ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 500U;
+    if (numThreads == 0 || numWrites == 0) {
+        std::cerr << "usage: " << argv[0] << " [number of threads] [number of writes per thread]" << std::endl;
+        return 1;
+    }
+
+    std::cout << numThreads << " threads writing " << numWrites << " vertices each" << std::endl;
+    try {
+        run("Txn", numThreads, numWrites, [](nogdb::Context &ctx, unsigned int numThreads, unsigned int numWrites) {
+            auto threads = std::vector<std::thread>{};
+            for (auto threadId = 0U; threadId < numThreads; ++threadId) {
+                threads.emplace_back([&ctx, threadId, numWrites]() {
+                    for (auto i = 0U; i < numWrites; ++i) {
+                        auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+                        nogdb::Vertex::create(txn, "persons", makeRecord(threadId, i));
+                        txn.commit();
+                    }
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+        });
+        run("WriteQueue", numThreads, numWrites,
+            [](nogdb::Context &ctx, unsigned int numThreads, unsigned int numWrites) {
+                nogdb::WriteQueue queue{ctx};
+                auto threads = std::vector<std::thread>{};
+                for (auto threadId = 0U; threadId < numThreads; ++threadId) {
+                    // every write waits for its commit, as a thread writing through Txn does
+                    threads.emplace_back([&queue, threadId, numWrites]() {
+                        for (auto i = 0U; i < numWrites; ++i) {
+                            auto record = makeRecord(threadId, i);
+                            queue.submit([record](nogdb::Txn &txn) {
+                                nogdb::Vertex::create(txn, "persons", record);
+                            }).get();
+                        }
+                    });
+                }
+                for (auto &thread: threads) {
+                    thread.join();
+                }
+            });
+    } catch (const nogdb::Error &ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        clearDatabase(DATABASE_PATH);
+        return 1;
+    }
+    clearDatabase(DATABASE_PATH);
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Measures the latency of committing a single edge to a hub vertex as the degree of the hub grows,
+// next to the latency of committing a single edge between two new vertices in the same database.
+// usage: benchmark_hub_insert [max degree] [number of inserts per degree]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "nogdb/nogdb.h"
+
+#include "benchmark_utils.h"
+
+namespace {
+
+    const std::string DATABASE_PATH{"./benchmark_hub_insert.db"};
+
+    void initSchema(nogdb::Context &ctx) {
+        auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txn, "persons", nogdb::ClassType::VERTEX);
+        nogdb::Class::create(txn, "knows", nogdb::ClassType::EDGE);
+        txn.commit();
+    }
+
+    // add edges from the hub to new vertices until the hub has the given degree
+    void growHub(nogdb::Context &ctx, const nogdb::RecordDescriptor &hub, unsigned int degree, unsigned int target) {
+        auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+        auto loader = std::unique_ptr<nogdb::BulkLoader>{new nogdb::BulkLoader{txn}};
+        for (auto i = degree; i < target; ++i) {
+            auto vertex = loader->addVertex("persons", nogdb::Record{});
+            loader->addEdge("knows", hub, vertex, nogdb::Record{});
+        }
+        loader->finish();
+        loader.reset();
+        txn.commit();
+        // let the bulk of new edges be merged into the adjacency first
+        while (ctx.getReclaimStat().numPendingVersions > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        }
+    }
+
+    // returns the mean latency in microseconds of committing an edge from the source, or from a new vertex if null
+    double measure(nogdb::Context &ctx, const nogdb::RecordDescriptor *source, unsigned int numInserts) {
+        auto begin = std::chrono::steady_clock::now();
+        for (auto i = 0U; i < numInserts; ++i) {
+            auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+            auto vertex = nogdb::Vertex::create(txn, "persons");
+            nogdb::Edge::create(txn, "knows", (source != nullptr) ? *source : vertex, vertex);
+            txn.commit();
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count() / numInserts;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    auto maxDegree = (argc > 1) ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 1000000U;
+    auto numInserts = (argc > 2) ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 1000U;
+    if (maxDegree == 0 || numInserts == 0) {
+        std::cerr << "usage: " << argv[0] << " [max degree] [number of inserts per degree]" << std::endl;
+        return 1;
+    }
+
+    clearDatabase(DATABASE_PATH);
+    try {
+        auto ctx = nogdb::Context{DATABASE_PATH};
+        initSchema(ctx);
+        auto hub = nogdb::RecordDescriptor{};
+        {
+            auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+            hub = nogdb::Vertex::create(txn, "persons");
+            txn.commit();
+        }
+
+        std::cout << std::setw(10) << "degree" << std::setw(16) << "hub" << std::setw(16) << "new vertex" << std::endl;
+        auto degree = 0U;
+        for (auto target = 1000U; target <= maxDegree; target *= 10U) {
+            growHub(ctx, hub, degree, target);
+            // the first commits after a bulk load are slower whatever they change
+            measure(ctx, &hub, numInserts);
+            measure(ctx, nullptr, numInserts);
+            auto hubLatency = measure(ctx, &hub, numInserts);
+            auto newVertexLatency = measure(ctx, nullptr, numInserts);
+            degree = target + 2 * numInserts;
+            std::cout << std::setw(10) << target << std::fixed << std::setprecision(1)
+                      << std::setw(13) << hubLatency << " us"
+                      << std::setw(13) << newVertexLatency << " us" << std::endl;
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        clearDatabase(DATABASE_PATH);
+        return 1;
+    }
+    clearDatabase(DATABASE_PATH);
+    return 0;
+}
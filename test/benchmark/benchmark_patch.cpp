@@ -0,0 +1,134 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Compares incrementing a counter property with Vertex::update against Vertex::patch and Vertex::increment
+// on vertices carrying indexed properties.
+// usage: benchmark_patch [number of vertices] [number of updates]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nogdb/nogdb.h"
+
+#include "benchmark_utils.h"
+
+namespace {
+
+    const std::string DATABASE_PATH{"./benchmark_patch.db"};
+
+    std::vector<nogdb::RecordDescriptor> initDatabase(nogdb::Context &ctx, unsigned int numVertices) {
+        auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txn, "pages", nogdb::ClassType::VERTEX);
+        nogdb::Property::add(txn, "pages", "url", nogdb::PropertyType::TEXT);
+        nogdb::Property::add(txn, "pages", "title", nogdb::PropertyType::TEXT);
+        nogdb::Property::add(txn, "pages", "rank", nogdb::PropertyType::UNSIGNED_INTEGER);
+        nogdb::Property::add(txn, "pages", "views", nogdb::PropertyType::UNSIGNED_BIGINT);
+        nogdb::Property::createIndex(txn, "pages", "url", true);
+        nogdb::Property::createIndex(txn, "pages", "rank");
+        auto vertices = std::vector<nogdb::RecordDescriptor>{};
+        vertices.reserve(numVertices);
+        for (auto i = 0U; i < numVertices; ++i) {
+            auto record = nogdb::Record{};
+            record.set("url", "https://example.com/" + std::to_string(i))
+                    .set("title", "page " + std::to_string(i))
+                    .set("rank", i % 1000U)
+                    .set("views", 0ULL);
+            vertices.emplace_back(nogdb::Vertex::create(txn, "pages", record));
+        }
+        txn.commit();
+        return vertices;
+    }
+
+    template<typename UpdateFunc>
+    double run(const std::string &name, const std::vector<nogdb::RecordDescriptor> &vertices,
+               const std::vector<size_t> &updates, UpdateFunc update) {
+        clearDatabase(DATABASE_PATH);
+        auto ctx = nogdb::Context{DATABASE_PATH};
+        initDatabase(ctx, static_cast<unsigned int>(vertices.size()));
+
+        auto begin = std::chrono::steady_clock::now();
+        auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+        for (const auto &index: updates) {
+            update(txn, vertices[index]);
+        }
+        txn.commit();
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        auto throughput = updates.size() / elapsed;
+        std::cout << std::left << std::setw(14) << name
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(10) << elapsed << " s"
+                  << std::setprecision(0) << std::setw(14) << throughput << " updates/s" << std::endl;
+        return throughput;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    auto numVertices = (argc > 1) ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 10000U;
+    auto numUpdates = (argc > 2) ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 100000U;
+    if (numVertices == 0) {
+        std::cerr << "usage: " << argv[0] << " [number of vertices] [number of updates]" << std::endl;
+        return 1;
+    }
+
+    auto generator = std::mt19937{42};
+    auto distribution = std::uniform_int_distribution<size_t>{0, numVertices - 1};
+    auto updates = std::vector<size_t>{};
+    updates.reserve(numUpdates);
+    for (auto i = 0U; i < numUpdates; ++i) {
+        updates.emplace_back(distribution(generator));
+    }
+
+    std::cout << "incrementing a counter " << numUpdates << " times over " << numVertices << " vertices" << std::endl;
+    try {
+        auto vertices = std::vector<nogdb::RecordDescriptor>{};
+        {
+            clearDatabase(DATABASE_PATH);
+            auto ctx = nogdb::Context{DATABASE_PATH};
+            vertices = initDatabase(ctx, numVertices);
+        }
+        auto baseline = run("update", vertices, updates, [](nogdb::Txn &txn, const nogdb::RecordDescriptor &vertex) {
+            auto record = nogdb::Db::getRecord(txn, vertex);
+            record.set("views", record.getBigIntU("views") + 1ULL);
+            nogdb::Vertex::update(txn, vertex, record);
+        });
+        auto patch = run("patch", vertices, updates, [](nogdb::Txn &txn, const nogdb::RecordDescriptor &vertex) {
+            auto record = nogdb::Db::getRecord(txn, vertex);
+            nogdb::Vertex::patch(txn, vertex, nogdb::Record{}.set("views", record.getBigIntU("views") + 1ULL));
+        });
+        auto increment = run("increment", vertices, updates, [](nogdb::Txn &txn, const nogdb::RecordDescriptor &vertex) {
+            nogdb::Vertex::increment(txn, vertex, "views", 1);
+        });
+        std::cout << "speedup       " << std::setprecision(1) << std::setw(10) << patch / baseline << "x (patch), "
+                  << increment / baseline << "x (increment)" << std::endl;
+    } catch (const nogdb::Error &ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        clearDatabase(DATABASE_PATH);
+        return 1;
+    }
+    clearDatabase(DATABASE_PATH);
+    return 0;
+}
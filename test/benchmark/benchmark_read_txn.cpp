@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Measures point lookups each made in its own read-only transaction, with and without reusing completed
+// read transactions.
+// usage: benchmark_read_txn [number of vertices] [number of lookups]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nogdb/nogdb.h"
+
+#include "benchmark_utils.h"
+
+namespace {
+
+    const std::string DATABASE_PATH{"./benchmark_read_txn.db"};
+
+    template<typename ReadFunc>
+    double measure(const std::string &name, unsigned int numLookups, ReadFunc read) {
+        auto begin = std::chrono::steady_clock::now();
+        for (auto i = 0U; i < numLookups; ++i) {
+            read(i);
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        auto throughput = numLookups / elapsed;
+        std::cout << std::left << std::setw(24) << name
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(10) << elapsed << " s"
+                  << std::setprecision(0) << std::setw(12) << throughput << " txns/s"
+                  << std::setprecision(2) << std::setw(10) << elapsed * 1e6 / numLookups << " us" << std::endl;
+        return throughput;
+    }
+
+    void run(unsigned int readTxnPoolSize, const std::vector<nogdb::RecordDescriptor> &vertices,
+             const std::vector<size_t> &lookups) {
+        auto options = nogdb::ContextOptions{};
+        options.readTxnPoolSize = readTxnPoolSize;
+        auto ctx = nogdb::Context{DATABASE_PATH, options};
+        auto const suffix = " (pool " + std::to_string(readTxnPoolSize) + ")";
+        measure("empty txn" + suffix, lookups.size(), [&ctx](unsigned int) {
+            auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_ONLY};
+        });
+        measure("point lookup" + suffix, lookups.size(), [&](unsigned int i) {
+            auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_ONLY};
+            nogdb::Db::getRecord(txn, vertices[lookups[i]]);
+        });
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    auto numVertices = (argc > 1) ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 10000U;
+    auto numLookups = (argc > 2) ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 200000U;
+    if (numVertices == 0 || numLookups == 0) {
+        std::cerr << "usage: " << argv[0] << " [number of vertices] [number of lookups]" << std::endl;
+        return 1;
+    }
+
+    clearDatabase(DATABASE_PATH);
+    auto vertices = std::vector<nogdb::RecordDescriptor>{};
+    auto lookups = std::vector<size_t>{};
+    try {
+        {
+            auto ctx = nogdb::Context{DATABASE_PATH};
+            auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+            nogdb::Class::create(txn, "persons", nogdb::ClassType::VERTEX);
+            nogdb::Property::add(txn, "persons", "name", nogdb::PropertyType::TEXT);
+            nogdb::Property::add(txn, "persons", "age", nogdb::PropertyType::UNSIGNED_INTEGER);
+            for (auto i = 0U; i < numVertices; ++i) {
+                auto record = nogdb::Record{};
+                record.set("name", "person" + std::to_string(i)).set("age", i % 100U);
+                vertices.emplace_back(nogdb::Vertex::create(txn, "persons", record));
+            }
+            txn.commit();
+        }
+        auto generator = std::mt19937{42};
+        auto distribution = std::uniform_int_distribution<size_t>{0, numVertices - 1};
+        lookups.reserve(numLookups);
+        for (auto i = 0U; i < numLookups; ++i) {
+            lookups.emplace_back(distribution(generator));
+        }
+
+        std::cout << numLookups << " read transactions over " << numVertices << " vertices" << std::endl;
+        run(0U, vertices, lookups);
+        run(64U, vertices, lookups);
+    } catch (const nogdb::Error &ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        clearDatabase(DATABASE_PATH);
+        return 1;
+    }
+    clearDatabase(DATABASE_PATH);
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Counts the heap allocations made per record while scanning a class of small properties.
+// usage: benchmark_record_alloc [number of vertices]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "nogdb/nogdb.h"
+
+#include "benchmark_utils.h"
+
+namespace {
+
+    std::atomic<unsigned long> numAllocations{0};
+
+}
+
+void *operator new(size_t size) {
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+    const std::string DATABASE_PATH{"./benchmark_record_alloc.db"};
+
+    void initDatabase(nogdb::Context &ctx, unsigned int numVertices) {
+        auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txn, "sensors", nogdb::ClassType::VERTEX);
+        nogdb::Property::add(txn, "sensors", "name", nogdb::PropertyType::TEXT);
+        nogdb::Property::add(txn, "sensors", "active", nogdb::PropertyType::UNSIGNED_TINYINT);
+        nogdb::Property::add(txn, "sensors", "level", nogdb::PropertyType::SMALLINT);
+        nogdb::Property::add(txn, "sensors", "zone", nogdb::PropertyType::UNSIGNED_INTEGER);
+        nogdb::Property::add(txn, "sensors", "serial", nogdb::PropertyType::BIGINT);
+        nogdb::Property::add(txn, "sensors", "reading", nogdb::PropertyType::REAL);
+        for (auto i = 0U; i < numVertices; ++i) {
+            auto record = nogdb::Record{};
+            record.set("name", "s" + std::to_string(i))
+                    .set("active", static_cast<uint8_t>(i % 2))
+                    .set("level", static_cast<int16_t>(i % 10))
+                    .set("zone", i % 100U)
+                    .set("serial", static_cast<int64_t>(i) * 7919)
+                    .set("reading", i * 0.5);
+            nogdb::Vertex::create(txn, "sensors", record);
+        }
+        txn.commit();
+    }
+
+    template<typename ScanFunc>
+    void measure(const std::string &name, nogdb::Context &ctx, ScanFunc scan) {
+        auto txn = nogdb::Txn{ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto begin = std::chrono::steady_clock::now();
+        auto allocations = numAllocations.load(std::memory_order_relaxed);
+        auto numRecords = scan(txn);
+        allocations = numAllocations.load(std::memory_order_relaxed) - allocations;
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << std::left << std::setw(10) << name
+                  << std::right << std::setw(10) << numRecords << " records"
+                  << std::fixed << std::setprecision(2) << std::setw(10)
+                  << (numRecords ? static_cast<double>(allocations) / numRecords : 0.0) << " allocs/record"
+                  << std::setprecision(3) << std::setw(10) << elapsed << " s" << std::endl;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    auto numVertices = (argc > 1) ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 100000U;
+    if (numVertices == 0) {
+        std::cerr << "usage: " << argv[0] << " [number of vertices]" << std::endl;
+        return 1;
+    }
+
+    try {
+        clearDatabase(DATABASE_PATH);
+        auto ctx = nogdb::Context{DATABASE_PATH};
+        initDatabase(ctx, numVertices);
+
+        measure("cursor", ctx, [](nogdb::Txn &txn) {
+            auto count = 0UL;
+            auto sum = 0ULL;
+            auto cursor = nogdb::Vertex::getCursor(txn, "sensors");
+            while (cursor.next()) {
+                sum += cursor->record.getIntU("zone");
+                ++count;
+            }
+            return sum ? count : 0UL;
+        });
+        measure("get", ctx, [](nogdb::Txn &txn) {
+            return nogdb::Vertex::get(txn, "sensors").size();
+        });
+        measure("find", ctx, [](nogdb::Txn &txn) {
+            return nogdb::Vertex::get(txn, "sensors", nogdb::Condition{"zone"}.ge(0U)).size();
+        });
+    } catch (const nogdb::Error &ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        clearDatabase(DATABASE_PATH);
+        return 1;
+    }
+    clearDatabase(DATABASE_PATH);
+    return 0;
+}
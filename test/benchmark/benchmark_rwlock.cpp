@@ -0,0 +1,126 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Compares the spinning and the parking reader-writer locks under a mixed read/write workload.
+// usage: benchmark_rwlock [max number of threads] [percentage of writes] [seconds per run]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spinlock.hpp"
+
+namespace {
+
+    const size_t NUM_SLOTS = 16;
+
+    struct Result {
+        double throughput;
+        double writeThroughput;
+        double cpuPerWall;
+    };
+
+    template<typename Lock>
+    Result run(unsigned int numThreads, unsigned int writePercentage, double seconds) {
+        Lock lock{};
+        unsigned long long slots[NUM_SLOTS] = {};
+        std::atomic<bool> isRunning{true};
+        std::atomic<unsigned long long> numReads{0};
+        std::atomic<unsigned long long> numWrites{0};
+        std::atomic<unsigned long long> checksum{0};
+        auto workers = std::vector<std::thread>{};
+        auto cpuBegin = std::clock();
+        auto begin = std::chrono::steady_clock::now();
+        for (auto i = 0U; i < numThreads; ++i) {
+            workers.emplace_back([&, i]() {
+                auto generator = std::mt19937{i};
+                auto distribution = std::uniform_int_distribution<unsigned int>{0, 99};
+                auto reads = 0ULL;
+                auto writes = 0ULL;
+                auto sum = 0ULL;
+                while (isRunning.load(std::memory_order_relaxed)) {
+                    if (distribution(generator) < writePercentage) {
+                        nogdb::RWSpinLockGuard<Lock> _(lock, nogdb::RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                        ++slots[writes % NUM_SLOTS];
+                        ++writes;
+                    } else {
+                        nogdb::RWSpinLockGuard<Lock> _(lock);
+                        for (auto slot: slots) {
+                            sum += slot;
+                        }
+                        ++reads;
+                    }
+                }
+                numReads += reads;
+                checksum += sum;
+                numWrites += writes;
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        isRunning = false;
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        auto cpuElapsed = static_cast<double>(std::clock() - cpuBegin) / CLOCKS_PER_SEC;
+        return Result{(numReads + numWrites) / elapsed, numWrites / elapsed, cpuElapsed / elapsed};
+    }
+
+    void print(const std::string &name, const Result &result) {
+        std::cout << "  " << std::left << std::setw(18) << name << std::right
+                  << std::fixed << std::setprecision(0) << std::setw(14) << result.throughput << " ops/s"
+                  << std::setw(12) << result.writeThroughput << " writes/s"
+                  << std::setprecision(2) << std::setw(8) << result.cpuPerWall << " cpu" << std::endl;
+    }
+
+}
+
+int main(int argc, char *argv[]) {
+    auto maxThreads = (argc > 1) ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 64U;
+    auto writePercentage = (argc > 2) ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 5U;
+    auto seconds = (argc > 3) ? std::strtod(argv[3], nullptr) : 1.0;
+    if (maxThreads == 0 || writePercentage > 100 || seconds <= 0.0) {
+        std::cerr << "usage: " << argv[0] << " [max number of threads] [percentage of writes] [seconds per run]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::cout << writePercentage << "% writes on " << std::thread::hardware_concurrency() << " hardware threads"
+              << std::endl;
+    for (auto numThreads = 1U; numThreads <= maxThreads;
+         numThreads = (numThreads == maxThreads) ? maxThreads + 1 : std::min(numThreads * 2, maxThreads)) {
+        std::cout << numThreads << " threads" << std::endl;
+        print("spinning", run<nogdb::SpinningRWLock>(numThreads, writePercentage, seconds));
+        print("parking", run<nogdb::ParkingRWLock<1>>(numThreads, writePercentage, seconds));
+        print("parking striped", run<nogdb::ParkingRWLock<RWLOCK_NUM_READER_STRIPES>>(numThreads, writePercentage,
+                                                                                       seconds));
+    }
+    return 0;
+}
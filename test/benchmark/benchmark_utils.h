@@ -0,0 +1,45 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BENCHMARK_UTILS_H_
+#define BENCHMARK_UTILS_H_
+
+#include <cstdio>
+#include <string>
+
+#include <dirent.h>
+#include <unistd.h>
+
+// removes a database left by a previous run
+inline void clearDatabase(const std::string &dbPath) {
+    DIR *theFolder = opendir(dbPath.c_str());
+    if (theFolder != NULL) {
+        struct dirent *nextFile;
+        while ((nextFile = readdir(theFolder)) != NULL) {
+            auto filePath = dbPath + "/" + nextFile->d_name;
+            remove(filePath.c_str());
+        }
+        closedir(theFolder);
+        rmdir(dbPath.c_str());
+    }
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <dirent.h>
+#include <unistd.h>
+#include "internaltest.h"
+
+nogdb::Context *ctx = nullptr;
+auto tnum = 0;
+
+void exec(void (*func)(), const std::string &msg) {
+    const clock_t begin_time = clock();
+    std::cout << "\x1B[32m+\x1B[0m " << msg << ".... ";
+    (*func)();
+    std::cout << "\x1B[32m(" << float(clock() - begin_time) / CLOCKS_PER_SEC * 1000 << std::fixed
+              << std::setprecision(3) << "ms)\x1B[0m"
+              << std::endl;
+    ++tnum;
+}
+
+void clear_database() {
+    DIR *theFolder = opendir(DATABASE_PATH.c_str());
+    if (theFolder != NULL) {
+        struct dirent *next_file;
+        while ((next_file = readdir(theFolder)) != NULL) {
+            auto filepath = DATABASE_PATH + "/" + next_file->d_name;
+            remove(filepath.c_str());
+        }
+        closedir(theFolder);
+        rmdir(DATABASE_PATH.c_str());
+    }
+}
+
+int main() {
+    clear_database();
+    try {
+        ctx = new nogdb::Context(DATABASE_PATH);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    const clock_t begin_time = clock();
+
+    std::cout << "\n\x1B[96mInternal tests for txn stat should:\x1B[0m\n";
+    exec(test_txn_stat_interleaved_readers, "getting the oldest version of readers which registered out of order");
+
+    std::cout << "\n\x1B[96mInternal tests for the record format should:\x1B[0m\n";
+    exec(test_read_legacy_record_format, "reading and upgrading records stored in the legacy format");
+
+    std::cout << "\n\x1B[96mInternal tests for the relations format should:\x1B[0m\n";
+    exec(test_upgrade_legacy_relations, "upgrading relations stored with legacy string keys");
+
+    std::cout << "\n\x1B[96mInternal tests for the adjacency cache should:\x1B[0m\n";
+    exec(test_traverse_within_adjacency_cache, "keeping a traversal over a larger graph within the cache size");
+
+    std::cout << "\n[\x1B[32mSuccess\x1B[0m] Test passed: " << tnum << "/" << tnum << ", "
+              << "Time elapse: " << float(clock() - begin_time) / CLOCKS_PER_SEC * 1000 << "ms\n";
+
+    delete ctx;
+    clear_database();
+}
@@ -0,0 +1,48 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef INTERNALTEST_H_
+#define INTERNALTEST_H_
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include "nogdb/nogdb.h"
+
+// tests which drive internal classes directly, unlike the apitests which only go through the public API
+
+const std::string DATABASE_PATH{"./internaltest.db"};
+
+extern nogdb::Context *ctx;
+
+// txn stat
+extern void test_txn_stat_interleaved_readers();
+
+// record format
+extern void test_read_legacy_record_format();
+
+// relations format
+extern void test_upgrade_legacy_relations();
+
+// adjacency cache
+extern void test_traverse_within_adjacency_cache();
+
+#endif
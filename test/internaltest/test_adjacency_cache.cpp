@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+#include "internaltest.h"
+
+#include "base_txn.hpp"
+
+// the number of edges kept in the in-memory graph
+static size_t getNumCachedEdges() {
+    nogdb::BaseTxn txn{*ctx, false};
+    auto const numEdges = txn.getRelation()->edges.size();
+    txn.rollback(*ctx);
+    return numEdges;
+}
+
+static void reopenWithAdjacencyCache(unsigned long adjacencyCacheSize) {
+    delete ctx;
+    auto options = nogdb::ContextOptions{};
+    options.numLoadingThreads = 1U;
+    options.adjacencyCacheSize = adjacencyCacheSize;
+    ctx = new nogdb::Context{DATABASE_PATH, options};
+}
+
+void test_traverse_within_adjacency_cache() {
+    const size_t numVertices = 300;
+    const unsigned long cacheSize = 32;
+    auto vertices = std::vector<nogdb::RecordDescriptor>{};
+    {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        try {
+            nogdb::Class::create(txn, "stops", nogdb::ClassType::VERTEX);
+            nogdb::Class::create(txn, "routes", nogdb::ClassType::EDGE);
+            for (size_t i = 0; i < numVertices; ++i) {
+                vertices.emplace_back(nogdb::Vertex::create(txn, "stops"));
+            }
+            // every stop leads to the next two, so the last stop is 150 hops away from the first
+            for (size_t i = 0; i + 1 < numVertices; ++i) {
+                nogdb::Edge::create(txn, "routes", vertices[i], vertices[i + 1]);
+                if (i + 2 < numVertices) {
+                    nogdb::Edge::create(txn, "routes", vertices[i], vertices[i + 2]);
+                }
+            }
+        } catch (const nogdb::Error &ex) {
+            std::cout << "\nError: " << ex.what() << std::endl;
+            assert(false);
+        }
+        txn.commit();
+    }
+
+    reopenWithAdjacencyCache(cacheSize);
+    {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        try {
+            // the traversal goes through the whole graph but hands back a single vertex
+            auto res = nogdb::Traverse::outEdgeBfs(txn, vertices.front(), 150, 150);
+            assert(res.size() == 1);
+            assert(res[0].descriptor == vertices.back());
+            assert(getNumCachedEdges() <= cacheSize + 4);
+
+            res = nogdb::Traverse::inEdgeDfs(txn, vertices.back(), 1, 1);
+            assert(res.size() == 2);
+            assert(getNumCachedEdges() <= cacheSize + 4);
+
+            // the vertices handed back stay loaded
+            res = nogdb::Traverse::shortestPath(txn, vertices.front(), vertices[4]);
+            assert(res.size() == 3);
+            assert(res[1].descriptor == vertices[2]);
+            assert(getNumCachedEdges() <= cacheSize + 12);
+        } catch (const nogdb::Error &ex) {
+            std::cout << "\nError: " << ex.what() << std::endl;
+            assert(false);
+        }
+        txn.rollback();
+    }
+
+    reopenWithAdjacencyCache(0UL);
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        nogdb::Class::drop(txn, "routes");
+        nogdb::Class::drop(txn, "stops");
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.commit();
+}
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "internaltest.h"
+
+#include "constant.hpp"
+#include "storage_engine.hpp"
+
+// appends a property block of the legacy record format
+static void appendLegacyProperty(nogdb::Blob &blob, nogdb::PropertyId propertyId, const void *value, size_t size) {
+    blob.append(&propertyId, sizeof(nogdb::PropertyId));
+    if (size < 128) {
+        auto flagAndSize = static_cast<uint8_t>(size << 1);
+        blob.append(&flagAndSize, sizeof(uint8_t));
+    } else {
+        auto flagAndSize = (static_cast<uint32_t>(size) << 1) | 1U;
+        blob.append(&flagAndSize, sizeof(uint32_t));
+    }
+    if (size > 0) {
+        blob.append(value, size);
+    }
+}
+
+void test_read_legacy_record_format() {
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txn, "books", nogdb::ClassType::VERTEX);
+        nogdb::Property::add(txn, "books", "title", nogdb::PropertyType::TEXT);
+        nogdb::Property::add(txn, "books", "words", nogdb::PropertyType::UNSIGNED_BIGINT);
+        nogdb::Property::add(txn, "books", "pages", nogdb::PropertyType::INTEGER);
+        nogdb::Property::add(txn, "books", "price", nogdb::PropertyType::REAL);
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    auto longTitle = std::string(300, 'a');
+    auto classId = nogdb::ClassId{};
+    auto titleId = nogdb::PropertyId{}, pagesId = nogdb::PropertyId{}, priceId = nogdb::PropertyId{};
+    auto rdesc1 = nogdb::RecordDescriptor{}, rdesc2 = nogdb::RecordDescriptor{}, rdesc3 = nogdb::RecordDescriptor{};
+    {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        try {
+            nogdb::Property::createIndex(txn, "books", "pages");
+            auto schema = nogdb::Db::getSchema(txn, "books");
+            classId = schema.id;
+            titleId = schema.properties.at("title").id;
+            pagesId = schema.properties.at("pages").id;
+            priceId = schema.properties.at("price").id;
+            rdesc1 = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", longTitle).set("pages", 320));
+            rdesc2 = nogdb::Vertex::create(txn, "books");
+            rdesc3 = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Tarzan").set("pages", 360));
+        } catch (const nogdb::Error &ex) {
+            std::cout << "\nError: " << ex.what() << std::endl;
+            assert(false);
+        }
+        txn.commit();
+    }
+
+    // rewrite the first two records in the legacy format, as a database of an earlier release stores them
+    delete ctx;
+    {
+        auto options = nogdb::ContextOptions{};
+        nogdb::storage_engine::LMDBEnv env{DATABASE_PATH, options.maxDbNum, options.maxDbSize, options.maxReaders};
+        nogdb::storage_engine::LMDBTxn dsTxn{&env, nogdb::storage_engine::lmdb::TXN_RW};
+        auto classDBHandler = dsTxn.openClassDbi(classId);
+        auto pages = int32_t{320};
+        auto price = 24.5;
+        auto version = uint64_t{1};
+        auto legacy = nogdb::Blob(512);
+        appendLegacyProperty(legacy, pagesId, &pages, sizeof(pages));
+        appendLegacyProperty(legacy, nogdb::VERSION_PROPERTY_ID, &version, sizeof(version));
+        appendLegacyProperty(legacy, titleId, longTitle.c_str(), longTitle.size());
+        appendLegacyProperty(legacy, priceId, &price, sizeof(price));
+        classDBHandler.put(rdesc1.rid.second, legacy);
+        auto placeholder = nogdb::Blob(1);
+        placeholder.append("\n", 1);
+        classDBHandler.put(rdesc2.rid.second, placeholder);
+        dsTxn.commit();
+    }
+    ctx = new nogdb::Context{DATABASE_PATH};
+
+    auto checkRecords = [&](nogdb::Txn &txn) {
+        auto record = nogdb::Db::getRecord(txn, rdesc1);
+        assert(record.getText("title") == longTitle);
+        assert(record.getInt("pages") == 320);
+        assert(record.getReal("price") == 24.5);
+        assert(record.get("words").empty());
+        assert(record.getVersion() == 1);
+        assert(nogdb::Db::getRecord(txn, rdesc2).getProperties().empty());
+
+        auto res = nogdb::Vertex::get(txn, "books");
+        assert(res.size() == 3);
+        assert(res[0].record.getReal("price") == 24.5);
+        assert(res[1].record.empty());
+        assert(res[2].record.getText("title") == "Tarzan");
+
+        auto cursor = nogdb::Vertex::getCursor(txn, "books");
+        assert(cursor.next());
+        assert(cursor->descriptor == rdesc1);
+        assert(cursor->record.getText("title") == longTitle);
+
+        // through the index on pages, and through a scan on title
+        res = nogdb::Vertex::getIndex(txn, "books", nogdb::Condition{"pages"}.eq(320));
+        assert(res.size() == 1);
+        assert(res[0].descriptor == rdesc1);
+        assert(res[0].record.getReal("price") == 24.5);
+        res = nogdb::Vertex::get(txn, "books", nogdb::Condition{"title"}.eq(longTitle));
+        assert(res.size() == 1);
+        assert(res[0].descriptor == rdesc1);
+        res = nogdb::Vertex::get(txn, "books", nogdb::Condition{"price"}.gt(20.0));
+        assert(res.size() == 1);
+        assert(res[0].descriptor == rdesc1);
+    };
+
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+    try {
+        checkRecords(txn);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.rollback();
+
+    txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        assert(nogdb::Db::upgradeRecordFormat(txn, "books") == 2);
+        checkRecords(txn);
+        assert(nogdb::Db::upgradeRecordFormat(txn, "books") == 0);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.commit();
+
+    txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        checkRecords(txn);
+        assert(nogdb::Db::upgradeRecordFormat(txn, "books") == 0);
+        // an upgraded record is updated as any other record
+        nogdb::Vertex::update(txn, rdesc1, nogdb::Record{}.set("title", "Lion King").set("pages", 330));
+        auto record = nogdb::Db::getRecord(txn, rdesc1);
+        assert(record.getText("title") == "Lion King");
+        assert(record.get("price").empty());
+        assert(record.getVersion() == 1);
+        assert(nogdb::Vertex::getIndex(txn, "books", nogdb::Condition{"pages"}.eq(320)).size() == 0);
+        assert(nogdb::Vertex::getIndex(txn, "books", nogdb::Condition{"pages"}.eq(330)).size() == 1);
+        nogdb::Property::dropIndex(txn, "books", "pages");
+        nogdb::Class::drop(txn, "books");
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.commit();
+}
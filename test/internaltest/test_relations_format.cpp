@@ -0,0 +1,147 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include <utility>
+
+#include "internaltest.h"
+
+#include "constant.hpp"
+#include "storage_engine.hpp"
+#include "graph.hpp"
+
+void test_upgrade_legacy_relations() {
+    auto v1 = nogdb::RecordDescriptor{}, v2 = nogdb::RecordDescriptor{}, v3 = nogdb::RecordDescriptor{};
+    auto e1 = nogdb::RecordDescriptor{}, e2 = nogdb::RecordDescriptor{}, e3 = nogdb::RecordDescriptor{};
+    {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        try {
+            nogdb::Class::create(txn, "persons", nogdb::ClassType::VERTEX);
+            nogdb::Class::create(txn, "knows", nogdb::ClassType::EDGE);
+            nogdb::Property::add(txn, "persons", "name", nogdb::PropertyType::TEXT);
+            v1 = nogdb::Vertex::create(txn, "persons", nogdb::Record{}.set("name", "Alice"));
+            v2 = nogdb::Vertex::create(txn, "persons", nogdb::Record{}.set("name", "Bob"));
+            v3 = nogdb::Vertex::create(txn, "persons", nogdb::Record{}.set("name", "Carol"));
+            e1 = nogdb::Edge::create(txn, "knows", v1, v2);
+            e2 = nogdb::Edge::create(txn, "knows", v1, v3);
+            e3 = nogdb::Edge::create(txn, "knows", v3, v2);
+        } catch (const nogdb::Error &ex) {
+            std::cout << "\nError: " << ex.what() << std::endl;
+            assert(false);
+        }
+        txn.commit();
+    }
+
+    // rewrite the relations with "classId:positionId" keys and without the format marker,
+    // as a database of an earlier release stores them, and drop the adjacency snapshot which it does not have
+    delete ctx;
+    auto const options = nogdb::ContextOptions{};
+    {
+        nogdb::storage_engine::LMDBEnv env{DATABASE_PATH, options.maxDbNum, options.maxDbSize, options.maxReaders};
+        nogdb::storage_engine::LMDBTxn dsTxn{&env, nogdb::storage_engine::lmdb::TXN_RW};
+        auto relationDBHandler = dsTxn.openDbi(nogdb::TB_RELATIONS);
+        auto legacyRelations = std::vector<std::pair<std::string, nogdb::Blob>>{};
+        {
+            auto relationCursor = dsTxn.openCursor(relationDBHandler);
+            for (auto keyValue = relationCursor.getNext(); !keyValue.empty(); keyValue = relationCursor.getNext()) {
+                if (keyValue.key.data.size() != sizeof(nogdb::RelationKey)) {
+                    continue;
+                }
+                auto rid = nogdb::key2rid(keyValue.key.data.numeric<nogdb::RelationKey>());
+                legacyRelations.emplace_back(std::to_string(rid.first) + ":" + std::to_string(rid.second),
+                                             keyValue.val.data.blob());
+                relationCursor.del();
+            }
+        }
+        assert(legacyRelations.size() == 3);
+        for (const auto &relation: legacyRelations) {
+            relationDBHandler.put(relation.first, relation.second);
+        }
+        relationDBHandler.del(nogdb::RELATIONS_FORMAT_KEY);
+        dsTxn.openDbi(nogdb::TB_RELATIONS_SNAPSHOT, true).drop();
+        dsTxn.openDbi(nogdb::TB_RELATIONS_DIRTY).drop();
+        dsTxn.commit();
+    }
+    ctx = new nogdb::Context{DATABASE_PATH};
+
+    {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        try {
+            auto res = nogdb::Edge::getSrcDst(txn, e1);
+            assert(res.size() == 2);
+            assert(res[0].descriptor == v1 && res[1].descriptor == v2);
+            res = nogdb::Edge::getSrcDst(txn, e3);
+            assert(res[0].descriptor == v3 && res[1].descriptor == v2);
+            res = nogdb::Vertex::getOutEdge(txn, v1);
+            assert(res.size() == 2);
+            assert((res[0].descriptor == e1 && res[1].descriptor == e2) ||
+                   (res[0].descriptor == e2 && res[1].descriptor == e1));
+            res = nogdb::Vertex::getInEdge(txn, v2);
+            assert(res.size() == 2);
+            assert(nogdb::Vertex::getInEdge(txn, v1).empty());
+            res = nogdb::Traverse::outEdgeBfs(txn, v1, 1, 2);
+            assert(res.size() == 2);
+        } catch (const nogdb::Error &ex) {
+            std::cout << "\nError: " << ex.what() << std::endl;
+            assert(false);
+        }
+        txn.rollback();
+    }
+
+    // the relations have been rewritten with binary keys and marked as such
+    delete ctx;
+    {
+        nogdb::storage_engine::LMDBEnv env{DATABASE_PATH, options.maxDbNum, options.maxDbSize, options.maxReaders};
+        nogdb::storage_engine::LMDBTxn dsTxn{&env, nogdb::storage_engine::lmdb::TXN_RO};
+        auto relationDBHandler = dsTxn.openDbi(nogdb::TB_RELATIONS);
+        auto numRelations = 0U;
+        {
+            auto relationCursor = dsTxn.openCursor(relationDBHandler);
+            for (auto keyValue = relationCursor.getNext(); !keyValue.empty(); keyValue = relationCursor.getNext()) {
+                auto key = keyValue.key.data.string();
+                if (key == nogdb::STRING_EM_INIT || key == nogdb::RELATIONS_FORMAT_KEY) {
+                    continue;
+                }
+                assert(keyValue.key.data.size() == sizeof(nogdb::RelationKey));
+                assert(sizeof(nogdb::RelationKey) == 6);
+                ++numRelations;
+            }
+        }
+        assert(numRelations == 3);
+        auto format = relationDBHandler.get(nogdb::RELATIONS_FORMAT_KEY);
+        assert(!format.empty);
+        assert(format.data.numeric<uint8_t>() == nogdb::RELATIONS_FORMAT_BINARY_KEY);
+        assert(!relationDBHandler.get(nogdb::rid2key(e2.rid)).empty);
+        dsTxn.rollback();
+    }
+    ctx = new nogdb::Context{DATABASE_PATH};
+
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        assert(nogdb::Vertex::getOutEdge(txn, v3).size() == 1);
+        nogdb::Class::drop(txn, "knows");
+        nogdb::Class::drop(txn, "persons");
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.commit();
+}
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Affero General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Affero General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Affero General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "internaltest.h"
+
+#include "txn_object.hpp"
+
+void test_txn_stat_interleaved_readers() {
+    // a reader moves its slot to a newer version when a writer commits while it registers, so it can
+    // see a newer version than a reader which has a greater txn id
+    nogdb::TxnStat txnStat{};
+    txnStat.maxVersionId = 10;
+    auto const txnIdA = txnStat.fetchAddMaxTxnId();
+    auto const txnIdB = txnStat.fetchAddMaxTxnId();
+    auto readerB = txnStat.addActiveTxnId(txnIdB);
+    assert(readerB.second == 10);
+    txnStat.fetchAddMaxVersionId();
+    auto readerA = txnStat.addActiveTxnId(txnIdA);
+    assert(readerA.second == 11);
+    assert(txnIdA < txnIdB);
+    assert(txnStat.minActiveTxnId() == std::make_pair(txnIdB, (nogdb::TxnId) 10));
+
+    txnStat.removeActiveTxnId(readerB.first, txnIdB);
+    assert(txnStat.minActiveTxnId() == std::make_pair(txnIdA, (nogdb::TxnId) 11));
+    txnStat.removeActiveTxnId(readerA.first, txnIdA);
+    assert(txnStat.minActiveTxnId() == std::make_pair((nogdb::TxnId) 0, (nogdb::TxnId) 0));
+}